@@ -301,7 +301,21 @@ typedef enum ir_builtin_kind {
 	                                 1 otherwise */
 	ir_bk_va_start,             /**< va_start from <stdarg.h> */
 	ir_bk_va_arg,               /**< va_arg from <stdarg.h> */
-	ir_bk_last = ir_bk_va_arg,
+	ir_bk_sqrt,                 /**< floating point square root */
+	ir_bk_fabs,                 /**< floating point absolute value */
+	ir_bk_floor,                /**< round towards negative infinity */
+	ir_bk_ceil,                 /**< round towards positive infinity */
+	ir_bk_trunc,                /**< round towards zero */
+	ir_bk_round,                /**< round to nearest, ties away from zero */
+	ir_bk_fmin,                 /**< floating point minimum */
+	ir_bk_fmax,                 /**< floating point maximum */
+	ir_bk_copysign,             /**< magnitude of the first operand with the
+	                                 sign of the second operand */
+	ir_bk_cycle_counter,        /**< read the lower 32 bits of the processor
+	                                 cycle counter, differences of two reads
+	                                 wrap around after 2^32 cycles; only
+	                                 the x86 backends (rdtsc) support it */
+	ir_bk_last = ir_bk_cycle_counter,
 } ir_builtin_kind;
 
 /**
@@ -120,6 +120,17 @@ FIRM_API const char *ir_get_dump_filter(void);
  */
 FIRM_API void dump_ir_graph_file(FILE *out, ir_graph *graph);
 
+/**
+ * Dumps all Firm nodes of a single graph in a compact streaming format:
+ * One JSON object per line with interned strings. The dump is compressed with
+ * zstd if the dump format is #ir_dump_format_stream_zstd and libFirm was built
+ * with zstd support. Nodes rejected by the node filter hook are skipped.
+ * support/firmdump.py converts these dumps to vcg or dot.
+ * @param out    Output stream the graph is written to
+ * @param graph  The firm graph to be dumped.
+ */
+FIRM_API void dump_ir_graph_stream(FILE *out, ir_graph *graph);
+
 /**
  * Dump the control flow graph of a procedure.
  *
@@ -286,6 +297,18 @@ typedef enum {
 } ir_dump_flags_t;
 ENUM_BITSET(ir_dump_flags_t)
 
+/** File formats used by #dump_ir_graph */
+typedef enum {
+	ir_dump_format_vcg,         /**< vcg, see #dump_ir_graph_file */
+	ir_dump_format_stream,      /**< streaming format, see #dump_ir_graph_stream */
+	ir_dump_format_stream_zstd, /**< zstd compressed streaming format */
+} ir_dump_format_t;
+
+/** Sets the file format used by #dump_ir_graph */
+FIRM_API void ir_set_dump_format(ir_dump_format_t format);
+/** Returns the file format used by #dump_ir_graph */
+FIRM_API ir_dump_format_t ir_get_dump_format(void);
+
 /** override currently set dump flags with new ones */
 FIRM_API void ir_set_dump_flags(ir_dump_flags_t flags);
 /** add flags to the currently set dump flags */
@@ -315,11 +338,22 @@ typedef int (*dump_edge_vcgattr_func)(FILE *out, const ir_node *node, int to);
  */
 typedef void (*dump_node_edge_func)(FILE *out, const ir_node *node);
 
+/**
+ * This hook is called by the streaming dumper for each node. The node is only
+ * dumped if it returns nonzero.
+ */
+typedef int (*dump_node_filter_func)(const ir_node *node);
+
 /** Sets the node_vcgattr hook. */
 FIRM_API void set_dump_node_vcgattr_hook(dump_node_vcgattr_func hook);
 /** Sets the edge_vcgattr hook. */
 FIRM_API void set_dump_edge_vcgattr_hook(dump_edge_vcgattr_func hook);
 
+/** Sets the node filter hook of the streaming dumper, NULL dumps all nodes. */
+FIRM_API void set_dump_node_filter_hook(dump_node_filter_func hook);
+/** Returns the node filter hook of the streaming dumper. */
+FIRM_API dump_node_filter_func get_dump_node_filter_hook(void);
+
 /**
  * Sets the hook to be called to dump additional edges to a node.
  * @param func The hook to be called.
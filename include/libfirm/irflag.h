@@ -110,6 +110,19 @@ FIRM_API void set_opt_global_null_ptr_elimination(int value);
 /** Returns global null pointer test elimination setting. */
 FIRM_API int get_opt_global_null_ptr_elimination(void);
 
+/**
+ * Enable/Disable fast math.
+ *
+ * If opt_fast_math == 1, floating point operations may be transformed in
+ * ways, which ignore NaNs, signed zeros and errno. This allows, for example,
+ * to replace calls of C library math functions by machine instructions.
+ * Default: opt_fast_math == 0.
+ */
+FIRM_API void set_opt_fast_math(int value);
+
+/** Returns fast math setting. */
+FIRM_API int get_opt_fast_math(void);
+
 /**
  * Save the current optimization state.
  */
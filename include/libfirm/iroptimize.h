@@ -115,6 +115,14 @@ typedef int (*arch_allow_ifconv_func)(ir_node const *sel,
  *
  * @param irg The graph.
  *
+ * A branch is only converted if the Mux nodes, which compute both arms, are
+ * cheaper than the branch given the execution frequencies of the arms, i.e.
+ * the branch is hard to predict or the arms are cheap. Branches mostly taking
+ * one direction are never converted. Conversely, Mux nodes with expensive
+ * operands are split into branches, if the target does not support them or
+ * their selector is known to be biased. The frequencies of a loaded profile
+ * are used, if the graph has them, and estimated otherwise.
+ *
  * Cannot handle blocks with Bad control predecessors, so call it after control
  * flow optimization.
  */
@@ -301,6 +309,68 @@ FIRM_API void remove_phi_cycles(ir_graph *irg);
  */
 FIRM_API void proc_cloning(float threshold);
 
+/**
+ * Interprocedural constant and range propagation.
+ *
+ * All call sites of functions, which are not externally visible and whose
+ * address is never taken, are known. Parameters, which have the same constant
+ * at all call sites, and results, which are the same constant at all Returns,
+ * are replaced by the constant. Integer values in a range of constants are
+ * marked with Confirm nodes, which must be removed before code generation
+ * like the ones of construct_confirms(). Parameters and results, which are
+ * not used anymore, are removed from the method type and all call sites.
+ *
+ * Computes callee information if it is not available.
+ */
+FIRM_API void propagate_interprocedural(void);
+
+/**
+ * Merges functions with identical graphs.
+ *
+ * A duplicate function is removed and all references to it are redirected to
+ * the remaining copy, when the program cannot observe that both functions
+ * have the same address. This holds for functions, which are not visible
+ * outside of the compilation unit and whose address is never taken, and for
+ * functions with IR_LINKAGE_NO_IDENTITY. Externally visible duplicates are
+ * replaced by an alias entity if @p use_aliases is set. A duplicate, whose
+ * address must stay unique, gets a graph which just calls the remaining copy,
+ * if the duplicate is large enough for this to save code.
+ *
+ * Alias entities are only supported for ELF targets.
+ */
+FIRM_API void merge_identical_functions(int use_aliases);
+
+/**
+ * A per-graph optimization pipeline for optimize_graphs_parallel().
+ */
+typedef void (*irg_pipeline_func)(ir_graph *irg, void *data);
+
+/**
+ * Runs @p pipeline for all graphs of the program using up to @p n_threads
+ * threads.
+ *
+ * A graph is processed after the graphs of all functions it calls, unless
+ * they are in the same strongly connected component of the call graph. The
+ * graphs of one component are processed one after the other.
+ *
+ * The pipeline may only modify the graph it is called for and must use the
+ * new_r_* constructors instead of current_ir_graph. Passes working on the
+ * whole program, like inlining, optimize_funccalls(), mark_private_methods()
+ * and the lowerings of calls, double-word and floating point operations, as
+ * well as dumping and statistics must not be used in the pipeline.
+ *
+ * Passes reserving program wide resources, like scalar_replacement_opt(),
+ * opt_frame_irg() and create_irg_copy(), hold the global libFirm lock (see
+ * be_jit_lock()) while the resource is reserved, so they do not run
+ * concurrently with each other.
+ *
+ * The optimization flags (see irflag.h) are thread local. Every thread starts
+ * with the flags of the thread calling this function, and changes made by the
+ * pipeline only affect the thread running it.
+ */
+FIRM_API void optimize_graphs_parallel(irg_pipeline_func pipeline, void *data,
+                                       unsigned n_threads);
+
 /**
  * Reassociation.
  *
@@ -314,9 +384,23 @@ FIRM_API void proc_cloning(float threshold);
  *
  * See Muchnik 12.3.1 Algebraic Simplification and Reassociation of
  * Addressing Expressions.
+ *
+ * Afterwards the trees are rebalanced by balance_expression_trees().
  */
 FIRM_API void optimize_reassociation(ir_graph *irg);
 
+/**
+ * Rebalances trees of associative operations like a0 + a1 + ... + an, which
+ * are often built left-deep, into trees of logarithmic depth. A Phi
+ * accumulating the tree in a loop, as in an unrolled reduction, is combined
+ * last to keep the loop carried dependency short.
+ *
+ * Handles Add, Mul, And, Or and Eor of integers and Add and Mul of floating
+ * point values if imprecise float transformations are allowed.
+ * Called by optimize_reassociation(), if optimizations are enabled.
+ */
+FIRM_API void balance_expression_trees(ir_graph *irg);
+
 /**
  * Normalize the Returns of a graph by creating a new End block
  * with One Return(Phi).
@@ -459,6 +543,17 @@ FIRM_API void do_loop_peeling(ir_graph *irg);
  */
 FIRM_API void garbage_collect_entities(void);
 
+/**
+ * Promotes global variables, which are never written, to constants.
+ *
+ * Global entities not visible outside the compilation unit, whose address
+ * does not escape and which are never stored to, are marked with
+ * IR_LINKAGE_CONSTANT, which places them in a read-only section. Afterwards
+ * all loads at a constant offset into a constant entity, including loads of
+ * members of aggregates, are replaced by the value of its initializer.
+ */
+FIRM_API void promote_readonly_globals(void);
+
 /**
  * Performs dead node elimination by copying the ir graph to a new obstack.
  *
@@ -496,6 +591,25 @@ FIRM_API void dead_node_elimination(ir_graph *irg);
  */
 FIRM_API void place_code(ir_graph *irg);
 
+/**
+ * Code placement with partial dead code elimination.
+ *
+ * Places the code like place_code(). Afterwards a floating node, which is
+ * only needed on some of the paths leaving its block, is moved into the
+ * branches using it. If several branches use it, cheap nodes are duplicated
+ * into each of them, but only if the execution frequency of the branches is
+ * clearly lower than the one of the original block. The frequencies of a
+ * loaded profile are used, if the graph has them, and estimated otherwise.
+ * Nodes are never moved into loops.
+ *
+ * As with the other optimizations, the frontend decides whether to run this
+ * pass. It replaces place_code() in an optimization sequence; the backends
+ * only call place_code(), because they must not change the code size.
+ *
+ * @param irg  The graph to be optimized.
+ */
+FIRM_API void sink_partially_dead_code(ir_graph *irg);
+
 /**
  * This optimization finds values where the bits are either constant or irrelevant
  * and exchanges them for a corresponding constant.
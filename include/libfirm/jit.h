@@ -72,6 +72,142 @@ FIRM_API unsigned be_get_function_size(ir_jit_function_t const *function);
  */
 FIRM_API void be_emit_function(char *buffer, ir_jit_function_t *function);
 
+/**
+ * Optimization tiers of lazily compiled functions.
+ */
+typedef enum ir_jit_tier_t {
+	ir_jit_tier_fast, /**< little optimization and fast register allocation */
+	ir_jit_tier_full, /**< full optimization */
+} ir_jit_tier_t;
+
+/**
+ * Callbacks used to compile functions on their first call.
+ */
+typedef struct ir_jit_lazy_callbacks_t {
+	/**
+	 * Optimizes \p irg for \p tier before it is compiled, may be NULL.
+	 */
+	void (*optimize)(ir_graph *irg, ir_jit_tier_t tier, void *data);
+	/**
+	 * Returns executable memory of at least \p size bytes.
+	 */
+	char *(*allocate)(unsigned size, void *data);
+	/**
+	 * Called if \p entity could not be compiled with any tier. Returns the
+	 * address, which is called instead, e.g. an interpreter for \p entity.
+	 * May be NULL, then the failure is fatal.
+	 */
+	void const *(*compile_failed)(ir_entity *entity, void *data);
+	/** Passed to the callbacks. */
+	void *data;
+} ir_jit_lazy_callbacks_t;
+
+/**
+ * Set up lazy compilation for \p segment. Functions are compiled with
+ * ir_jit_tier_fast on their first call and compiled again with
+ * ir_jit_tier_full after \p recompile_threshold further calls. A threshold
+ * of 0 compiles with ir_jit_tier_full right away.
+ * If a tier cannot be compiled, the function keeps running the code it
+ * has: A function failing in ir_jit_tier_fast is compiled with
+ * ir_jit_tier_full immediately, and a function failing in ir_jit_tier_full
+ * stays in ir_jit_tier_fast.
+ */
+FIRM_API void be_jit_set_lazy_callbacks(ir_jit_segment_t *segment,
+                                        ir_jit_lazy_callbacks_t const *callbacks,
+                                        unsigned recompile_threshold);
+
+/**
+ * Compile the graph of \p entity on its first call: Creates a small stub
+ * for \p entity and sets the address of \p entity to it, so references from
+ * other functions and be_jit_get_entity_addr() use the stub. The stub
+ * compiles the function when it is called first and jumps through a slot,
+ * which is updated whenever a new tier of the function is compiled. Once
+ * ir_jit_tier_full is compiled, the stub jumps to it directly and the
+ * address of \p entity is set to its code.
+ * The graph must have been lowered for the target.
+ *
+ * @returns 0 if the target does not support lazy compilation
+ */
+FIRM_API int be_jit_compile_lazy(ir_jit_segment_t *segment, ir_entity *entity);
+
+/**
+ * Queue of graphs, which are compiled by background worker threads.
+ */
+typedef struct ir_jit_queue_t ir_jit_queue_t;
+
+/**
+ * Result of a graph compiled by a \ref ir_jit_queue_t.
+ */
+typedef struct ir_jit_future_t ir_jit_future_t;
+
+/**
+ * Called on the worker thread after \p irg was compiled to \p function
+ * (NULL if the target cannot compile it). The libFirm lock is held, so the
+ * callback may use be_get_function_size() and be_emit_function() to install
+ * the code. As the lock is recursive, the callback may also call
+ * be_jit_lock() itself.
+ */
+typedef void (*ir_jit_install_func)(ir_jit_function_t *function, ir_graph *irg,
+                                    void *data);
+
+/**
+ * Create a queue with \p n_workers worker threads. Each worker emits into
+ * its own segment.
+ *
+ * libFirm is not thread safe: While a queue exists, other threads must hold
+ * the libFirm lock (see be_jit_lock()) when they call into libFirm. A worker
+ * holds the lock while it compiles a graph, so graphs are compiled one at a
+ * time: The queue moves compilation off the calling thread, but additional
+ * workers do not compile faster.
+ *
+ * @returns NULL if no worker thread could be started
+ */
+FIRM_API ir_jit_queue_t *be_new_jit_queue(unsigned n_workers);
+
+/**
+ * Wait until all graphs of \p queue are compiled and destroy the queue with
+ * the segments of its workers. This invalidates the compiled functions,
+ * install their code before.
+ */
+FIRM_API void be_destroy_jit_queue(ir_jit_queue_t *queue);
+
+/**
+ * Enqueue \p irg for compilation. The graph must have been lowered for the
+ * target and must not be used until the compilation is done. \p install is
+ * called with \p data when the function is compiled, it may be NULL.
+ */
+FIRM_API ir_jit_future_t *be_jit_enqueue(ir_jit_queue_t *queue, ir_graph *irg,
+                                         ir_jit_install_func install,
+                                         void *data);
+
+/**
+ * Return non-zero if the graph of \p future has been compiled.
+ */
+FIRM_API int be_jit_future_done(ir_jit_future_t const *future);
+
+/**
+ * Wait until the graph of \p future has been compiled and return the
+ * function (NULL if the target cannot compile it).
+ */
+FIRM_API ir_jit_function_t *be_jit_future_wait(ir_jit_future_t *future);
+
+/**
+ * Free \p future, which must be done.
+ */
+FIRM_API void be_jit_free_future(ir_jit_future_t *future);
+
+/**
+ * Acquire the libFirm lock, which serializes calls into libFirm while worker
+ * threads of a \ref ir_jit_queue_t are running. The lock is recursive, a
+ * thread holding it may acquire it again and has to release it as often.
+ */
+FIRM_API void be_jit_lock(void);
+
+/**
+ * Release the libFirm lock. \see be_jit_lock()
+ */
+FIRM_API void be_jit_unlock(void);
+
 /** @} */
 
 #include "end.h"
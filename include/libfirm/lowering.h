@@ -211,6 +211,7 @@ FIRM_API int i_mapper_abs(ir_node *call);
 
 /**
  * A mapper for the floating point sqrt(v): floattype sqrt(floattype v);
+ * With fast math enabled, the call is replaced by a Builtin.
  *
  * @return 1 if the sqrt call was removed, 0 else.
  */
@@ -335,6 +336,70 @@ FIRM_API int i_mapper_cosh(ir_node *call);
  */
 FIRM_API int i_mapper_tanh(ir_node *call);
 
+/**
+ * A mapper for the floating point fabs(a): floattype fabs(floattype a);
+ * With fast math enabled, the call is replaced by a Builtin.
+ *
+ * @return 1 if the fabs call was removed, 0 else.
+ */
+FIRM_API int i_mapper_fabs(ir_node *call);
+
+/**
+ * A mapper for the floating point floor(a): floattype floor(floattype a);
+ * With fast math enabled, the call is replaced by a Builtin.
+ *
+ * @return 1 if the floor call was removed, 0 else.
+ */
+FIRM_API int i_mapper_floor(ir_node *call);
+
+/**
+ * A mapper for the floating point ceil(a): floattype ceil(floattype a);
+ * With fast math enabled, the call is replaced by a Builtin.
+ *
+ * @return 1 if the ceil call was removed, 0 else.
+ */
+FIRM_API int i_mapper_ceil(ir_node *call);
+
+/**
+ * A mapper for the floating point trunc(a): floattype trunc(floattype a);
+ * With fast math enabled, the call is replaced by a Builtin.
+ *
+ * @return 1 if the trunc call was removed, 0 else.
+ */
+FIRM_API int i_mapper_trunc(ir_node *call);
+
+/**
+ * A mapper for the floating point round(a): floattype round(floattype a);
+ * With fast math enabled, the call is replaced by a Builtin.
+ *
+ * @return 1 if the round call was removed, 0 else.
+ */
+FIRM_API int i_mapper_round(ir_node *call);
+
+/**
+ * A mapper for the floating point fmin(a, b): floattype fmin(floattype a, floattype b);
+ * With fast math enabled, the call is replaced by a Builtin.
+ *
+ * @return 1 if the fmin call was removed, 0 else.
+ */
+FIRM_API int i_mapper_fmin(ir_node *call);
+
+/**
+ * A mapper for the floating point fmax(a, b): floattype fmax(floattype a, floattype b);
+ * With fast math enabled, the call is replaced by a Builtin.
+ *
+ * @return 1 if the fmax call was removed, 0 else.
+ */
+FIRM_API int i_mapper_fmax(ir_node *call);
+
+/**
+ * A mapper for the floating point copysign(a, b): floattype copysign(floattype a, floattype b);
+ * With fast math enabled, the call is replaced by a Builtin.
+ *
+ * @return 1 if the copysign call was removed, 0 else.
+ */
+FIRM_API int i_mapper_copysign(ir_node *call);
+
 /**
  * A mapper for the strcmp-Function: inttype strcmp(char pointer a, char pointer b);
  *
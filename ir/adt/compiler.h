@@ -45,12 +45,18 @@
  */
 #define ENUMBF(type)  __extension__ type
 
+/**
+ * Declares a variable with a separate instance in each thread.
+ */
+#define THREAD_LOCAL  __thread
+
 #else
 #define LIKELY(x)   x
 #define UNLIKELY(x) x
 #define PURE
 #define UNUSED
 #define ENUMBF(type)  unsigned
+#define THREAD_LOCAL  __declspec(thread)
 #endif
 
 /**
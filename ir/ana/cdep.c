@@ -10,6 +10,7 @@
  */
 #include "cdep_t.h"
 
+#include "compiler.h"
 #include "irdom_t.h"
 #include "irdump.h"
 #include "irgraph_t.h"
@@ -27,7 +28,7 @@ typedef struct cdep_info {
 	struct obstack obst;     /**< An obstack where all cdep data lives on. */
 } cdep_info;
 
-static cdep_info *cdep_data;
+static THREAD_LOCAL cdep_info *cdep_data;
 
 ir_node *(get_cdep_node)(const ir_cdep *cdep)
 {
@@ -10,6 +10,7 @@
  */
 #include "constbits.h"
 
+#include "compiler.h"
 #include "debug.h"
 #include "iredges_t.h"
 #include "irgwalk.h"
@@ -29,6 +30,7 @@
 #if VERIFY_CONSTBITS
 #include "irdump.h"
 #include "irprintf.h"
+#include "opt_init.h"
 #include "panic.h"
 #endif
 
@@ -204,7 +206,7 @@ static bitinfo *get_bitinfo_recursive(ir_node const *const irn)
 	return b;
 }
 
-static bitinfo *(*get_bitinfo_func)(ir_node const*) = &get_bitinfo_null;
+static THREAD_LOCAL bitinfo *(*get_bitinfo_func)(ir_node const*) = &get_bitinfo_null;
 
 bitinfo *get_bitinfo(ir_node const *const irn)
 {
@@ -872,7 +874,6 @@ static void verify_constbits(ir_graph *const irg)
 
 void constbits_analyze(ir_graph *const irg)
 {
-	FIRM_DBG_REGISTER(dbg, "firm.ana.constbits");
 	DB((dbg, LEVEL_1, "---> activating constbits for %+F\n", irg));
 
 	assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES);
@@ -894,3 +895,8 @@ void constbits_clear(ir_graph *const irg)
 	ir_nodemap_destroy(&irg->bitinfo.map);
 	obstack_free(&irg->bitinfo.obst, NULL);
 }
+
+void firm_init_constbits(void)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.ana.constbits");
+}
@@ -18,16 +18,18 @@
  */
 #include "dca.h"
 
+#include "compiler.h"
 #include "constbits.h"
 #include "debug.h"
 #include "irgwalk.h"
 #include "irnode_t.h"
+#include "opt_init.h"
 #include "pdeq.h"
 #include "tv.h"
 
 DEBUG_ONLY(static firm_dbg_module_t *dbg;)
 
-static deq_t worklist;
+static THREAD_LOCAL deq_t worklist;
 
 /**
  * Set cared for bits in irn, possibly putting it on the worklist.
@@ -407,8 +409,6 @@ static void dca_init_node(ir_node *n, void *data)
 
 void dca_analyze(ir_graph *irg)
 {
-	FIRM_DBG_REGISTER(dbg, "firm.ana.dca");
-
 	DB((dbg, LEVEL_1, "===> Performing don't care bit analysis on %+F\n", irg));
 
 	assert(tarval_get_wrap_on_overflow());
@@ -428,3 +428,8 @@ void dca_analyze(ir_graph *irg)
 	}
 	deq_free(&worklist);
 }
+
+void firm_init_dca(void)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.ana.dca");
+}
@@ -27,6 +27,7 @@
  */
 #include "execfreq_t.h"
 
+#include "compiler.h"
 #include "dfs_t.h"
 #include "gaussjordan.h"
 #include "hashptr.h"
@@ -183,6 +184,22 @@ void set_block_execfreq(ir_node *block, double newfreq)
 	block->attr.block.execfreq = newfreq;
 }
 
+void set_execfreq_from_profile(ir_graph *irg)
+{
+	irg->execfreq_from_profile = true;
+}
+
+bool has_profile_execfreq(const ir_graph *irg)
+{
+	return irg->execfreq_from_profile;
+}
+
+void assure_execfreq(ir_graph *irg)
+{
+	if (!has_profile_execfreq(irg))
+		ir_estimate_execfreq(irg);
+}
+
 static void exec_freq_node_info(void *ctx, FILE *f, const ir_node *irn)
 {
 	(void)ctx;
@@ -265,9 +282,9 @@ static double get_cf_probability(const ir_node *bb, int pos,
 	return cur/sum;
 }
 
-static double *freqs;
-static double  min_non_zero;
-static double  max_freq;
+static THREAD_LOCAL double *freqs;
+static THREAD_LOCAL double  min_non_zero;
+static THREAD_LOCAL double  max_freq;
 
 static void collect_freqs(ir_node *node, void *data)
 {
@@ -438,6 +455,7 @@ static void free_properties_and_dfs(ir_graph *const irg, dfs_t *const dfs) {
 void ir_estimate_execfreq(ir_graph *irg)
 {
 	double loop_weight = 10.0;
+	irg->execfreq_from_profile = false;
 
 	assure_irg_properties(irg,
 		IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES
@@ -13,6 +13,7 @@
 #define FIRM_ANA_EXECFREQ_T_H
 
 #include "execfreq.h"
+#include <stdbool.h>
 
 void init_execfreq(void);
 
@@ -20,6 +21,24 @@ void exit_execfreq(void);
 
 void set_block_execfreq(ir_node *block, double freq);
 
+/**
+ * Marks the block execution frequencies of @p irg as read from a profile.
+ * They stay valid until ir_estimate_execfreq() is called for @p irg.
+ */
+void set_execfreq_from_profile(ir_graph *irg);
+
+/**
+ * Returns whether the block execution frequencies of @p irg were read from a
+ * profile.
+ */
+bool has_profile_execfreq(const ir_graph *irg);
+
+/**
+ * Estimates the block execution frequencies of @p irg, unless they were read
+ * from a profile.
+ */
+void assure_execfreq(ir_graph *irg);
+
 typedef struct ir_execfreq_int_factors {
 	double min_non_zero;
 	double m;
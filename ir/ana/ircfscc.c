@@ -12,6 +12,7 @@
  * @date      7.2002
  */
 #include "array.h"
+#include "compiler.h"
 #include "ircons_t.h"
 #include "irdump.h"
 #include "irgraph_t.h"
@@ -22,16 +23,16 @@
 #include "pmap.h"
 
 /** The outermost graph the scc is computed for */
-static ir_graph *outermost_ir_graph;
+static THREAD_LOCAL ir_graph *outermost_ir_graph;
 /** Current cfloop construction is working on. */
-static ir_loop *current_loop;
+static THREAD_LOCAL ir_loop *current_loop;
 /** Counts the number of allocated cfloop nodes.
  * Each cfloop node gets a unique number.
  * @todo What for? ev. remove.
  */
-static int loop_node_cnt = 0;
+static THREAD_LOCAL int loop_node_cnt = 0;
 /** Counter to generate depth first numbering of visited nodes. */
-static int current_dfn = 1;
+static THREAD_LOCAL int current_dfn = 1;
 
 /**********************************************************************/
 /* Node attributes needed for the construction.                      **/
@@ -121,9 +122,9 @@ static inline int get_irn_dfn(ir_node *n)
 /**********************************************************************/
 
 /** An IR-node stack */
-static ir_node **stack = NULL;
+static THREAD_LOCAL ir_node **stack = NULL;
 /** The top (index) of the IR-node stack */
-static size_t    tos = 0;
+static THREAD_LOCAL size_t    tos = 0;
 
 /**
  * Initializes the IR-node stack
@@ -23,6 +23,7 @@
 #include "irnode_t.h"
 #include "iropt_dbg.h"
 #include "irtools.h"
+#include "opt_init.h"
 
 /**
  * Walker environment.
@@ -526,8 +527,6 @@ static void insert_Confirm(ir_node *node, void *data)
 
 static void do_construct_confirms(ir_graph *irg, bool optimize)
 {
-	FIRM_DBG_REGISTER(dbg, "firm.ana.confirm");
-
 	assure_irg_properties(irg,
 		IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES
 		| IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE
@@ -584,3 +583,8 @@ void remove_confirms(ir_graph *irg)
 	irg_walk_graph(irg, NULL, remove_confirm, NULL);
 	confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_CONTROL_FLOW);
 }
+
+void firm_init_confirm(void)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.ana.confirm");
+}
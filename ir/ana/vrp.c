@@ -12,6 +12,7 @@
 
 #include "bitset.h"
 #include "debug.h"
+#include "firm_lock.h"
 #include "iredges_t.h"
 #include "irgopt.h"
 #include "irgraph_t.h"
@@ -21,6 +22,7 @@
 #include "iroptimize.h"
 #include "irouts_t.h"
 #include "irprintf.h"
+#include "opt_init.h"
 #include "pdeq.h"
 #include "tv.h"
 
@@ -298,11 +300,32 @@ static int vrp_update_node(ir_vrp_info *info, ir_node *node)
 				new_range_top = get_Const_tarval(bound);
 				new_range_bottom = get_Const_tarval(bound);
 			}
-		} else if (relation == ir_relation_less_equal) {
-			if (is_Const(bound)) {
-				new_range_type = VRP_RANGE;
-				new_range_top = get_Const_tarval(bound);
-				new_range_bottom = get_mode_min(get_irn_mode(node));
+		} else if ((relation == ir_relation_less_equal
+		         || relation == ir_relation_greater_equal) && is_Const(bound)) {
+			/* Intersect with the range of the value, so chained Confirms
+			 * for the lower and upper bound yield both bounds. */
+			ir_mode        *mode     = get_irn_mode(node);
+			const vrp_attr *vrp_pred = vrp_get_or_set_info(info, get_Confirm_value(node));
+			ir_tarval      *bottom   = get_mode_min(mode);
+			ir_tarval      *top      = get_mode_max(mode);
+			if (vrp_pred->range_type == VRP_RANGE) {
+				bottom = vrp_pred->range_bottom;
+				top    = vrp_pred->range_top;
+			}
+			ir_tarval *tv = get_Const_tarval(bound);
+			if (relation == ir_relation_less_equal) {
+				if (tarval_cmp(top, tv) == ir_relation_greater)
+					top = tv;
+			} else {
+				if (tarval_cmp(bottom, tv) == ir_relation_less)
+					bottom = tv;
+			}
+			/* An empty intersection means, that the Confirm is never
+			 * reached, so its range stays undefined. */
+			if (tarval_cmp(bottom, top) != ir_relation_greater) {
+				new_range_type   = VRP_RANGE;
+				new_range_bottom = bottom;
+				new_range_top    = top;
 			}
 		}
 		break;
@@ -503,17 +526,17 @@ void set_vrp_data(ir_graph *irg)
 	if (irg->vrp.infos.data != NULL)
 		free_vrp_data(irg);
 
-	FIRM_DBG_REGISTER(dbg, "ir.ana.vrp");
-
 	assure_irg_outs(irg); /* ensure that out edges are consistent*/
 	ir_nodemap_init(&irg->vrp.infos, irg);
 	obstack_init(&irg->vrp.obst);
 	ir_vrp_info *info = &irg->vrp;
 
+	firm_lock_globals();
 	if (dump_hook.hook._hook_node_info == NULL) {
 		dump_hook.hook._hook_node_info = dump_vrp_info;
 		register_hook(hook_node_info, &dump_hook);
 	}
+	firm_unlock_globals();
 
 	vrp_env_t *env = OALLOCZ(&irg->vrp.obst, vrp_env_t);
 	env->info      = info;
@@ -572,3 +595,8 @@ ir_relation vrp_cmp(const ir_node *left, const ir_node *right)
 	/* TODO: We can get way more information here*/
 	return ir_relation_true;
 }
+
+void firm_init_vrp(void)
+{
+	FIRM_DBG_REGISTER(dbg, "ir.ana.vrp");
+}
@@ -16,7 +16,9 @@
 #include "amd64_optimize.h"
 #include "amd64_transform.h"
 #include "amd64_varargs.h"
+#include "array.h"
 #include "beflags.h"
+#include "beipra.h"
 #include "beirg.h"
 #include "bemodule.h"
 #include "bera.h"
@@ -47,6 +49,9 @@ pmap *amd64_constants;
 
 ir_mode *amd64_mode_xmm;
 
+/** Use the SSE4.1 rounding instructions. */
+static bool use_sse4_1 = false;
+
 static ir_node *create_push(ir_node *node, ir_node *schedpoint, ir_node *sp,
                             ir_node *mem, ir_entity *ent, x86_insn_size_t size)
 {
@@ -410,6 +415,7 @@ static void amd64_collect_frame_entity_nodes(ir_node *node, void *data)
 static void amd64_select_instructions(ir_graph *irg)
 {
 	amd64_adjust_pic(irg);
+	amd64_get_irg_data(irg)->aligned_stack = be_ipra_needs_aligned_stack(irg);
 
 	be_timer_push(T_CODEGEN);
 	amd64_transform_graph(irg);
@@ -422,6 +428,11 @@ static void amd64_select_instructions(ir_graph *irg)
 	be_dump(DUMP_BE, irg, "opt");
 }
 
+/* The epilogue code handles returns and tail calls alike. */
+COMPILETIME_ASSERT((int)n_amd64_ret_mem   == (int)n_amd64_tail_call_mem &&
+                   (int)n_amd64_ret_stack == (int)n_amd64_tail_call_stack,
+                   ret_and_tail_call_inputs_equal)
+
 static void introduce_epilogue(ir_node *ret, bool omit_fp)
 {
 	ir_graph *irg      = get_irn_irg(ret);
@@ -503,7 +514,7 @@ static void introduce_prologue_epilogue(ir_graph *irg, bool omit_fp)
 {
 	/* introduce epilogue for every return node */
 	foreach_irn_in(get_irg_end_block(irg), i, ret) {
-		assert(is_amd64_ret(ret));
+		assert(is_amd64_ret(ret) || is_amd64_tail_call(ret));
 		introduce_epilogue(ret, omit_fp);
 	}
 
@@ -597,13 +608,23 @@ int amd64_get_sp_change(ir_node *const node)
 	return res;
 }
 
+static ir_entity *amd64_get_frame_entity(const ir_node *node)
+{
+	if (!is_amd64_irn(node)
+	 || !amd64_has_addr_attr(get_amd64_attr_const(node)->op_mode))
+		return NULL;
+	x86_imm32_t const *const imm
+		= &get_amd64_addr_attr_const(node)->addr.immediate;
+	return imm->kind == X86_IMM_FRAMEENT ? imm->entity : NULL;
+}
+
 /**
  * Called immediately before emit phase.
  */
 static void amd64_finish_and_emit(ir_graph *irg)
 {
-	amd64_irg_data_t const *const irg_data = amd64_get_irg_data(irg);
-	bool                    const omit_fp  = irg_data->omit_fp;
+	amd64_irg_data_t *const irg_data = amd64_get_irg_data(irg);
+	bool              const omit_fp  = irg_data->omit_fp;
 
 	/* create and coalesce frame entities */
 	be_fec_env_t *fec_env = be_new_frame_entity_coalescer(irg);
@@ -612,7 +633,7 @@ static void amd64_finish_and_emit(ir_graph *irg)
 	be_free_frame_entity_coalescer(fec_env);
 
 	ir_type *const frame = get_irg_frame_type(irg);
-	be_sort_frame_entities(frame, omit_fp);
+	be_sort_frame_entities(irg, omit_fp, amd64_get_frame_entity);
 	unsigned const misalign = AMD64_REGISTER_SIZE; /* return address on stack */
 	int      const begin    = omit_fp ? 0 : -AMD64_REGISTER_SIZE;
 	be_layout_frame_type(frame, begin, misalign);
@@ -624,7 +645,12 @@ static void amd64_finish_and_emit(ir_graph *irg)
 	/* fix stack entity offsets */
 	be_fix_stack_nodes(irg, &amd64_registers[REG_RSP]);
 	be_birg_from_irg(irg)->non_ssa_regs = NULL;
-	unsigned const p2align = AMD64_PO2_STACK_ALIGNMENT;
+	/* The stack pointer only needs the alignment of a register, unless a
+	 * callee or a frame entity needs more. */
+	if (be_get_frame_alignment(frame) > AMD64_REGISTER_SIZE)
+		irg_data->aligned_stack = true;
+	unsigned const p2align = irg_data->aligned_stack
+		? AMD64_PO2_STACK_ALIGNMENT : AMD64_PO2_REGISTER_SIZE;
 	be_sim_stack_pointer(irg, misalign, p2align, amd64_sp_sim);
 
 	/* Fix 2-address code constraints. */
@@ -638,6 +664,13 @@ static void amd64_finish_and_emit(ir_graph *irg)
 	be_timer_push(T_EMIT);
 	amd64_emit_function(irg);
 	be_timer_pop(T_EMIT);
+
+	/* The registers modified by the target of a tail call are unknown. */
+	foreach_irn_in(get_irg_end_block(irg), i, ret) {
+		if (is_amd64_tail_call(ret))
+			return;
+	}
+	be_ipra_record(irg, irg_data->aligned_stack);
 }
 
 static void amd64_finish(void)
@@ -659,7 +692,9 @@ static void amd64_generate_code(FILE *output, const char *cup_name)
 	unsigned *const sp_is_non_ssa = rbitset_alloca(N_AMD64_REGISTERS);
 	rbitset_set(sp_is_non_ssa, REG_RSP);
 
-	foreach_irp_irg(i, irg) {
+	ir_graph **const irgs = be_ipra_get_irg_order();
+	for (size_t i = 0, n = ARR_LEN(irgs); i < n; ++i) {
+		ir_graph *const irg = irgs[i];
 		if (!be_step_first(irg))
 			continue;
 
@@ -682,6 +717,7 @@ static void amd64_generate_code(FILE *output, const char *cup_name)
 
 		be_step_last(irg);
 	}
+	DEL_ARR_F(irgs);
 
 	be_finish();
 	pmap_destroy(amd64_constants);
@@ -744,14 +780,26 @@ static void amd64_lower_for_target(void)
 		be_after_transform(irg, "lower-copyb");
 	}
 
-	ir_builtin_kind supported[6];
+	ir_builtin_kind supported[16];
 	size_t  s = 0;
 	supported[s++] = ir_bk_ffs;
 	supported[s++] = ir_bk_clz;
 	supported[s++] = ir_bk_ctz;
 	supported[s++] = ir_bk_compare_swap;
 	supported[s++] = ir_bk_saturating_increment;
+	supported[s++] = ir_bk_cycle_counter;
 	supported[s++] = ir_bk_va_start;
+	supported[s++] = ir_bk_sqrt;
+	supported[s++] = ir_bk_fabs;
+	supported[s++] = ir_bk_fmin;
+	supported[s++] = ir_bk_fmax;
+	supported[s++] = ir_bk_copysign;
+	if (use_sse4_1) {
+		supported[s++] = ir_bk_floor;
+		supported[s++] = ir_bk_ceil;
+		supported[s++] = ir_bk_trunc;
+		supported[s++] = ir_bk_round;
+	}
 
 	assert(s <= ARRAY_SIZE(supported));
 	lower_builtins(s, supported, amd64_lower_va_arg);
@@ -779,6 +827,7 @@ static void amd64_init(void)
 	ir_target.experimental = "the amd64 backend is experimental and unfinished (consider the ia32 backend)";
 	ir_target.fast_unaligned_memaccess = true;
 	ir_target.float_int_overflow       = ir_overflow_indefinite;
+	ir_target.cycle_counter            = true;
 }
 
 static unsigned amd64_get_op_estimated_cost(const ir_node *node)
@@ -834,6 +883,8 @@ void be_init_arch_amd64(void)
 {
 	static const lc_opt_table_entry_t options[] = {
 		LC_OPT_ENT_BOOL("no-red-zone", "gcc compatibility",                &amd64_use_red_zone),
+		LC_OPT_ENT_BOOL("optcc",       "optimize calling convention",      &amd64_optimize_cc),
+		LC_OPT_ENT_BOOL("sse4_1",      "use SSE4.1 instructions",          &use_sse4_1),
 		LC_OPT_LAST
 	};
 	lc_opt_entry_t *be_grp    = lc_opt_get_grp(firm_opt_get_root(), "be");
@@ -841,4 +892,5 @@ void be_init_arch_amd64(void)
 	lc_opt_add_table(amd64_grp, options);
 
 	amd64_init_transform();
+	x86_init_x87();
 }
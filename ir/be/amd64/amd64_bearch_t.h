@@ -16,6 +16,7 @@
 
 typedef struct amd64_irg_data_t {
 	bool omit_fp;
+	bool aligned_stack;
 } amd64_irg_data_t;
 
 extern pmap *amd64_constants; /**< A map of entities that store const tarvals */
@@ -23,8 +24,11 @@ extern pmap *amd64_constants; /**< A map of entities that store const tarvals */
 extern ir_mode *amd64_mode_xmm;
 
 extern bool amd64_use_red_zone;
+extern bool amd64_optimize_cc;
 
 #define AMD64_REGISTER_SIZE   8
+/** power of two stack alignment if no callee needs more */
+#define AMD64_PO2_REGISTER_SIZE 3
 /** power of two stack alignment on calls */
 #define AMD64_PO2_STACK_ALIGNMENT 4
 
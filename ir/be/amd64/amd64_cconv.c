@@ -32,6 +32,7 @@
  * calls itself "AMD64 ABI").
  */
 bool amd64_use_red_zone = true;
+bool amd64_optimize_cc  = true;
 
 static const unsigned ignore_regs[] = {
 	REG_RSP,
@@ -41,6 +42,11 @@ static const unsigned ignore_regs[] = {
 static const arch_register_t *const *param_regs;
 static unsigned n_param_regs;
 
+/* Functions private to the compilation unit additionally pass parameters in
+ * the remaining caller saved registers. */
+static const arch_register_t *private_param_regs[9];
+static unsigned n_private_param_regs;
+
 static const arch_register_t* const float_param_regs[] = {
 	&amd64_registers[REG_XMM0],
 	&amd64_registers[REG_XMM1],
@@ -97,6 +103,12 @@ x86_cconv_t *amd64_decide_calling_convention(ir_type *function_type,
 	rbitset_copy(caller_saves, default_caller_saves, N_AMD64_REGISTERS);
 	rbitset_copy(callee_saves, default_callee_saves, N_AMD64_REGISTERS);
 
+	/* All calls of private functions are known, so they may use more
+	 * registers for their parameters. */
+	bool const private_cc = amd64_optimize_cc
+		&& (get_method_additional_properties(function_type) & mtp_property_private)
+		&& !is_method_variadic(function_type);
+
 	/* determine how parameters are passed */
 	size_t              n_params           = get_method_n_params(function_type);
 	size_t              param_regnum       = 0;
@@ -104,9 +116,18 @@ x86_cconv_t *amd64_decide_calling_convention(ir_type *function_type,
 	reg_or_stackslot_t *params             = XMALLOCNZ(reg_or_stackslot_t,
 	                                                   n_params);
 	/* x64 always reserves space to spill the first 4 arguments to have it
-	 * easy in case of variadic functions. */
-	bool amd64_use_x64_abi = ir_platform.amd64_x64abi;
+	 * easy in case of variadic functions. Private functions are never
+	 * variadic and assign the parameter registers independently. */
+	bool amd64_use_x64_abi = ir_platform.amd64_x64abi && !private_cc;
 	unsigned stack_offset = amd64_use_x64_abi ? 32 : 0;
+	arch_register_t const *const *int_regs = param_regs;
+	size_t n_int_regs   = n_param_regs;
+	size_t n_float_regs = n_float_param_regs;
+	if (private_cc) {
+		int_regs     = private_param_regs;
+		n_int_regs   = n_private_param_regs;
+		n_float_regs = ARRAY_SIZE(float_param_regs);
+	}
 	for (size_t i = 0; i < n_params; ++i) {
 		ir_type *param_type = get_method_param_type(function_type,i);
 		reg_or_stackslot_t *param = &params[i];
@@ -116,14 +137,14 @@ x86_cconv_t *amd64_decide_calling_convention(ir_type *function_type,
 		if (is_aggregate_type(param_type)) {
 			goto use_memory;
 
-		} else if (mode_is_float(mode) && float_param_regnum < n_float_param_regs
+		} else if (mode_is_float(mode) && float_param_regnum < n_float_regs
 		    && mode != x86_mode_E) {
 			param->reg = float_param_regs[float_param_regnum++];
 			if (amd64_use_x64_abi) {
 				++param_regnum;
 			}
-		} else if (!mode_is_float(mode) && param_regnum < n_param_regs) {
-			param->reg = param_regs[param_regnum++];
+		} else if (!mode_is_float(mode) && param_regnum < n_int_regs) {
+			param->reg = int_regs[param_regnum++];
 			if (amd64_use_x64_abi) {
 				++float_param_regnum;
 			}
@@ -286,5 +307,17 @@ void amd64_cconv_init(void)
 	param_regs   = amd64_use_x64_abi ? &param_regs_list[2] : param_regs_list;
 	n_param_regs = ARRAY_SIZE(param_regs_list) - (amd64_use_x64_abi ? 2 : 0);
 
+	static const arch_register_t* const private_param_regs_extra[] = {
+		&amd64_registers[REG_R10],
+		&amd64_registers[REG_R11],
+		&amd64_registers[REG_RAX],
+	};
+	n_private_param_regs = 0;
+	for (unsigned i = 0; i < n_param_regs; ++i)
+		private_param_regs[n_private_param_regs++] = param_regs[i];
+	for (unsigned i = 0; i < ARRAY_SIZE(private_param_regs_extra); ++i)
+		private_param_regs[n_private_param_regs++] = private_param_regs_extra[i];
+	assert(n_private_param_regs <= ARRAY_SIZE(private_param_regs));
+
 	n_float_param_regs = amd64_use_x64_abi ? 4 : ARRAY_SIZE(float_param_regs);
 }
@@ -253,6 +253,15 @@ my $cvtopx2i = {
 	emit      => "{name} %AM, %D0",
 };
 
+my $unopx = {
+	state     => "exc_pinned",
+	in_reqs   => "...",
+	out_reqs  => [ "xmm", "none", "mem" ],
+	outs      => [ "res", "none", "M" ],
+	attr_type => "amd64_addr_attr_t",
+	attr      => "x86_insn_size_t size, amd64_op_mode_t op_mode, x86_addr_t addr",
+};
+
 my $movopx = {
 	state     => "exc_pinned",
 	in_reqs   => "...",
@@ -376,6 +385,18 @@ cqto => {
 	           ."x86_insn_size_t size    = X86_SIZE_64;\n",
 },
 
+rdtsc => {
+	state    => "pinned",
+	in_reqs  => [ "mem" ],
+	out_reqs => [ "rax", "rdx", "mem" ],
+	ins      => [ "mem" ],
+	outs     => [ "low", "high", "M" ],
+	fixed    => "amd64_op_mode_t op_mode = AMD64_OP_NONE;\n"
+	           ."x86_insn_size_t size    = X86_SIZE_32;\n",
+	emit     => "rdtsc",
+	latency  => 25,
+},
+
 div => { template => $divop },
 
 idiv => { template => $divop },
@@ -562,6 +583,18 @@ ret => {
 	emit     => "ret",
 },
 
+tail_call => {
+	state     => "pinned",
+	op_flags  => [ "cfopcode" ],
+	in_reqs   => "...",
+	out_reqs  => [ "exec" ],
+	ins       => [ "mem", "stack", "first_argument" ],
+	attr_type => "amd64_addr_attr_t",
+	attr      => "amd64_op_mode_t op_mode, x86_addr_t addr",
+	fixed     => "x86_insn_size_t size = X86_SIZE_64;\n",
+	emit      => "jmp %*AM",
+},
+
 bsf => { template => $unop_out },
 
 bsr => { template => $unop_out },
@@ -570,6 +603,8 @@ bsr => { template => $unop_out },
 
 adds => { template => $binopx_commutative },
 
+andp => { template => $binopx_commutative },
+
 divs => {
 	template => $binopx,
 	emit     => "divs%MX %AM",
@@ -581,6 +616,16 @@ movs_xmm => {
 	emit     => "movs%MX %AM, %D0",
 },
 
+maxs => {
+	template => $binopx,
+	emit     => "maxs%MX %AM",
+},
+
+mins => {
+	template => $binopx,
+	emit     => "mins%MX %AM",
+},
+
 muls => { template => $binopx_commutative },
 
 movs_store_xmm => {
@@ -594,6 +639,30 @@ movs_store_xmm => {
 	emit      => "movs%MX %^S0, %A",
 },
 
+orp => { template => $binopx_commutative },
+
+# SSE4.1 rounding, the immediate selects the rounding mode and suppresses the
+# precision exception
+rounds_floor => {
+	template => $unopx,
+	emit     => "rounds%MX \$0x9, %AM, %^D0",
+},
+
+rounds_ceil => {
+	template => $unopx,
+	emit     => "rounds%MX \$0xA, %AM, %^D0",
+},
+
+rounds_trunc => {
+	template => $unopx,
+	emit     => "rounds%MX \$0xB, %AM, %^D0",
+},
+
+sqrts => {
+	template => $unopx,
+	emit     => "sqrts%MX %AM, %^D0",
+},
+
 subs => {
 	template => $binopx,
 	emit     => "subs%MX %AM",
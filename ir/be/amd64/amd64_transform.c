@@ -38,6 +38,7 @@
 DEBUG_ONLY(static firm_dbg_module_t *dbg = NULL;)
 
 static x86_cconv_t    *current_cconv = NULL;
+static bool            sibling_calls;
 static be_stack_env_t  stack_env;
 
 #define GP &amd64_reg_classes[CLASS_amd64_gp]
@@ -1676,8 +1677,100 @@ static ir_node *gen_Proj_Start(ir_node *const node)
 	panic("unexpected Start Proj: %u", pn);
 }
 
+/**
+ * Turns @p call, whose results are returned by @p ret, into a jump to the
+ * callee after the epilogue. Returns NULL if the calling conventions do not
+ * allow it.
+ */
+static ir_node *gen_sibling_call(ir_node *const ret, ir_node *const call)
+{
+	ir_type     *const type  = get_Call_type(call);
+	x86_cconv_t *const cconv = amd64_decide_calling_convention(type, NULL);
+	if (!x86_can_sibling_call(current_cconv, cconv, N_AMD64_REGISTERS, false))
+		goto fail;
+	/* x87 results would have to stay on the x87 stack */
+	for (size_t r = 0; r < cconv->n_reg_results; ++r) {
+		if (cconv->results[r].reg->cls == &amd64_reg_classes[CLASS_amd64_x87])
+			goto fail;
+	}
+
+	x86_addr_t      addr;
+	amd64_op_mode_t op_mode;
+	ir_node  *const callee = get_Call_ptr(call);
+	arch_register_t const *scratch = NULL;
+	memset(&addr, 0, sizeof(addr));
+	if (match_immediate_32(&addr.immediate, callee, true)) {
+		op_mode = AMD64_OP_IMM32;
+	} else {
+		scratch = x86_get_sibling_call_scratch(current_cconv, cconv,
+		                                       &amd64_reg_classes[CLASS_amd64_gp]);
+		if (scratch == NULL)
+			goto fail;
+		op_mode = AMD64_OP_REG;
+	}
+
+	ir_graph *const irg            = get_irn_irg(ret);
+	size_t    const n_params       = get_Call_n_params(call);
+	size_t    const n_callee_saves = rbitset_popcount(current_cconv->callee_saves, N_AMD64_REGISTERS);
+	size_t    const n_ins          = n_amd64_tail_call_first_argument
+		+ (scratch != NULL) + n_params + n_callee_saves;
+
+	arch_register_req_t const **const reqs = be_allocate_in_reqs(irg, n_ins);
+	ir_node **const in = ALLOCAN(ir_node*, n_ins);
+	size_t          p  = n_amd64_tail_call_first_argument;
+
+	in[n_amd64_tail_call_mem]     = be_transform_node(get_Call_mem(call));
+	reqs[n_amd64_tail_call_mem]   = arch_memory_req;
+	in[n_amd64_tail_call_stack]   = get_initial_sp(irg);
+	reqs[n_amd64_tail_call_stack] = &amd64_single_reg_req_gp_rsp;
+
+	if (scratch != NULL) {
+		addr = (x86_addr_t) {
+			.base_input = p,
+			.variant    = X86_ADDR_REG,
+		};
+		in[p]   = be_transform_node(callee);
+		reqs[p] = scratch->single_req;
+		++p;
+	}
+	for (size_t i = 0; i < n_params; ++i) {
+		in[p]   = be_transform_node(get_Call_param(call, i));
+		reqs[p] = cconv->parameters[i].reg->single_req;
+		++p;
+	}
+	/* callee saves */
+	for (size_t i = 0; i < N_AMD64_REGISTERS; ++i) {
+		if (!rbitset_is_set(current_cconv->callee_saves, i))
+			continue;
+		arch_register_t const *const reg = &amd64_registers[i];
+		in[p]   = be_get_Start_proj(irg, reg);
+		reqs[p] = reg->single_req;
+		++p;
+	}
+	assert(p == n_ins);
+	x86_free_calling_convention(cconv);
+
+	dbg_info *const dbgi      = get_irn_dbg_info(call);
+	ir_node  *const new_block = be_transform_nodes_block(ret);
+	ir_node  *const tail_call
+		= new_bd_amd64_tail_call(dbgi, new_block, n_ins, in, reqs, op_mode, addr);
+	be_stack_record_chain(&stack_env, tail_call, n_amd64_tail_call_stack, NULL);
+	return tail_call;
+
+fail:
+	x86_free_calling_convention(cconv);
+	return NULL;
+}
+
 static ir_node *gen_Return(ir_node *const node)
 {
+	ir_node *const call = sibling_calls ? x86_find_sibling_call(node) : NULL;
+	if (call != NULL) {
+		ir_node *const tail_call = gen_sibling_call(node, call);
+		if (tail_call != NULL)
+			return tail_call;
+	}
+
 	ir_graph          *const irg       = get_irn_irg(node);
 	ir_node           *const new_block = be_transform_nodes_block(node);
 	dbg_info          *const dbgi      = get_irn_dbg_info(node);
@@ -1795,6 +1888,8 @@ static ir_node *gen_Call(ir_node *const node)
 	unsigned           const max_inputs   = 5 + n_param_regs;
 
 	assert(n_params == cconv->n_parameters);
+	x86_remove_unclobbered_caller_saves(cconv, node, &amd64_reg_classes[CLASS_amd64_gp]);
+	x86_remove_unclobbered_caller_saves(cconv, node, &amd64_reg_classes[CLASS_amd64_xmm]);
 
 	record_returns_twice(irg, type);
 
@@ -3122,6 +3217,14 @@ static ir_node *gen_saturating_increment(ir_node *const node)
 	return sbb;
 }
 
+static ir_node *gen_cycle_counter(ir_node *const node)
+{
+	dbg_info *const dbgi  = get_irn_dbg_info(node);
+	ir_node  *const block = be_transform_nodes_block(node);
+	ir_node  *const mem   = be_transform_node(get_Builtin_mem(node));
+	return new_bd_amd64_rdtsc(dbgi, block, mem);
+}
+
 static ir_node *gen_va_start(ir_node *const node)
 {
 	ir_graph *const irg   = get_irn_irg(node);
@@ -3134,6 +3237,144 @@ static ir_node *gen_va_start(ir_node *const node)
 	return amd64_initialize_va_list(dbgi, block, current_cconv, mem, ap, fp);
 }
 
+typedef ir_node *(*construct_unopx_func)(dbg_info *dbgi, ir_node *block, int arity, ir_node *const *in, arch_register_req_t const **in_reqs, x86_insn_size_t size, amd64_op_mode_t op_mode, x86_addr_t addr);
+
+static ir_node *create_sse_unop(dbg_info *const dbgi, ir_node *const block,
+                                ir_node *const op, x86_insn_size_t const size,
+                                construct_unopx_func const func,
+                                unsigned const pn_res)
+{
+	x86_addr_t const addr = {
+		.base_input = 0,
+		.variant    = X86_ADDR_REG,
+	};
+	ir_node *const in[]     = { op };
+	ir_node *const new_node = func(dbgi, block, ARRAY_SIZE(in), in,
+	                               amd64_xmm_reqs, size, AMD64_OP_REG, addr);
+	return be_new_Proj(new_node, pn_res);
+}
+
+static ir_node *create_sse_binop(dbg_info *const dbgi, ir_node *const block,
+                                 ir_node *const op0, ir_node *const op1,
+                                 x86_insn_size_t const size,
+                                 construct_binop_func const func,
+                                 unsigned const pn_res)
+{
+	amd64_binop_addr_attr_t attr = {
+		.base = {
+			.base = {
+				.op_mode = AMD64_OP_REG_REG,
+				.size    = size,
+			},
+			.addr = {
+				.base_input = 0,
+				.variant    = X86_ADDR_REG,
+			},
+		},
+		.u.reg_input = 1,
+	};
+	ir_node *const in[]     = { op0, op1 };
+	ir_node *const new_node = func(dbgi, block, ARRAY_SIZE(in), in,
+	                               amd64_xmm_xmm_reqs, &attr);
+	/* Without swapping the inputs, the finishing phase needs the output to
+	 * differ from input 1 to fix the same-as constraint with a copy. */
+	bool const commutative = arch_get_irn_flags(new_node)
+	                       & amd64_arch_irn_flag_commutative_binop;
+	arch_set_irn_register_req_out(new_node, 0, commutative
+		? &amd64_requirement_xmm_same_0
+		: &amd64_requirement_xmm_same_0_not_1);
+	return be_new_Proj(new_node, pn_res);
+}
+
+/** Loads a mask with all bits except the sign bit of @p mode set. */
+static ir_node *create_abs_mask(dbg_info *const dbgi, ir_node *const block,
+                                ir_mode *const mode)
+{
+	ir_mode   *const int_mode = mode == mode_F ? mode_Iu : mode_Lu;
+	ir_tarval *const sign_tv  = tarval_bitcast(create_sign_tv(mode), int_mode);
+	ir_tarval *const mask_tv  = tarval_bitcast(tarval_not(sign_tv), mode);
+	return create_float_const(dbgi, block, mask_tv);
+}
+
+/**
+ * Transforms a floating point Builtin. Clearing and copying the sign is done
+ * with masks and round() adds the largest value below 0.5 with the sign of the
+ * operand before truncating.
+ */
+static ir_node *gen_float_builtin(ir_node *const node)
+{
+	dbg_info       *const dbgi  = get_irn_dbg_info(node);
+	ir_node        *const block = be_transform_nodes_block(node);
+	ir_node        *const param = get_Builtin_param(node, 0);
+	ir_node        *const op    = be_transform_node(param);
+	ir_mode        *const mode  = get_irn_mode(param);
+	x86_insn_size_t const size  = x86_size_from_mode(mode);
+	assert(mode == mode_F || mode == mode_D);
+
+	ir_builtin_kind const kind = get_Builtin_kind(node);
+	switch (kind) {
+	case ir_bk_sqrt:
+		return create_sse_unop(dbgi, block, op, size, new_bd_amd64_sqrts,
+		                       pn_amd64_sqrts_res);
+	case ir_bk_floor:
+		return create_sse_unop(dbgi, block, op, size, new_bd_amd64_rounds_floor,
+		                       pn_amd64_rounds_floor_res);
+	case ir_bk_ceil:
+		return create_sse_unop(dbgi, block, op, size, new_bd_amd64_rounds_ceil,
+		                       pn_amd64_rounds_ceil_res);
+	case ir_bk_trunc:
+		return create_sse_unop(dbgi, block, op, size, new_bd_amd64_rounds_trunc,
+		                       pn_amd64_rounds_trunc_res);
+	case ir_bk_fabs: {
+		ir_node *const mask = create_abs_mask(dbgi, block, mode);
+		return create_sse_binop(dbgi, block, op, mask,
+		                        size, new_bd_amd64_andp, pn_amd64_andp_res);
+	}
+	case ir_bk_round: {
+		double     const below_half = mode == mode_F ? 0.5 - 0x1p-25 : 0.5 - 0x1p-54;
+		ir_tarval *const half_tv    = new_tarval_from_double(below_half, mode);
+		ir_node   *const half       = create_float_const(dbgi, block, half_tv);
+		ir_node   *const sign       = create_float_const(dbgi, block, create_sign_tv(mode));
+		ir_node   *const op_sign    = create_sse_binop(dbgi, block, op, sign,
+		                                               size, new_bd_amd64_andp, pn_amd64_andp_res);
+		ir_node   *const bias       = create_sse_binop(dbgi, block, op_sign, half,
+		                                               size, new_bd_amd64_orp, pn_amd64_orp_res);
+		ir_node   *const sum        = create_sse_binop(dbgi, block, op, bias,
+		                                               size, new_bd_amd64_adds, pn_amd64_adds_res);
+		return create_sse_unop(dbgi, block, sum, size, new_bd_amd64_rounds_trunc,
+		                       pn_amd64_rounds_trunc_res);
+	}
+	case ir_bk_fmin:
+	case ir_bk_fmax:
+	case ir_bk_copysign:
+		break;
+	default:
+		panic("unexpected Builtin %+F", node);
+	}
+
+	ir_node *const op1 = be_transform_node(get_Builtin_param(node, 1));
+	switch (kind) {
+	case ir_bk_fmin:
+		return create_sse_binop(dbgi, block, op, op1,
+		                        size, new_bd_amd64_mins, pn_amd64_mins_res);
+	case ir_bk_fmax:
+		return create_sse_binop(dbgi, block, op, op1,
+		                        size, new_bd_amd64_maxs, pn_amd64_maxs_res);
+	case ir_bk_copysign: {
+		ir_node *const mask      = create_abs_mask(dbgi, block, mode);
+		ir_node *const sign      = create_float_const(dbgi, block, create_sign_tv(mode));
+		ir_node *const magnitude = create_sse_binop(dbgi, block, op, mask,
+		                                            size, new_bd_amd64_andp, pn_amd64_andp_res);
+		ir_node *const op1_sign  = create_sse_binop(dbgi, block, op1, sign,
+		                                            size, new_bd_amd64_andp, pn_amd64_andp_res);
+		return create_sse_binop(dbgi, block, magnitude, op1_sign,
+		                        size, new_bd_amd64_orp, pn_amd64_orp_res);
+	}
+	default:
+		panic("unexpected Builtin %+F", node);
+	}
+}
+
 static ir_node *gen_Builtin(ir_node *const node)
 {
 	ir_builtin_kind const kind = get_Builtin_kind(node);
@@ -3148,8 +3389,20 @@ static ir_node *gen_Builtin(ir_node *const node)
 		return gen_compare_swap(node);
 	case ir_bk_saturating_increment:
 		return gen_saturating_increment(node);
+	case ir_bk_cycle_counter:
+		return gen_cycle_counter(node);
 	case ir_bk_va_start:
 		return gen_va_start(node);
+	case ir_bk_sqrt:
+	case ir_bk_fabs:
+	case ir_bk_floor:
+	case ir_bk_ceil:
+	case ir_bk_trunc:
+	case ir_bk_round:
+	case ir_bk_fmin:
+	case ir_bk_fmax:
+	case ir_bk_copysign:
+		return gen_float_builtin(node);
 	default:
 		break;
 	}
@@ -3178,9 +3431,31 @@ static ir_node *gen_Proj_Builtin(ir_node *const proj)
 		}
 	case ir_bk_saturating_increment:
 		return be_new_Proj(new_node, pn_amd64_sbb_res);
+	case ir_bk_cycle_counter:
+		if (get_Proj_num(proj) == pn_Builtin_M) {
+			return be_new_Proj(new_node, pn_amd64_rdtsc_M);
+		} else {
+			assert(get_Proj_num(proj) == pn_Builtin_max+1);
+			return be_new_Proj(new_node, pn_amd64_rdtsc_low);
+		}
 	case ir_bk_va_start:
 		assert(get_Proj_num(proj) == pn_Builtin_M);
 		return new_node;
+	case ir_bk_sqrt:
+	case ir_bk_fabs:
+	case ir_bk_floor:
+	case ir_bk_ceil:
+	case ir_bk_trunc:
+	case ir_bk_round:
+	case ir_bk_fmin:
+	case ir_bk_fmax:
+	case ir_bk_copysign:
+		if (get_Proj_num(proj) == pn_Builtin_M) {
+			return be_transform_node(get_Builtin_mem(node));
+		} else {
+			assert(get_Proj_num(proj) == pn_Builtin_max+1);
+			return new_node;
+		}
 	default:
 		break;
 	}
@@ -3317,6 +3592,7 @@ void amd64_transform_graph(ir_graph *irg)
 	amd64_set_va_stack_args_param(current_cconv->va_start_addr);
 	be_add_parameter_entity_stores(irg);
 	x86_create_parameter_loads(irg, current_cconv);
+	sibling_calls = x86_sibling_calls_possible(irg);
 
 	heights = heights_new(irg);
 	x86_calculate_non_address_mode_nodes(irg);
@@ -84,21 +84,22 @@ static void sim_amd64_fucomi(x87_state *const state, ir_node *const node)
 static void prepare_callbacks(void)
 {
 	x86_prepare_x87_callbacks();
-	x86_register_x87_sim(op_amd64_call,   sim_amd64_call);
-	x86_register_x87_sim(op_amd64_fadd,   sim_amd64_fadd);
-	x86_register_x87_sim(op_amd64_fchs,   x86_sim_x87_unop);
-	x86_register_x87_sim(op_amd64_fdiv,   sim_amd64_fdiv);
-	x86_register_x87_sim(op_amd64_fild,   sim_amd64_fild);
-	x86_register_x87_sim(op_amd64_fisttp, sim_amd64_fisttp);
-	x86_register_x87_sim(op_amd64_fld,    sim_amd64_fld);
-	x86_register_x87_sim(op_amd64_fld1,   x86_x87_push);
-	x86_register_x87_sim(op_amd64_fldz,   x86_x87_push);
-	x86_register_x87_sim(op_amd64_fmul,   sim_amd64_fmul);
-	x86_register_x87_sim(op_amd64_fst,    sim_amd64_fst);
-	x86_register_x87_sim(op_amd64_fstp,   sim_amd64_fstp);
-	x86_register_x87_sim(op_amd64_fsub,   sim_amd64_fsub);
-	x86_register_x87_sim(op_amd64_fucomi, sim_amd64_fucomi);
-	x86_register_x87_sim(op_amd64_ret,    x86_sim_x87_ret);
+	x86_register_x87_sim(op_amd64_call,      sim_amd64_call);
+	x86_register_x87_sim(op_amd64_fadd,      sim_amd64_fadd);
+	x86_register_x87_sim(op_amd64_fchs,      x86_sim_x87_unop);
+	x86_register_x87_sim(op_amd64_fdiv,      sim_amd64_fdiv);
+	x86_register_x87_sim(op_amd64_fild,      sim_amd64_fild);
+	x86_register_x87_sim(op_amd64_fisttp,    sim_amd64_fisttp);
+	x86_register_x87_sim(op_amd64_fld,       sim_amd64_fld);
+	x86_register_x87_sim(op_amd64_fld1,      x86_x87_push);
+	x86_register_x87_sim(op_amd64_fldz,      x86_x87_push);
+	x86_register_x87_sim(op_amd64_fmul,      sim_amd64_fmul);
+	x86_register_x87_sim(op_amd64_fst,       sim_amd64_fst);
+	x86_register_x87_sim(op_amd64_fstp,      sim_amd64_fstp);
+	x86_register_x87_sim(op_amd64_fsub,      sim_amd64_fsub);
+	x86_register_x87_sim(op_amd64_fucomi,    sim_amd64_fucomi);
+	x86_register_x87_sim(op_amd64_ret,       x86_sim_x87_ret);
+	x86_register_x87_sim(op_amd64_tail_call, x86_sim_x87_ret);
 }
 
 void amd64_simulate_graph_x87(ir_graph *irg)
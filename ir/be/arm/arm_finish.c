@@ -55,6 +55,17 @@ static void arm_set_frame_entity(ir_node *node, ir_entity *entity,
 	attr->entity = entity;
 }
 
+static ir_entity *arm_get_frame_entity(const ir_node *node)
+{
+	if (is_arm_FrameAddr(node))
+		return get_arm_Address_attr_const(node)->entity;
+	if (!is_arm_irn(node) || !get_arm_attr_const(node)->is_load_store)
+		return NULL;
+	arm_load_store_attr_t const *const attr
+		= get_arm_load_store_attr_const(node);
+	return attr->is_frame_entity ? attr->entity : NULL;
+}
+
 static void introduce_epilog(ir_node *ret)
 {
 	assert(arch_get_irn_register_req_in(ret, n_arm_Return_sp) == &arm_single_reg_req_gp_sp);
@@ -133,7 +144,7 @@ void arm_finish_graph(ir_graph *irg)
 	be_free_frame_entity_coalescer(fec_env);
 
 	ir_type *const frame = get_irg_frame_type(irg);
-	be_sort_frame_entities(frame, omit_fp);
+	be_sort_frame_entities(irg, omit_fp, arm_get_frame_entity);
 	unsigned const misalign = 0;
 	be_layout_frame_type(frame, 0, misalign);
 
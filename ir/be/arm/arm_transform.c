@@ -1403,9 +1403,19 @@ static ir_node *gen_Builtin(ir_node *node)
 	case ir_bk_inport:
 	case ir_bk_saturating_increment:
 	case ir_bk_compare_swap:
+	case ir_bk_cycle_counter:
 	case ir_bk_may_alias:
 	case ir_bk_va_start:
 	case ir_bk_va_arg:
+	case ir_bk_sqrt:
+	case ir_bk_fabs:
+	case ir_bk_floor:
+	case ir_bk_ceil:
+	case ir_bk_trunc:
+	case ir_bk_round:
+	case ir_bk_fmin:
+	case ir_bk_fmax:
+	case ir_bk_copysign:
 		break;
 	}
 	panic("Builtin %s not implemented", get_builtin_kind_name(kind));
@@ -1440,9 +1450,19 @@ static ir_node *gen_Proj_Builtin(ir_node *proj)
 	case ir_bk_inport:
 	case ir_bk_saturating_increment:
 	case ir_bk_compare_swap:
+	case ir_bk_cycle_counter:
 	case ir_bk_may_alias:
 	case ir_bk_va_start:
 	case ir_bk_va_arg:
+	case ir_bk_sqrt:
+	case ir_bk_fabs:
+	case ir_bk_floor:
+	case ir_bk_ceil:
+	case ir_bk_trunc:
+	case ir_bk_round:
+	case ir_bk_fmin:
+	case ir_bk_fmax:
+	case ir_bk_copysign:
 		break;
 	}
 	panic("Builtin %s not implemented", get_builtin_kind_name(kind));
@@ -34,13 +34,17 @@ typedef enum be_dump_flags_t {
 /** Backend options */
 struct be_options_t {
 	unsigned dump_flags;       /**< backend dumping flags */
+	int dump_format;           /**< file format of the dumps */
 	bool timing;               /**< time the backend phases */
 	bool opt_profile_generate; /**< instrument code for profiling */
 	bool opt_profile_use;      /**< use existing profile data */
+	char profile_samples[256]; /**< sampled profile to use */
+	unsigned instrument;       /**< hot path instrumentation flags */
 	bool omit_fp;              /**< try to omit the frame pointer */
 	bool do_verify;            /**< backend verify option */
 	char ilp_solver[128];      /**< the ilp solver name */
 	bool verbose_asm;          /**< dump verbose assembler */
+	bool ipra;                 /**< interprocedural register allocation */
 };
 extern be_options_t be_options;
 
@@ -95,6 +99,7 @@ typedef enum {
 	T_RA_SPILL,
 	T_RA_SPILL_APPLY,
 	T_RA_COLOR,
+	T_RA_COALESCE,
 	T_RA_IFG,
 	T_RA_COPYMIN,
 	T_RA_SSA,
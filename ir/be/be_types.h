@@ -62,9 +62,13 @@ typedef struct be_options_t    be_options_t;
 typedef struct regalloc_if_t   regalloc_if_t;
 
 typedef struct be_register_name_t be_register_name_t;
+typedef struct be_jit_stub_interface_t be_jit_stub_interface_t;
 
 /** Additional register pressure applied to before (positive value) or after
  * (negative value) a instruction. */
 typedef int8_t be_add_pressure_t;
 
+/** Returns the frame entity accessed by a node or NULL. */
+typedef ir_entity *(*get_frame_entity_func)(const ir_node *node);
+
 #endif
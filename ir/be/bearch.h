@@ -295,6 +295,12 @@ struct arch_isa_if_t {
 
 	void (*emit_function)(char *buffer, ir_jit_function_t *function);
 
+	/**
+	 * Stubs for lazily compiled functions, NULL if the target does not
+	 * support lazy compilation.
+	 */
+	be_jit_stub_interface_t const *jit_stubs;
+
 	/**
 	 * lowers current program for target. See the documentation for
 	 * be_lower_for_target() for details.
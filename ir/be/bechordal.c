@@ -11,6 +11,7 @@
  */
 #include "bechordal_t.h"
 
+#include "be_t.h"
 #include "bechordal_common.h"
 #include "beinsn_t.h"
 #include "beirg.h"
@@ -364,10 +365,18 @@ static void assign(ir_node *const block, void *const env_ptr)
 				assert(bitset_is_set(available, col) && "pre-colored register must be free");
 			} else {
 				assert(!arch_irn_is_ignore(irn));
-				col = get_next_free_reg(available);
+				int const pref = env->congruence != NULL
+					? be_congruence_get_color(env->congruence, irn) : -1;
+				if (pref >= 0 && bitset_is_set(available, pref)) {
+					col = pref;
+				} else {
+					col = get_next_free_reg(available);
+				}
 				arch_set_irn_register_idx(irn, col);
 			}
 			bitset_clear(available, col);
+			if (env->congruence != NULL)
+				be_congruence_set_color(env->congruence, irn, col);
 
 			DBG((dbg, LEVEL_1, "\tassigning register %s(%d) to %+F\n", arch_get_irn_register(irn)->name, col, irn));
 		}
@@ -387,11 +396,22 @@ static void be_ra_chordal_color(be_chordal_env_t *const chordal_env)
 
 	be_chordal_dump(BE_CH_DUMP_CONSTR, irg, chordal_env->cls, "constr");
 
+	/* Merge copy related values, the coloring prefers equal registers for
+	 * them. */
+	be_timer_push(T_RA_COALESCE);
+	chordal_env->congruence = be_coalesce_values(irg, chordal_env->cls);
+	be_timer_pop(T_RA_COALESCE);
+
 	/* First, determine the pressure */
 	dom_tree_walk_irg(irg, create_borders, NULL, chordal_env);
 
 	/* Assign the colors */
 	dom_tree_walk_irg(irg, assign, NULL, chordal_env);
+
+	if (chordal_env->congruence != NULL) {
+		be_free_congruence(chordal_env->congruence);
+		chordal_env->congruence = NULL;
+	}
 }
 
 BE_REGISTER_MODULE_CONSTRUCTOR(be_init_chordal)
@@ -254,6 +254,7 @@ static void be_ra_chordal_main(ir_graph *irg, const regalloc_if_t *regif)
 	chordal_env.border_heads     = NULL;
 	chordal_env.ifg              = NULL;
 	chordal_env.allocatable_regs = NULL;
+	chordal_env.congruence       = NULL;
 
 	if (stat_ev_enabled)
 		be_collect_node_stats(&last_node_stats, irg);
@@ -19,6 +19,7 @@
 #include "obst.h"
 
 #include "bechordal.h"
+#include "becoalesce.h"
 #include "beifg.h"
 
 /**
@@ -44,6 +45,7 @@ struct be_chordal_env_t {
 	pmap                 *border_heads; /**< Maps blocks to border heads. */
 	be_ifg_t             *ifg;          /**< The interference graph. */
 	bitset_t             *allocatable_regs; /**< set of allocatable registers */
+	be_congruence_t      *congruence;   /**< coalesced values, may be NULL */
 };
 
 static inline struct list_head *get_block_border_head(be_chordal_env_t const *const inf, ir_node *const bl)
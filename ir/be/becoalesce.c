@@ -0,0 +1,358 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief       SSA based coalescing of copy related values before coloring.
+ *
+ * Affinities between Phis and their arguments, Perm results and their sources,
+ * Copies and their operands and should_be_same constrained operands are
+ * processed by decreasing execution frequency. The congruence classes of the
+ * two values are merged if no pair of members interferes. Following Budimlić
+ * et al. and Boissinot et al., the members of a class are kept in dominance
+ * order, so the interference test of two classes is a single merge of both
+ * member lists: A value can only interfere with the values dominating it,
+ * which are exactly the values on the stack of the dominance forest walk.
+ * Members which are copies of the same value do not interfere.
+ *
+ * The coloring prefers the register of the first colored member of a class,
+ * so coalesced values mostly end up in the same register and the copies and
+ * Phi permutations between them vanish before copy minimization runs.
+ */
+#include "becoalesce.h"
+
+#include "array.h"
+#include "bearch.h"
+#include "becopyopt_t.h"
+#include "beirg.h"
+#include "belive.h"
+#include "bemodule.h"
+#include "benode.h"
+#include "besched.h"
+#include "debug.h"
+#include "execfreq.h"
+#include "irdom_t.h"
+#include "irgwalk.h"
+#include "irnode_t.h"
+#include "irtools.h"
+#include "lc_opts.h"
+#include "statev_t.h"
+#include "util.h"
+#include "xmalloc.h"
+
+DEBUG_ONLY(static firm_dbg_module_t *dbg = NULL;)
+
+static bool do_coalesce = true;
+
+typedef struct coalesce_node_t coalesce_node_t;
+struct coalesce_node_t {
+	ir_node          *irn;
+	ir_node const    *value;   /**< the value @c irn is a copy of */
+	coalesce_node_t  *parent;  /**< union-find parent, itself for roots */
+	coalesce_node_t **members; /**< members in dominance order (roots only) */
+	int               color;   /**< preferred register index (roots only) */
+};
+
+typedef struct affinity_t {
+	ir_node *a;
+	ir_node *b;
+	double   costs;
+} affinity_t;
+
+struct be_congruence_t {
+	struct obstack                obst;
+	arch_register_class_t const  *cls;
+	unsigned                      n_nodes;
+	coalesce_node_t             **nodes;      /**< indexed by node index */
+	affinity_t                   *affinities;
+};
+
+static bool is_coalescable(be_congruence_t const *const c,
+                           ir_node const *const irn)
+{
+	if (get_irn_mode(irn) == mode_T)
+		return false;
+	arch_register_req_t const *const req = arch_get_irn_register_req(irn);
+	return req->cls == c->cls && !req->ignore && sched_is_scheduled(irn);
+}
+
+/** Returns the value @p irn is a copy of. */
+static ir_node const *get_copied_value(ir_node const *irn)
+{
+	for (;;) {
+		if (be_is_Copy(irn)) {
+			irn = be_get_Copy_op(irn);
+		} else if (is_Perm_Proj(irn)) {
+			irn = get_Perm_src(irn);
+		} else {
+			return irn;
+		}
+	}
+}
+
+static coalesce_node_t *get_node(be_congruence_t *const c, ir_node *const irn)
+{
+	unsigned const idx = get_irn_idx(irn);
+	assert(idx < c->n_nodes);
+	coalesce_node_t *node = c->nodes[idx];
+	if (node == NULL) {
+		node          = OALLOCZ(&c->obst, coalesce_node_t);
+		node->irn     = irn;
+		node->value   = get_copied_value(irn);
+		node->parent  = node;
+		node->members = NEW_ARR_F(coalesce_node_t*, 1);
+		node->members[0] = node;
+		node->color   = -1;
+		c->nodes[idx] = node;
+	}
+	return node;
+}
+
+static coalesce_node_t *find_root(coalesce_node_t *node)
+{
+	coalesce_node_t *root = node;
+	while (root->parent != root)
+		root = root->parent;
+	/* path compression */
+	while (node->parent != root) {
+		coalesce_node_t *const next = node->parent;
+		node->parent = root;
+		node         = next;
+	}
+	return root;
+}
+
+static void add_affinity(be_congruence_t *const c, ir_node *const a,
+                         ir_node *const b, double const costs)
+{
+	if (a == b || !is_coalescable(c, b))
+		return;
+	affinity_t const aff = { .a = a, .b = b, .costs = costs };
+	ARR_APP1(affinity_t, c->affinities, aff);
+}
+
+static void collect_affinities(ir_node *const irn, void *const env)
+{
+	be_congruence_t *const c = (be_congruence_t*)env;
+	if (!is_coalescable(c, irn))
+		return;
+
+	if (is_Phi(irn)) {
+		ir_node *const block = get_nodes_block(irn);
+		foreach_irn_in(irn, pos, arg) {
+			ir_node *const pred = get_Block_cfgpred_block(block, pos);
+			add_affinity(c, irn, arg, get_block_execfreq(pred));
+		}
+		return;
+	}
+
+	double const costs = get_block_execfreq(get_nodes_block(irn));
+	if (be_is_Copy(irn)) {
+		add_affinity(c, irn, be_get_Copy_op(irn), costs);
+	} else if (is_Perm_Proj(irn)) {
+		add_affinity(c, irn, get_Perm_src(irn), costs);
+	} else {
+		unsigned const other = arch_get_irn_register_req(irn)->should_be_same;
+		for (unsigned i = 0; 1U << i <= other; ++i) {
+			if (other & (1U << i))
+				add_affinity(c, irn, get_irn_n(skip_Proj(irn), i), costs);
+		}
+	}
+}
+
+static int cmp_affinity(void const *const a, void const *const b)
+{
+	affinity_t const *const aa = (affinity_t const*)a;
+	affinity_t const *const ab = (affinity_t const*)b;
+	if (aa->costs != ab->costs)
+		return aa->costs < ab->costs ? 1 : -1;
+	return (int)get_irn_idx(aa->a) - (int)get_irn_idx(ab->a);
+}
+
+/** Orders values by the dominance of their definitions. */
+static int cmp_dominance_order(ir_node const *const a, ir_node const *const b)
+{
+	unsigned const pre_a = get_Block_dom_tree_pre_num(get_nodes_block(a));
+	unsigned const pre_b = get_Block_dom_tree_pre_num(get_nodes_block(b));
+	if (pre_a != pre_b)
+		return pre_a < pre_b ? -1 : 1;
+	sched_timestep_t const step_a = sched_get_time_step(a);
+	sched_timestep_t const step_b = sched_get_time_step(b);
+	if (step_a != step_b)
+		return step_a < step_b ? -1 : 1;
+	return (int)get_irn_idx(a) - (int)get_irn_idx(b);
+}
+
+static bool def_dominates(ir_node const *const a, ir_node const *const b)
+{
+	return skip_Proj_const(a) == skip_Proj_const(b)
+	    || value_strictly_dominates(a, b);
+}
+
+/** Checks whether @p dom, which dominates @p node, interferes with it. */
+static bool nodes_interfere(coalesce_node_t const *const dom,
+                            coalesce_node_t const *const node)
+{
+	/* results of the same node are live at the same time */
+	if (skip_Proj_const(dom->irn) == skip_Proj_const(node->irn))
+		return true;
+	if (dom->value == node->value)
+		return false;
+	return be_values_interfere(dom->irn, node->irn);
+}
+
+/**
+ * Merges the member lists of the classes @p a and @p b into @p merged.
+ * Returns false and leaves @p merged incomplete if the classes interfere.
+ */
+static bool merge_classes(coalesce_node_t *const a, coalesce_node_t *const b,
+                          coalesce_node_t **const merged,
+                          coalesce_node_t **const stack)
+{
+	size_t const n_a     = ARR_LEN(a->members);
+	size_t const n_b     = ARR_LEN(b->members);
+	size_t       i_a     = 0;
+	size_t       i_b     = 0;
+	size_t       n_stack = 0;
+	for (size_t n = 0; i_a < n_a || i_b < n_b; ++n) {
+		coalesce_node_t *node;
+		if (i_b == n_b || (i_a < n_a
+		    && cmp_dominance_order(a->members[i_a]->irn, b->members[i_b]->irn) < 0)) {
+			node = a->members[i_a++];
+		} else {
+			node = b->members[i_b++];
+		}
+
+		/* Walk the dominance forest: Everything left on the stack dominates
+		 * node. */
+		while (n_stack > 0 && !def_dominates(stack[n_stack - 1]->irn, node->irn))
+			--n_stack;
+		coalesce_node_t *const root = find_root(node);
+		for (size_t s = n_stack; s-- > 0;) {
+			coalesce_node_t *const dom = stack[s];
+			if (find_root(dom) != root && nodes_interfere(dom, node))
+				return false;
+		}
+		stack[n_stack++] = node;
+		merged[n]        = node;
+	}
+	return true;
+}
+
+static bool coalesce(be_congruence_t *const c, affinity_t const *const aff)
+{
+	coalesce_node_t *const a = find_root(get_node(c, aff->a));
+	coalesce_node_t *const b = find_root(get_node(c, aff->b));
+	if (a == b)
+		return false;
+
+	size_t            const n      = ARR_LEN(a->members) + ARR_LEN(b->members);
+	coalesce_node_t **const merged = NEW_ARR_F(coalesce_node_t*, n);
+	coalesce_node_t **const stack  = XMALLOCN(coalesce_node_t*, n);
+	bool              const ok     = merge_classes(a, b, merged, stack);
+	free(stack);
+	if (!ok) {
+		DEL_ARR_F(merged);
+		DB((dbg, LEVEL_2, "%+F and %+F interfere\n", aff->a, aff->b));
+		return false;
+	}
+
+	DB((dbg, LEVEL_2, "coalesce %+F and %+F\n", aff->a, aff->b));
+	DEL_ARR_F(a->members);
+	DEL_ARR_F(b->members);
+	b->members = NULL;
+	b->parent  = a;
+	a->members = merged;
+	return true;
+}
+
+be_congruence_t *be_coalesce_values(ir_graph *const irg,
+                                    arch_register_class_t const *const cls)
+{
+	if (!do_coalesce)
+		return NULL;
+
+	assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE);
+	be_assure_live_chk(irg);
+
+	be_congruence_t *const c = XMALLOCZ(be_congruence_t);
+	obstack_init(&c->obst);
+	c->cls        = cls;
+	c->n_nodes    = get_irg_last_idx(irg);
+	c->nodes      = XMALLOCNZ(coalesce_node_t*, c->n_nodes);
+	c->affinities = NEW_ARR_F(affinity_t, 0);
+
+	irg_walk_graph(irg, NULL, collect_affinities, c);
+	QSORT_ARR(c->affinities, cmp_affinity);
+
+	unsigned n_coalesced = 0;
+	for (size_t i = 0, n = ARR_LEN(c->affinities); i < n; ++i) {
+		if (coalesce(c, &c->affinities[i]))
+			++n_coalesced;
+	}
+	stat_ev_dbl("bechordal_coalesced_affinities", n_coalesced);
+	stat_ev_dbl("bechordal_affinities", ARR_LEN(c->affinities));
+	DEL_ARR_F(c->affinities);
+	c->affinities = NULL;
+
+	/* Values colored by constraint handling already determine the register of
+	 * their class. */
+	for (unsigned i = 0; i < c->n_nodes; ++i) {
+		coalesce_node_t *const node = c->nodes[i];
+		if (node == NULL)
+			continue;
+		arch_register_t const *const reg = arch_get_irn_register(node->irn);
+		if (reg != NULL)
+			be_congruence_set_color(c, node->irn, reg->index);
+	}
+	return c;
+}
+
+int be_congruence_get_color(be_congruence_t const *const congruence,
+                            ir_node const *const node)
+{
+	unsigned const idx = get_irn_idx(node);
+	if (idx >= congruence->n_nodes || congruence->nodes[idx] == NULL)
+		return -1;
+	return find_root(congruence->nodes[idx])->color;
+}
+
+void be_congruence_set_color(be_congruence_t *const congruence,
+                             ir_node const *const node, unsigned const col)
+{
+	unsigned const idx = get_irn_idx(node);
+	if (idx >= congruence->n_nodes || congruence->nodes[idx] == NULL)
+		return;
+	coalesce_node_t *const root = find_root(congruence->nodes[idx]);
+	if (root->color < 0)
+		root->color = col;
+}
+
+void be_free_congruence(be_congruence_t *const congruence)
+{
+	for (unsigned i = 0; i < congruence->n_nodes; ++i) {
+		coalesce_node_t *const node = congruence->nodes[i];
+		if (node != NULL && node->members != NULL)
+			DEL_ARR_F(node->members);
+	}
+	free(congruence->nodes);
+	obstack_free(&congruence->obst, NULL);
+	free(congruence);
+}
+
+BE_REGISTER_MODULE_CONSTRUCTOR(be_init_coalesce)
+void be_init_coalesce(void)
+{
+	static const lc_opt_table_entry_t options[] = {
+		LC_OPT_ENT_BOOL("coalesce", "coalesce copy related values before coloring", &do_coalesce),
+		LC_OPT_LAST
+	};
+	lc_opt_entry_t *be_grp      = lc_opt_get_grp(firm_opt_get_root(), "be");
+	lc_opt_entry_t *ra_grp      = lc_opt_get_grp(be_grp, "ra");
+	lc_opt_entry_t *chordal_grp = lc_opt_get_grp(ra_grp, "chordal");
+	lc_opt_add_table(chordal_grp, options);
+
+	FIRM_DBG_REGISTER(dbg, "firm.be.coalesce");
+}
@@ -0,0 +1,42 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief       SSA based coalescing of copy related values before coloring.
+ */
+#ifndef FIRM_BE_BECOALESCE_H
+#define FIRM_BE_BECOALESCE_H
+
+#include "be_types.h"
+#include "firm_types.h"
+
+typedef struct be_congruence_t be_congruence_t;
+
+/**
+ * Merges Phi related and copy related values of register class @p cls into
+ * congruence classes of non-interfering values. Interference is value based:
+ * Copies of the same value do not interfere with each other.
+ * Returns NULL if coalescing is disabled.
+ */
+be_congruence_t *be_coalesce_values(ir_graph *irg,
+                                    arch_register_class_t const *cls);
+
+/**
+ * Returns the register index preferred for @p node, that is the register of
+ * the first colored member of its congruence class, or -1 if there is none.
+ */
+int be_congruence_get_color(be_congruence_t const *congruence,
+                            ir_node const *node);
+
+/**
+ * Records that @p node was assigned register index @p col.
+ */
+void be_congruence_set_color(be_congruence_t *congruence, ir_node const *node,
+                             unsigned col);
+
+void be_free_congruence(be_congruence_t *congruence);
+
+#endif
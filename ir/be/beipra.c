@@ -0,0 +1,150 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief       Interprocedural register allocation.
+ *
+ * The graphs are compiled bottom-up in the call graph. After a graph is
+ * compiled, the registers written by its code are recorded. A call of a
+ * function which is not visible outside of the compilation unit only clobbers
+ * these registers instead of all caller saved registers of the calling
+ * convention, so values may stay in registers across the call.
+ */
+#include "beipra.h"
+
+#include "array.h"
+#include "be_t.h"
+#include "bearch.h"
+#include "beirg.h"
+#include "benode.h"
+#include "besched.h"
+#include "callgraph.h"
+#include "cgana.h"
+#include "entity_t.h"
+#include "irgraph_t.h"
+#include "irgwalk.h"
+#include "irnode_t.h"
+#include "irprog_t.h"
+#include "obst.h"
+#include "pmap.h"
+#include "raw_bitset.h"
+#include "target_t.h"
+
+static pmap           *infos;
+static struct obstack  obst;
+
+void be_ipra_begin(void)
+{
+	assert(infos == NULL);
+	infos = pmap_create();
+	obstack_init(&obst);
+}
+
+void be_ipra_finish(void)
+{
+	if (infos == NULL)
+		return;
+	pmap_destroy(infos);
+	obstack_free(&obst, NULL);
+	infos = NULL;
+}
+
+static void append_irg(ir_graph *const irg, void *const data)
+{
+	ir_graph ***const order = (ir_graph***)data;
+	ARR_APP1(ir_graph*, *order, irg);
+}
+
+ir_graph **be_ipra_get_irg_order(void)
+{
+	ir_graph **order = NEW_ARR_F(ir_graph*, 0);
+	if (infos == NULL) {
+		foreach_irp_irg(i, irg) {
+			ARR_APP1(ir_graph*, order, irg);
+		}
+		return order;
+	}
+
+	/* The post order of the call graph visits callees before their callers,
+	 * the graphs of a recursion are visited in some order. */
+	bool const has_callee_info
+		= get_irp_callee_info_state() == irg_callee_info_consistent;
+	if (!has_callee_info) {
+		ir_entity **free_methods;
+		cgana(&free_methods);
+		free(free_methods);
+	}
+	compute_callgraph();
+	callgraph_walk(NULL, append_irg, &order);
+	assert(ARR_LEN(order) == get_irp_n_irgs());
+	free_callgraph();
+	if (!has_callee_info)
+		free_irp_callee_info();
+	return order;
+}
+
+static void collect_clobbers(ir_node *const block, void *const env)
+{
+	unsigned *const clobbers = (unsigned*)env;
+	sched_foreach(block, node) {
+		/* The Start node defines the values at the function entry. */
+		if (be_is_Start(node))
+			continue;
+		be_foreach_out(node, o) {
+			arch_register_t const *const reg
+				= arch_get_irn_register_out(node, o);
+			if (reg != NULL)
+				rbitset_set(clobbers, reg->global_index);
+		}
+	}
+}
+
+void be_ipra_record(ir_graph *const irg, bool const aligned_stack)
+{
+	if (infos == NULL)
+		return;
+
+	unsigned const  n_regs   = ir_target.isa->n_registers;
+	unsigned *const clobbers = rbitset_obstack_alloc(&obst, n_regs);
+	irg_block_walk_graph(irg, collect_clobbers, NULL, clobbers);
+
+	be_ipra_info_t *const info = OALLOC(&obst, be_ipra_info_t);
+	info->clobbers      = clobbers;
+	info->aligned_stack = aligned_stack;
+	pmap_insert(infos, get_irg_entity(irg), info);
+}
+
+be_ipra_info_t const *be_ipra_get_callee_info(ir_node const *const call)
+{
+	if (infos == NULL)
+		return NULL;
+	ir_entity const *const callee = get_Call_callee(call);
+	/* Other definitions may replace externally visible functions. */
+	if (callee == NULL || entity_is_externally_visible(callee))
+		return NULL;
+	return pmap_get(be_ipra_info_t const, infos, callee);
+}
+
+static void check_aligned_stack(ir_node *const node, void *const env)
+{
+	bool *const aligned_stack = (bool*)env;
+	if (is_Alloc(node) || is_Free(node)) {
+		*aligned_stack = true;
+	} else if (is_Call(node)) {
+		be_ipra_info_t const *const info = be_ipra_get_callee_info(node);
+		if (info == NULL || info->aligned_stack)
+			*aligned_stack = true;
+	}
+}
+
+bool be_ipra_needs_aligned_stack(ir_graph *const irg)
+{
+	if (infos == NULL)
+		return true;
+	bool aligned_stack = false;
+	irg_walk_graph(irg, check_aligned_stack, NULL, &aligned_stack);
+	return aligned_stack;
+}
@@ -0,0 +1,59 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief       Interprocedural register allocation: Calls to functions of
+ *              the compilation unit, which are not visible outside of it,
+ *              only clobber the registers actually modified by the callee.
+ */
+#ifndef FIRM_BE_BEIPRA_H
+#define FIRM_BE_BEIPRA_H
+
+#include <stdbool.h>
+
+#include "be_types.h"
+#include "firm_types.h"
+
+typedef struct be_ipra_info_t {
+	/** registers possibly modified by the function and its callees */
+	unsigned *clobbers;
+	/** the function expects the stack to be aligned at its entry */
+	bool      aligned_stack;
+} be_ipra_info_t;
+
+void be_ipra_begin(void);
+
+void be_ipra_finish(void);
+
+/**
+ * Returns all graphs of the program ordered bottom-up in the call graph:
+ * A graph comes after the graphs it calls unless they call it recursively.
+ * Compiling in this order makes the register usage of most callees known at
+ * their call sites. The result must be freed with DEL_ARR_F().
+ */
+ir_graph **be_ipra_get_irg_order(void);
+
+/**
+ * Records the registers modified by the code of @p irg after register
+ * allocation and whether @p irg needs an aligned stack at its entry.
+ */
+void be_ipra_record(ir_graph *irg, bool aligned_stack);
+
+/**
+ * Returns the information recorded for the callee of @p call or NULL if the
+ * callee is unknown, externally visible or not compiled yet.
+ */
+be_ipra_info_t const *be_ipra_get_callee_info(ir_node const *call);
+
+/**
+ * Checks whether the code of @p irg needs an aligned stack: This is the case
+ * unless it allocates no stack memory and all its callees are known not to
+ * need an aligned stack. The alignment of the frame entities is not checked.
+ * Must be called before the graph is transformed.
+ */
+bool be_ipra_needs_aligned_stack(ir_graph *irg);
+
+#endif
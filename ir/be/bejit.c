@@ -12,13 +12,18 @@
 #include "bejit.h"
 
 #include "array.h"
+#include "bearch.h"
 #include "beemitter.h"
 #include "begnuas.h"
+#include "bera.h"
 #include "bitfiddle.h"
 #include "compiler.h"
 #include "entity_t.h"
+#include "irgraph_t.h"
 #include "obst.h"
 #include "panic.h"
+#include "target_t.h"
+#include "type_t.h"
 #include <assert.h>
 #include <limits.h>
 
@@ -51,6 +56,10 @@ struct ir_jit_segment_t {
 	struct obstack code_obst;
 	struct obstack fragment_info_obst;
 	struct obstack fragment_info_arr_obst;
+	struct obstack stub_obst;
+	ir_jit_lazy_callbacks_t callbacks;
+	unsigned       recompile_threshold;
+	char          *resolver; /**< resolver code shared by the stubs */
 };
 
 struct ir_jit_function_t {
@@ -60,9 +69,11 @@ struct ir_jit_function_t {
 	fragment_info_t **fragment_infos;
 };
 
-struct obstack        *code_obst;
-static struct obstack *fragment_info_obst;
-static struct obstack *fragment_info_arr_obst;
+/* The segment obstacks of the function being emitted. They are thread local,
+ * so workers of a jit queue can emit into their own segments. */
+THREAD_LOCAL struct obstack        *code_obst;
+static THREAD_LOCAL struct obstack *fragment_info_obst;
+static THREAD_LOCAL struct obstack *fragment_info_arr_obst;
 
 ir_jit_segment_t *be_new_jit_segment(void)
 {
@@ -70,6 +81,7 @@ ir_jit_segment_t *be_new_jit_segment(void)
 	obstack_init(&segment->code_obst);
 	obstack_init(&segment->fragment_info_obst);
 	obstack_init(&segment->fragment_info_arr_obst);
+	obstack_init(&segment->stub_obst);
 	return segment;
 }
 
@@ -78,6 +90,7 @@ void be_destroy_jit_segment(ir_jit_segment_t *segment)
 	obstack_free(&segment->code_obst, NULL);
 	obstack_free(&segment->fragment_info_obst, NULL);
 	obstack_free(&segment->fragment_info_arr_obst, NULL);
+	obstack_free(&segment->stub_obst, NULL);
 	free(segment);
 }
 
@@ -372,3 +385,120 @@ void be_jit_emit_memory(char *const buffer, ir_jit_function_t *const function,
 		last_address = address + fragment->len;
 	}
 }
+
+void be_jit_set_lazy_callbacks(ir_jit_segment_t *const segment,
+                               ir_jit_lazy_callbacks_t const *const callbacks,
+                               unsigned const recompile_threshold)
+{
+	segment->callbacks           = *callbacks;
+	segment->recompile_threshold = recompile_threshold;
+}
+
+/**
+ * Compiles @p irg for @p tier into memory of the segment.
+ *
+ * @returns the address of the code or NULL if @p irg could not be compiled
+ */
+static void const *compile_tier(ir_jit_segment_t *const segment,
+                                ir_graph *const irg, ir_jit_tier_t const tier)
+{
+	ir_jit_lazy_callbacks_t const *const callbacks = &segment->callbacks;
+	if (callbacks->optimize != NULL)
+		callbacks->optimize(irg, tier, callbacks->data);
+
+	be_set_fast_register_allocation(tier == ir_jit_tier_fast);
+	ir_jit_function_t *const function = be_jit_compile(segment, irg);
+	be_set_fast_register_allocation(false);
+	if (function == NULL)
+		return NULL;
+
+	char *const buffer = callbacks->allocate(be_get_function_size(function),
+	                                         callbacks->data);
+	be_emit_function(buffer, function);
+	return buffer;
+}
+
+/**
+ * Called by the stub code, when the counter of @p stub drops to zero.
+ * Compiles the next tier of the function and returns its address.
+ */
+static void const *resolve_stub(be_jit_stub_t *const stub)
+{
+	if (stub->target != NULL && stub->tier == ir_jit_tier_full) {
+		/* The counter wrapped around, there is no higher tier. */
+		stub->counter = 0;
+		return stub->target;
+	}
+
+	ir_jit_segment_t *const segment = stub->segment;
+	ir_entity        *const entity  = stub->entity;
+	ir_graph         *const irg     = get_entity_irg(entity);
+	if (stub->target == NULL && segment->recompile_threshold > 0) {
+		/* Compile a copy, the graph itself is kept for the full tier. */
+		ir_graph *const copy = create_irg_copy(irg);
+		set_irg_entity(copy, entity);
+		void const *const target = compile_tier(segment, copy,
+		                                        ir_jit_tier_fast);
+
+		ir_type *const frame = get_irg_frame_type(copy);
+		set_irg_entity(copy, NULL);
+		free_ir_graph(copy);
+		free_type(frame);
+
+		if (target != NULL) {
+			stub->target  = target;
+			stub->tier    = ir_jit_tier_fast;
+			stub->counter = segment->recompile_threshold;
+			return target;
+		}
+		/* Try the full tier right away. */
+	}
+
+	void const *target = compile_tier(segment, irg, ir_jit_tier_full);
+	if (target == NULL) {
+		/* Keep running the fast tier, if there is one. */
+		target = stub->target;
+	}
+	if (target == NULL) {
+		ir_jit_lazy_callbacks_t const *const callbacks = &segment->callbacks;
+		if (callbacks->compile_failed == NULL)
+			panic("could not compile %+F", entity);
+		target = callbacks->compile_failed(entity, callbacks->data);
+	}
+	stub->target  = target;
+	stub->tier    = ir_jit_tier_full;
+	stub->counter = 0;
+	/* There is no higher tier: Let the stub jump to the code directly and
+	 * let functions compiled from now on call it without the stub. */
+	ir_target.isa->jit_stubs->patch_stub(stub->code, target);
+	be_jit_set_entity_addr(entity, target);
+	return target;
+}
+
+int be_jit_compile_lazy(ir_jit_segment_t *const segment,
+                        ir_entity *const entity)
+{
+	be_jit_stub_interface_t const *const stubs = ir_target.isa->jit_stubs;
+	if (stubs == NULL)
+		return false;
+
+	ir_jit_lazy_callbacks_t const *const callbacks = &segment->callbacks;
+	assert(callbacks->allocate != NULL && "lazy compilation callbacks not set");
+	assert(get_entity_irg(entity) != NULL);
+	if (segment->resolver == NULL) {
+		segment->resolver = callbacks->allocate(stubs->resolver_size,
+		                                        callbacks->data);
+		stubs->emit_resolver(segment->resolver, resolve_stub);
+	}
+
+	be_jit_stub_t *const stub = OALLOCZ(&segment->stub_obst, be_jit_stub_t);
+	stub->counter = 1;
+	stub->entity  = entity;
+	stub->segment = segment;
+
+	char *const code = callbacks->allocate(stubs->stub_size, callbacks->data);
+	stub->code = code;
+	stubs->emit_stub(code, stub, segment->resolver);
+	be_jit_set_entity_addr(entity, code);
+	return true;
+}
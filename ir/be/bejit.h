@@ -14,6 +14,8 @@
 
 #include <stdint.h>
 
+#include "be_types.h"
+#include "compiler.h"
 #include "firm_types.h"
 #include "jit.h"
 #include "obst.h"
@@ -41,7 +43,8 @@ ir_jit_function_t *be_jit_finish_function(void);
 unsigned be_begin_fragment(uint8_t p2align, uint8_t max_skip);
 void be_finish_fragment(void);
 
-extern struct obstack *code_obst;
+/** Code of the function being emitted by the current thread. */
+extern THREAD_LOCAL struct obstack *code_obst;
 
 /** Append a byte to the current fragment */
 static inline void be_emit8(uint8_t const byte)
@@ -67,4 +70,44 @@ void be_emit_reloc_fragment(unsigned len, uint8_t be_kind,
 void be_emit_reloc_entity(unsigned len, uint8_t be_kind, ir_entity *entity,
                           int32_t offset);
 
+/**
+ * Stub of a lazily compiled function. The stub code decrements @c counter and
+ * jumps to @c target, unless the counter drops to zero. Then it calls the
+ * resolver of the segment, which compiles the next tier of the function.
+ */
+typedef struct be_jit_stub_t {
+	uint32_t          counter; /**< calls left until the next resolve */
+	void const       *target;  /**< current code of the function */
+	ir_entity        *entity;
+	ir_jit_segment_t *segment;
+	char             *code;    /**< code of the stub */
+	ir_jit_tier_t     tier;    /**< tier of the current code */
+} be_jit_stub_t;
+
+typedef void const *(*be_jit_resolve_func)(be_jit_stub_t *stub);
+
+struct be_jit_stub_interface_t {
+	unsigned stub_size;     /**< size of the code of a stub */
+	unsigned resolver_size; /**< maximal size of the code of the resolver */
+
+	/**
+	 * Emit the code of @p stub into @p buffer, jumping to @p resolver when
+	 * the counter of the stub drops to zero.
+	 */
+	void (*emit_stub)(char *buffer, be_jit_stub_t *stub, char const *resolver);
+
+	/**
+	 * Emit the resolver, which is shared by all stubs of a segment, into
+	 * @p buffer. The resolver preserves the arguments of the call, passes the
+	 * stub to @p resolve and continues at the address returned by it.
+	 */
+	void (*emit_resolver)(char *buffer, be_jit_resolve_func resolve);
+
+	/**
+	 * Overwrite the start of the stub code @p buffer by a direct jump to
+	 * @p target, so calls of the final tier skip the counter.
+	 */
+	void (*patch_stub)(char *buffer, void const *target);
+};
+
 #endif
@@ -0,0 +1,191 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Compile graphs on background worker threads.
+ *
+ * libFirm itself is not thread safe, so the workers compile while holding the
+ * libFirm lock (see be_jit_lock()) and compilations never overlap. The lock is
+ * the recursive global lock of libFirm, so install callbacks may take it
+ * again. Each worker emits into its own segment, the emitter keeps the
+ * obstacks of the current function thread local.
+ */
+#include "bejit.h"
+#include "firm_lock.h"
+#include "firm_thread.h"
+#include "jit.h"
+#include "xmalloc.h"
+#include <assert.h>
+#include <stdbool.h>
+
+struct ir_jit_future_t {
+	ir_jit_future_t     *next;     /**< next pending future of the queue */
+	ir_jit_queue_t      *queue;
+	ir_graph            *irg;
+	ir_jit_install_func  install;
+	void                *data;
+	ir_jit_function_t   *function; /**< the result, valid when done */
+	bool                 done;
+};
+
+typedef struct jit_worker_t {
+	ir_jit_queue_t   *queue;
+	ir_jit_segment_t *segment; /**< segment owned by the worker */
+	firm_thread_t     thread;
+} jit_worker_t;
+
+struct ir_jit_queue_t {
+	firm_mutex_t     mutex;        /**< protects the rest of the queue */
+	firm_cond_t      pending_cond; /**< signals new futures and shutdown */
+	firm_cond_t      done_cond;    /**< signals finished futures */
+	ir_jit_future_t *first;        /**< first pending future */
+	ir_jit_future_t **last;        /**< next field of the last pending future */
+	bool             shutdown;
+	unsigned         n_workers;
+	jit_worker_t    *workers;
+};
+
+void be_jit_lock(void)
+{
+	firm_lock();
+}
+
+void be_jit_unlock(void)
+{
+	firm_unlock();
+}
+
+static void compile_future(jit_worker_t *const worker,
+                           ir_jit_future_t *const future)
+{
+	be_jit_lock();
+	ir_jit_function_t *const function
+		= be_jit_compile(worker->segment, future->irg);
+	if (future->install != NULL)
+		future->install(function, future->irg, future->data);
+	be_jit_unlock();
+
+	ir_jit_queue_t *const queue = worker->queue;
+	firm_mutex_lock(&queue->mutex);
+	future->function = function;
+	future->done     = true;
+	firm_cond_broadcast(&queue->done_cond);
+	firm_mutex_unlock(&queue->mutex);
+}
+
+static void *run_worker(void *const data)
+{
+	jit_worker_t   *const worker = (jit_worker_t*)data;
+	ir_jit_queue_t *const queue  = worker->queue;
+	for (;;) {
+		firm_mutex_lock(&queue->mutex);
+		while (queue->first == NULL && !queue->shutdown)
+			firm_cond_wait(&queue->pending_cond, &queue->mutex);
+		/* Pending futures are still compiled after shutdown was requested. */
+		ir_jit_future_t *const future = queue->first;
+		if (future != NULL) {
+			queue->first = future->next;
+			if (queue->first == NULL)
+				queue->last = &queue->first;
+		}
+		firm_mutex_unlock(&queue->mutex);
+
+		if (future == NULL)
+			return NULL;
+		compile_future(worker, future);
+	}
+}
+
+ir_jit_queue_t *be_new_jit_queue(unsigned const n_workers)
+{
+	assert(n_workers > 0);
+	ir_jit_queue_t *const queue = XMALLOCZ(ir_jit_queue_t);
+	firm_mutex_init(&queue->mutex);
+	firm_cond_init(&queue->pending_cond);
+	firm_cond_init(&queue->done_cond);
+	queue->last    = &queue->first;
+	queue->workers = XMALLOCNZ(jit_worker_t, n_workers);
+	for (unsigned i = 0; i < n_workers; ++i) {
+		jit_worker_t *const worker = &queue->workers[i];
+		worker->queue   = queue;
+		worker->segment = be_new_jit_segment();
+		if (!firm_thread_create(&worker->thread, run_worker, worker)) {
+			be_destroy_jit_segment(worker->segment);
+			break;
+		}
+		++queue->n_workers;
+	}
+	if (queue->n_workers == 0) {
+		be_destroy_jit_queue(queue);
+		return NULL;
+	}
+	return queue;
+}
+
+void be_destroy_jit_queue(ir_jit_queue_t *const queue)
+{
+	firm_mutex_lock(&queue->mutex);
+	queue->shutdown = true;
+	firm_cond_broadcast(&queue->pending_cond);
+	firm_mutex_unlock(&queue->mutex);
+
+	for (unsigned i = 0, n = queue->n_workers; i < n; ++i) {
+		jit_worker_t *const worker = &queue->workers[i];
+		firm_thread_join(worker->thread);
+		be_destroy_jit_segment(worker->segment);
+	}
+
+	firm_cond_destroy(&queue->done_cond);
+	firm_cond_destroy(&queue->pending_cond);
+	firm_mutex_destroy(&queue->mutex);
+	free(queue->workers);
+	free(queue);
+}
+
+ir_jit_future_t *be_jit_enqueue(ir_jit_queue_t *const queue,
+                                ir_graph *const irg,
+                                ir_jit_install_func const install,
+                                void *const data)
+{
+	ir_jit_future_t *const future = XMALLOCZ(ir_jit_future_t);
+	future->queue   = queue;
+	future->irg     = irg;
+	future->install = install;
+	future->data    = data;
+
+	firm_mutex_lock(&queue->mutex);
+	assert(!queue->shutdown);
+	*queue->last = future;
+	queue->last  = &future->next;
+	firm_cond_broadcast(&queue->pending_cond);
+	firm_mutex_unlock(&queue->mutex);
+	return future;
+}
+
+int be_jit_future_done(ir_jit_future_t const *const future)
+{
+	ir_jit_queue_t *const queue = future->queue;
+	firm_mutex_lock(&queue->mutex);
+	bool const done = future->done;
+	firm_mutex_unlock(&queue->mutex);
+	return done;
+}
+
+ir_jit_function_t *be_jit_future_wait(ir_jit_future_t *const future)
+{
+	ir_jit_queue_t *const queue = future->queue;
+	firm_mutex_lock(&queue->mutex);
+	while (!future->done)
+		firm_cond_wait(&queue->done_cond, &queue->mutex);
+	firm_mutex_unlock(&queue->mutex);
+	return future->function;
+}
+
+void be_jit_free_future(ir_jit_future_t *const future)
+{
+	assert(be_jit_future_done(future));
+	free(future);
+}
@@ -472,12 +472,15 @@ static const ir_node *get_highest_sync_op(const ir_node *const sync)
 	return best;
 }
 
+const ir_node *be_get_memory_value_def(const ir_node *const value)
+{
+	return is_Sync(value) ? get_highest_sync_op(value) : value;
+}
+
 bool be_memory_values_interfere(const ir_node *a, const ir_node *b)
 {
-	if (is_Sync(a))
-		a = get_highest_sync_op(a);
-	if (is_Sync(b))
-		b = get_highest_sync_op(b);
+	a = be_get_memory_value_def(a);
+	b = be_get_memory_value_def(b);
 
 	if (value_strictly_dominates(b, a)) {
 		/* Adjust a and b so, that a dominates b if
@@ -119,6 +119,13 @@ bool be_values_interfere(const ir_node *a, const ir_node *b);
  */
 bool be_memory_values_interfere(const ir_node *a, const ir_node *b);
 
+/**
+ * Returns the node whose definition starts the live range of memory value
+ * @p value. This is the value itself except for Sync nodes, where it is the
+ * operand dominated by all others.
+ */
+const ir_node *be_get_memory_value_def(const ir_node *value);
+
 /**
  * Compute a set of nodes which are live just before the given node.
  * @param cls      The register class to consider.
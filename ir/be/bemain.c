@@ -16,6 +16,7 @@
 #include "beemitter.h"
 #include "begnuas.h"
 #include "beifg.h"
+#include "beipra.h"
 #include "beirg.h"
 #include "belistsched.h"
 #include "belive.h"
@@ -57,13 +58,17 @@ static be_main_env_t  env;
 /* options visible for anyone */
 be_options_t be_options = {
 	.dump_flags           = DUMP_NONE,
+	.dump_format          = ir_dump_format_vcg,
 	.timing               = false,
 	.opt_profile_generate = false,
 	.opt_profile_use      = false,
+	.profile_samples      = "",
+	.instrument           = IR_PROFILE_HOTPATH_NONE,
 	.omit_fp              = false,
 	.do_verify            = true,
 	.ilp_solver           = "",
 	.verbose_asm          = true,
+	.ipra                 = true,
 };
 
 /* possible dumping options */
@@ -83,14 +88,45 @@ static lc_opt_enum_mask_var_t dump_var = {
 	&be_options.dump_flags, dump_items
 };
 
+/* possible dump formats */
+static const lc_opt_enum_int_items_t dump_format_items[] = {
+	{ "vcg",    ir_dump_format_vcg },
+	{ "stream", ir_dump_format_stream },
+	{ "zstd",   ir_dump_format_stream_zstd },
+	{ NULL,     0 }
+};
+
+static lc_opt_enum_int_var_t dump_format_var = {
+	&be_options.dump_format, dump_format_items
+};
+
+/* possible hot path instrumentation options */
+static const lc_opt_enum_mask_items_t instrument_items[] = {
+	{ "none",   IR_PROFILE_HOTPATH_NONE },
+	{ "entry",  IR_PROFILE_HOTPATH_ENTRY },
+	{ "cycles", IR_PROFILE_HOTPATH_CYCLES },
+	{ "loops",  IR_PROFILE_HOTPATH_LOOPS },
+	{ "calls",  IR_PROFILE_HOTPATH_CALLS },
+	{ "all",    2 * IR_PROFILE_HOTPATH_CALLS - 1 },
+	{ NULL,     0 }
+};
+
+static lc_opt_enum_mask_var_t instrument_var = {
+	&be_options.instrument, instrument_items
+};
+
 static const lc_opt_table_entry_t be_main_options[] = {
 	LC_OPT_ENT_ENUM_MASK("dump",       "dump irg on several occasions",                       &dump_var),
+	LC_OPT_ENT_ENUM_INT ("dumpformat", "file format of the irg dumps",                        &dump_format_var),
 	LC_OPT_ENT_BOOL     ("omitfp",     "omit frame pointer",                                  &be_options.omit_fp),
 	LC_OPT_ENT_BOOL     ("verify",     "verify the backend irg",                              &be_options.do_verify),
 	LC_OPT_ENT_BOOL     ("time",       "get backend timing statistics",                       &be_options.timing),
 	LC_OPT_ENT_BOOL     ("profilegenerate", "instrument the code for execution count profiling", &be_options.opt_profile_generate),
 	LC_OPT_ENT_BOOL     ("profileuse",      "use existing profile data",                         &be_options.opt_profile_use),
+	LC_OPT_ENT_STR      ("profilesamples",  "use sampled profile (perf script or AutoFDO text)",   &be_options.profile_samples),
+	LC_OPT_ENT_ENUM_MASK("instrument", "instrument the code with hot path counters",         &instrument_var),
 	LC_OPT_ENT_BOOL     ("verboseasm", "enable verbose assembler output",                        &be_options.verbose_asm),
+	LC_OPT_ENT_BOOL     ("ipra",       "use the register usage of local callees at calls",      &be_options.ipra),
 
 	LC_OPT_ENT_STR("ilp.solver", "the ilp solver name", &be_options.ilp_solver),
 	LC_OPT_LAST
@@ -281,7 +317,39 @@ static void initialize_birg(be_irg_t *birg, ir_graph *irg, be_main_env_t *env)
 	}
 }
 
-static ir_graph *be_prepare_profile(const char *const cup_name)
+/**
+ * Instrument the program with the hot path counters selected by
+ * be_options.instrument. The counters are written to "<cup_name>.hotprof",
+ * their descriptions to "<cup_name>.hotprof.map".
+ */
+static ir_graph *be_instrument_hotpaths(const char *const cup_name)
+{
+	unsigned flags = be_options.instrument;
+	if ((flags & IR_PROFILE_HOTPATH_CYCLES) && !ir_target.cycle_counter) {
+		be_warningf(NULL, "cycle counting needs rdtsc (x86 only); not instrumenting cycles");
+		flags &= ~IR_PROFILE_HOTPATH_CYCLES;
+	}
+
+	obstack_printf(&obst, "%s.hotprof", cup_name);
+	obstack_1grow(&obst, '\0');
+	const char *prof_filename = obstack_finish(&obst);
+
+	obstack_printf(&obst, "%s.map", prof_filename);
+	obstack_1grow(&obst, '\0');
+	const char *map_filename = obstack_finish(&obst);
+
+	FILE *const map = fopen(map_filename, "w");
+	if (map == NULL)
+		be_warningf(NULL, "could not write hot path counter map '%s'", map_filename);
+
+	ir_graph *const init_irg = ir_profile_instrument_hotpaths(prof_filename, flags, map);
+	if (map != NULL)
+		fclose(map);
+	return init_irg;
+}
+
+static ir_graph *be_prepare_profile(const char *const cup_name,
+                                    ir_graph **const hotpath_init_irg)
 {
 	obstack_printf(&obst, "%s.prof", cup_name);
 	obstack_1grow(&obst, '\0');
@@ -298,17 +366,34 @@ static ir_graph *be_prepare_profile(const char *const cup_name)
 			have_profile = true;
 		}
 	}
+	if (!have_profile && be_options.profile_samples[0] != '\0') {
+		be_timer_push(T_EXECFREQ);
+		have_profile = ir_profile_read_samples(be_options.profile_samples);
+		be_timer_pop(T_EXECFREQ);
+		if (!have_profile)
+			be_warningf(NULL, "could not read sample profile '%s'", be_options.profile_samples);
+	}
 
 	ir_graph *prof_init_irg = NULL;
 	if (be_options.opt_profile_generate)
 		prof_init_irg = ir_profile_instrument(prof_filename);
 
+	*hotpath_init_irg = NULL;
+	if (be_options.instrument != IR_PROFILE_HOTPATH_NONE)
+		*hotpath_init_irg = be_instrument_hotpaths(cup_name);
+
 	if (!have_profile) {
 		be_timer_push(T_EXECFREQ);
 		foreach_irp_irg(i, irg) {
 			ir_estimate_execfreq(irg);
 		}
 		be_timer_pop(T_EXECFREQ);
+	} else {
+		/* the constructors are not covered by the profile */
+		if (prof_init_irg != NULL)
+			ir_estimate_execfreq(prof_init_irg);
+		if (*hotpath_init_irg != NULL)
+			ir_estimate_execfreq(*hotpath_init_irg);
 	}
 	return prof_init_irg;
 }
@@ -317,6 +402,9 @@ void be_begin(FILE *file_handle, const char *cup_name)
 {
 	memset(be_asm_constraint_flags, 0, sizeof(be_asm_constraint_flags));
 
+	if (be_options.dump_format != ir_dump_format_vcg)
+		ir_set_dump_format((ir_dump_format_t)be_options.dump_format);
+
 	bemain_timer = NULL;
 	if (be_options.timing) {
 		bemain_timer = ir_timer_new();
@@ -360,11 +448,13 @@ void be_begin(FILE *file_handle, const char *cup_name)
 	env.cup_name             = cup_name;
 
 	be_info_init();
+	if (be_options.ipra)
+		be_ipra_begin();
 
 	/* First: initialize all birgs */
 	size_t          num_birgs = 0;
-	/* we might need 1 birg more for instrumentation constructor */
-	be_irg_t *const birgs     = OALLOCN(&obst, be_irg_t, get_irp_n_irgs()+1);
+	/* we might need 2 birgs more for instrumentation constructors */
+	be_irg_t *const birgs     = OALLOCN(&obst, be_irg_t, get_irp_n_irgs()+2);
 	foreach_irp_irg(i, irg) {
 		ir_entity *entity = get_irg_entity(irg);
 		if (get_entity_linkage(entity) & IR_LINKAGE_NO_CODEGEN)
@@ -378,9 +468,12 @@ void be_begin(FILE *file_handle, const char *cup_name)
 	/* Prepare basicblock profile generation/usage. Note: You should avoid
 	 * introducing new control flow after this point or you won't have profile
 	 * data for the new basic blocks. */
-	ir_graph *prof_init_irg = be_prepare_profile(cup_name);
+	ir_graph *hotpath_init_irg;
+	ir_graph *prof_init_irg = be_prepare_profile(cup_name, &hotpath_init_irg);
 	if (prof_init_irg != NULL)
 		initialize_birg(&birgs[num_birgs++], prof_init_irg, &env);
+	if (hotpath_init_irg != NULL)
+		initialize_birg(&birgs[num_birgs++], hotpath_init_irg, &env);
 
 	be_gas_begin_compilation_unit(&env);
 }
@@ -414,6 +507,7 @@ static const char *get_timer_name(be_timer_id_t id)
 	case T_RA_SPILL:       return "ra_spill";
 	case T_RA_SPILL_APPLY: return "ra_spill_apply";
 	case T_RA_COLOR:       return "ra_color";
+	case T_RA_COALESCE:    return "ra_coalesce";
 	case T_RA_IFG:         return "ra_ifg";
 	case T_RA_COPYMIN:     return "ra_copymin";
 	case T_RA_SSA:         return "ra_ssa";
@@ -570,6 +664,7 @@ void be_finish(void)
 
 	be_emit_exit();
 	be_info_free();
+	be_ipra_finish();
 
 	pmap_destroy(env.ent_trampoline_map);
 	pmap_destroy(env.ent_pic_symbol_map);
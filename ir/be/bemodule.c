@@ -32,6 +32,7 @@ void be_init_blocksched(void);
 void be_init_chordal(void);
 void be_init_chordal_common(void);
 void be_init_chordal_main(void);
+void be_init_coalesce(void);
 void be_init_copyheur4(void);
 void be_init_copyilp(void);
 void be_init_copyilp2(void);
@@ -88,14 +89,18 @@ void be_init_modules(void)
 	be_init_ssaconstr();
 	be_init_state();
 
-	/* in the following groups the first one is the default */
+	/* Only register the options and debug modules of the backends here. Their
+	 * nodes and register classes are created by isa->init(), when
+	 * ir_target_init() selects one of them. */
 	be_init_arch_ia32();
 	be_init_arch_arm();
 	be_init_arch_mips();
+	be_init_arch_riscv();
 	be_init_arch_sparc();
 	be_init_arch_amd64();
 	be_init_arch_TEMPLATE();
 
+	/* in the following groups the first one is the default */
 	be_init_listsched();
 	be_init_sched_normal();
 	be_init_sched_rand();
@@ -105,6 +110,7 @@ void be_init_modules(void)
 	be_init_pref_alloc();
 
 	be_init_chordal();
+	be_init_coalesce();
 	be_init_pbqp_coloring();
 
 	be_init_spillbelady();
@@ -129,6 +135,17 @@ void be_quit_modules(void)
 
 //---------------------------------------------------------------------------
 
+void *be_get_module(be_module_list_entry_t const *const list_head,
+                    char const *const name)
+{
+	for (be_module_list_entry_t const *module = list_head; module != NULL;
+	     module = module->next) {
+		if (streq(module->name, name))
+			return module->data;
+	}
+	return NULL;
+}
+
 typedef struct module_opt_data_t {
 	void **var;
 	be_module_list_entry_t * const *list_head;
@@ -144,17 +161,11 @@ static bool set_opt_module(void *const data, size_t const length, char const *co
 	(void)length;
 
 	const module_opt_data_t *moddata = (module_opt_data_t*)data;
-	bool                     res     = false;
-	for (const be_module_list_entry_t *module = *(moddata->list_head);
-	     module != NULL; module = module->next) {
-		if (streq(module->name, opt)) {
-			*(moddata->var) = module->data;
-			res = true;
-			break;
-		}
-	}
-
-	return res;
+	void                    *module  = be_get_module(*moddata->list_head, opt);
+	if (module == NULL)
+		return false;
+	*(moddata->var) = module;
+	return true;
 }
 
 /**
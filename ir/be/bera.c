@@ -17,6 +17,7 @@
 /** The list of register allocators */
 static be_module_list_entry_t *register_allocators;
 static allocate_func           selected_allocator;
+static bool                    use_fast_allocator;
 
 void be_register_allocator(const char *name, allocate_func allocator)
 {
@@ -27,7 +28,19 @@ void be_register_allocator(const char *name, allocate_func allocator)
 
 void be_allocate_registers(ir_graph *irg, const regalloc_if_t *regif)
 {
-	selected_allocator(irg, regif);
+	allocate_func allocator = selected_allocator;
+	if (use_fast_allocator) {
+		allocate_func const fast
+			= (allocate_func)be_get_module(register_allocators, "pref");
+		if (fast != NULL)
+			allocator = fast;
+	}
+	allocator(irg, regif);
+}
+
+void be_set_fast_register_allocation(bool const enable)
+{
+	use_fast_allocator = enable;
 }
 
 BE_REGISTER_MODULE_CONSTRUCTOR(be_init_ra)
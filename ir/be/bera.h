@@ -12,6 +12,7 @@
 #ifndef FIRM_BE_BERA_H
 #define FIRM_BE_BERA_H
 
+#include <stdbool.h>
 #include "firm_types.h"
 #include "be_types.h"
 
@@ -54,6 +55,12 @@ struct regalloc_if_t {
  */
 void be_allocate_registers(ir_graph *irg, const regalloc_if_t *regif);
 
+/**
+ * Use the fast preference allocator instead of the selected register
+ * allocator, used for quickly compiled code of the JIT.
+ */
+void be_set_fast_register_allocation(bool enable);
+
 typedef void (*allocate_func)(ir_graph *irg, const regalloc_if_t *regif);
 
 void be_register_allocator(const char *name, allocate_func allocator);
@@ -811,6 +811,7 @@ static void be_spill_belady(ir_graph *irg, const arch_register_class_t *rcls,
 	n_regs       = be_get_n_allocatable_regs(irg, cls);
 	ws           = new_workset();
 	uses         = be_begin_uses(irg, lv);
+	be_precompute_next_uses(uses, cls);
 	loop_ana     = be_new_loop_pressure(irg, cls);
 	senv         = be_new_spill_env(irg, regif);
 	blocklist    = be_get_cfgpostorder(irg);
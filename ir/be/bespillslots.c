@@ -224,142 +224,253 @@ void be_load_needs_frame_entity(be_fec_env_t *const env, ir_node *const node,
 	merge_slotsizes(spill->web, slot_size, slot_po2align);
 }
 
-static int merge_interferences(be_fec_env_t *env, bitset_t** interferences,
-                               int* spillslot_unionfind, int s1, int s2)
+typedef struct spill_slot_t {
+	ir_entity *entity;
+	unsigned   size;
+	unsigned   po2align;
+} spill_slot_t;
+
+typedef struct spill_order_t {
+	int              spill;
+	unsigned         dom_pre_num; /**< dominance preorder number of the block */
+	sched_timestep_t step;        /**< schedule position inside the block */
+	const ir_node   *def;
+} spill_order_t;
+
+static int cmp_spill_order(const void *d1, const void *d2)
 {
-	/* merge spillslots and interferences */
-	int res = uf_union(spillslot_unionfind, s1, s2);
-	/* we assume that we always merge s2 to s1 so swap s1, s2 if necessary */
-	if (res != s1) {
-		int t = s1;
-		s1 = s2;
-		s2 = t;
-	}
+	const spill_order_t *const o1 = (const spill_order_t*)d1;
+	const spill_order_t *const o2 = (const spill_order_t*)d2;
+	if (o1->dom_pre_num != o2->dom_pre_num)
+		return o1->dom_pre_num < o2->dom_pre_num ? -1 : 1;
+	if (o1->step != o2->step)
+		return o1->step < o2->step ? -1 : 1;
+	return o1->spill - o2->spill;
+}
 
-	bitset_or(interferences[s1], interferences[s2]);
+static bool def_dominates(const ir_node *const a, const ir_node *const b)
+{
+	return a == b || value_strictly_dominates(a, b);
+}
 
-	/* update other interferences */
-	for (size_t i = 0, n = ARR_LEN(env->spills); i < n; ++i) {
-		bitset_t *intfs = interferences[i];
-		if (bitset_is_set(intfs, s2))
-			bitset_set(intfs, s1);
+/**
+ * Builds the interference lists of the spills. Interfering memory values
+ * always have dominance related definitions, so walking the definitions in
+ * dominance order while keeping a stack of the dominating definitions only
+ * tests pairs that can interfere at all.
+ */
+static unsigned build_interferences(be_fec_env_t *const env,
+                                    int **const neighbours,
+                                    struct obstack *const data)
+{
+	spill_t **const spills     = env->spills;
+	size_t    const spillcount = ARR_LEN(spills);
+	spill_order_t  *order      = OALLOCN(data, spill_order_t, spillcount);
+	size_t          n_order    = 0;
+	for (size_t i = 0; i < spillcount; ++i) {
+		ir_node *const spill = spills[i]->spill;
+		if (is_NoMem(spill))
+			continue;
+		const ir_node *const def = be_get_memory_value_def(spill);
+		spill_order_t *const o   = &order[n_order++];
+		o->spill       = (int)i;
+		o->def         = def;
+		o->dom_pre_num = get_Block_dom_tree_pre_num(get_block_const(def));
+		o->step        = sched_is_scheduled(def) ? sched_get_time_step(def) : 0;
 	}
+	QSORT(order, n_order, cmp_spill_order);
+
+	unsigned        n_edges = 0;
+	spill_order_t **stack   = OALLOCN(data, spill_order_t*, n_order);
+	size_t          n_stack = 0;
+	for (size_t i = 0; i < n_order; ++i) {
+		spill_order_t *const cur = &order[i];
+		while (n_stack > 0 && !def_dominates(stack[n_stack - 1]->def, cur->def))
+			--n_stack;
+
+		ir_node *const spill = spills[cur->spill]->spill;
+		for (size_t s = 0; s < n_stack; ++s) {
+			int const other = stack[s]->spill;
+			if (!be_memory_values_interfere(spills[other]->spill, spill))
+				continue;
+			DB((dbg, LEVEL_1, "Slot %d and %d interfere\n", other, cur->spill));
+			ARR_APP1(int, neighbours[other], cur->spill);
+			ARR_APP1(int, neighbours[cur->spill], other);
+			++n_edges;
+		}
+		stack[n_stack++] = cur;
+	}
+	return n_edges;
+}
 
-	return res;
+/** Tests whether the coalesced spills of @p s1 and @p s2 interfere. */
+static bool classes_interfere(int **const neighbours, int *const unionfind,
+                              const int *const next_member, int const s1,
+                              int const s2)
+{
+	for (int m = s1; m >= 0; m = next_member[m]) {
+		for (size_t i = 0, n = ARR_LEN(neighbours[m]); i < n; ++i) {
+			if (uf_find(unionfind, neighbours[m][i]) == s2)
+				return true;
+		}
+	}
+	return false;
+}
+
+typedef struct slot_class_t {
+	int      root;
+	double   weight; /**< execution frequency of the accesses */
+	unsigned size;
+	unsigned po2align;
+} slot_class_t;
+
+static int cmp_slot_class(const void *d1, const void *d2)
+{
+	const slot_class_t *const c1 = (const slot_class_t*)d1;
+	const slot_class_t *const c2 = (const slot_class_t*)d2;
+	if (c1->weight != c2->weight)
+		return c1->weight < c2->weight ? 1 : -1;
+	return c1->root - c2->root;
 }
 
 /**
- * A greedy coalescing algorithm for spillslots:
- *  1. Sort the list of affinity edges
- *  2. Try to merge slots with affinity edges (most expensive slots first)
- *  3. Try to merge everything else that is possible
+ * Assigns spillslots by coloring the interference graph of the spills:
+ *  1. Merge spills connected by affinity edges (most expensive first), so
+ *     PhiMs need no MemPerms.
+ *  2. Color the resulting classes by decreasing access frequency. Each class
+ *     takes the non-interfering slot that grows least, so hot classes get the
+ *     first slots and cold ones fill up existing slots before new ones are
+ *     created.
  */
-static void do_greedy_coalescing(be_fec_env_t *env)
+static void color_spillslots(be_fec_env_t *env)
 {
 	spill_t **spills     = env->spills;
 	size_t    spillcount = ARR_LEN(spills);
 	if (spillcount == 0)
 		return;
 
-	DB((dbg, LEVEL_1, "Coalescing %d spillslots\n", spillcount));
+	DB((dbg, LEVEL_1, "Coloring %d spillslots\n", spillcount));
 
 	struct obstack data;
 	obstack_init(&data);
 
-	bitset_t **interferences       = OALLOCN(&data, bitset_t*, spillcount);
-	int       *spillslot_unionfind = OALLOCN(&data, int,       spillcount);
-
-	uf_init(spillslot_unionfind, spillcount);
-
+	int **const neighbours  = OALLOCN(&data, int*, spillcount);
+	int  *const unionfind   = OALLOCN(&data, int,  spillcount);
+	int  *const next_member = OALLOCN(&data, int,  spillcount);
+	int  *const last_member = OALLOCN(&data, int,  spillcount);
+	uf_init(unionfind, spillcount);
 	for (size_t i = 0; i < spillcount; ++i) {
-		interferences[i] = bitset_obstack_alloc(&data, spillcount);
+		neighbours[i]  = NEW_ARR_F(int, 0);
+		next_member[i] = -1;
+		last_member[i] = (int)i;
 	}
 
-	/* construct interferences */
-	for (size_t i = 0; i < spillcount; ++i) {
-		ir_node *spill1 = spills[i]->spill;
-		if (is_NoMem(spill1))
-			continue;
-
-		for (size_t i2 = i+1; i2 < spillcount; ++i2) {
-			ir_node *spill2 = spills[i2]->spill;
-			if (is_NoMem(spill2))
-				continue;
-
-			if (be_memory_values_interfere(spill1, spill2)) {
-				DB((dbg, LEVEL_1, "Slot %d and %d interfere\n", i, i2));
-
-				bitset_set(interferences[i], i2);
-				bitset_set(interferences[i2], i);
-			}
-		}
-	}
-
-	/* sort affinity edges */
-	QSORT_ARR(env->affinity_edges, cmp_affinity);
+	unsigned const n_edges = build_interferences(env, neighbours, &data);
+	stat_ev_dbl("spillslots_interferences", n_edges);
 
 	/* try to merge affine nodes */
+	QSORT_ARR(env->affinity_edges, cmp_affinity);
 	for (size_t i = 0, n = ARR_LEN(env->affinity_edges); i < n; ++i) {
 		const affinity_edge_t *edge = env->affinity_edges[i];
-		int s1 = uf_find(spillslot_unionfind, edge->slot1);
-		int s2 = uf_find(spillslot_unionfind, edge->slot2);
-
-		/* test if values interfere */
-		if (bitset_is_set(interferences[s1], s2)) {
-			assert(bitset_is_set(interferences[s2], s1));
+		int s1 = uf_find(unionfind, edge->slot1);
+		int s2 = uf_find(unionfind, edge->slot2);
+		if (s1 == s2 || classes_interfere(neighbours, unionfind, next_member, s1, s2))
 			continue;
-		}
 
 		DB((dbg, LEVEL_1,
 		    "Merging %d and %d because of affinity edge\n", s1, s2));
+		int const root  = uf_union(unionfind, s1, s2);
+		int const other = root == s1 ? s2 : s1;
+		next_member[last_member[root]] = other;
+		last_member[root]              = last_member[other];
+	}
 
-		merge_interferences(env, interferences, spillslot_unionfind, s1, s2);
+	/* determine the access frequency of the spills */
+	double *const weights = OALLOCNZ(&data, double, spillcount);
+	for (size_t i = 0; i < spillcount; ++i) {
+		ir_node *const spill = spills[i]->spill;
+		if (!is_NoMem(spill) && !is_Phi(spill)) {
+			const ir_node *const def = be_get_memory_value_def(spill);
+			weights[i] = get_block_execfreq(get_block_const(def));
+		}
+	}
+	for (size_t i = 0, n = ARR_LEN(env->reloads); i < n; ++i) {
+		ir_node       *const reload = env->reloads[i];
+		const spill_t *const spill  = get_spill(env, get_memory_edge(reload));
+		weights[spill->spillslot] += get_block_execfreq(get_nodes_block(reload));
 	}
 
-	/* Try to merge as much remaining spillslots as possible */
+	slot_class_t *const classes   = OALLOCN(&data, slot_class_t, spillcount);
+	size_t              n_classes = 0;
 	for (size_t i = 0; i < spillcount; ++i) {
-		int s1 = uf_find(spillslot_unionfind, i);
-		if (s1 != (int)i)
+		if (uf_find(unionfind, i) != (int)i)
 			continue;
-
-		for (size_t i2 = i+1; i2 < spillcount; ++i2) {
-			int s2 = uf_find(spillslot_unionfind, i2);
-			if (s2 != (int)i2)
-				continue;
-
-			/* Test if values interfere, we have to test n1-n2 and n2-n1,
-			 * because only 1 side gets updated when node merging occurs */
-			if (bitset_is_set(interferences[s1], s2)) {
-				assert(bitset_is_set(interferences[s2], s1));
-				continue;
+		slot_class_t *const c = &classes[n_classes++];
+		c->root     = (int)i;
+		c->weight   = 0;
+		c->size     = 0;
+		c->po2align = 0;
+		for (int m = (int)i; m >= 0; m = next_member[m]) {
+			const spillweb_t *const web = get_spill_web(spills[m]->web);
+			c->weight  += weights[m];
+			c->size     = MAX(c->size, web->slot_size);
+			c->po2align = MAX(c->po2align, web->slot_po2align);
+		}
+	}
+	QSORT(classes, n_classes, cmp_slot_class);
+
+	/* color the classes */
+	int          *const class_slot = OALLOCN(&data, int, spillcount);
+	unsigned     *const slot_mark  = OALLOCNZ(&data, unsigned, spillcount);
+	spill_slot_t *const slots      = OALLOCNZ(&data, spill_slot_t, spillcount);
+	unsigned            n_slots    = 0;
+	for (size_t i = 0; i < spillcount; ++i)
+		class_slot[i] = -1;
+	for (size_t c = 0; c < n_classes; ++c) {
+		slot_class_t *const cls  = &classes[c];
+		unsigned      const mark = (unsigned)c + 1;
+		for (int m = cls->root; m >= 0; m = next_member[m]) {
+			for (size_t i = 0, n = ARR_LEN(neighbours[m]); i < n; ++i) {
+				int const slot = class_slot[uf_find(unionfind, neighbours[m][i])];
+				if (slot >= 0)
+					slot_mark[slot] = mark;
 			}
+		}
 
-			DB((dbg, LEVEL_1,
-			    "Merging %d and %d because it is possible\n", s1, s2));
-
-			if (merge_interferences(env, interferences, spillslot_unionfind,
-			                        s1, s2) != 0) {
-				/* We can break the loop here, because s2 is the new supernode
-				 * now and we'll test s2 again later anyway */
-				break;
+		int      best        = -1;
+		unsigned best_growth = 0;
+		for (unsigned s = 0; s < n_slots; ++s) {
+			if (slot_mark[s] == mark)
+				continue;
+			unsigned const size   = MAX(slots[s].size, cls->size);
+			unsigned const growth = size - slots[s].size
+				+ (cls->po2align > slots[s].po2align);
+			if (best < 0 || growth < best_growth) {
+				best        = (int)s;
+				best_growth = growth;
+				if (growth == 0)
+					break;
 			}
 		}
+		if (best < 0)
+			best = (int)n_slots++;
+
+		DB((dbg, LEVEL_1, "Class %d (weight %f) gets slot %d\n", cls->root,
+		    cls->weight, best));
+		slots[best].size     = MAX(slots[best].size, cls->size);
+		slots[best].po2align = MAX(slots[best].po2align, cls->po2align);
+		class_slot[cls->root] = best;
 	}
 
 	/* Assign spillslots to spills */
 	for (size_t i = 0; i < spillcount; ++i) {
-		spills[i]->spillslot = uf_find(spillslot_unionfind, i);
+		spills[i]->spillslot = class_slot[uf_find(unionfind, i)];
+		DEL_ARR_F(neighbours[i]);
 	}
 
 	obstack_free(&data, 0);
 }
 
-typedef struct spill_slot_t {
-	ir_entity *entity;
-	unsigned   size;
-	unsigned   po2align;
-} spill_slot_t;
-
 typedef struct memperm_entry_t memperm_entry_t;
 struct memperm_entry_t {
 	ir_node         *node;
@@ -426,6 +537,7 @@ static void assign_spillslots(be_fec_env_t *env)
 	spill_t     **spills     = env->spills;
 	size_t        spillcount = ARR_LEN(spills);
 	spill_slot_t *spillslots = ALLOCANZ(spill_slot_t, spillcount);
+	unsigned     *used       = rbitset_alloca(spillcount);
 
 	/* construct spillslots */
 	for (size_t s = 0; s < spillcount; ++s) {
@@ -436,18 +548,24 @@ static void assign_spillslots(be_fec_env_t *env)
 
 		slot->size     = MAX(slot->size, web->slot_size);
 		slot->po2align = MAX(slot->po2align, web->slot_po2align);
+		rbitset_set(used, slotid);
 	}
 
+	/* Create the entities in slot order, so the frame layout can keep the
+	 * frequently accessed slots (the low ids) together. */
 	ir_type *const frame = get_irg_frame_type(env->irg);
+	for (size_t s = 0; s < spillcount; ++s) {
+		spill_slot_t *const slot = &spillslots[s];
+		if (rbitset_is_set(used, s))
+			slot->entity = new_spillslot(frame, slot->size, slot->po2align);
+	}
+
 	for (size_t s = 0; s < spillcount; ++s) {
 		const spill_t *spill  = spills[s];
 		ir_node       *node   = spill->spill;
 		int            slotid = spill->spillslot;
 		spill_slot_t  *slot   = &spillslots[slotid];
 
-		if (slot->entity == NULL)
-			slot->entity = new_spillslot(frame, slot->size, slot->po2align);
-
 		if (is_Phi(node)) {
 			ir_node *block = get_nodes_block(node);
 
@@ -460,10 +578,7 @@ static void assign_spillslots(be_fec_env_t *env)
 				int      argslotid = argspill->spillslot;
 
 				if (slotid != argslotid) {
-					spill_slot_t *argslot = &spillslots[argslotid];
-					if (argslot->entity == NULL)
-						argslot->entity = new_spillslot(frame, argslot->size,
-						                                argslot->po2align);
+					spill_slot_t const *const argslot = &spillslots[argslotid];
 
 					memperm_t *const memperm = get_memperm(env, predblock);
 					memperm_entry_t *const entry
@@ -594,7 +709,7 @@ void be_assign_entities(be_fec_env_t *env,
 	 * our control flow graph isn't completely correct: There are no backedges
 	 * from longjmp to the setjmp => coalescing would produce wrong results. */
 	if (be_coalesce_spill_slots && !be_birg_from_irg(env->irg)->has_returns_twice_call)
-		do_greedy_coalescing(env);
+		color_spillslots(env);
 
 	if (stat_ev_enabled)
 		stat_ev_dbl("spillslots_after_coalescing", count_spillslots(env));
@@ -16,6 +16,7 @@
 #include "bearch.h"
 #include "bechordal_t.h"
 #include "beirg.h"
+#include "belive.h"
 #include "bemodule.h"
 #include "benode.h"
 #include "besched.h"
@@ -74,9 +75,25 @@ struct spill_info_t {
 	                                the value of the Phi gets spilled */
 };
 
+/**
+ * Part of a block where a value of a register class without register
+ * allocation (usually the flags) is live.
+ */
+typedef struct manual_range_t manual_range_t;
+struct manual_range_t {
+	manual_range_t *next;
+	ir_node const  *def;      /**< definition, NULL if live at block start */
+	ir_node const  *last_use; /**< last use, NULL if live at block end */
+};
+
+typedef struct block_ranges_t {
+	manual_range_t *first;
+} block_ranges_t;
+
 struct spill_env_t {
 	ir_graph         *irg;
 	ir_nodehashmap_t  spillmap;
+	ir_nodehashmap_t  manual_ranges; /**< maps blocks to block_ranges_t */
 	spill_info_t     *spills;
 	spill_info_t     *mem_phis;
 	struct obstack    obst;
@@ -113,6 +130,7 @@ spill_env_t *be_new_spill_env(ir_graph *irg, const regalloc_if_t *regif)
 	env->irg         = irg;
 	env->regif       = *regif;
 	ir_nodehashmap_init(&env->spillmap);
+	ir_nodehashmap_init(&env->manual_ranges);
 	obstack_init(&env->obst);
 	return env;
 }
@@ -120,6 +138,7 @@ spill_env_t *be_new_spill_env(ir_graph *irg, const regalloc_if_t *regif)
 void be_delete_spill_env(spill_env_t *env)
 {
 	ir_nodehashmap_destroy(&env->spillmap);
+	ir_nodehashmap_destroy(&env->manual_ranges);
 	obstack_free(&env->obst, NULL);
 	free(env);
 }
@@ -326,11 +345,124 @@ static void spill_node(spill_env_t *env, spill_info_t *spillinfo)
 	}
 }
 
+static bool is_manual_value(const ir_node *const value)
+{
+	const arch_register_req_t *const req = arch_get_irn_register_req(value);
+	return req->cls != NULL && req->cls->manual_ra;
+}
+
+static void add_manual_range(spill_env_t *const env,
+                             block_ranges_t *const ranges,
+                             const ir_node *const def,
+                             const ir_node *const last_use)
+{
+	manual_range_t *const range = OALLOC(&env->obst, manual_range_t);
+	range->next     = ranges->first;
+	range->def      = def;
+	range->last_use = last_use;
+	ranges->first   = range;
+}
+
+/**
+ * Returns the live ranges of the values without register allocation in
+ * @p block. Remats do not use or define such values, so the ranges stay valid
+ * while spills and reloads are inserted.
+ */
+static block_ranges_t *get_manual_ranges(spill_env_t *const env,
+                                         ir_node *const block)
+{
+	block_ranges_t *ranges
+		= ir_nodehashmap_get(block_ranges_t, &env->manual_ranges, block);
+	if (ranges != NULL)
+		return ranges;
+
+	ranges = OALLOCZ(&env->obst, block_ranges_t);
+	ir_nodehashmap_insert(&env->manual_ranges, block, ranges);
+
+	/* values passing through the block */
+	const be_lv_t *const lv = be_get_irg_liveness(env->irg);
+	if (lv->sets_valid) {
+		be_lv_foreach(lv, block, be_lv_state_end, value) {
+			if (is_manual_value(value) && get_nodes_block(value) != block)
+				add_manual_range(env, ranges, NULL, NULL);
+		}
+	}
+
+	sched_foreach(block, node) {
+		if (!is_Phi(node)) {
+			foreach_irn_in(node, i, op) {
+				if (is_manual_value(op) && get_nodes_block(op) != block)
+					add_manual_range(env, ranges, NULL, node);
+			}
+		}
+		be_foreach_value(node, value,
+			if (!is_manual_value(value))
+				continue;
+			const ir_node *last_use = node;
+			foreach_out_edge(value, edge) {
+				ir_node *const user = get_edge_src_irn(edge);
+				if (is_Phi(user) || get_block_const(user) != block) {
+					last_use = NULL;
+					break;
+				}
+				if (sched_is_scheduled(user) && sched_comes_before(last_use, user))
+					last_use = user;
+			}
+			add_manual_range(env, ranges, node, last_use);
+		);
+	}
+	return ranges;
+}
+
+/**
+ * Tests whether a value without register allocation (usually the flags) is
+ * live immediately before @p before.
+ */
+static bool is_manual_value_live_before(spill_env_t *const env,
+                                        const ir_node *const before)
+{
+	/* cost queries may refer to whole blocks */
+	if (is_Block(before))
+		return true;
+	block_ranges_t const *const ranges
+		= get_manual_ranges(env, get_nodes_block(before));
+	for (manual_range_t const *r = ranges->first; r != NULL; r = r->next) {
+		if (r->def != NULL && !sched_comes_before(r->def, before))
+			continue;
+		if (r->last_use != NULL && sched_comes_before(r->last_use, before))
+			continue;
+		return true;
+	}
+	return false;
+}
+
+/**
+ * Tests whether @p value is live immediately before @p before.
+ */
+static bool is_live_before(const ir_node *const value,
+                           const ir_node *const before)
+{
+	if (is_Block(before) || !value_strictly_dominates(value, before))
+		return false;
+	const ir_node *const block = get_nodes_block(before);
+	const be_lv_t *const lv    = be_get_irg_liveness(get_irn_irg(before));
+	if (be_is_live_end(lv, block, value))
+		return true;
+	foreach_out_edge(value, edge) {
+		const ir_node *const user = get_edge_src_irn(edge);
+		if (get_nodes_block(user) == block && !is_Phi(user)
+		    && sched_is_scheduled(user) && !sched_comes_before(user, before))
+			return true;
+	}
+	return false;
+}
+
 /**
  * Tests whether value @p arg is available before node @p reloader
  * @returns true if value is available
  */
-static bool is_value_available(spill_env_t *env, const ir_node *arg)
+static bool is_value_available(spill_env_t *env, const ir_node *arg,
+                               const ir_node *reloader)
 {
 	if (is_Unknown(arg) || is_NoMem(arg))
 		return true;
@@ -344,14 +476,22 @@ static bool is_value_available(spill_env_t *env, const ir_node *arg)
 	if (arch_irn_is_ignore(arg))
 		return true;
 
-	return false;
+	/* A value which is live at the reloader and never spilled is in a
+	 * register there, using it does not extend its live range. */
+	if (is_manual_value(arg)
+	    || ir_nodehashmap_get(spill_info_t, &env->spillmap, arg) != NULL)
+		return false;
+	return is_live_before(arg, reloader);
 }
 
 /**
  * Check if a node is rematerializable. This tests for the following conditions:
  *
  * - The node itself is rematerializable
- * - All arguments of the node are available or also rematerialisable
+ * - All arguments of the node are available or also rematerialisable. Values
+ *   live at the reloader count as available, so expression chains on live
+ *   operands are recomputed
+ * - The node does not modify the flags while they are live at the reloader
  * - The costs for the rematerialisation operation is less or equal a limit
  *
  * Returns the costs needed for rematerialisation or something
@@ -373,16 +513,15 @@ static int check_remat_conditions_costs(spill_env_t *env,
 	if (parentcosts + costs >= spillcosts)
 		return REMAT_COST_INFINITE;
 
-	/* never rematerialize a node which modifies the flags.
-	 * (would be better to test whether the flags are actually live at point
-	 * reloader...)
-	 */
-	if (arch_irn_is(insn, modify_flags))
+	/* never rematerialize a node which modifies the flags while they are
+	 * live */
+	if (arch_irn_is(insn, modify_flags)
+	    && is_manual_value_live_before(env, reloader))
 		return REMAT_COST_INFINITE;
 
 	int argremats = 0;
 	foreach_irn_in(insn, i, arg) {
-		if (is_value_available(env, arg))
+		if (is_value_available(env, arg, reloader))
 			continue;
 
 		/* we have to rematerialize the argument as well */
@@ -413,7 +552,7 @@ static ir_node *do_remat(spill_env_t *env, ir_node *spilled, ir_node *reloader)
 {
 	ir_node **ins = ALLOCAN(ir_node*, get_irn_arity(spilled));
 	foreach_irn_in(spilled, i, arg) {
-		if (is_value_available(env, arg)) {
+		if (is_value_available(env, arg, reloader)) {
 			ins[i] = arg;
 		} else {
 			ins[i] = do_remat(env, arg, reloader);
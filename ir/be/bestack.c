@@ -21,12 +21,15 @@
 #include "benode.h"
 #include "besched.h"
 #include "bessaconstr.h"
+#include "execfreq.h"
 #include "ircons_t.h"
 #include "iredges_t.h"
 #include "irgmod.h"
 #include "irgwalk.h"
 #include "irnode_t.h"
 #include "util.h"
+#include "xmalloc.h"
+#include <math.h>
 
 static unsigned round_up2_misaligned(unsigned const offset,
                                      unsigned const alignment,
@@ -203,12 +206,110 @@ static int cmp_slots_first(void const *const p0, void const *const p1)
 	return QSORT_CMP(e0->nr, e1->nr);
 }
 
-void be_sort_frame_entities(ir_type *const frame, bool spillslots_first)
+typedef struct frame_access_env_t {
+	ir_type              *frame;
+	get_frame_entity_func get_frame_entity;
+} frame_access_env_t;
+
+static void add_frame_access(frame_access_env_t const *const env,
+                             ir_entity *const entity, ir_node const *const node)
+{
+	if (entity == NULL || get_entity_owner(entity) != env->frame)
+		return;
+	double *const freq = (double*)get_entity_link(entity);
+	*freq += get_block_execfreq(get_nodes_block(node));
+}
+
+static void count_frame_accesses(ir_node *node, void *data)
+{
+	frame_access_env_t const *const env = (frame_access_env_t const*)data;
+	if (be_is_MemPerm(node)) {
+		for (unsigned i = 0, n = be_get_MemPerm_entity_arity(node); i < n; ++i) {
+			add_frame_access(env, be_get_MemPerm_in_entity(node, i), node);
+			add_frame_access(env, be_get_MemPerm_out_entity(node, i), node);
+		}
+	} else {
+		add_frame_access(env, env->get_frame_entity(node), node);
+	}
+}
+
+/**
+ * Returns the frequency class of an entity. Entities in the same class are
+ * considered equally hot.
+ */
+static int get_freq_class(ir_entity const *const entity)
+{
+	double const freq = *(double const*)get_entity_link(entity);
+	return freq > 0 ? ilogb(freq) : INT_MIN;
+}
+
+static unsigned get_frame_member_alignment(ir_entity const *const member)
+{
+	unsigned const alignment = get_entity_alignment(member);
+	if (member->kind == IR_ENTITY_SPILLSLOT)
+		return alignment;
+	return MAX(alignment, get_type_alignment(get_entity_type(member)));
+}
+
+static int cmp_freq_packed(ir_entity const *const e0, ir_entity const *const e1)
+{
+	unsigned const a0 = get_frame_member_alignment(e0);
+	unsigned const a1 = get_frame_member_alignment(e1);
+	if (a0 != a1)
+		return a0 < a1 ? 1 : -1;
+	return cmp_slots_first(&e0, &e1);
+}
+
+static int cmp_hot_first(void const *const p0, void const *const p1)
+{
+	ir_entity const *const e0 = *(ir_entity const**)p0;
+	ir_entity const *const e1 = *(ir_entity const**)p1;
+	int const c0 = get_freq_class(e0);
+	int const c1 = get_freq_class(e1);
+	if (c0 != c1)
+		return c0 < c1 ? 1 : -1;
+	return cmp_freq_packed(e0, e1);
+}
+
+static int cmp_hot_last(void const *const p0, void const *const p1)
 {
+	ir_entity const *const e0 = *(ir_entity const**)p0;
+	ir_entity const *const e1 = *(ir_entity const**)p1;
+	int const c0 = get_freq_class(e0);
+	int const c1 = get_freq_class(e1);
+	if (c0 != c1)
+		return c0 < c1 ? -1 : 1;
+	return cmp_freq_packed(e0, e1);
+}
+
+void be_sort_frame_entities(ir_graph *const irg, bool const spillslots_first,
+                            get_frame_entity_func const get_frame_entity)
+{
+	ir_type *const frame     = get_irg_frame_type(irg);
 	unsigned const n_members = get_compound_n_members(frame);
 	assert(is_compound_type(frame));
+	if (get_frame_entity == NULL) {
+		QSORT(frame->attr.compound.members, n_members,
+		      spillslots_first ? cmp_slots_first : cmp_slots_last);
+		return;
+	}
+
+	double *const freqs = XMALLOCNZ(double, n_members);
+	irp_reserve_resources(irp, IRP_RESOURCE_ENTITY_LINK);
+	for (unsigned i = 0; i < n_members; ++i)
+		set_entity_link(get_compound_member(frame, i), &freqs[i]);
+
+	frame_access_env_t env = {
+		.frame            = frame,
+		.get_frame_entity = get_frame_entity,
+	};
+	irg_walk_graph(irg, NULL, count_frame_accesses, &env);
+
+	/* The stack pointer is below the last member. */
 	QSORT(frame->attr.compound.members, n_members,
-		  spillslots_first ? cmp_slots_first : cmp_slots_last);
+	      spillslots_first ? cmp_hot_last : cmp_hot_first);
+	irp_free_resources(irp, IRP_RESOURCE_ENTITY_LINK);
+	free(freqs);
 }
 
 void be_layout_frame_type(ir_type *const frame, int const begin,
@@ -227,16 +328,10 @@ void be_layout_frame_type(ir_type *const frame, int const begin,
 		}
 		assert(get_entity_bitfield_size(member) == 0);
 
-		unsigned size;
-		unsigned alignment = get_entity_alignment(member);
-		if (member->kind == IR_ENTITY_SPILLSLOT) {
-			size = member->attr.spillslot.size;
-		} else {
-			ir_type const *const type           = get_entity_type(member);
-			unsigned       const type_alignment = get_type_alignment(type);
-			size      = get_type_size(type);
-			alignment = MAX(alignment, type_alignment);
-		}
+		unsigned const size = member->kind == IR_ENTITY_SPILLSLOT
+			? member->attr.spillslot.size
+			: get_type_size(get_entity_type(member));
+		unsigned const alignment = get_frame_member_alignment(member);
 
 		offset -= size;
 		offset  = -round_up2_misaligned(-offset, alignment, misalign);
@@ -245,3 +340,14 @@ void be_layout_frame_type(ir_type *const frame, int const begin,
 	set_type_size(frame, -(offset-begin));
 	set_type_state(frame, layout_fixed);
 }
+
+unsigned be_get_frame_alignment(ir_type const *const frame)
+{
+	unsigned alignment = 1;
+	for (unsigned i = 0, n_members = get_compound_n_members(frame);
+	     i < n_members; ++i) {
+		ir_entity const *const member = get_compound_member(frame, i);
+		alignment = MAX(alignment, get_frame_member_alignment(member));
+	}
+	return alignment;
+}
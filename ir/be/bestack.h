@@ -52,6 +52,22 @@ void be_sim_stack_pointer(ir_graph *irg, unsigned misalign, unsigned p2align,
  */
 void be_layout_frame_type(ir_type *frame, int begin, unsigned misalign);
 
-void be_sort_frame_entities(ir_type *const frame, bool spillslots_first);
+/**
+ * Returns the alignment required by the members of the frame type @p frame.
+ */
+unsigned be_get_frame_alignment(ir_type const *frame);
+
+/**
+ * Sorts the members of the frame type of @p irg for be_layout_frame_type().
+ * Without @p get_frame_entity the spill slots are grouped before or after the
+ * other entities. Otherwise the entities are ordered by their execution
+ * frequency weighted access counts: The hottest entities are placed next to
+ * the base register (the stack pointer if @p spillslots_first is set, the
+ * frame pointer otherwise), so they get short displacements and share cache
+ * lines. Entities of similar frequency are ordered by decreasing alignment to
+ * avoid padding.
+ */
+void be_sort_frame_entities(ir_graph *irg, bool spillslots_first,
+                            get_frame_entity_func get_frame_entity);
 
 #endif
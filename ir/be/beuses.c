@@ -12,9 +12,11 @@
 #include "beuses.h"
 
 #include "be_t.h"
+#include "bearch.h"
 #include "belive.h"
 #include "benode.h"
 #include "besched.h"
+#include "beutil.h"
 #include "debug.h"
 #include "ircons_t.h"
 #include "irdom_t.h"
@@ -40,13 +42,38 @@ typedef struct be_use_t {
 	ir_visited_t   visited;
 } be_use_t;
 
+/**
+ * The precomputed next use of a value live-in at a block.
+ */
+typedef struct next_use_entry_t {
+	const ir_node *value;
+	const ir_node *before;         /**< the next use */
+	unsigned       time;           /**< distance from the block start */
+	unsigned       outermost_loop;
+	bool           local;          /**< the next use is in the block itself */
+} next_use_entry_t;
+
+/**
+ * The next uses of all values of the register class live-in at a block,
+ * sorted by the index of the values.
+ */
+typedef struct block_uses_t {
+	next_use_entry_t *entries;
+	size_t            n_entries;
+} block_uses_t;
+
 /**
  * The "uses" environment.
  */
 struct be_uses_t {
 	set           *uses; /**< cache: contains all computed uses so far. */
 	const be_lv_t *lv;   /**< the liveness for the graph. */
+	ir_graph      *irg;
 	ir_visited_t   visited_counter; /**< current search counter. */
+	const arch_register_class_t *cls; /**< class of the precomputed tables */
+	block_uses_t  *tables;   /**< next-use tables indexed by block index */
+	unsigned       n_tables;
+	struct obstack obst;
 };
 
 /**
@@ -158,6 +185,47 @@ static inline void set_step(ir_node *node, unsigned step)
 	set_irn_link(node, INT_TO_PTR(step));
 }
 
+/**
+ * Returns the penalty for leaving the loop of @p block to @p succ_block.
+ */
+static unsigned get_loop_exit_penalty(const ir_node *block,
+                                      const ir_node *succ_block)
+{
+	unsigned depth      = get_loop_depth(get_irn_loop(block));
+	unsigned succ_depth = get_loop_depth(get_irn_loop(succ_block));
+	if (succ_depth >= depth)
+		return 0;
+	// TODO we should use the number of nodes in the loop or so...
+	return (depth - succ_depth) * 5000;
+}
+
+static int cmp_entry_value(const void *a, const void *b)
+{
+	const next_use_entry_t *p = (const next_use_entry_t*)a;
+	const next_use_entry_t *q = (const next_use_entry_t*)b;
+	return QSORT_CMP(get_irn_idx(p->value), get_irn_idx(q->value));
+}
+
+/**
+ * Returns the precomputed next use of @p def at the start of @p block or NULL
+ * if @p def is not live-in at @p block.
+ */
+static const next_use_entry_t *find_next_use_entry(const be_uses_t *env,
+                                                   const ir_node *block,
+                                                   const ir_node *def)
+{
+	unsigned const idx = get_irn_idx(block);
+	if (idx >= env->n_tables)
+		return NULL;
+	block_uses_t const *const table = &env->tables[idx];
+	next_use_entry_t key;
+	key.value = def;
+	return (const next_use_entry_t*)bsearch(&key, table->entries,
+	                                        table->n_entries,
+	                                        sizeof(*table->entries),
+	                                        cmp_entry_value);
+}
+
 /**
  * Find the next use of a value defined by def, starting at node from.
  *
@@ -222,10 +290,29 @@ static be_next_use_t get_next_use(be_uses_t *const env, ir_node *const from,
 	bool      found_use      = false;
 	unsigned  outermost_loop = loopdepth;
 	unsigned  next_use       = USES_INFINITY;
+	bool      use_tables     = env->tables != NULL
+	                        && arch_irn_consider_in_reg_alloc(env->cls, def);
 	foreach_block_succ(block, edge) {
 		const ir_node *succ_block = get_edge_src_irn(edge);
 		DBG((dbg, LEVEL_5, "Checking succ of block %+F: %+F (for use of %+F)\n",
 		     block, succ_block, def));
+		if (use_tables) {
+			const next_use_entry_t *entry
+				= find_next_use_entry(env, succ_block, def);
+			if (entry == NULL || USES_IS_INFINITE(entry->time))
+				continue;
+
+			found_use = true;
+			unsigned use_dist = entry->time
+			                  + get_loop_exit_penalty(block, succ_block);
+			if (use_dist < next_use) {
+				next_use       = use_dist;
+				outermost_loop = entry->outermost_loop;
+				result.before  = entry->before;
+			}
+			continue;
+		}
+
 		if (!be_is_live_in(env->lv, succ_block, def)) {
 			//next_use = USES_INFINITY;
 			DBG((dbg, LEVEL_5, "   not live in\n"));
@@ -243,17 +330,8 @@ static be_next_use_t get_next_use(be_uses_t *const env, ir_node *const from,
 		}
 
 		found_use = true;
-		unsigned use_dist = use->next_use;
-
-		ir_loop *succ_loop = get_irn_loop(succ_block);
-		if (get_loop_depth(succ_loop) < loopdepth) {
-			unsigned factor = (loopdepth - get_loop_depth(succ_loop)) * 5000;
-			DBG((dbg, LEVEL_5,
-			     "Increase usestep because of loop out edge %d -> %d (%u)\n",
-			     factor));
-			// TODO we should use the number of nodes in the loop or so...
-			use_dist += factor;
-		}
+		unsigned use_dist = use->next_use
+		                  + get_loop_exit_penalty(block, succ_block);
 
 		if (use_dist < next_use) {
 			next_use       = use_dist;
@@ -305,6 +383,133 @@ static void set_sched_step_walker(ir_node *block, void *data)
 	}
 }
 
+/**
+ * Computes the next use of @p value inside of @p block, which is either a
+ * non-Phi user or the use as Phi argument at the end of the block. Returns
+ * false if there is none.
+ */
+static bool get_local_next_use(const ir_node *block, const ir_node *value,
+                               next_use_entry_t *entry)
+{
+	const ir_node *use  = NULL;
+	unsigned       step = UINT_MAX;
+	foreach_out_edge(value, edge) {
+		ir_node *node = get_edge_src_irn(edge);
+		if (is_Anchor(node) || is_Phi(node) || get_nodes_block(node) != block)
+			continue;
+
+		unsigned node_step = get_step(node);
+		if (node_step < step) {
+			use  = node;
+			step = node_step;
+		}
+	}
+
+	if (use == NULL && be_is_phi_argument(block, value)) {
+		use  = block;
+		step = get_step(sched_last(block)) + 1;
+	}
+	if (use == NULL)
+		return false;
+
+	entry->before         = use;
+	entry->time           = step;
+	entry->outermost_loop = get_loop_depth(get_irn_loop(block));
+	return true;
+}
+
+/**
+ * Recomputes the next use of the non-local entry @p entry of @p block from
+ * the tables of the successor blocks.
+ * Returns true if the distance decreased.
+ */
+static bool update_next_use_entry(const be_uses_t *env, const ir_node *block,
+                                  next_use_entry_t *entry)
+{
+	unsigned       loopdepth      = get_loop_depth(get_irn_loop(block));
+	unsigned       next_use       = USES_INFINITY;
+	unsigned       outermost_loop = loopdepth;
+	const ir_node *before         = NULL;
+	foreach_block_succ(block, edge) {
+		const ir_node          *succ_block = get_edge_src_irn(edge);
+		const next_use_entry_t *succ
+			= find_next_use_entry(env, succ_block, entry->value);
+		if (succ == NULL || USES_IS_INFINITE(succ->time))
+			continue;
+
+		unsigned use_dist = succ->time + get_loop_exit_penalty(block, succ_block);
+		if (use_dist < next_use) {
+			next_use       = use_dist;
+			outermost_loop = succ->outermost_loop;
+			before         = succ->before;
+		}
+	}
+	if (USES_IS_INFINITE(next_use))
+		return false;
+
+	unsigned time = next_use + get_step(sched_last(block)) + 1;
+	if (time >= entry->time)
+		return false;
+
+	entry->time           = time;
+	entry->outermost_loop = MIN(outermost_loop, loopdepth);
+	entry->before         = before;
+	return true;
+}
+
+void be_precompute_next_uses(be_uses_t *env, const arch_register_class_t *cls)
+{
+	ir_graph  *irg    = env->irg;
+	ir_node  **blocks = be_get_cfgpostorder(irg);
+	size_t     n      = ARR_LEN(blocks);
+
+	env->cls      = cls;
+	env->n_tables = get_irg_last_idx(irg);
+	env->tables   = OALLOCNZ(&env->obst, block_uses_t, env->n_tables);
+
+	/* collect the live-in values and their uses inside of the blocks */
+	for (size_t i = 0; i < n; ++i) {
+		ir_node *block    = blocks[i];
+		size_t   n_values = 0;
+		be_lv_foreach_cls(env->lv, block, be_lv_state_in, cls, value) {
+			++n_values;
+		}
+
+		block_uses_t *table = &env->tables[get_irn_idx(block)];
+		table->entries   = OALLOCN(&env->obst, next_use_entry_t, n_values);
+		table->n_entries = n_values;
+
+		size_t v = 0;
+		be_lv_foreach_cls(env->lv, block, be_lv_state_in, cls, value) {
+			next_use_entry_t *entry = &table->entries[v++];
+			entry->value          = value;
+			entry->before         = NULL;
+			entry->time           = USES_INFINITY;
+			entry->outermost_loop = get_loop_depth(get_irn_loop(block));
+			entry->local          = get_local_next_use(block, value, entry);
+		}
+		QSORT(table->entries, n_values, cmp_entry_value);
+	}
+
+	/* propagate the distances backwards until a fixpoint is reached, the
+	 * distances only decrease */
+	bool changed;
+	do {
+		changed = false;
+		for (size_t i = 0; i < n; ++i) {
+			ir_node      *block = blocks[i];
+			block_uses_t *table = &env->tables[get_irn_idx(block)];
+			for (size_t e = 0; e < table->n_entries; ++e) {
+				next_use_entry_t *entry = &table->entries[e];
+				if (!entry->local)
+					changed |= update_next_use_entry(env, block, entry);
+			}
+		}
+	} while (changed);
+
+	DEL_ARR_F(blocks);
+}
+
 be_uses_t *be_begin_uses(ir_graph *irg, const be_lv_t *lv)
 {
 	FIRM_DBG_REGISTER(dbg, "firm.be.uses");
@@ -317,6 +522,8 @@ be_uses_t *be_begin_uses(ir_graph *irg, const be_lv_t *lv)
 	be_uses_t *env = XMALLOCZ(be_uses_t);
 	env->uses = new_set(cmp_use, 512);
 	env->lv   = lv;
+	env->irg  = irg;
+	obstack_init(&env->obst);
 
 	return env;
 }
@@ -324,5 +531,6 @@ be_uses_t *be_begin_uses(ir_graph *irg, const be_lv_t *lv)
 void be_end_uses(be_uses_t *env)
 {
 	del_set(env->uses);
+	obstack_free(&env->obst, NULL);
 	free(env);
 }
@@ -22,7 +22,9 @@
 typedef struct be_next_use_t {
 	unsigned       time;
 	unsigned       outermost_loop;
-	/* point of the next use is at the beginning of this node. */
+	/* point of the next use is at the beginning of this node. For a use in
+	 * a later block this is the value itself, unless the next uses were
+	 * precomputed, see be_precompute_next_uses(). */
 	const ir_node *before;
 } be_next_use_t;
 
@@ -52,6 +54,22 @@ be_next_use_t be_get_next_use(be_uses_t *uses, ir_node *from,
  */
 be_uses_t *be_begin_uses(ir_graph *irg, const be_lv_t *lv);
 
+/**
+ * Precomputes the next-use distances of all values of register class @p cls
+ * at the block entries with a backward dataflow analysis. Afterwards
+ * be_get_next_use() looks up the distances of these values across blocks
+ * in per-block tables instead of searching the successor blocks.
+ * The schedule must not change while the tables are used.
+ *
+ * With the tables, the @c before field of a next use in a later block is
+ * the using node, or the block for a Phi argument, instead of the value
+ * itself.
+ *
+ * @param uses  the environment
+ * @param cls   the register class
+ */
+void be_precompute_next_uses(be_uses_t *uses, const arch_register_class_t *cls);
+
 /**
  * Destroys the given uses environment.
  *
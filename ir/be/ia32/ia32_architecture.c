@@ -75,6 +75,7 @@ typedef enum cpu_arch_features {
 	arch_feature_sse4_2   = 0x02000000, /**< SSE4.2 instructions */
 	arch_feature_sse4a    = 0x04000000, /**< SSE4a instructions */
 	arch_feature_popcnt   = 0x08000000, /**< popcnt instruction */
+	arch_feature_tsc      = 0x10000000, /**< rdtsc instruction */
 
 	arch_mmx_insn     = arch_feature_mmx,                         /**< MMX instructions */
 	arch_sse1_insn    = arch_feature_sse1   | arch_mmx_insn,      /**< SSE1 instructions, include MMX */
@@ -94,44 +95,44 @@ typedef enum cpu_arch_features {
 	/* intel CPUs */
 	cpu_i386                = arch_i386,
 	cpu_i486                = arch_i486,
-	cpu_pentium             = arch_pentium,
-	cpu_pentium_mmx         = arch_pentium | arch_mmx_insn,
-	cpu_pentium_pro_generic = arch_ppro | arch_feature_p6_insn,
-	cpu_pentium_pro         = arch_ppro | arch_feature_cmov | arch_feature_p6_insn,
-	cpu_pentium_2           = arch_ppro | arch_feature_cmov | arch_feature_p6_insn | arch_mmx_insn,
-	cpu_pentium_3           = arch_ppro | arch_feature_cmov | arch_feature_p6_insn | arch_sse1_insn,
-	cpu_pentium_m           = arch_ppro | arch_feature_cmov | arch_feature_p6_insn | arch_sse2_insn,
-	cpu_netburst_generic    = arch_netburst | arch_feature_p6_insn,
-	cpu_pentium_4           = arch_netburst | arch_feature_cmov | arch_feature_p6_insn | arch_sse2_insn,
-	cpu_prescott            = arch_nocona | arch_feature_cmov | arch_feature_p6_insn | arch_sse3_insn,
-	cpu_nocona              = arch_nocona | arch_feature_cmov | arch_feature_p6_insn | arch_64bit_insn | arch_sse3_insn,
-	cpu_core2_generic       = arch_core2 | arch_feature_p6_insn,
-	cpu_core2               = arch_core2 | arch_feature_cmov | arch_feature_p6_insn | arch_64bit_insn | arch_ssse3_insn,
-	cpu_penryn              = arch_core2 | arch_feature_cmov | arch_feature_p6_insn | arch_64bit_insn | arch_sse4_1_insn,
-	cpu_atom_generic        = arch_atom | arch_feature_p6_insn,
-	cpu_atom                = arch_atom | arch_feature_cmov | arch_feature_p6_insn | arch_ssse3_insn,
+	cpu_pentium             = arch_pentium | arch_feature_tsc,
+	cpu_pentium_mmx         = arch_pentium | arch_mmx_insn | arch_feature_tsc,
+	cpu_pentium_pro_generic = arch_ppro | arch_feature_p6_insn | arch_feature_tsc,
+	cpu_pentium_pro         = arch_ppro | arch_feature_cmov | arch_feature_p6_insn | arch_feature_tsc,
+	cpu_pentium_2           = arch_ppro | arch_feature_cmov | arch_feature_p6_insn | arch_mmx_insn | arch_feature_tsc,
+	cpu_pentium_3           = arch_ppro | arch_feature_cmov | arch_feature_p6_insn | arch_sse1_insn | arch_feature_tsc,
+	cpu_pentium_m           = arch_ppro | arch_feature_cmov | arch_feature_p6_insn | arch_sse2_insn | arch_feature_tsc,
+	cpu_netburst_generic    = arch_netburst | arch_feature_p6_insn | arch_feature_tsc,
+	cpu_pentium_4           = arch_netburst | arch_feature_cmov | arch_feature_p6_insn | arch_sse2_insn | arch_feature_tsc,
+	cpu_prescott            = arch_nocona | arch_feature_cmov | arch_feature_p6_insn | arch_sse3_insn | arch_feature_tsc,
+	cpu_nocona              = arch_nocona | arch_feature_cmov | arch_feature_p6_insn | arch_64bit_insn | arch_sse3_insn | arch_feature_tsc,
+	cpu_core2_generic       = arch_core2 | arch_feature_p6_insn | arch_feature_tsc,
+	cpu_core2               = arch_core2 | arch_feature_cmov | arch_feature_p6_insn | arch_64bit_insn | arch_ssse3_insn | arch_feature_tsc,
+	cpu_penryn              = arch_core2 | arch_feature_cmov | arch_feature_p6_insn | arch_64bit_insn | arch_sse4_1_insn | arch_feature_tsc,
+	cpu_atom_generic        = arch_atom | arch_feature_p6_insn | arch_feature_tsc,
+	cpu_atom                = arch_atom | arch_feature_cmov | arch_feature_p6_insn | arch_ssse3_insn | arch_feature_tsc,
 
 	/* AMD CPUs */
-	cpu_k6_generic     = arch_k6,
-	cpu_k6             = arch_k6 | arch_mmx_insn,
-	cpu_k6_PLUS        = arch_k6 | arch_3DNow_insn,
-	cpu_geode_generic  = arch_geode,
-	cpu_geode          = arch_geode  | arch_sse1_insn | arch_3DNowE_insn,
-	cpu_athlon_generic = arch_athlon | arch_feature_p6_insn,
-	cpu_athlon_old     = arch_athlon | arch_3DNowE_insn | arch_feature_cmov | arch_feature_p6_insn,
-	cpu_athlon         = arch_athlon | arch_sse1_insn | arch_3DNowE_insn | arch_feature_cmov | arch_feature_p6_insn,
-	cpu_athlon64       = arch_athlon | arch_sse2_insn | arch_3DNowE_insn | arch_feature_cmov | arch_feature_p6_insn | arch_64bit_insn,
-	cpu_k8_generic     = arch_k8  | arch_feature_p6_insn,
-	cpu_k8             = arch_k8  | arch_3DNowE_insn | arch_feature_cmov | arch_feature_p6_insn | arch_64bit_insn,
-	cpu_k8_sse3        = arch_k8  | arch_3DNowE_insn | arch_feature_cmov | arch_feature_p6_insn | arch_64bit_insn | arch_sse3_insn,
-	cpu_k10_generic    = arch_k10 | arch_feature_p6_insn,
-	cpu_k10            = arch_k10 | arch_3DNowE_insn | arch_feature_cmov | arch_feature_p6_insn | arch_feature_popcnt | arch_64bit_insn | arch_sse4a_insn,
+	cpu_k6_generic     = arch_k6 | arch_feature_tsc,
+	cpu_k6             = arch_k6 | arch_mmx_insn | arch_feature_tsc,
+	cpu_k6_PLUS        = arch_k6 | arch_3DNow_insn | arch_feature_tsc,
+	cpu_geode_generic  = arch_geode | arch_feature_tsc,
+	cpu_geode          = arch_geode  | arch_sse1_insn | arch_3DNowE_insn | arch_feature_tsc,
+	cpu_athlon_generic = arch_athlon | arch_feature_p6_insn | arch_feature_tsc,
+	cpu_athlon_old     = arch_athlon | arch_3DNowE_insn | arch_feature_cmov | arch_feature_p6_insn | arch_feature_tsc,
+	cpu_athlon         = arch_athlon | arch_sse1_insn | arch_3DNowE_insn | arch_feature_cmov | arch_feature_p6_insn | arch_feature_tsc,
+	cpu_athlon64       = arch_athlon | arch_sse2_insn | arch_3DNowE_insn | arch_feature_cmov | arch_feature_p6_insn | arch_64bit_insn | arch_feature_tsc,
+	cpu_k8_generic     = arch_k8  | arch_feature_p6_insn | arch_feature_tsc,
+	cpu_k8             = arch_k8  | arch_3DNowE_insn | arch_feature_cmov | arch_feature_p6_insn | arch_64bit_insn | arch_feature_tsc,
+	cpu_k8_sse3        = arch_k8  | arch_3DNowE_insn | arch_feature_cmov | arch_feature_p6_insn | arch_64bit_insn | arch_sse3_insn | arch_feature_tsc,
+	cpu_k10_generic    = arch_k10 | arch_feature_p6_insn | arch_feature_tsc,
+	cpu_k10            = arch_k10 | arch_3DNowE_insn | arch_feature_cmov | arch_feature_p6_insn | arch_feature_popcnt | arch_64bit_insn | arch_sse4a_insn | arch_feature_tsc,
 
 	/* other CPUs */
-	cpu_winchip_c6  = arch_i486 | arch_feature_mmx,
-	cpu_winchip2    = arch_i486 | arch_feature_mmx | arch_feature_3DNow,
-	cpu_c3          = arch_i486 | arch_feature_mmx | arch_feature_3DNow,
-	cpu_c3_2        = arch_ppro | arch_feature_cmov | arch_feature_p6_insn | arch_sse1_insn, /* really no 3DNow! */
+	cpu_winchip_c6  = arch_i486 | arch_feature_mmx | arch_feature_tsc,
+	cpu_winchip2    = arch_i486 | arch_feature_mmx | arch_feature_3DNow | arch_feature_tsc,
+	cpu_c3          = arch_i486 | arch_feature_mmx | arch_feature_3DNow | arch_feature_tsc,
+	cpu_c3_2        = arch_ppro | arch_feature_cmov | arch_feature_p6_insn | arch_sse1_insn | arch_feature_tsc, /* really no 3DNow! */
 
 	cpu_autodetect  = 0,
 } cpu_arch_features;
@@ -840,6 +841,8 @@ static void autodetect_arch(void)
 			auto_arch = cpu_geode_generic;
 		}
 
+		if (cpu_info.edx_features & CPUID_FEAT_EDX_TSC)
+			auto_arch |= arch_feature_tsc;
 		if (cpu_info.edx_features & CPUID_FEAT_EDX_CMOV)
 			auto_arch |= arch_feature_cmov;
 		if (cpu_info.edx_features & CPUID_FEAT_EDX_MMX)
@@ -917,6 +920,7 @@ void ia32_setup_cg_config(void)
 	c->use_popcnt           = flags(arch, arch_feature_popcnt);
 	c->use_bswap            = (arch & arch_mask) >= arch_i486;
 	c->use_cmpxchg          = (arch & arch_mask) != arch_i386;
+	c->use_rdtsc            = flags(arch, arch_feature_tsc);
 	c->optimize_cc          = opt_cc;
 	c->use_unsafe_floatconv = opt_unsafe_floatconv;
 	c->emit_machcode        = emit_machcode;
@@ -72,6 +72,8 @@ typedef struct {
 	bool use_bswap:1;
 	/** use cmpxchg */
 	bool use_cmpxchg:1;
+	/** use rdtsc (Pentium and later) */
+	bool use_rdtsc:1;
 	/** optimize calling convention where possible */
 	bool optimize_cc:1;
 	/**
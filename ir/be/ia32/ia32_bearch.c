@@ -10,8 +10,10 @@
  */
 #include "ia32_bearch_t.h"
 
+#include "array.h"
 #include "beflags.h"
 #include "begnuas.h"
+#include "beipra.h"
 #include "bemodule.h"
 #include "bera.h"
 #include "besched.h"
@@ -947,6 +949,11 @@ request_entity:;
 	be_load_needs_frame_entity(env, node, size, po2align);
 }
 
+/* The epilogue code handles returns and tail calls alike. */
+COMPILETIME_ASSERT((int)n_ia32_Ret_mem   == (int)n_ia32_TailCall_mem &&
+                   (int)n_ia32_Ret_stack == (int)n_ia32_TailCall_stack,
+                   ret_and_tail_call_inputs_equal)
+
 static void introduce_epilogue(ir_node *const ret, bool const omit_fp)
 {
 	ir_node        *curr_sp;
@@ -1045,7 +1052,7 @@ static void introduce_prologue_epilogue(ir_graph *const irg, bool omit_fp)
 {
 	/* introduce epilogue for every return node */
 	foreach_irn_in(get_irg_end_block(irg), i, ret) {
-		assert(is_ia32_Ret(ret));
+		assert(is_ia32_Ret(ret) || is_ia32_TailCall(ret));
 		introduce_epilogue(ret, omit_fp);
 	}
 
@@ -1058,6 +1065,14 @@ static x87_attr_t *ia32_get_x87_attr(ir_node *const node)
 	return &attr->x87;
 }
 
+static ir_entity *ia32_get_frame_entity(const ir_node *node)
+{
+	if (!is_ia32_irn(node))
+		return NULL;
+	x86_imm32_t const *const imm = &get_ia32_attr_const(node)->addr.immediate;
+	return imm->kind == X86_IMM_FRAMEENT ? imm->entity : NULL;
+}
+
 /**
  * Last touchups for the graph before emit: x87 simulation to replace the
  * virtual with real x87 instructions, creating a block schedule and
@@ -1065,8 +1080,8 @@ static x87_attr_t *ia32_get_x87_attr(ir_node *const node)
  */
 static void ia32_before_emit(ir_graph *irg)
 {
-	ia32_irg_data_t const *const irg_data = ia32_get_irg_data(irg);
-	bool                   const omit_fp  = irg_data->omit_fp;
+	ia32_irg_data_t *const irg_data = ia32_get_irg_data(irg);
+	bool             const omit_fp  = irg_data->omit_fp;
 
 	/* create and coalesce frame entities */
 	be_fec_env_t *fec_env = be_new_frame_entity_coalescer(irg);
@@ -1075,7 +1090,7 @@ static void ia32_before_emit(ir_graph *irg)
 	be_free_frame_entity_coalescer(fec_env);
 
 	ir_type *const frame = get_irg_frame_type(irg);
-	be_sort_frame_entities(frame, omit_fp);
+	be_sort_frame_entities(irg, omit_fp, ia32_get_frame_entity);
 	unsigned const misalign = IA32_REGISTER_SIZE; /* return address on stack */
 	int      const begin    = omit_fp ? 0 : -IA32_REGISTER_SIZE;
 	be_layout_frame_type(frame, begin, misalign);
@@ -1087,7 +1102,12 @@ static void ia32_before_emit(ir_graph *irg)
 	/* fix stack entity offsets */
 	be_fix_stack_nodes(irg, &ia32_registers[REG_ESP]);
 	be_birg_from_irg(irg)->non_ssa_regs = NULL;
-	unsigned const p2align = ir_platform.ia32_po2_stackalign;
+	/* The stack pointer only needs the alignment of a register, unless a
+	 * callee or a frame entity needs more. */
+	if (be_get_frame_alignment(frame) > IA32_REGISTER_SIZE)
+		irg_data->aligned_stack = true;
+	unsigned const p2align = irg_data->aligned_stack
+		? ir_platform.ia32_po2_stackalign : IA32_PO2_REGISTER_SIZE;
 	be_sim_stack_pointer(irg, misalign, p2align, ia32_sp_sim);
 
 	/* fix 2-address code constraints */
@@ -1136,6 +1156,7 @@ static void ia32_select_instructions(ir_graph *irg)
 		instrument_initcall(irg, mcount);
 	}
 	ia32_adjust_pic(irg);
+	ia32_get_irg_data(irg)->aligned_stack = be_ipra_needs_aligned_stack(irg);
 
 	be_timer_push(T_CODEGEN);
 	ia32_transform_graph(irg);
@@ -1352,6 +1373,7 @@ static void ia32_init(void)
 	ir_target.fast_unaligned_memaccess = true;
 	ir_target.allow_ifconv             = ia32_is_mux_allowed;
 	ir_target.float_int_overflow       = ir_overflow_indefinite;
+	ir_target.cycle_counter            = ia32_cg_config.use_rdtsc;
 	ir_platform_set_va_list_type_pointer();
 
 	if (!ia32_cg_config.use_sse2 && !ia32_cg_config.use_softfloat) {
@@ -1412,6 +1434,16 @@ static bool lower_for_emit(ir_graph *const irg, const unsigned *const sp_is_non_
 	return true;
 }
 
+static void ia32_record_ipra(ir_graph *const irg)
+{
+	/* The registers modified by the target of a tail call are unknown. */
+	foreach_irn_in(get_irg_end_block(irg), i, ret) {
+		if (is_ia32_TailCall(ret))
+			return;
+	}
+	be_ipra_record(irg, ia32_get_irg_data(irg)->aligned_stack);
+}
+
 static void ia32_generate_code(FILE *output, const char *cup_name)
 {
 	ia32_tv_ent = pmap_create();
@@ -1420,7 +1452,9 @@ static void ia32_generate_code(FILE *output, const char *cup_name)
 	unsigned *const sp_is_non_ssa = rbitset_alloca(N_IA32_REGISTERS);
 	rbitset_set(sp_is_non_ssa, REG_ESP);
 
-	foreach_irp_irg(i, irg) {
+	ir_graph **const irgs = be_ipra_get_irg_order();
+	for (size_t i = 0, n = ARR_LEN(irgs); i < n; ++i) {
+		ir_graph *const irg = irgs[i];
 		if (!lower_for_emit(irg, sp_is_non_ssa))
 			continue;
 
@@ -1428,8 +1462,10 @@ static void ia32_generate_code(FILE *output, const char *cup_name)
 		ia32_emit_function(irg);
 		be_timer_pop(T_EMIT);
 
+		ia32_record_ipra(irg);
 		be_step_last(irg);
 	}
+	DEL_ARR_F(irgs);
 
 	ia32_emit_thunks();
 
@@ -1607,6 +1643,8 @@ static void ia32_lower_for_target(void)
 		supported[s++] = ir_bk_popcount;
 	if (ia32_cg_config.use_cmpxchg)
 		supported[s++] = ir_bk_compare_swap;
+	if (ia32_cg_config.use_rdtsc)
+		supported[s++] = ir_bk_cycle_counter;
 	assert(s < ARRAY_SIZE(supported));
 	lower_builtins(s, supported, ia32_lower_va_arg);
 	be_after_irp_transform("lower-builtins");
@@ -1669,6 +1707,7 @@ arch_isa_if_t const ia32_isa_if = {
 	.generate_code         = ia32_generate_code,
 	.jit_compile           = ia32_jit_compile,
 	.emit_function         = ia32_emit_jit_function,
+	.jit_stubs             = &ia32_jit_stubs,
 	.lower_for_target      = ia32_lower_for_target,
 	.additional_reg_names  = ia32_additional_reg_names,
 	.get_op_estimated_cost = ia32_get_op_estimated_cost,
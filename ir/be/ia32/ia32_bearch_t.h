@@ -17,6 +17,8 @@
 #include "x86_x87.h"
 
 #define IA32_REGISTER_SIZE 4
+/** power of two stack alignment if no callee needs more */
+#define IA32_PO2_REGISTER_SIZE 2
 
 typedef struct ia32_irg_data_t {
 	bool     do_x87_sim;     /**< Should simulate x87 register stack. */
@@ -26,6 +28,7 @@ typedef struct ia32_irg_data_t {
 	ir_node *noreg_xmm;      /**< unique NoReg_XMM node */
 	ir_node *fpu_trunc_mode; /**< truncate fpu mode */
 	ir_node *get_eip;        /**< get eip node */
+	bool     aligned_stack;  /**< Align the stack pointer for calls. */
 } ia32_irg_data_t;
 
 extern pmap *ia32_tv_ent; /**< A map of entities that store const tarvals */
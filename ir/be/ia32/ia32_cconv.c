@@ -21,6 +21,7 @@
 #include "typerep.h"
 #include "util.h"
 #include "x86_cconv.h"
+#include "x86_x87.h"
 #include "xmalloc.h"
 
 static const unsigned ignore_regs[] = {
@@ -32,6 +33,24 @@ static const unsigned ignore_regs[] = {
 static const arch_register_t* const default_param_regs[] = {};
 static const arch_register_t* const float_param_regs[]   = {};
 
+/* Functions private to the compilation unit use these registers instead. */
+static const arch_register_t* const private_param_regs[] = {
+	&ia32_registers[REG_EAX],
+	&ia32_registers[REG_EDX],
+	&ia32_registers[REG_ECX],
+};
+
+static const arch_register_t* const private_float_param_regs[] = {
+	&ia32_registers[REG_XMM0],
+	&ia32_registers[REG_XMM1],
+	&ia32_registers[REG_XMM2],
+	&ia32_registers[REG_XMM3],
+	&ia32_registers[REG_XMM4],
+	&ia32_registers[REG_XMM5],
+	&ia32_registers[REG_XMM6],
+	&ia32_registers[REG_XMM7],
+};
+
 static const arch_register_t* const result_regs[] = {
 	&ia32_registers[REG_EAX],
 	&ia32_registers[REG_EDX],
@@ -101,7 +120,11 @@ x86_cconv_t *ia32_decide_calling_convention(ir_type const *const function_type,
 
 	mtp_additional_properties mtp
 		= get_method_additional_properties(function_type);
-	(void)mtp;
+	/* All calls of private functions are known, so they may pass their
+	 * parameters in registers. */
+	bool const private_cc = ia32_cg_config.optimize_cc
+	                     && (mtp & mtp_property_private)
+	                     && !is_method_variadic(function_type);
 	/* TODO: do something with cc_reg_param/cc_this_call */
 
 	unsigned *caller_saves = rbitset_malloc(N_IA32_REGISTERS);
@@ -116,8 +139,18 @@ x86_cconv_t *ia32_decide_calling_convention(ir_type const *const function_type,
 	reg_or_stackslot_t *params             = XMALLOCNZ(reg_or_stackslot_t,
 	                                                   n_params);
 
+	arch_register_t const *const *int_regs   = default_param_regs;
+	arch_register_t const *const *float_regs = float_param_regs;
 	unsigned n_param_regs       = ARRAY_SIZE(default_param_regs);
 	unsigned n_float_param_regs = ARRAY_SIZE(float_param_regs);
+	if (private_cc) {
+		int_regs     = private_param_regs;
+		n_param_regs = ARRAY_SIZE(private_param_regs);
+		if (ia32_cg_config.use_sse2) {
+			float_regs         = private_float_param_regs;
+			n_float_param_regs = ARRAY_SIZE(private_float_param_regs);
+		}
+	}
 	unsigned stack_offset       = 0;
 	for (unsigned i = 0; i < n_params; ++i) {
 		ir_type            *param_type = get_method_param_type(function_type, i);
@@ -130,10 +163,11 @@ x86_cconv_t *ia32_decide_calling_convention(ir_type const *const function_type,
 		}
 
 		ir_mode *mode = get_type_mode(param_type);
-		if (mode_is_float(mode) && float_param_regnum < n_float_param_regs) {
-			param->reg = float_param_regs[float_param_regnum++];
+		if (mode_is_float(mode) && float_param_regnum < n_float_param_regs
+		 && mode != x86_mode_E) {
+			param->reg = float_regs[float_param_regnum++];
 		} else if (!mode_is_float(mode) && param_regnum < n_param_regs) {
-			param->reg = default_param_regs[param_regnum++];
+			param->reg = int_regs[param_regnum++];
 		} else {
 			param->type   = param_type;
 			param->offset = stack_offset;
@@ -183,7 +217,7 @@ align_stack:;
 
 	x86_cconv_t *cconv     = XMALLOCZ(x86_cconv_t);
 	cconv->sp_delta        = (cc & cc_compound_ret) && !(cc & cc_reg_param)
-	                         ? IA32_REGISTER_SIZE : 0;
+	                         && !private_cc ? IA32_REGISTER_SIZE : 0;
 	cconv->parameters      = params;
 	cconv->n_parameters    = n_params;
 	cconv->param_stacksize = stack_offset;
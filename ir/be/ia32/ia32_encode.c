@@ -911,6 +911,26 @@ static void enc_call(ir_node const *const node)
 	}
 }
 
+static void enc_tail_call(ir_node const *const node)
+{
+	ir_node *const callee = get_irn_n(node, n_ia32_TailCall_callee);
+	if (is_ia32_Immediate(callee)) {
+		x86_imm32_t const *const imm
+			= &get_ia32_immediate_attr_const(callee)->imm;
+		assert(imm->kind == X86_IMM_PCREL);
+
+		be_emit8(0xE9);
+		x86_imm32_t const jmp_imm = {
+			.kind   = X86_IMM_PCREL,
+			.entity = imm->entity,
+			.offset = imm->offset - 4,
+		};
+		enc_relocation(&jmp_imm);
+	} else {
+		ia32_enc_unop(node, 0xFF, 4, n_ia32_TailCall_callee);
+	}
+}
+
 static void enc_jmp(ir_node const *const cfop)
 {
 	be_emit8(0xE9);
@@ -1314,6 +1334,7 @@ static void ia32_register_binary_emitters(void)
 	be_set_emitter(op_ia32_Store,         enc_store);
 	be_set_emitter(op_ia32_SubSP,         enc_subsp);
 	be_set_emitter(op_ia32_SwitchJmp,     enc_switchjmp);
+	be_set_emitter(op_ia32_TailCall,      enc_tail_call);
 	be_set_emitter(op_ia32_Test,          enc_test);
 	be_set_emitter(op_ia32_Xor0,          enc_xor0);
 	be_set_emitter(op_ia32_fild,          enc_fild);
@@ -1454,3 +1475,107 @@ void ia32_emit_jit_function(char *buffer, ir_jit_function_t *const function)
 	};
 	be_jit_emit_memory(buffer, function, &jit_emit_interface);
 }
+
+static char *put_bytes(char *const buffer, uint8_t const *const bytes,
+                       size_t const n)
+{
+	memcpy(buffer, bytes, n);
+	return buffer + n;
+}
+
+static char *put32(char *const buffer, uint32_t const value)
+{
+	memcpy(buffer, &value, 4);
+	return buffer + 4;
+}
+
+#define IA32_STUB_SIZE     24
+#define IA32_RESOLVER_SIZE 119
+#define IA32_N_XMM_PARAMS  8
+
+static void ia32_emit_jit_stub(char *const buffer, be_jit_stub_t *const stub,
+                               char const *const resolver)
+{
+	char *p = buffer;
+	/* dec dword [counter] */
+	p = put_bytes(p, (uint8_t const[]){ 0xFF, 0x0D }, 2);
+	p = put32(p, (uint32_t)(uintptr_t)&stub->counter);
+	/* jz resolve */
+	p = put_bytes(p, (uint8_t const[]){ 0x74, 0x06 }, 2);
+	/* jmp dword [target] */
+	p = put_bytes(p, (uint8_t const[]){ 0xFF, 0x25 }, 2);
+	p = put32(p, (uint32_t)(uintptr_t)&stub->target);
+	/* resolve: push stub */
+	p = put_bytes(p, (uint8_t const[]){ 0x68 }, 1);
+	p = put32(p, (uint32_t)(uintptr_t)stub);
+	/* jmp resolver */
+	p = put_bytes(p, (uint8_t const[]){ 0xE9 }, 1);
+	p = put32(p, (uint32_t)(resolver - (p + 4)));
+	assert(p == buffer + IA32_STUB_SIZE);
+}
+
+static void ia32_patch_jit_stub(char *const buffer, void const *const target)
+{
+	/* jmp target */
+	char *p = buffer;
+	p = put_bytes(p, (uint8_t const[]){ 0xE9 }, 1);
+	put32(p, (uint32_t)((char const*)target - (p + 4)));
+}
+
+/**
+ * Emit movups between xmm0-xmm7 and 16 byte slots at esp. Private functions
+ * pass float parameters in these registers, if SSE2 is used.
+ */
+static char *emit_xmm_params(char *p, uint8_t const opcode)
+{
+	for (uint8_t i = 0; i < IA32_N_XMM_PARAMS; ++i) {
+		/* movups [esp+16*i], xmmi or movups xmmi, [esp+16*i] */
+		p = put_bytes(p, (uint8_t const[]){
+			0x0F, opcode, 0x44 | i << 3, 0x24, 16 * i,
+		}, 5);
+	}
+	return p;
+}
+
+static void ia32_emit_jit_resolver(char *const buffer,
+                                   be_jit_resolve_func const resolve)
+{
+	char *p = buffer;
+	/* Save the registers, which may hold arguments, and align the stack.
+	 * push ebp; mov ebp, esp; push eax; push ecx; push edx;
+	 * and esp, -16 */
+	p = put_bytes(p, (uint8_t const[]){
+		0x55, 0x89, 0xE5, 0x50, 0x51, 0x52, 0x83, 0xE4, 0xF0,
+	}, 9);
+	if (ia32_cg_config.use_sse2) {
+		/* add esp, -128 */
+		p = put_bytes(p, (uint8_t const[]){ 0x83, 0xC4, 0x80 }, 3);
+		p = emit_xmm_params(p, 0x11);
+	}
+	/* sub esp, 12; push dword [ebp+4] (the stub) */
+	p = put_bytes(p, (uint8_t const[]){
+		0x83, 0xEC, 0x0C, 0xFF, 0x75, 0x04,
+	}, 6);
+	/* mov eax, resolve; call eax; add esp, 16 */
+	p = put_bytes(p, (uint8_t const[]){ 0xB8 }, 1);
+	p = put32(p, (uint32_t)(uintptr_t)resolve);
+	p = put_bytes(p, (uint8_t const[]){ 0xFF, 0xD0, 0x83, 0xC4, 0x10 }, 5);
+	if (ia32_cg_config.use_sse2)
+		p = emit_xmm_params(p, 0x10);
+	/* Replace the stub by the returned code address, restore the registers
+	 * and return into the function.
+	 * mov [ebp+4], eax; lea esp, [ebp-12]; pop edx; pop ecx; pop eax;
+	 * pop ebp; ret */
+	p = put_bytes(p, (uint8_t const[]){
+		0x89, 0x45, 0x04, 0x8D, 0x65, 0xF4, 0x5A, 0x59, 0x58, 0x5D, 0xC3,
+	}, 11);
+	assert(p <= buffer + IA32_RESOLVER_SIZE);
+}
+
+be_jit_stub_interface_t const ia32_jit_stubs = {
+	.stub_size     = IA32_STUB_SIZE,
+	.resolver_size = IA32_RESOLVER_SIZE,
+	.emit_stub     = ia32_emit_jit_stub,
+	.emit_resolver = ia32_emit_jit_resolver,
+	.patch_stub    = ia32_patch_jit_stub,
+};
@@ -12,6 +12,7 @@
 #define FIRM_BE_IA32_IA32_ENCODE_H
 
 #include <stdint.h>
+#include "be_types.h"
 #include "firm_types.h"
 #include "jit.h"
 
@@ -23,6 +24,9 @@ ir_jit_function_t *ia32_emit_jit(ir_jit_segment_t *segment, ir_graph *irg);
 
 void ia32_emit_jit_function(char *buffer, ir_jit_function_t *function);
 
+/** Stubs for lazily compiled functions. */
+extern be_jit_stub_interface_t const ia32_jit_stubs;
+
 void ia32_enc_simple(uint8_t opcode);
 
 void ia32_enc_binop(ir_node const *node, unsigned code);
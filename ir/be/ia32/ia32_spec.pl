@@ -1264,6 +1264,17 @@ Ret => {
 	fixed     => "x86_insn_size_t const size = X86_SIZE_32;",
 },
 
+TailCall => {
+	state     => "pinned",
+	op_flags  => [ "cfopcode" ],
+	in_reqs   => "...",
+	out_reqs  => [ "exec" ],
+	ins       => [ "mem", "stack", "callee", "first_argument" ],
+	fixed     => "x86_insn_size_t const size = X86_SIZE_32;",
+	emit      => "jmp %*S2",
+	latency   => 1,
+},
+
 Call => {
 	op_flags  => [ "uses_memory" ],
 	irn_flags => [ "modify_flags" ],
@@ -1345,6 +1356,18 @@ Inport => {
 	latency   => 1,
 },
 
+Rdtsc => {
+	state     => "pinned",
+	in_reqs   => [ "mem" ],
+	out_reqs  => [ "eax", "edx", "mem" ],
+	ins       => [ "mem" ],
+	outs      => [ "low", "high", "M" ],
+	fixed     => "x86_insn_size_t const size = X86_SIZE_32;",
+	emit      => "rdtsc",
+	encode    => "ia32_enc_simple(0x0F); ia32_enc_simple(0x31)",
+	latency   => 25,
+},
+
 # Intel style prefetching
 PrefetchT0 => {
 	template => $prefetchop,
@@ -53,6 +53,7 @@
 DEBUG_ONLY(static firm_dbg_module_t *dbg;)
 
 static x86_cconv_t          *current_cconv;
+static bool                  sibling_calls;
 static be_stack_env_t        stack_env;
 static ir_heights_t         *heights;
 static x86_immediate_kind_t  lconst_imm_kind;
@@ -136,6 +137,12 @@ static ir_node *create_immediate_or_transform(ir_node *node, char immediate_mode
 
 static ir_node *create_I2I_Conv(ir_mode *src_mode, dbg_info *dbgi, ir_node *block, ir_node *op);
 
+static void adjust_pc_relative_relocation(ir_node *node);
+
+static bool callee_is_plt(ir_node *callee);
+
+static ir_node *create_proj_for_store(ir_node *store, pn_Store pn);
+
 /* its enough to have those once */
 static ir_node *nomem;
 static ir_node *noreg_GP;
@@ -4047,8 +4054,127 @@ static ir_node *gen_Proj_Proj_Start(ir_node *node)
 	return be_get_Start_proj(irg, param->reg);
 }
 
+/**
+ * Turns @p call, whose results are returned by @p ret, into a jump to the
+ * callee after the epilogue. Returns NULL if the calling conventions do not
+ * allow it.
+ */
+static ir_node *gen_sibling_call(ir_node *const ret, ir_node *const call)
+{
+	/* PLT calls need the GOT address in ebx, which is callee saved */
+	ir_node *const callee = get_Call_ptr(call);
+	if (ia32_cg_config.emit_machcode || callee_is_plt(callee))
+		return NULL;
+
+	ir_type     *const type  = get_Call_type(call);
+	x86_cconv_t *const cconv = ia32_decide_calling_convention(type, NULL);
+	if (!x86_can_sibling_call(current_cconv, cconv, N_IA32_REGISTERS, true))
+		goto fail;
+	/* x87 results would have to stay on the x87 stack */
+	for (unsigned r = 0; r < cconv->n_reg_results; ++r) {
+		if (cconv->results[r].reg->cls == &ia32_reg_classes[CLASS_ia32_fp])
+			goto fail;
+	}
+
+	arch_register_req_t const *callee_req;
+	ir_node                   *new_callee = try_create_Immediate(callee, 'i');
+	if (new_callee != NULL) {
+		adjust_pc_relative_relocation(new_callee);
+		callee_req = &ia32_class_reg_req_gp;
+	} else {
+		arch_register_t const *const scratch
+			= x86_get_sibling_call_scratch(current_cconv, cconv,
+			                               &ia32_reg_classes[CLASS_ia32_gp]);
+		if (scratch == NULL)
+			goto fail;
+		new_callee = be_transform_node(callee);
+		callee_req = scratch->single_req;
+	}
+
+	ir_graph *const irg            = get_irn_irg(ret);
+	unsigned  const n_params       = get_Call_n_params(call);
+	unsigned  const n_callee_saves = rbitset_popcount(current_cconv->callee_saves, N_IA32_REGISTERS);
+	unsigned  const n_ins
+		= n_ia32_TailCall_first_argument + cconv->n_param_regs + n_callee_saves;
+
+	arch_register_req_t const **const reqs = be_allocate_in_reqs(irg, n_ins);
+	ir_node **const in = ALLOCAN(ir_node*, n_ins);
+	unsigned        p  = n_ia32_TailCall_first_argument;
+
+	in[n_ia32_TailCall_stack]    = get_initial_sp(irg);
+	reqs[n_ia32_TailCall_stack]  = &ia32_single_reg_req_gp_esp;
+	in[n_ia32_TailCall_callee]   = new_callee;
+	reqs[n_ia32_TailCall_callee] = callee_req;
+
+	dbg_info  *const dbgi       = get_irn_dbg_info(call);
+	ir_node   *const new_block  = be_transform_nodes_block(ret);
+	ir_node   *const mem        = be_transform_node(get_Call_mem(call));
+	ir_type   *const frame_type = get_irg_frame_type(irg);
+	unsigned         sync_arity = 0;
+	ir_node  **const sync_ins   = ALLOCAN(ir_node*, n_params + 1);
+	for (unsigned i = 0; i < n_params; ++i) {
+		ir_node                  *const value = get_Call_param(call, i);
+		reg_or_stackslot_t const *const param = &cconv->parameters[i];
+		if (param->reg) {
+			in[p]   = be_transform_node(value);
+			reqs[p] = param->reg->single_req;
+			++p;
+		} else {
+			/* Store the argument into the incoming parameters, which become
+			 * the incoming parameters of the callee. */
+			ident     *const id     = new_id_fmt("$sibling_arg%u", i);
+			ir_entity *const entity = new_entity(frame_type, id, param->type);
+			set_entity_offset(entity, param->offset + IA32_REGISTER_SIZE);
+			x86_address_t const store_addr = {
+				.variant = X86_ADDR_BASE,
+				.base    = get_irg_frame(irg),
+				.index   = noreg_GP,
+				.mem     = mem,
+				.imm     = {
+					.kind   = X86_IMM_FRAMEENT,
+					.entity = entity,
+				},
+			};
+			ir_node *const store = create_store(dbgi, new_block, value, &store_addr);
+			sync_ins[sync_arity++] = create_proj_for_store(store, pn_Store_M);
+		}
+	}
+	if (sync_arity == 0)
+		sync_ins[sync_arity++] = mem;
+	in[n_ia32_TailCall_mem]   = be_make_Sync(new_block, sync_arity, sync_ins);
+	reqs[n_ia32_TailCall_mem] = arch_memory_req;
+
+	/* callee saves */
+	for (unsigned i = 0; i < N_IA32_REGISTERS; ++i) {
+		if (!rbitset_is_set(current_cconv->callee_saves, i))
+			continue;
+		arch_register_t const *const reg = &ia32_registers[i];
+		in[p]   = be_get_Start_proj(irg, reg);
+		reqs[p] = reg->single_req;
+		++p;
+	}
+	assert(p == n_ins);
+	x86_free_calling_convention(cconv);
+
+	ir_node *const tail_call
+		= new_bd_ia32_TailCall(dbgi, new_block, n_ins, in, reqs);
+	be_stack_record_chain(&stack_env, tail_call, n_ia32_TailCall_stack, NULL);
+	return tail_call;
+
+fail:
+	x86_free_calling_convention(cconv);
+	return NULL;
+}
+
 static ir_node *gen_Return(ir_node *node)
 {
+	ir_node *const call = sibling_calls ? x86_find_sibling_call(node) : NULL;
+	if (call != NULL) {
+		ir_node *const tail_call = gen_sibling_call(node, call);
+		if (tail_call != NULL)
+			return tail_call;
+	}
+
 	ir_graph *irg       = get_irn_irg(node);
 	ir_node  *new_block = be_transform_nodes_block(node);
 	dbg_info *dbgi      = get_irn_dbg_info(node);
@@ -4591,6 +4717,8 @@ static ir_node *gen_Call(ir_node *node)
 	ir_node                   **const in       = ALLOCAN(ir_node*, n_ins);
 	arch_register_req_t const **const in_req   = be_allocate_in_reqs(irg, n_ins);
 
+	x86_remove_unclobbered_caller_saves(cconv, node, &ia32_reg_classes[CLASS_ia32_gp]);
+	x86_remove_unclobbered_caller_saves(cconv, node, &ia32_reg_classes[CLASS_ia32_xmm]);
 	record_returns_twice(irg, type);
 
 	arch_register_req_t const *const req_gp = &ia32_class_reg_req_gp;
@@ -5100,6 +5228,17 @@ static ir_node *gen_inport(ir_node *node)
 	return res;
 }
 
+/**
+ * Transform cycle counter read.
+ */
+static ir_node *gen_cycle_counter(ir_node *node)
+{
+	dbg_info *dbgi  = get_irn_dbg_info(node);
+	ir_node  *block = be_transform_nodes_block(node);
+	ir_node  *mem   = be_transform_node(get_Builtin_mem(node));
+	return new_bd_ia32_Rdtsc(dbgi, block, mem);
+}
+
 /*
  * Transform saturating increment.
  */
@@ -5216,10 +5355,21 @@ static ir_node *gen_Builtin(ir_node *node)
 		return gen_saturating_increment(node);
 	case ir_bk_compare_swap:
 		return gen_compare_swap(node);
+	case ir_bk_cycle_counter:
+		return gen_cycle_counter(node);
 	case ir_bk_va_start:
 		return gen_va_start(node);
 	case ir_bk_may_alias:
 	case ir_bk_va_arg:
+	case ir_bk_sqrt:
+	case ir_bk_fabs:
+	case ir_bk_floor:
+	case ir_bk_ceil:
+	case ir_bk_trunc:
+	case ir_bk_round:
+	case ir_bk_fmin:
+	case ir_bk_fmax:
+	case ir_bk_copysign:
 		break;
 	}
 	panic("Builtin %s not implemented", get_builtin_kind_name(kind));
@@ -5267,6 +5417,13 @@ static ir_node *gen_Proj_Builtin(ir_node *proj)
 			assert(get_Proj_num(proj) == pn_Builtin_max + 1);
 			return be_new_Proj(new_node, pn_ia32_CmpXChgMem_res);
 		}
+	case ir_bk_cycle_counter:
+		if (get_Proj_num(proj) == pn_Builtin_max + 1) {
+			return be_new_Proj(new_node, pn_ia32_Rdtsc_low);
+		} else {
+			assert(get_Proj_num(proj) == pn_Builtin_M);
+			return be_new_Proj(new_node, pn_ia32_Rdtsc_M);
+		}
 	case ir_bk_va_start:
 		switch(get_Proj_num(proj)) {
 		case pn_Builtin_M: {
@@ -5279,6 +5436,15 @@ static ir_node *gen_Proj_Builtin(ir_node *proj)
 		break;
 	case ir_bk_may_alias:
 	case ir_bk_va_arg:
+	case ir_bk_sqrt:
+	case ir_bk_fabs:
+	case ir_bk_floor:
+	case ir_bk_ceil:
+	case ir_bk_trunc:
+	case ir_bk_round:
+	case ir_bk_fmin:
+	case ir_bk_fmax:
+	case ir_bk_copysign:
 		break;
 	}
 	panic("Builtin %s not implemented", get_builtin_kind_name(kind));
@@ -5429,6 +5595,9 @@ void ia32_transform_graph(ir_graph *irg)
 	x86_layout_param_entities(irg, current_cconv, IA32_REGISTER_SIZE);
 	be_add_parameter_entity_stores(irg);
 	x86_create_parameter_loads(irg, current_cconv);
+	sibling_calls = x86_sibling_calls_possible(irg);
+	if (sibling_calls)
+		x86_order_parameter_loads(irg);
 
 	be_timer_push(T_HEIGHTS);
 	heights = heights_new(irg);
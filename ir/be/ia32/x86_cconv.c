@@ -10,11 +10,16 @@
  */
 #include "x86_cconv.h"
 
+#include "array.h"
+#include "bearch.h"
+#include "beipra.h"
 #include "betranshlp.h"
 #include "bevarargs.h"
 #include "iredges_t.h"
 #include "irgmod.h"
+#include "irgwalk.h"
 #include "irnode_t.h"
+#include "raw_bitset.h"
 #include <stdlib.h>
 
 void x86_free_calling_convention(x86_cconv_t *cconv)
@@ -83,3 +88,172 @@ void x86_layout_param_entities(ir_graph *const irg, x86_cconv_t *const cconv,
 		cconv->va_start_addr = be_make_va_start_entity(frame_type, offset);
 	}
 }
+
+void x86_remove_unclobbered_caller_saves(x86_cconv_t *const cconv,
+                                         ir_node const *const call,
+                                         arch_register_class_t const *const cls)
+{
+	be_ipra_info_t const *const info = be_ipra_get_callee_info(call);
+	if (info == NULL)
+		return;
+	for (unsigned i = 0; i < cls->n_regs; ++i) {
+		unsigned const index = cls->regs[i].global_index;
+		if (!rbitset_is_set(info->clobbers, index))
+			rbitset_clear(cconv->caller_saves, index);
+	}
+}
+
+static void check_stack_alloc(ir_node *node, void *env)
+{
+	if (is_Alloc(node) || is_Free(node)) {
+		bool *const escapes = (bool*)env;
+		*escapes = true;
+	}
+}
+
+bool x86_sibling_calls_possible(ir_graph *const irg)
+{
+	if (is_method_variadic(get_entity_type(get_irg_entity(irg))))
+		return false;
+
+	/* The frame may only be used to load parameters before the jump. */
+	foreach_out_edge(get_irg_frame(irg), edge) {
+		ir_node *const user = get_edge_src_irn(edge);
+		if (is_Anchor(user))
+			continue;
+		if (!is_Member(user) || !is_parameter_entity(get_Member_entity(user)))
+			return false;
+		foreach_out_edge(user, member_edge) {
+			ir_node *const load = get_edge_src_irn(member_edge);
+			if (!is_Load(load) || get_edge_src_pos(member_edge) != n_Load_ptr)
+				return false;
+		}
+	}
+
+	bool escapes = false;
+	irg_walk_graph(irg, check_stack_alloc, NULL, &escapes);
+	return !escapes;
+}
+
+ir_node *x86_find_sibling_call(ir_node const *const ret)
+{
+	ir_node *const mem = get_Return_mem(ret);
+	if (!is_Proj(mem) || get_irn_n_edges(mem) != 1)
+		return NULL;
+	ir_node *const call = get_Proj_pred(mem);
+	if (!is_Call(call) || get_nodes_block(call) != get_nodes_block(ret)
+	 || ir_throws_exception(call))
+		return NULL;
+
+	ir_type *const type = get_Call_type(call);
+	if (is_method_variadic(type)
+	 || (get_method_additional_properties(type) & mtp_property_returns_twice))
+		return NULL;
+
+	/* The results of the call must be returned unchanged. */
+	size_t const n_res = get_Return_n_ress(ret);
+	if (n_res > get_method_n_ress(type))
+		return NULL;
+	for (size_t i = 0; i < n_res; ++i) {
+		ir_node *const res = get_Return_res(ret, i);
+		if (!is_Proj(res) || get_Proj_num(res) != i)
+			return NULL;
+		ir_node *const res_tuple = get_Proj_pred(res);
+		if (!is_Proj(res_tuple) || get_Proj_pred(res_tuple) != call)
+			return NULL;
+	}
+	/* Nothing else may use the call. */
+	foreach_out_edge(call, edge) {
+		ir_node *const proj = get_edge_src_irn(edge);
+		if (proj == mem)
+			continue;
+		if (get_Proj_num(proj) != pn_Call_T_result)
+			return NULL;
+		foreach_out_edge(proj, res_edge) {
+			ir_node *const res = get_edge_src_irn(res_edge);
+			foreach_out_edge(res, user_edge) {
+				if (get_edge_src_irn(user_edge) != ret)
+					return NULL;
+			}
+		}
+	}
+	return call;
+}
+
+void x86_order_parameter_loads(ir_graph *const irg)
+{
+	ir_node *const frame       = get_irg_frame(irg);
+	ir_node *const start_block = get_irg_start_block(irg);
+	ir_node *const end_block   = get_irg_end_block(irg);
+	foreach_irn_in(end_block, i, ret) {
+		if (!is_Return(ret))
+			continue;
+		ir_node *const call = x86_find_sibling_call(ret);
+		if (call == NULL || get_nodes_block(call) != start_block)
+			continue;
+
+		ir_node **in = NEW_ARR_F(ir_node*, 1);
+		in[0] = get_Call_mem(call);
+		foreach_out_edge(frame, edge) {
+			ir_node *const member = get_edge_src_irn(edge);
+			if (!is_Member(member))
+				continue;
+			foreach_out_edge(member, member_edge) {
+				ir_node *const load = get_edge_src_irn(member_edge);
+				ARR_APP1(ir_node*, in, new_r_Proj(load, mode_M, pn_Load_M));
+			}
+		}
+		if (ARR_LEN(in) > 1)
+			set_Call_mem(call, new_r_Sync(start_block, ARR_LEN(in), in));
+		DEL_ARR_F(in);
+	}
+}
+
+bool x86_can_sibling_call(x86_cconv_t const *const caller,
+                          x86_cconv_t const *const callee,
+                          unsigned const n_regs, bool const stack_args)
+{
+	if (callee->param_stacksize > caller->param_stacksize
+	 || callee->sp_delta != caller->sp_delta)
+		return false;
+	for (size_t p = 0; p < callee->n_parameters; ++p) {
+		reg_or_stackslot_t const *const param = &callee->parameters[p];
+		arch_register_t    const *const reg   = param->reg;
+		if (reg == NULL) {
+			/* aggregates would have to be copied */
+			if (!stack_args || is_aggregate_type(param->type))
+				return false;
+		} else if (rbitset_is_set(caller->callee_saves, reg->global_index)) {
+			return false;
+		}
+	}
+	for (size_t r = 0; r < caller->n_reg_results; ++r) {
+		if (caller->results[r].reg != callee->results[r].reg)
+			return false;
+	}
+	for (unsigned i = 0; i < n_regs; ++i) {
+		if (rbitset_is_set(caller->callee_saves, i)
+		 && !rbitset_is_set(callee->callee_saves, i))
+			return false;
+	}
+	return true;
+}
+
+arch_register_t const *x86_get_sibling_call_scratch(
+		x86_cconv_t const *const caller, x86_cconv_t const *const callee,
+		arch_register_class_t const *const cls)
+{
+	for (unsigned i = cls->n_regs; i-- > 0;) {
+		arch_register_t const *const reg = &cls->regs[i];
+		if (rbitset_is_set(caller->callee_saves, reg->global_index)
+		 || !rbitset_is_set(callee->caller_saves, reg->global_index))
+			continue;
+		for (size_t p = 0; p < callee->n_parameters; ++p) {
+			if (callee->parameters[p].reg == reg)
+				goto next_reg;
+		}
+		return reg;
+next_reg:;
+	}
+	return NULL;
+}
@@ -56,4 +56,53 @@ void x86_create_parameter_loads(ir_graph *irg, const x86_cconv_t *cconv);
 void x86_layout_param_entities(ir_graph *irg, x86_cconv_t *cconv,
                                int params_offset);
 
+/**
+ * Removes the registers of class @p cls, which the callee of @p call is known
+ * not to modify, from the caller saved registers of @p cconv.
+ */
+void x86_remove_unclobbered_caller_saves(x86_cconv_t *cconv,
+                                         ir_node const *call,
+                                         arch_register_class_t const *cls);
+
+/**
+ * Checks whether calls in @p irg may become sibling calls: Neither the frame
+ * nor stack allocated memory of @p irg may be accessed after the frame is torn
+ * down. Must be called before the graph is transformed.
+ */
+bool x86_sibling_calls_possible(ir_graph *irg);
+
+/**
+ * Returns the Call whose results are returned by @p ret, if the call may
+ * become a sibling call: a jump to the callee after the frame of the caller is
+ * torn down. Returns NULL otherwise.
+ * The calling conventions are checked separately by x86_can_sibling_call().
+ */
+ir_node *x86_find_sibling_call(ir_node const *ret);
+
+/**
+ * Orders the parameter loads of @p irg before the sibling call candidates in
+ * the start block, so the arguments of a sibling call may overwrite the
+ * incoming parameters. Must be called after x86_create_parameter_loads().
+ */
+void x86_order_parameter_loads(ir_graph *irg);
+
+/**
+ * Checks whether a function with calling convention @p caller may jump to a
+ * callee with calling convention @p callee: The results must be passed in the
+ * same registers, and the callee must preserve the callee saved registers of
+ * the caller. Arguments must be passed in registers or, if @p stack_args is
+ * set, in non-aggregate stack slots, which are stored into the incoming
+ * parameters of the caller.
+ */
+bool x86_can_sibling_call(x86_cconv_t const *caller, x86_cconv_t const *callee,
+                          unsigned n_regs, bool stack_args);
+
+/**
+ * Returns a register of class @p cls for the address of an indirect sibling
+ * call. It is neither restored by the epilogue nor holds an argument.
+ */
+arch_register_t const *x86_get_sibling_call_scratch(
+		x86_cconv_t const *caller, x86_cconv_t const *callee,
+		arch_register_class_t const *cls);
+
 #endif
@@ -7,6 +7,7 @@
 
 #include "be2addr.h"
 #include "be_t.h"
+#include "beflags.h"
 #include "beirg.h"
 #include "bemodule.h"
 #include "bera.h"
@@ -17,12 +18,17 @@
 #include "gen_mips_new_nodes.h"
 #include "gen_mips_regalloc_if.h"
 #include "irarch.h"
+#include "ircons_t.h"
 #include "iredges.h"
+#include "irgmod.h"
 #include "irgwalk.h"
 #include "irprog_t.h"
+#include "irtools.h"
 #include "isas.h"
+#include "lc_opts.h"
 #include "lower_builtins.h"
 #include "lower_calls.h"
+#include "lower_softfloat.h"
 #include "lowering.h"
 #include "mips_emitter.h"
 #include "mips_lower64.h"
@@ -30,6 +36,15 @@
 #include "target_t.h"
 #include "util.h"
 
+pmap *mips_constants;
+
+static bool use_softfloat;
+
+static lc_opt_table_entry_t const mips_options[] = {
+	LC_OPT_ENT_BOOL("soft-float", "do not use the floating point unit", &use_softfloat),
+	LC_OPT_LAST
+};
+
 static ir_settings_arch_dep_t const mips_arch_dep = {
 	.replace_muls         = true,
 	.replace_divs         = true,
@@ -91,30 +106,41 @@ static void mips_select_instructions(ir_graph *const irg)
 static ir_node *mips_new_spill(ir_node *const value, ir_node *const after)
 {
 	ir_mode *const mode = get_irn_mode(value);
+	ir_node *(*cons)(dbg_info*, ir_node*, ir_node*, ir_node*, ir_node*, ir_entity*, int32_t);
 	if (be_mode_needs_gp_reg(mode)) {
-		ir_node  *const block = get_block(after);
-		ir_graph *const irg   = get_irn_irg(after);
-		ir_node  *const nomem = get_irg_no_mem(irg);
-		ir_node  *const frame = get_irg_frame(irg);
-		ir_node  *const store = new_bd_mips_sw(NULL, block, nomem, frame, value, NULL, 0);
-		sched_add_after(after, store);
-		return store;
+		cons = &new_bd_mips_sw;
+	} else if (mode_is_float(mode)) {
+		/* Always spill the whole register pair. */
+		cons = &new_bd_mips_sdc1;
+	} else {
+		TODO(value);
 	}
-	TODO(value);
+	ir_node  *const block = get_block(after);
+	ir_graph *const irg   = get_irn_irg(after);
+	ir_node  *const nomem = get_irg_no_mem(irg);
+	ir_node  *const frame = get_irg_frame(irg);
+	ir_node  *const store = cons(NULL, block, nomem, frame, value, NULL, 0);
+	sched_add_after(after, store);
+	return store;
 }
 
 static ir_node *mips_new_reload(ir_node *const value, ir_node *const spill, ir_node *const before)
 {
 	ir_mode *const mode = get_irn_mode(value);
+	ir_node *(*cons)(dbg_info*, ir_node*, ir_node*, ir_node*, ir_entity*, int32_t);
 	if (be_mode_needs_gp_reg(mode)) {
-		ir_node  *const block = get_block(before);
-		ir_graph *const irg   = get_irn_irg(before);
-		ir_node  *const frame = get_irg_frame(irg);
-		ir_node  *const load  = new_bd_mips_lw(NULL, block, spill, frame, NULL, 0);
-		sched_add_before(before, load);
-		return be_new_Proj(load, pn_mips_lw_res);
+		cons = &new_bd_mips_lw;
+	} else if (mode_is_float(mode)) {
+		cons = &new_bd_mips_ldc1;
+	} else {
+		TODO(value);
 	}
-	TODO(value);
+	ir_node  *const block = get_block(before);
+	ir_graph *const irg   = get_irn_irg(before);
+	ir_node  *const frame = get_irg_frame(irg);
+	ir_node  *const load  = cons(NULL, block, spill, frame, NULL, 0);
+	sched_add_before(before, load);
+	return be_new_Proj(load, pn_mips_lw_res);
 }
 
 static regalloc_if_t const mips_regalloc_if = {
@@ -128,14 +154,14 @@ static void mips_collect_frame_entity_nodes(ir_node *const node, void *const dat
 {
 	be_fec_env_t *const env = (be_fec_env_t*)data;
 
-	if (is_mips_lw(node)) {
+	if (is_mips_lw(node) || is_mips_ldc1(node)) {
 		ir_node  *const base  = get_irn_n(node, n_mips_lw_base);
 		ir_graph *const irg   = get_irn_irg(node);
 		ir_node  *const frame = get_irg_frame(irg);
 		if (base == frame) {
 			mips_immediate_attr_t const *const attr = get_mips_immediate_attr_const(node);
 			if (!attr->ent) {
-				unsigned const size     = MIPS_MACHINE_SIZE / 8; // TODO
+				unsigned const size     = is_mips_ldc1(node) ? 8 : MIPS_MACHINE_SIZE / 8;
 				unsigned const po2align = log2_floor(size);
 				be_load_needs_frame_entity(env, node, size, po2align);
 			}
@@ -198,30 +224,48 @@ static void mips_introduce_prologue_epilogue(ir_graph *const irg)
 	mips_introduce_prologue(irg, size);
 }
 
-static void mips_sp_sim(ir_node *const node, stack_pointer_state_t *const state)
+/**
+ * Returns whether the immediate of @p node may refer to a frame entity.
+ */
+static bool mips_has_frame_immediate(ir_node const *const node)
 {
-	if (is_mips_irn(node)) {
-		switch ((mips_opcodes)get_mips_irn_opcode(node)) {
-		case iro_mips_addiu:
-		case iro_mips_lb:
-		case iro_mips_lbu:
-		case iro_mips_lh:
-		case iro_mips_lhu:
-		case iro_mips_lw:
-		case iro_mips_sb:
-		case iro_mips_sh:
-		case iro_mips_sw: {
-			mips_immediate_attr_t *const imm = get_mips_immediate_attr(node);
-			ir_entity             *const ent = imm->ent;
-			if (ent && is_frame_type(get_entity_owner(ent))) {
-				imm->ent  = NULL;
-				imm->val += state->offset + get_entity_offset(ent);
-			}
-			break;
-		}
+	if (!is_mips_irn(node))
+		return false;
+	switch ((mips_opcodes)get_mips_irn_opcode(node)) {
+	case iro_mips_addiu:
+	case iro_mips_lb:
+	case iro_mips_lbu:
+	case iro_mips_ldc1:
+	case iro_mips_lh:
+	case iro_mips_lhu:
+	case iro_mips_lw:
+	case iro_mips_lwc1:
+	case iro_mips_sb:
+	case iro_mips_sdc1:
+	case iro_mips_sh:
+	case iro_mips_sw:
+	case iro_mips_swc1:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static ir_entity *mips_get_frame_entity(ir_node const *const node)
+{
+	if (!mips_has_frame_immediate(node))
+		return NULL;
+	return get_mips_immediate_attr_const(node)->ent;
+}
 
-		default:
-			break;
+static void mips_sp_sim(ir_node *const node, stack_pointer_state_t *const state)
+{
+	if (mips_has_frame_immediate(node)) {
+		mips_immediate_attr_t *const imm = get_mips_immediate_attr(node);
+		ir_entity             *const ent = imm->ent;
+		if (ent && is_frame_type(get_entity_owner(ent))) {
+			imm->ent  = NULL;
+			imm->val += state->offset + get_entity_offset(ent);
 		}
 	}
 }
@@ -229,6 +273,7 @@ static void mips_sp_sim(ir_node *const node, stack_pointer_state_t *const state)
 static void mips_generate_code(FILE *const output, char const *const cup_name)
 {
 	be_begin(output, cup_name);
+	mips_constants = pmap_create();
 
 	unsigned *const sp_is_non_ssa = rbitset_alloca(N_MIPS_REGISTERS);
 	rbitset_set(sp_is_non_ssa, REG_SP);
@@ -242,12 +287,17 @@ static void mips_generate_code(FILE *const output, char const *const cup_name)
 
 		mips_select_instructions(irg);
 		be_step_schedule(irg);
+
+		be_timer_push(T_RA_PREPARATION);
+		be_sched_fix_flags(irg, &mips_reg_classes[CLASS_mips_fpflags], NULL, NULL, NULL);
+		be_timer_pop(T_RA_PREPARATION);
+
 		be_step_regalloc(irg, &mips_regalloc_if);
 
 		mips_assign_spill_slots(irg);
 
 		ir_type *const frame = get_irg_frame_type(irg);
-		be_sort_frame_entities(frame, true);
+		be_sort_frame_entities(irg, true, mips_get_frame_entity);
 		be_layout_frame_type(frame, 0, 0);
 
 		mips_introduce_prologue_epilogue(irg);
@@ -261,6 +311,7 @@ static void mips_generate_code(FILE *const output, char const *const cup_name)
 		be_step_last(irg);
 	}
 
+	pmap_destroy(mips_constants);
 	be_finish();
 }
 
@@ -291,10 +342,160 @@ static void mips_lower_for_target(void)
 		be_after_transform(irg, "lower-switch");
 	}
 
+	if (use_softfloat) {
+		lower_floating_point();
+		be_after_irp_transform("lower-fp");
+	}
+
 	mips_lower64();
 	be_after_irp_transform("lower-64");
 }
 
+/**
+ * Rewrites an unsigned 32 bit integer to float conversion. MIPS only converts
+ * signed integers, so we do the following:
+ *
+ *   int    signed_x = unsigned_value_x;
+ *   double res      = signed_x;
+ *   if (signed_x < 0)
+ *       res += 4294967296. ;
+ *   return (float) res;
+ */
+static void rewrite_unsigned_float_Conv(ir_node *const node)
+{
+	ir_graph *const irg         = get_irn_irg(node);
+	dbg_info *const dbgi        = get_irn_dbg_info(node);
+	ir_node  *const lower_block = get_nodes_block(node);
+
+	part_block(node);
+
+	ir_node   *const block       = get_nodes_block(node);
+	ir_node   *const unsigned_x  = get_Conv_op(node);
+	ir_mode   *const mode_u      = get_irn_mode(unsigned_x);
+	ir_mode   *const mode_s      = find_signed_mode(mode_u);
+	ir_node   *const signed_x    = new_rd_Conv(dbgi, block, unsigned_x, mode_s);
+	ir_node   *const res         = new_rd_Conv(dbgi, block, signed_x, mode_D);
+	ir_node   *const zero        = new_r_Const_null(irg, mode_s);
+	collect_new_start_block_node(zero);
+	ir_node   *const cmp         = new_rd_Cmp(dbgi, block, signed_x, zero, ir_relation_less);
+	ir_node   *const cond        = new_rd_Cond(dbgi, block, cmp);
+	ir_node   *const proj_true   = new_r_Proj(cond, mode_X, pn_Cond_true);
+	ir_node   *const proj_false  = new_r_Proj(cond, mode_X, pn_Cond_false);
+	ir_node   *const in_true[]   = { proj_true };
+	ir_node   *const in_false[]  = { proj_false };
+	ir_node   *const true_block  = new_r_Block(irg, ARRAY_SIZE(in_true), in_true);
+	ir_node   *const false_block = new_r_Block(irg, ARRAY_SIZE(in_false), in_false);
+	ir_node   *const true_jmp    = new_r_Jmp(true_block);
+	ir_node   *const false_jmp   = new_r_Jmp(false_block);
+	ir_tarval *const correction  = new_tarval_from_double(4294967296., mode_D);
+	ir_node   *const c_const     = new_r_Const(irg, correction);
+	collect_new_start_block_node(c_const);
+	ir_node   *const fadd        = new_rd_Add(dbgi, true_block, res, c_const);
+
+	ir_node *const lower_in[] = { true_jmp, false_jmp };
+	ir_node *const phi_in[]   = { fadd, res };
+	set_irn_in(lower_block, ARRAY_SIZE(lower_in), lower_in);
+	ir_node *const phi = new_r_Phi(lower_block, ARRAY_SIZE(phi_in), phi_in, mode_D);
+	collect_new_phi_node(phi);
+
+	ir_mode *const dest_mode = get_irn_mode(node);
+	ir_node *const res_conv  = new_rd_Conv(dbgi, lower_block, phi, dest_mode);
+	exchange(node, res_conv);
+}
+
+/**
+ * Rewrites a float to unsigned integer conversion. MIPS only converts to
+ * signed integers, so we do the following:
+ *
+ * if (x >= 2147483648.) {
+ *   converted ^= (int)(x-2147483648.) ^ 0x80000000;
+ * } else {
+ *   converted = (int)x;
+ * }
+ * return (unsigned)converted;
+ */
+static void rewrite_float_unsigned_Conv(ir_node *const node)
+{
+	ir_graph *const irg         = get_irn_irg(node);
+	dbg_info *const dbgi        = get_irn_dbg_info(node);
+	ir_node  *const lower_block = get_nodes_block(node);
+
+	part_block(node);
+
+	ir_node   *const block       = get_nodes_block(node);
+	ir_node   *const float_x     = get_Conv_op(node);
+	ir_mode   *const mode_u      = get_irn_mode(node);
+	ir_mode   *const mode_s      = find_signed_mode(mode_u);
+	ir_mode   *const mode_f      = get_irn_mode(float_x);
+	ir_tarval *const limit       = new_tarval_from_double(2147483648., mode_f);
+	ir_node   *const limitc      = new_r_Const(irg, limit);
+	collect_new_start_block_node(limitc);
+	ir_node   *const cmp         = new_rd_Cmp(dbgi, block, float_x, limitc, ir_relation_greater_equal);
+	ir_node   *const cond        = new_rd_Cond(dbgi, block, cmp);
+	ir_node   *const proj_true   = new_r_Proj(cond, mode_X, pn_Cond_true);
+	ir_node   *const proj_false  = new_r_Proj(cond, mode_X, pn_Cond_false);
+	ir_node   *const in_true[]   = { proj_true };
+	ir_node   *const in_false[]  = { proj_false };
+	ir_node   *const true_block  = new_r_Block(irg, ARRAY_SIZE(in_true), in_true);
+	ir_node   *const false_block = new_r_Block(irg, ARRAY_SIZE(in_false), in_false);
+	ir_node   *const true_jmp    = new_r_Jmp(true_block);
+	ir_node   *const false_jmp   = new_r_Jmp(false_block);
+
+	ir_node   *const c_const     = new_r_Const_long(irg, mode_s, 0x80000000L);
+	collect_new_start_block_node(c_const);
+	ir_node   *const sub         = new_rd_Sub(dbgi, true_block, float_x, limitc);
+	ir_node   *const sub_conv    = new_rd_Conv(dbgi, true_block, sub, mode_s);
+	ir_node   *const xorn        = new_rd_Eor(dbgi, true_block, sub_conv, c_const);
+
+	ir_node   *const converted   = new_rd_Conv(dbgi, false_block, float_x, mode_s);
+
+	ir_node *const lower_in[] = { true_jmp, false_jmp };
+	ir_node *const phi_in[]   = { xorn, converted };
+	set_irn_in(lower_block, ARRAY_SIZE(lower_in), lower_in);
+	ir_node *const phi = new_r_Phi(lower_block, ARRAY_SIZE(phi_in), phi_in, mode_s);
+	collect_new_phi_node(phi);
+
+	ir_node *const res_conv = new_rd_Conv(dbgi, lower_block, phi, mode_u);
+	exchange(node, res_conv);
+}
+
+static void handle_intrinsic(ir_node *const node, void *const data)
+{
+	if (!is_Conv(node))
+		return;
+
+	ir_mode *const to_mode   = get_irn_mode(node);
+	ir_mode *const from_mode = get_irn_mode(get_Conv_op(node));
+	if (mode_is_float(to_mode) && mode_is_int(from_mode)
+	    && get_mode_size_bits(from_mode) == 32 && !mode_is_signed(from_mode)) {
+		rewrite_unsigned_float_Conv(node);
+	} else if (mode_is_float(from_mode) && mode_is_int(to_mode)
+	           && get_mode_size_bits(to_mode) <= 32 && !mode_is_signed(to_mode)) {
+		rewrite_float_unsigned_Conv(node);
+	} else {
+		return;
+	}
+	bool *const changed = (bool*)data;
+	*changed = true;
+}
+
+static void mips_handle_intrinsics(ir_graph *const irg)
+{
+	ir_reserve_resources(irg, IR_RESOURCE_IRN_LINK | IR_RESOURCE_PHI_LIST);
+	collect_phiprojs_and_start_block_nodes(irg);
+	bool changed = false;
+	irg_walk_graph(irg, handle_intrinsic, NULL, &changed);
+	ir_free_resources(irg, IR_RESOURCE_IRN_LINK | IR_RESOURCE_PHI_LIST);
+
+	if (changed) {
+		confirm_irg_properties(irg,
+			IR_GRAPH_PROPERTY_NO_BADS
+			| IR_GRAPH_PROPERTY_NO_CRITICAL_EDGES
+			| IR_GRAPH_PROPERTY_MANY_RETURNS
+			| IR_GRAPH_PROPERTY_ONE_RETURN);
+	}
+}
+
 static unsigned mips_get_op_estimated_cost(ir_node const *const node)
 {
 	(void)node; // TODO
@@ -316,6 +517,7 @@ arch_isa_if_t const mips_isa_if = {
 	.finish                = mips_finish,
 	.generate_code         = mips_generate_code,
 	.lower_for_target      = mips_lower_for_target,
+	.handle_intrinsics     = mips_handle_intrinsics,
 	.register_prefix       = '$',
 	.get_op_estimated_cost = mips_get_op_estimated_cost,
 };
@@ -323,4 +525,7 @@ arch_isa_if_t const mips_isa_if = {
 BE_REGISTER_MODULE_CONSTRUCTOR(be_init_arch_mips)
 void be_init_arch_mips(void)
 {
+	lc_opt_entry_t *const be_grp   = lc_opt_get_grp(firm_opt_get_root(), "be");
+	lc_opt_entry_t *const mips_grp = lc_opt_get_grp(be_grp, "mips");
+	lc_opt_add_table(mips_grp, mips_options);
 }
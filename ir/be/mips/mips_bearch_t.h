@@ -6,6 +6,11 @@
 #ifndef FIRM_BE_MIPS_MIPS_BEARCH_T_H
 #define FIRM_BE_MIPS_MIPS_BEARCH_T_H
 
+#include "pmap.h"
+
 #define MIPS_MACHINE_SIZE 32
 
+/** Maps floating point tarvals to their constant entities. */
+extern pmap *mips_constants;
+
 #endif
@@ -17,16 +17,27 @@ static unsigned const regs_param_gp[] = {
 	REG_A3,
 };
 
+static unsigned const regs_param_fp[] = {
+	REG_F12,
+	REG_F14,
+};
+
 static unsigned const regs_result_gp[] = {
 	REG_V0,
 	REG_V1,
 };
 
+static unsigned const regs_result_fp[] = {
+	REG_F0,
+	REG_F2,
+};
+
 void mips_determine_calling_convention(mips_calling_convention_t *const cconv, ir_type *const fun_type)
 {
 	/* Handle parameters. */
 	mips_reg_or_slot_t *params;
 	size_t              gp_param = 0;
+	size_t              fp_param = 0;
 	size_t        const n_params = get_method_n_params(fun_type);
 	if (n_params != 0) {
 		params = XMALLOCNZ(mips_reg_or_slot_t, n_params);
@@ -37,7 +48,21 @@ void mips_determine_calling_convention(mips_calling_convention_t *const cconv, i
 			if (!param_mode) {
 				panic("TODO");
 			} else if (mode_is_float(param_mode)) {
-				panic("TODO");
+				/* Only leading floating point parameters are passed in fp
+				 * registers, all others use the slots of the gp registers.
+				 * Doubles are aligned to an even slot. */
+				unsigned const n_slots = get_mode_size_bytes(param_mode) / (MIPS_MACHINE_SIZE / 8);
+				if (n_slots == 2 && gp_param % 2 != 0)
+					++gp_param;
+				if (fp_param == i && fp_param < ARRAY_SIZE(regs_param_fp)) {
+					params[i].reg = &mips_registers[regs_param_fp[fp_param++]];
+				} else if (gp_param + n_slots <= ARRAY_SIZE(regs_param_gp)) {
+					params[i].reg = &mips_registers[regs_param_gp[gp_param]];
+					if (n_slots == 2)
+						params[i].reg1 = &mips_registers[regs_param_gp[gp_param + 1]];
+				}
+				params[i].offset = gp_param * (MIPS_MACHINE_SIZE / 8);
+				gp_param += n_slots;
 			} else {
 				if (param_type->flags & tf_lowered_dw && gp_param % 2 != 0)
 					++gp_param;
@@ -62,13 +87,16 @@ void mips_determine_calling_convention(mips_calling_convention_t *const cconv, i
 		results = XMALLOCNZ(mips_reg_or_slot_t, n_results);
 
 		size_t gp_res = 0;
+		size_t fp_res = 0;
 		for (size_t i = 0; i != n_results; ++i) {
 			ir_type *const res_type = get_method_res_type(fun_type, i);
 			ir_mode *const res_mode = get_type_mode(res_type);
 			if (!res_mode) {
 				panic("TODO");
 			} else if (mode_is_float(res_mode)) {
-				panic("TODO");
+				if (fp_res == ARRAY_SIZE(regs_result_fp))
+					panic("too many fp results");
+				results[i].reg = &mips_registers[regs_result_fp[fp_res++]];
 			} else {
 				if (gp_res == ARRAY_SIZE(regs_result_gp))
 					panic("too many gp results");
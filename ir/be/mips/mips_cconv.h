@@ -10,6 +10,7 @@
 
 typedef struct mips_reg_or_slot_t {
 	arch_register_t const *reg;
+	arch_register_t const *reg1;   /**< second register of a double passed in gp registers */
 	unsigned               offset;
 	ir_entity             *entity;
 } mips_reg_or_slot_t;
@@ -78,6 +78,30 @@ void mips_emitf(ir_node const *const node, char const *fmt, ...)
 		case 'I': emit_immediate("%lo", node); break;
 		case 'J': emit_immediate(NULL,  node); break;
 
+		case 'M': {
+			mips_fp_attr_t const *const attr = get_mips_fp_attr_const(node);
+			be_emit_string(mips_get_mode_suffix(attr->mode));
+			break;
+		}
+
+		case 'O': {
+			/* The odd register of the pair holding a double. */
+			arch_register_t const *reg;
+			char            const  kind = *fmt++;
+			if (!is_digit(*fmt))
+				goto unknown;
+			unsigned const pos = *fmt++ - '0';
+			if (kind == 'D') {
+				reg = arch_get_irn_register_out(node, pos);
+			} else if (kind == 'S') {
+				reg = arch_get_irn_register_in(node, pos);
+			} else {
+				goto unknown;
+			}
+			be_emit_irprintf("$f%u", reg->encoding + 1);
+			break;
+		}
+
 		case 'R':
 			emit_register(va_arg(ap, arch_register_t const*));
 			break;
@@ -90,6 +114,12 @@ void mips_emitf(ir_node const *const node, char const *fmt, ...)
 			break;
 		}
 
+		case 'V': {
+			mips_conv_attr_t const *const attr = get_mips_conv_attr_const(node);
+			be_emit_irprintf("%s.%s", mips_get_mode_suffix(attr->dst_mode), mips_get_mode_suffix(attr->src_mode));
+			break;
+		}
+
 		default:
 unknown:
 			panic("unknown format conversion");
@@ -164,6 +194,8 @@ static void emit_be_Copy(ir_node const *const node)
 
 	if (in->cls == &mips_reg_classes[CLASS_mips_gp]) {
 		mips_emitf(node, "move\t%R, %R", out, in);
+	} else if (in->cls == &mips_reg_classes[CLASS_mips_fp]) {
+		mips_emitf(node, "mov.d\t%R, %R", out, in);
 	} else {
 		panic("unexpected register class");
 	}
@@ -184,6 +216,14 @@ static void emit_be_Perm(ir_node const *const node)
 			"xor\t%D1, %D0, %D1\n"
 			"xor\t%D0, %D0, %D1"
 		);
+	} else if (out->cls == &mips_reg_classes[CLASS_mips_fp]) {
+		arch_register_t const *const tmp = &mips_registers[REG_F18];
+		mips_emitf(node,
+			"mov.d\t%R, %D0\n"
+			"mov.d\t%D0, %D1\n"
+			"mov.d\t%D1, %R",
+			tmp, tmp
+		);
 	} else {
 		panic("unexpected register class");
 	}
@@ -197,7 +237,10 @@ static void emit_mips_b(ir_node const *const node)
 static void emit_mips_bcc(ir_node const *const node)
 {
 	mips_cond_t            const cond  = get_mips_cond_attr_const(node)->cond;
-	char            const *const fmt   = cond == mips_cc_eq || cond == mips_cc_ne ? "b%C\t%S0, %S1, %L\nnop" : "b%C\t%S0, %L\nnop";
+	char            const *const fmt   =
+		cond == mips_cc_eq  || cond == mips_cc_ne  ? "b%C\t%S0, %S1, %L\nnop" :
+		cond == mips_cc_c1f || cond == mips_cc_c1t ? "b%C\t%L\nnop" :
+		"b%C\t%S0, %L\nnop";
 	be_cond_branch_projs_t const projs = be_get_cond_branch_projs(node);
 	if (be_is_fallthrough(projs.t)) {
 		mips_emitf(node, fmt, mips_negate_cond(cond), projs.f);
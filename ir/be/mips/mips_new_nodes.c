@@ -36,6 +36,25 @@ int mips_cond_attrs_equal(ir_node const *const a, ir_node const *const b)
 		a_attr->cond == b_attr->cond;
 }
 
+int mips_conv_attrs_equal(ir_node const *const a, ir_node const *const b)
+{
+	mips_conv_attr_t const *const a_attr = get_mips_conv_attr_const(a);
+	mips_conv_attr_t const *const b_attr = get_mips_conv_attr_const(b);
+	return
+		mips_attrs_equal_(&a_attr->attr, &b_attr->attr) &&
+		a_attr->src_mode == b_attr->src_mode &&
+		a_attr->dst_mode == b_attr->dst_mode;
+}
+
+int mips_fp_attrs_equal(ir_node const *const a, ir_node const *const b)
+{
+	mips_fp_attr_t const *const a_attr = get_mips_fp_attr_const(a);
+	mips_fp_attr_t const *const b_attr = get_mips_fp_attr_const(b);
+	return
+		mips_attrs_equal_(&a_attr->attr, &b_attr->attr) &&
+		a_attr->mode == b_attr->mode;
+}
+
 int mips_immediate_attrs_equal(ir_node const *const a, ir_node const *const b)
 {
 	mips_immediate_attr_t const *const a_attr = get_mips_immediate_attr_const(a);
@@ -86,16 +105,20 @@ void mips_dump_node(FILE *const F, ir_node const *const n, dump_reason_t const r
 			case iro_mips_addiu:
 			case iro_mips_lb:
 			case iro_mips_lbu:
+			case iro_mips_ldc1:
 			case iro_mips_lh:
 			case iro_mips_lhu:
 			case iro_mips_lw:
+			case iro_mips_lwc1:
 			case iro_mips_sb:
+			case iro_mips_sdc1:
 			case iro_mips_sh:
 			case iro_mips_sll:
 			case iro_mips_sltiu:
 			case iro_mips_sra:
 			case iro_mips_srl:
 			case iro_mips_sw:
+			case iro_mips_swc1:
 				dump_immediate(F, "%lo", n);
 				break;
 
@@ -113,6 +136,30 @@ void mips_dump_node(FILE *const F, ir_node const *const n, dump_reason_t const r
 				break;
 			}
 
+			case iro_mips_c_eq:
+			case iro_mips_c_ole:
+			case iro_mips_c_olt:
+			case iro_mips_c_ueq:
+			case iro_mips_c_ule:
+			case iro_mips_c_ult:
+			case iro_mips_c_un:
+			case iro_mips_fadd:
+			case iro_mips_fdiv:
+			case iro_mips_fmul:
+			case iro_mips_fneg:
+			case iro_mips_fsub: {
+				mips_fp_attr_t const *const fp = get_mips_fp_attr_const(n);
+				fprintf(F, " %s", mips_get_mode_suffix(fp->mode));
+				break;
+			}
+
+			case iro_mips_cvt:
+			case iro_mips_trunc_w: {
+				mips_conv_attr_t const *const conv = get_mips_conv_attr_const(n);
+				fprintf(F, " %s.%s", mips_get_mode_suffix(conv->dst_mode), mips_get_mode_suffix(conv->src_mode));
+				break;
+			}
+
 			case iro_mips_jal:
 				dump_immediate(F, NULL, n);
 				break;
@@ -131,6 +178,12 @@ void mips_dump_node(FILE *const F, ir_node const *const n, dump_reason_t const r
 			case iro_mips_ijmp:
 			case iro_mips_jalr:
 			case iro_mips_last:
+			case iro_mips_mfc1:
+			case iro_mips_mfc1_d:
+			case iro_mips_movf:
+			case iro_mips_movt:
+			case iro_mips_mtc1:
+			case iro_mips_mtc1_d:
 			case iro_mips_mult_hi:
 			case iro_mips_mult_lo:
 			case iro_mips_multu_hi:
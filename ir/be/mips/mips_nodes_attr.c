@@ -16,6 +16,17 @@ char const *mips_get_cond_name(mips_cond_t const cond)
 	case mips_cc_gez: return "gez";
 	case mips_cc_lez: return "lez";
 	case mips_cc_gtz: return "gtz";
+	case mips_cc_c1f: return "c1f";
+	case mips_cc_c1t: return "c1t";
 	}
 	panic("invalid cond");
 }
+
+char const *mips_get_mode_suffix(ir_mode const *const mode)
+{
+	switch (get_mode_size_bits(mode)) {
+	case 32: return mode_is_float(mode) ? "s" : "w";
+	case 64: return mode_is_float(mode) ? "d" : "l";
+	}
+	panic("unexpected mode %+F", mode);
+}
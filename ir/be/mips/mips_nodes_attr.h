@@ -24,6 +24,8 @@ typedef enum mips_cond_t {
 	mips_cc_gez,
 	mips_cc_lez,
 	mips_cc_gtz,
+	mips_cc_c1f, /**< FP condition code false */
+	mips_cc_c1t, /**< FP condition code true */
 } mips_cond_t;
 
 static inline mips_cond_t mips_negate_cond(mips_cond_t const c)
@@ -42,6 +44,17 @@ typedef struct mips_cond_attr_t {
 	mips_cond_t cond;
 } mips_cond_attr_t;
 
+typedef struct mips_conv_attr_t {
+	mips_attr_t attr;
+	ir_mode    *src_mode;
+	ir_mode    *dst_mode;
+} mips_conv_attr_t;
+
+typedef struct mips_fp_attr_t {
+	mips_attr_t attr;
+	ir_mode    *mode;
+} mips_fp_attr_t;
+
 typedef struct mips_immediate_attr_t {
 	mips_attr_t attr;
 	ir_entity  *ent;
@@ -63,6 +76,16 @@ static inline mips_cond_attr_t const *get_mips_cond_attr_const(ir_node const *co
 	return (mips_cond_attr_t const*)get_irn_generic_attr_const(node);
 }
 
+static inline mips_conv_attr_t const *get_mips_conv_attr_const(ir_node const *const node)
+{
+	return (mips_conv_attr_t const*)get_irn_generic_attr_const(node);
+}
+
+static inline mips_fp_attr_t const *get_mips_fp_attr_const(ir_node const *const node)
+{
+	return (mips_fp_attr_t const*)get_irn_generic_attr_const(node);
+}
+
 static inline mips_immediate_attr_t *get_mips_immediate_attr(ir_node *const node)
 {
 	return (mips_immediate_attr_t*)get_irn_generic_attr_const(node);
@@ -80,4 +103,9 @@ static inline mips_switch_attr_t const *get_mips_switch_attr_const(ir_node const
 
 char const *mips_get_cond_name(mips_cond_t cond);
 
+/**
+ * Returns the format suffix of @p mode as used by floating point instructions.
+ */
+char const *mips_get_mode_suffix(ir_mode const *mode);
+
 #endif
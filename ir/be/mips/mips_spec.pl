@@ -4,6 +4,7 @@
 $arch = "mips";
 
 my $mode_gp = "mode_Iu"; # TODO
+my $mode_fp = "mode_D";
 
 %reg_classes = (
 	gp => {
@@ -43,12 +44,45 @@ my $mode_gp = "mode_Iu"; # TODO
 			{ name => "ra",   encoding => 31 },
 		]
 	},
+	# Doubles occupy an even/odd register pair, so only the even registers
+	# are allocated.
+	fp => {
+		mode => $mode_fp,
+		registers => [
+			{ name => "f0",  encoding =>  0 },
+			{ name => "f2",  encoding =>  2 },
+			{ name => "f4",  encoding =>  4 },
+			{ name => "f6",  encoding =>  6 },
+			{ name => "f8",  encoding =>  8 },
+			{ name => "f10", encoding => 10 },
+			{ name => "f12", encoding => 12 },
+			{ name => "f14", encoding => 14 },
+			{ name => "f16", encoding => 16 },
+			{ name => "f18", encoding => 18 },
+			{ name => "f20", encoding => 20 },
+			{ name => "f22", encoding => 22 },
+			{ name => "f24", encoding => 24 },
+			{ name => "f26", encoding => 26 },
+			{ name => "f28", encoding => 28 },
+			{ name => "f30", encoding => 30 },
+		]
+	},
+	fpflags => {
+		flags => "manual_ra",
+		mode => "mode_Bu",
+		registers => [ { name => "fcc0" } ]
+	},
 );
 
 %init_attr = (
 	mips_attr_t => "",
 	mips_cond_attr_t =>
 		"attr->cond = cond;",
+	mips_conv_attr_t =>
+		"attr->src_mode = src_mode;\n".
+		"\tattr->dst_mode = dst_mode;",
+	mips_fp_attr_t =>
+		"attr->mode = mode;",
 	mips_immediate_attr_t =>
 		"attr->ent = ent;\n".
 		"\tattr->val = val;",
@@ -73,6 +107,16 @@ my $callOp = {
   outs      => [ "M",   "stack", "first_result" ],
 };
 
+my $convOp = {
+	irn_flags => [ "rematerializable" ],
+	in_reqs   => [ "cls-fp" ],
+	out_reqs  => [ "cls-fp" ],
+	ins       => [ "val" ],
+	outs      => [ "res" ],
+	attr_type => "mips_conv_attr_t",
+	attr      => "ir_mode *const src_mode, ir_mode *const dst_mode",
+};
+
 my $divOp = {
 	in_reqs   => [ "cls-gp", "cls-gp" ],
 	out_reqs  => [ "cls-gp" ],
@@ -82,6 +126,26 @@ my $divOp = {
 	             "mflo\t%D0",
 };
 
+my $fpBinOp = {
+	irn_flags => [ "rematerializable" ],
+	in_reqs   => [ "cls-fp", "cls-fp" ],
+	out_reqs  => [ "cls-fp" ],
+	ins       => [ "left", "right" ],
+	outs      => [ "res" ],
+	attr_type => "mips_fp_attr_t",
+	attr      => "ir_mode *const mode",
+};
+
+my $fpCmpOp = {
+	irn_flags => [ "rematerializable" ],
+	in_reqs   => [ "cls-fp", "cls-fp" ],
+	out_reqs  => [ "fpflags" ],
+	ins       => [ "left", "right" ],
+	outs      => [ "flags" ],
+	attr_type => "mips_fp_attr_t",
+	attr      => "ir_mode *const mode",
+};
+
 my $immediateOp = {
 	irn_flags => [ "rematerializable" ],
 	in_reqs   => [ "cls-gp" ],
@@ -104,6 +168,8 @@ my $loadOp = {
 	emit      => "{name}\t%D1, %A",
 };
 
+my $fpLoadOp = { %$loadOp, out_reqs => [ "mem", "cls-fp" ] };
+
 my $modOp = {
 	in_reqs   => [ "cls-gp", "cls-gp" ],
 	out_reqs  => [ "cls-gp" ],
@@ -124,6 +190,16 @@ my $storeOp = {
 	emit      => "{name}\t%S2, %A",
 };
 
+my $fpStoreOp = { %$storeOp, in_reqs => [ "mem", "cls-gp", "cls-fp" ] };
+
+my $fpSetOp = {
+	irn_flags => [ "rematerializable" ],
+	in_reqs   => [ "fpflags" ],
+	out_reqs  => [ "cls-gp" ],
+	ins       => [ "flags" ],
+	outs      => [ "res" ],
+};
+
 %nodes = (
 
 addu => { template => $binOp },
@@ -148,6 +224,7 @@ bcc => {
 	constructors => {
 		""  => { in_reqs => [ "cls-gp", "cls-gp" ], ins => [ "left", "right" ] },
 		"z" => { in_reqs => [ "cls-gp" ],           ins => [ "left" ]          },
+		"c1" => { in_reqs => [ "fpflags" ],         ins => [ "flags" ]         },
 	},
 	out_reqs     => [ "exec", "exec" ],
 	outs         => [ "false", "true" ],
@@ -155,6 +232,19 @@ bcc => {
 	attr         => "mips_cond_t const cond",
 },
 
+c_eq  => { template => $fpCmpOp, emit => "c.eq.%M\t%S0, %S1"  },
+c_ole => { template => $fpCmpOp, emit => "c.ole.%M\t%S0, %S1" },
+c_olt => { template => $fpCmpOp, emit => "c.olt.%M\t%S0, %S1" },
+c_ueq => { template => $fpCmpOp, emit => "c.ueq.%M\t%S0, %S1" },
+c_ule => { template => $fpCmpOp, emit => "c.ule.%M\t%S0, %S1" },
+c_ult => { template => $fpCmpOp, emit => "c.ult.%M\t%S0, %S1" },
+c_un  => { template => $fpCmpOp, emit => "c.un.%M\t%S0, %S1"  },
+
+cvt => {
+	template => $convOp,
+	emit     => "cvt.%V\t%D0, %S0",
+},
+
 div_lo => {
 	template => $divOp,
 	name     => "div",
@@ -165,6 +255,33 @@ divu_lo => {
 	name     => "divu",
 },
 
+fadd => {
+	template => $fpBinOp,
+	emit     => "add.%M\t%D0, %S0, %S1",
+},
+
+fdiv => {
+	template => $fpBinOp,
+	emit     => "div.%M\t%D0, %S0, %S1",
+},
+
+fmul => {
+	template => $fpBinOp,
+	emit     => "mul.%M\t%D0, %S0, %S1",
+},
+
+fneg => {
+	template => $fpBinOp,
+	in_reqs  => [ "cls-fp" ],
+	ins      => [ "val" ],
+	emit     => "neg.%M\t%D0, %S0",
+},
+
+fsub => {
+	template => $fpBinOp,
+	emit     => "sub.%M\t%D0, %S0, %S1",
+},
+
 ijmp => {
 	state    => "pinned",
 	op_flags => [ "cfopcode", "unknown_jump" ],
@@ -190,6 +307,8 @@ jalr => {
 
 lb => { template => $loadOp },
 
+ldc1 => { template => $fpLoadOp },
+
 lbu => { template => $loadOp },
 
 lh => { template => $loadOp },
@@ -205,6 +324,59 @@ lui => {
 
 lw => { template => $loadOp },
 
+lwc1 => { template => $fpLoadOp },
+
+mfc1 => {
+	irn_flags => [ "rematerializable" ],
+	in_reqs   => [ "cls-fp" ],
+	out_reqs  => [ "cls-gp" ],
+	ins       => [ "val" ],
+	outs      => [ "res" ],
+	emit      => "mfc1\t%D0, %S0",
+},
+
+# Moves a double into a register pair. The even register holds the lower half.
+mfc1_d => {
+	irn_flags => [ "rematerializable" ],
+	in_reqs   => [ "cls-fp" ],
+	out_reqs  => [ "cls-gp", "cls-gp" ],
+	ins       => [ "val" ],
+	outs      => [ "lo", "hi" ],
+	emit      => "mfc1\t%D0, %S0\n".
+	             "mfc1\t%D1, %OS0",
+},
+
+movf => {
+	template => $fpSetOp,
+	emit     => "li\t%D0, 1\n".
+	            "movf\t%D0, \$zero, \$fcc0",
+},
+
+movt => {
+	template => $fpSetOp,
+	emit     => "li\t%D0, 1\n".
+	            "movt\t%D0, \$zero, \$fcc0",
+},
+
+mtc1 => {
+	irn_flags => [ "rematerializable" ],
+	in_reqs   => [ "cls-gp" ],
+	out_reqs  => [ "cls-fp" ],
+	ins       => [ "val" ],
+	outs      => [ "res" ],
+	emit      => "mtc1\t%S0, %D0",
+},
+
+mtc1_d => {
+	irn_flags => [ "rematerializable" ],
+	in_reqs   => [ "cls-gp", "cls-gp" ],
+	out_reqs  => [ "cls-fp" ],
+	ins       => [ "lo", "hi" ],
+	outs      => [ "res" ],
+	emit      => "mtc1\t%S0, %D0\n".
+	             "mtc1\t%S1, %OD0",
+},
+
 div_hi => {
 	template => $modOp,
 	name     => "div",
@@ -250,6 +422,8 @@ ret => {
 
 sb => { template => $storeOp },
 
+sdc1 => { template => $fpStoreOp },
+
 sh => { template => $storeOp },
 
 sll => { template => $immediateOp },
@@ -274,6 +448,8 @@ subu => { template => $binOp },
 
 sw => { template => $storeOp },
 
+swc1 => { template => $fpStoreOp },
+
 switch => {
 	op_flags  => [ "cfopcode", "forking" ],
 	state     => "pinned",
@@ -283,6 +459,11 @@ switch => {
 	attr      => "const ir_switch_table *table, ir_entity *table_entity",
 },
 
+trunc_w => {
+	template => $convOp,
+	emit     => "trunc.%V\t%D0, %S0",
+},
+
 xor => { template => $binOp },
 
 xori => { template => $immediateOp },
@@ -31,6 +31,12 @@ static unsigned const callee_saves[] = {
 	REG_S6,
 	REG_S7,
 	REG_S8,
+	REG_F20,
+	REG_F22,
+	REG_F24,
+	REG_F26,
+	REG_F28,
+	REG_F30,
 };
 
 static unsigned const caller_saves[] = {
@@ -51,6 +57,16 @@ static unsigned const caller_saves[] = {
 	REG_T8,
 	REG_T9,
 	REG_RA,
+	REG_F0,
+	REG_F2,
+	REG_F4,
+	REG_F6,
+	REG_F8,
+	REG_F10,
+	REG_F12,
+	REG_F14,
+	REG_F16,
+	/* REG_F18 is reserved as scratch register for Perms. */
 };
 
 static ir_node *get_Start_sp(ir_graph *const irg)
@@ -293,8 +309,26 @@ static ir_node *gen_ASM(ir_node *const node)
 	return be_make_asm(node, &info, operands);
 }
 
+typedef ir_node *cons_fp_binop(dbg_info*, ir_node*, ir_node*, ir_node*, ir_mode*);
+
+static ir_node *gen_fp_binop(ir_node *const node, ir_node *const l, ir_node *const r, cons_fp_binop *const cons)
+{
+	dbg_info *const dbgi  = get_irn_dbg_info(node);
+	ir_node  *const block = be_transform_nodes_block(node);
+	ir_node  *const new_l = be_transform_node(l);
+	ir_node  *const new_r = be_transform_node(r);
+	ir_mode  *const mode  = get_irn_mode(l);
+	return cons(dbgi, block, new_l, new_r, mode);
+}
+
 static ir_node *gen_Add(ir_node *const node)
 {
+	ir_node *const l    = get_Add_left(node);
+	ir_node *const r    = get_Add_right(node);
+	ir_mode *const mode = get_irn_mode(node);
+	if (mode_is_float(mode))
+		return gen_fp_binop(node, l, r, &new_bd_mips_fadd);
+
 	ir_tarval *tv;
 	ir_entity *ent;
 	unsigned   reloc_kind;
@@ -304,9 +338,6 @@ static ir_node *gen_Add(ir_node *const node)
 		return make_address(node, ent, val);
 	}
 
-	ir_node *const l    = get_Add_left(node);
-	ir_node *const r    = get_Add_right(node);
-	ir_mode *const mode = get_irn_mode(node);
 	if (be_mode_needs_gp_reg(mode)) {
 		dbg_info *const dbgi  = get_irn_dbg_info(node);
 		ir_node  *const block = be_transform_nodes_block(node);
@@ -371,11 +402,18 @@ static ir_node *gen_Builtin(ir_node *const node)
 	case ir_bk_saturating_increment: return gen_saturating_increment(node);
 
 	case ir_bk_bswap:
+	case ir_bk_ceil:
 	case ir_bk_clz:
 	case ir_bk_compare_swap:
+	case ir_bk_copysign:
 	case ir_bk_ctz:
+	case ir_bk_cycle_counter:
 	case ir_bk_debugbreak:
+	case ir_bk_fabs:
 	case ir_bk_ffs:
+	case ir_bk_floor:
+	case ir_bk_fmax:
+	case ir_bk_fmin:
 	case ir_bk_frame_address:
 	case ir_bk_inport:
 	case ir_bk_may_alias:
@@ -384,7 +422,10 @@ static ir_node *gen_Builtin(ir_node *const node)
 	case ir_bk_popcount:
 	case ir_bk_prefetch:
 	case ir_bk_return_address:
+	case ir_bk_round:
+	case ir_bk_sqrt:
 	case ir_bk_trap:
+	case ir_bk_trunc:
 	case ir_bk_va_arg:
 	case ir_bk_va_start:
 		TODO(node);
@@ -392,14 +433,40 @@ static ir_node *gen_Builtin(ir_node *const node)
 	panic("unexpected Builtin");
 }
 
+typedef ir_node *cons_loadop(dbg_info*, ir_node*, ir_node*, ir_node*, ir_entity*, int32_t);
+typedef ir_node *cons_storeop(dbg_info*, ir_node*, ir_node*, ir_node*, ir_node*, ir_entity*, int32_t);
+
+static cons_loadop *get_fp_load_cons(ir_mode *const mode)
+{
+	return get_mode_size_bits(mode) == 32 ? &new_bd_mips_lwc1 : &new_bd_mips_ldc1;
+}
+
+static cons_storeop *get_fp_store_cons(ir_mode *const mode)
+{
+	return get_mode_size_bits(mode) == 32 ? &new_bd_mips_swc1 : &new_bd_mips_sdc1;
+}
+
 static ir_node *gen_Call(ir_node *const node)
 {
 	ir_graph *const irg = get_irn_irg(node);
 
-	unsigned                          p        = n_mips_jal_first_argument;
-	unsigned                    const n_params = get_Call_n_params(node);
-	unsigned                    const n_ins    = p + 1 + n_params;
-	arch_register_req_t const **const reqs     = be_allocate_in_reqs(irg, n_ins);
+	ir_type *const fun_type = get_Call_type(node);
+	record_returns_twice(irg, fun_type);
+
+	mips_calling_convention_t cconv;
+	mips_determine_calling_convention(&cconv, fun_type);
+
+	/* Doubles passed in gp registers need two inputs. */
+	unsigned const n_params = get_Call_n_params(node);
+	unsigned       n_pairs  = 0;
+	for (size_t i = 0; i != n_params; ++i) {
+		if (cconv.parameters[i].reg1)
+			++n_pairs;
+	}
+
+	unsigned                          p     = n_mips_jal_first_argument;
+	unsigned                    const n_ins = p + 1 + n_params + n_pairs;
+	arch_register_req_t const **const reqs  = be_allocate_in_reqs(irg, n_ins);
 	ir_node                          *ins[n_ins];
 
 	ir_entity     *callee;
@@ -413,12 +480,6 @@ static ir_node *gen_Call(ir_node *const node)
 		++p;
 	}
 
-	ir_type *const fun_type = get_Call_type(node);
-	record_returns_twice(irg, fun_type);
-
-	mips_calling_convention_t cconv;
-	mips_determine_calling_convention(&cconv, fun_type);
-
 	ir_node *mems[1 + cconv.n_mem_param];
 	unsigned m = 0;
 
@@ -435,10 +496,34 @@ static ir_node *gen_Call(ir_node *const node)
 
 	dbg_info *const dbgi = get_irn_dbg_info(node);
 	for (size_t i = 0; i != n_params; ++i) {
-		ir_node *const arg = get_Call_param(node, i);
-		ir_node *const val = extend_value(arg);
-
+		ir_node                  *const arg   = get_Call_param(node, i);
+		ir_mode                  *const mode  = get_irn_mode(arg);
 		mips_reg_or_slot_t const *const param = &cconv.parameters[i];
+		if (mode_is_float(mode)) {
+			ir_node *const val = be_transform_node(arg);
+			if (param->reg1) {
+				/* The first register holds the upper half (big endian). */
+				ir_node *const mfc1 = new_bd_mips_mfc1_d(dbgi, block, val);
+				ins[p]  = be_new_Proj(mfc1, pn_mips_mfc1_d_hi);
+				reqs[p] = param->reg->single_req;
+				++p;
+				ins[p]  = be_new_Proj(mfc1, pn_mips_mfc1_d_lo);
+				reqs[p] = param->reg1->single_req;
+				++p;
+			} else if (param->reg) {
+				bool const in_gp = param->reg->cls == &mips_reg_classes[CLASS_mips_gp];
+				ins[p]  = in_gp ? new_bd_mips_mfc1(dbgi, block, val) : val;
+				reqs[p] = param->reg->single_req;
+				++p;
+			} else {
+				ir_node      *const nomem = get_irg_no_mem(irg);
+				cons_storeop *const cons  = get_fp_store_cons(mode);
+				mems[m++] = cons(dbgi, block, nomem, call_frame, val, NULL, param->offset);
+			}
+			continue;
+		}
+
+		ir_node *const val = extend_value(arg);
 		if (param->reg) {
 			ins[p]  = val;
 			reqs[p] = param->reg->single_req;
@@ -473,12 +558,61 @@ static ir_node *gen_Call(ir_node *const node)
 	return jal;
 }
 
+typedef ir_node *cons_fp_cmp(dbg_info*, ir_node*, ir_node*, ir_node*, ir_mode*);
+
+/**
+ * Creates a floating point comparison setting the condition code. The
+ * comparisons only test for less, equal and unordered, so some relations are
+ * tested negated, which is indicated by @p negated.
+ */
+static ir_node *gen_fp_cmp(ir_node *const node, bool *const negated)
+{
+	ir_node     *l   = get_Cmp_left(node);
+	ir_node     *r   = get_Cmp_right(node);
+	ir_relation  rel = get_Cmp_relation(node);
+	if (rel & ir_relation_greater && !(rel & ir_relation_less)) {
+		ir_node *const t = l;
+		l   = r;
+		r   = t;
+		rel = get_inversed_relation(rel);
+	}
+
+	cons_fp_cmp *cons;
+	*negated = false;
+	switch (rel) {
+	case ir_relation_equal:                  cons = &new_bd_mips_c_eq;  break;
+	case ir_relation_less:                   cons = &new_bd_mips_c_olt; break;
+	case ir_relation_less_equal:             cons = &new_bd_mips_c_ole; break;
+	case ir_relation_unordered:              cons = &new_bd_mips_c_un;  break;
+	case ir_relation_unordered_equal:        cons = &new_bd_mips_c_ueq; break;
+	case ir_relation_unordered_less:         cons = &new_bd_mips_c_ult; break;
+	case ir_relation_unordered_less_equal:   cons = &new_bd_mips_c_ule; break;
+	case ir_relation_less_greater:           cons = &new_bd_mips_c_ueq; *negated = true; break;
+	case ir_relation_less_equal_greater:     cons = &new_bd_mips_c_un;  *negated = true; break;
+	case ir_relation_unordered_less_greater: cons = &new_bd_mips_c_eq;  *negated = true; break;
+	default: panic("unexpected relation");
+	}
+
+	dbg_info *const dbgi  = get_irn_dbg_info(node);
+	ir_node  *const block = be_transform_nodes_block(node);
+	ir_node  *const new_l = be_transform_node(l);
+	ir_node  *const new_r = be_transform_node(r);
+	ir_mode  *const mode  = get_irn_mode(l);
+	return cons(dbgi, block, new_l, new_r, mode);
+}
+
 static ir_node *gen_Cmp(ir_node *const node)
 {
 	ir_node       *l    = get_Cmp_left(node);
 	ir_node       *r    = get_Cmp_right(node);
 	ir_mode *const mode = get_irn_mode(l);
-	if (be_mode_needs_gp_reg(mode)) {
+	if (mode_is_float(mode)) {
+		bool            negated;
+		ir_node  *const flags = gen_fp_cmp(node, &negated);
+		dbg_info *const dbgi  = get_irn_dbg_info(node);
+		ir_node  *const block = be_transform_nodes_block(node);
+		return negated ? new_bd_mips_movt(dbgi, block, flags) : new_bd_mips_movf(dbgi, block, flags);
+	} else if (be_mode_needs_gp_reg(mode)) {
 		ir_relation const rel = get_Cmp_relation(node) & ir_relation_less_equal_greater;
 		switch (rel) {
 		case ir_relation_greater:
@@ -524,7 +658,14 @@ static ir_node *gen_Cond(ir_node *const node)
 	if (is_Cmp(sel)) {
 		ir_node *const l    = get_Cmp_left(sel);
 		ir_mode *const mode = get_irn_mode(l);
-		if (be_mode_needs_gp_reg(mode)) {
+		if (mode_is_float(mode)) {
+			bool               negated;
+			ir_node     *const flags = gen_fp_cmp(sel, &negated);
+			dbg_info    *const dbgi  = get_irn_dbg_info(node);
+			ir_node     *const block = be_transform_nodes_block(node);
+			mips_cond_t  const cc    = negated ? mips_cc_c1f : mips_cc_c1t;
+			return new_bd_mips_bcc_c1(dbgi, block, flags, cc);
+		} else if (be_mode_needs_gp_reg(mode)) {
 			ir_relation    rel = get_Cmp_relation(sel) & ir_relation_less_equal_greater;
 			ir_node *const r   = get_Cmp_right(sel);
 			if (is_irn_null(r)) {
@@ -599,16 +740,51 @@ bcceqz:;
 
 static ir_node *gen_Conv(ir_node *const node)
 {
-	ir_node *const op      = get_Conv_op(node);
-	ir_mode *const op_mode = get_irn_mode(op);
-	ir_mode *const mode    = get_irn_mode(node);
+	ir_node  *const op      = get_Conv_op(node);
+	ir_mode  *const op_mode = get_irn_mode(op);
+	ir_mode  *const mode    = get_irn_mode(node);
+	dbg_info *const dbgi    = get_irn_dbg_info(node);
 	if (be_mode_needs_gp_reg(op_mode) && be_mode_needs_gp_reg(mode)) {
-		dbg_info *const dbgi = get_irn_dbg_info(node);
 		return make_extension(dbgi, op, get_mode_size_bits(mode));
+	} else if (mode_is_float(op_mode) && mode_is_float(mode)) {
+		ir_node *const new_op = be_transform_node(op);
+		if (get_mode_size_bits(op_mode) == get_mode_size_bits(mode))
+			return new_op;
+		ir_node *const block = be_transform_nodes_block(node);
+		return new_bd_mips_cvt(dbgi, block, new_op, op_mode, mode);
+	} else if (be_mode_needs_gp_reg(op_mode) && mode_is_float(mode)) {
+		/* cvt reads signed 32 bit integers. Unsigned 32 bit values were
+		 * rewritten by mips_handle_intrinsics(). */
+		assert(mode_is_signed(op_mode) || get_mode_size_bits(op_mode) < 32);
+		ir_node *const block  = be_transform_nodes_block(node);
+		ir_node *const new_op = make_extension(dbgi, op, 32);
+		ir_node *const mtc1   = new_bd_mips_mtc1(dbgi, block, new_op);
+		return new_bd_mips_cvt(dbgi, block, mtc1, mode_Is, mode);
+	} else if (mode_is_float(op_mode) && be_mode_needs_gp_reg(mode)) {
+		ir_node *const block  = be_transform_nodes_block(node);
+		ir_node *const new_op = be_transform_node(op);
+		ir_node *const trunc  = new_bd_mips_trunc_w(dbgi, block, new_op, op_mode, mode_Is);
+		return new_bd_mips_mfc1(dbgi, block, trunc);
 	}
 	TODO(node);
 }
 
+static ir_entity *create_float_const_entity(ir_tarval *const tv)
+{
+	ir_entity *entity = pmap_get(ir_entity, mips_constants, tv);
+	if (entity)
+		return entity;
+
+	ir_mode *const mode = get_tarval_mode(tv);
+	ir_type *const type = get_type_for_mode(mode);
+	ir_type *const glob = get_glob_type();
+	entity = new_global_entity(glob, id_unique("C"), type, ir_visibility_private, IR_LINKAGE_CONSTANT | IR_LINKAGE_NO_IDENTITY);
+	set_entity_initializer(entity, create_initializer_tarval(tv));
+
+	pmap_insert(mips_constants, tv, entity);
+	return entity;
+}
+
 static ir_node *gen_Const(ir_node *const node)
 {
 	ir_mode *const mode = get_irn_mode(node);
@@ -639,6 +815,25 @@ static ir_node *gen_Const(ir_node *const node)
 				res = new_bd_mips_ori(dbgi, block, res, NULL, lo);
 			return res;
 		}
+	} else if (mode_is_float(mode)) {
+		dbg_info  *const dbgi  = get_irn_dbg_info(node);
+		ir_node   *const block = be_transform_nodes_block(node);
+		ir_graph  *const irg   = get_irn_irg(node);
+		ir_tarval *const tv    = get_Const_tarval(node);
+		if (tv == get_mode_null(mode)) {
+			ir_node *const zero = get_Start_zero(irg);
+			if (get_mode_size_bits(mode) == 32)
+				return new_bd_mips_mtc1(dbgi, block, zero);
+			return new_bd_mips_mtc1_d(dbgi, block, zero, zero);
+		}
+
+		ir_entity   *const ent   = create_float_const_entity(tv);
+		ir_node     *const lui   = new_bd_mips_lui(dbgi, block, ent, 0);
+		ir_node     *const nomem = get_irg_no_mem(irg);
+		cons_loadop *const cons  = get_fp_load_cons(mode);
+		ir_node     *const load  = cons(dbgi, block, nomem, lui, ent, 0);
+		set_irn_pinned(load, false);
+		return be_new_Proj(load, pn_mips_lw_res);
 	}
 	TODO(node);
 }
@@ -646,6 +841,9 @@ static ir_node *gen_Const(ir_node *const node)
 static ir_node *gen_Div(ir_node *const node)
 {
 	ir_mode *const mode = get_Div_resmode(node);
+	if (mode_is_float(mode))
+		return gen_fp_binop(node, get_Div_left(node), get_Div_right(node), &new_bd_mips_fdiv);
+
 	if (be_mode_needs_gp_reg(mode) && get_mode_size_bits(mode) == MIPS_MACHINE_SIZE) {
 		dbg_info *const dbgi  = get_irn_dbg_info(node);
 		ir_node  *const block = be_transform_nodes_block(node);
@@ -680,15 +878,15 @@ static ir_node *gen_Jmp(ir_node *const node)
 	return new_bd_mips_b(dbgi, block);
 }
 
-typedef ir_node *cons_loadop(dbg_info*, ir_node*, ir_node*, ir_node*, ir_entity*, int32_t);
-
 static ir_node *gen_Load(ir_node *const node)
 {
 	ir_mode *const mode = get_Load_mode(node);
-	if (be_mode_needs_gp_reg(mode)) {
+	if (be_mode_needs_gp_reg(mode) || mode_is_float(mode)) {
 		cons_loadop   *cons;
 		unsigned const size = get_mode_size_bits(mode);
-		if (size == 8) {
+		if (mode_is_float(mode)) {
+			cons = get_fp_load_cons(mode);
+		} else if (size == 8) {
 			cons = mode_is_signed(mode) ? &new_bd_mips_lb : &new_bd_mips_lbu;
 		} else if (size == 16) {
 			cons = mode_is_signed(mode) ? &new_bd_mips_lh : &new_bd_mips_lhu;
@@ -754,6 +952,9 @@ static ir_node *gen_Mulh(ir_node *const node)
 static ir_node *gen_Mul(ir_node *const node)
 {
 	ir_mode *const mode = get_irn_mode(node);
+	if (mode_is_float(mode))
+		return gen_fp_binop(node, get_Mul_left(node), get_Mul_right(node), &new_bd_mips_fmul);
+
 	if (be_mode_needs_gp_reg(mode)) {
 		dbg_info *const dbgi  = get_irn_dbg_info(node);
 		ir_node  *const block = be_transform_nodes_block(node);
@@ -775,6 +976,11 @@ static ir_node *gen_Minus(ir_node *const node)
 		ir_node  *const new_l = get_Start_zero(irg);
 		ir_node  *const new_r = be_transform_node(val);
 		return new_bd_mips_subu(dbgi, block, new_l, new_r);
+	} else if (mode_is_float(mode)) {
+		dbg_info *const dbgi   = get_irn_dbg_info(node);
+		ir_node  *const block  = be_transform_nodes_block(node);
+		ir_node  *const new_op = be_transform_node(val);
+		return new_bd_mips_fneg(dbgi, block, new_op, mode);
 	}
 	TODO(node);
 }
@@ -786,6 +992,8 @@ static ir_node *gen_Mux(ir_node *const node)
 		if (is_irn_null(get_Mux_false(node)) && is_irn_one(get_Mux_true(node))) {
 			ir_node *const sel = get_Mux_sel(node);
 			if (is_Cmp(sel)) {
+				if (mode_is_float(get_irn_mode(get_Cmp_left(sel))))
+					return be_transform_node(sel);
 				ir_relation const rel = get_Cmp_relation(sel) & ir_relation_less_equal_greater;
 				if (rel == ir_relation_less || rel == ir_relation_greater)
 					return be_transform_node(sel);
@@ -824,6 +1032,8 @@ static ir_node *gen_Phi(ir_node *const node)
 	ir_mode            *const  mode = get_irn_mode(node);
 	if (be_mode_needs_gp_reg(mode)) {
 		req = &mips_class_reg_req_gp;
+	} else if (mode_is_float(mode)) {
+		req = &mips_class_reg_req_fp;
 	} else if (mode == mode_M) {
 		req = arch_memory_req;
 	} else {
@@ -843,11 +1053,18 @@ static ir_node *gen_Proj_Builtin(ir_node *const node)
 		return new_pred;
 
 	case ir_bk_bswap:
+	case ir_bk_ceil:
 	case ir_bk_clz:
 	case ir_bk_compare_swap:
+	case ir_bk_copysign:
 	case ir_bk_ctz:
+	case ir_bk_cycle_counter:
 	case ir_bk_debugbreak:
+	case ir_bk_fabs:
 	case ir_bk_ffs:
+	case ir_bk_floor:
+	case ir_bk_fmax:
+	case ir_bk_fmin:
 	case ir_bk_frame_address:
 	case ir_bk_inport:
 	case ir_bk_may_alias:
@@ -856,7 +1073,10 @@ static ir_node *gen_Proj_Builtin(ir_node *const node)
 	case ir_bk_popcount:
 	case ir_bk_prefetch:
 	case ir_bk_return_address:
+	case ir_bk_round:
+	case ir_bk_sqrt:
 	case ir_bk_trap:
+	case ir_bk_trunc:
 	case ir_bk_va_arg:
 	case ir_bk_va_start:
 		TODO(node);
@@ -951,14 +1171,24 @@ static ir_node *gen_Proj_Proj_Start(ir_node *const node)
 	ir_graph           *const irg   = get_irn_irg(node);
 	unsigned            const num   = get_Proj_num(node);
 	mips_reg_or_slot_t *const param = &cur_cconv.parameters[num];
-	if (param->reg) {
-		return be_get_Start_proj(irg, param->reg);
+	ir_mode            *const mode  = get_irn_mode(node);
+	dbg_info           *const dbgi  = get_irn_dbg_info(node);
+	ir_node            *const block = be_transform_nodes_block(node);
+	if (param->reg1) {
+		/* The first register holds the upper half (big endian). */
+		ir_node *const hi = be_get_Start_proj(irg, param->reg);
+		ir_node *const lo = be_get_Start_proj(irg, param->reg1);
+		return new_bd_mips_mtc1_d(dbgi, block, lo, hi);
+	} else if (param->reg) {
+		ir_node *const val = be_get_Start_proj(irg, param->reg);
+		if (mode_is_float(mode) && param->reg->cls == &mips_reg_classes[CLASS_mips_gp])
+			return new_bd_mips_mtc1(dbgi, block, val);
+		return val;
 	} else {
-		dbg_info *const dbgi  = get_irn_dbg_info(node);
-		ir_node  *const block = be_transform_nodes_block(node);
-		ir_node  *const mem   = be_get_Start_mem(irg);
-		ir_node  *const base  = get_Start_sp(irg);
-		ir_node  *const load  = new_bd_mips_lw(dbgi, block, mem, base, param->entity, 0);
+		ir_node     *const mem  = be_get_Start_mem(irg);
+		ir_node     *const base = get_Start_sp(irg);
+		cons_loadop *const cons = mode_is_float(mode) ? get_fp_load_cons(mode) : &new_bd_mips_lw;
+		ir_node     *const load = cons(dbgi, block, mem, base, param->entity, 0);
 		return be_new_Proj(load, pn_mips_lw_res);
 	}
 }
@@ -1096,21 +1326,29 @@ static ir_node *gen_Start(ir_node *const node)
 	ir_entity *const ent  = get_irg_entity(irg);
 	ir_type   *const type = get_entity_type(ent);
 	for (size_t i = 0, n = get_method_n_params(type); i != n; ++i) {
-		arch_register_t const *const reg = cur_cconv.parameters[i].reg;
-		if (reg)
-			outs[reg->global_index] = BE_START_REG;
+		mips_reg_or_slot_t const *const param = &cur_cconv.parameters[i];
+		if (param->reg)
+			outs[param->reg->global_index] = BE_START_REG;
+		if (param->reg1)
+			outs[param->reg1->global_index] = BE_START_REG;
 	}
 
 	return be_new_Start(irg, outs);
 }
 
-typedef ir_node *cons_storeop(dbg_info*, ir_node*, ir_node*, ir_node*, ir_node*, ir_entity*, int32_t);
-
 static ir_node *gen_Store(ir_node *const node)
 {
 	ir_node       *old_val = get_Store_value(node);
 	ir_mode *const mode    = get_irn_mode(old_val);
-	if (be_mode_needs_gp_reg(mode)) {
+	if (mode_is_float(mode)) {
+		dbg_info     *const dbgi  = get_irn_dbg_info(node);
+		ir_node      *const block = be_transform_nodes_block(node);
+		ir_node      *const mem   = be_transform_node(get_Store_mem(node));
+		ir_node      *const val   = be_transform_node(old_val);
+		mips_addr     const addr  = make_addr(get_Store_ptr(node));
+		cons_storeop *const cons  = get_fp_store_cons(mode);
+		return cons(dbgi, block, mem, addr.base, val, addr.ent, addr.val);
+	} else if (be_mode_needs_gp_reg(mode)) {
 		cons_storeop  *cons;
 		unsigned const size = get_mode_size_bits(mode);
 		if (size == 8) {
@@ -1138,6 +1376,9 @@ static ir_node *gen_Sub(ir_node *const node)
 	ir_node *const l    = get_Sub_left(node);
 	ir_node *const r    = get_Sub_right(node);
 	ir_mode *const mode = get_irn_mode(node);
+	if (mode_is_float(mode))
+		return gen_fp_binop(node, l, r, &new_bd_mips_fsub);
+
 	if (be_mode_needs_gp_reg(mode)) {
 		dbg_info *const dbgi  = get_irn_dbg_info(node);
 		ir_node  *const block = be_transform_nodes_block(node);
@@ -1176,6 +1417,8 @@ static ir_node *gen_Unknown(ir_node *const node)
 	ir_mode *const mode  = get_irn_mode(node);
 	if (be_mode_needs_gp_reg(mode)) {
 		return be_new_Unknown(block, &mips_class_reg_req_gp);
+	} else if (mode_is_float(mode)) {
+		return be_new_Unknown(block, &mips_class_reg_req_fp);
 	} else {
 		TODO(node);
 	}
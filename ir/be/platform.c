@@ -147,12 +147,13 @@ void ir_platform_set(ir_machine_triple_t const *machine,
 		ppdef1("__mips__");
 		ir_platform.long_double_size  = 8;
 		ir_platform.long_double_align = 8;
-	} else if (streq(cpu, "riscv32")) {
+	} else if (streq(cpu, "riscv32") || streq(cpu, "riscv64")) {
 		ppdef1("__riscv");
 		ppdef1("__riscv_div");
 		ppdef1("__riscv_mul");
 		ppdef1("__riscv_muldiv");
-		ppdef("__riscv_xlen", "32");
+		ppdef("__riscv_xlen", pointer_size == 8 ? "64" : "32");
+		ir_platform.is_riscv = true;
 		ir_platform.long_double_size  = 16;
 		ir_platform.long_double_align = 16;
 	} else if (streq(cpu, "TEMPLATE")) {
@@ -300,6 +301,17 @@ void ir_platform_init(void)
 	if (ir_platform.is_darwin && !ir_target_big_endian())
 		ppdef1("__LITTLE_ENDIAN__");
 
+	/* The float ABI depends on the ISA string given to the backend. */
+	if (ir_platform.is_riscv) {
+		if (ir_platform.riscv_soft_float) {
+			ppdef1("__riscv_float_abi_soft");
+		} else {
+			ppdef1("__riscv_fdiv");
+			ppdef1("__riscv_float_abi_double");
+			ppdef("__riscv_flen", "64");
+		}
+	}
+
 	ir_platform.initialized = true;
 }
 
@@ -44,6 +44,10 @@ typedef struct platform_t {
 	bool                  ia32_struct_in_regs               : 1;
 	unsigned              ia32_po2_stackalign               : 4;
 	bool                  amd64_x64abi                      : 1;
+	bool                  is_riscv                          : 1;
+	/** Set by the RISC-V backend, if it lowers floating point to library
+	 * calls. */
+	bool                  riscv_soft_float                  : 1;
 	ENUMBF(object_format_t)    object_format                : 2;
 	ENUMBF(ir_platform_type_t) wchar_type                   : 4;
 	ENUMBF(ir_platform_type_t) intptr_type                  : 4;
@@ -21,15 +21,46 @@
 #include "iredges.h"
 #include "irgwalk.h"
 #include "irprog_t.h"
+#include "irtools.h"
+#include "isas.h"
+#include "lc_opts.h"
 #include "lower_builtins.h"
+#include "lower_softfloat.h"
 #include "lowering.h"
+#include "platform_t.h"
 #include "riscv_emitter.h"
 #include "riscv_lower64.h"
 #include "riscv_transform.h"
 #include "target_t.h"
+#include "type_t.h"
 #include "util.h"
+#include <string.h>
 
-static ir_settings_arch_dep_t const riscv_arch_dep = {
+unsigned riscv_machine_size;
+
+pmap *riscv_constants;
+
+static char riscv32_isa[64] = "rv32gc";
+static char riscv64_isa[64] = "rv64gc";
+static bool use_softfloat32;
+static bool use_softfloat64;
+
+/** Whether floating point is lowered to library calls. */
+static bool use_softfloat;
+
+static lc_opt_table_entry_t const riscv32_options[] = {
+	LC_OPT_ENT_STR ("isa",        "the ISA string, e.g. rv32imac",    &riscv32_isa),
+	LC_OPT_ENT_BOOL("soft-float", "do not use the F and D extensions", &use_softfloat32),
+	LC_OPT_LAST
+};
+
+static lc_opt_table_entry_t const riscv64_options[] = {
+	LC_OPT_ENT_STR ("isa",        "the ISA string, e.g. rv64imac",    &riscv64_isa),
+	LC_OPT_ENT_BOOL("soft-float", "do not use the F and D extensions", &use_softfloat64),
+	LC_OPT_LAST
+};
+
+static ir_settings_arch_dep_t riscv_arch_dep = {
 	.replace_muls         = true,
 	.replace_divs         = true,
 	.replace_mods         = true,
@@ -39,7 +70,7 @@ static ir_settings_arch_dep_t const riscv_arch_dep = {
 	.maximum_shifts       = 4,
 	.highest_shift_amount = 63,
 	.evaluate             = NULL,
-	.max_bits_for_mulh    = RISCV_MACHINE_SIZE,
+	.max_bits_for_mulh    = 32,
 };
 
 /**
@@ -71,18 +102,60 @@ static int riscv_ifconv(ir_node const *const sel, ir_node const *const mux_false
 	return false;
 }
 
-static void riscv_init(void)
+/**
+ * Returns whether the ISA string @p isa includes the D extension. The hard-float
+ * ABI is only used with D, the F extension alone selects soft-float.
+ */
+static bool riscv_isa_has_d(char const *const isa, unsigned const machine_size)
+{
+	char const *const prefix = machine_size == 64 ? "rv64" : "rv32";
+	if (strncmp(isa, prefix, 4) != 0)
+		panic("ISA string \"%s\" does not start with %s", isa, prefix);
+	/* Single letter extensions come before the first '_' and the multi-letter
+	 * extensions starting with 's', 'x' or 'z'. */
+	for (char const *c = isa + 4; *c != '\0' && *c != '_'; ++c) {
+		if (*c == 's' || *c == 'x' || *c == 'z')
+			break;
+		if (*c == 'd' || *c == 'g')
+			return true;
+	}
+	return false;
+}
+
+static void riscv_init(unsigned const machine_size)
 {
 	riscv_init_asm_constraints();
 	riscv_create_opcodes();
 	riscv_register_init();
 
+	riscv_machine_size = machine_size;
+	if (machine_size == 64)
+		riscv_reg_classes[CLASS_riscv_gp].mode = mode_Lu;
+	riscv_arch_dep.max_bits_for_mulh = machine_size;
+
+	if (machine_size == 64) {
+		use_softfloat = use_softfloat64 || !riscv_isa_has_d(riscv64_isa, 64);
+	} else {
+		use_softfloat = use_softfloat32 || !riscv_isa_has_d(riscv32_isa, 32);
+	}
+	ir_platform.riscv_soft_float = use_softfloat;
+
 	ir_target.experimental = "the RISC-V backend is highly experimental and unfinished";
 
 	ir_target.allow_ifconv       = riscv_ifconv;
 	ir_target.float_int_overflow = ir_overflow_indefinite;
 }
 
+static void riscv32_init(void)
+{
+	riscv_init(32);
+}
+
+static void riscv64_init(void)
+{
+	riscv_init(64);
+}
+
 static void riscv_finish(void)
 {
 	riscv_free_opcodes();
@@ -102,30 +175,49 @@ static void riscv_select_instructions(ir_graph *const irg)
 static ir_node *riscv_new_spill(ir_node *const value, ir_node *const after)
 {
 	ir_mode *const mode = get_irn_mode(value);
+	ir_node *(*cons)(dbg_info*, ir_node*, ir_node*, ir_node*, ir_node*, ir_entity*, int32_t);
 	if (be_mode_needs_gp_reg(mode)) {
-		ir_node  *const block = get_block(after);
-		ir_graph *const irg   = get_irn_irg(after);
-		ir_node  *const nomem = get_irg_no_mem(irg);
-		ir_node  *const frame = get_irg_frame(irg);
-		ir_node  *const store = new_bd_riscv_sw(NULL, block, nomem, frame, value, NULL, 0);
-		sched_add_after(after, store);
-		return store;
+		cons = riscv_machine_size == 64 ? &new_bd_riscv_sd : &new_bd_riscv_sw;
+	} else if (mode_is_float(mode)) {
+		/* Single precision values are NaN-boxed, so spill all 64 bits. */
+		cons = &new_bd_riscv_fsd;
+	} else {
+		TODO(value);
 	}
-	TODO(value);
+	ir_node  *const block = get_block(after);
+	ir_graph *const irg   = get_irn_irg(after);
+	ir_node  *const nomem = get_irg_no_mem(irg);
+	ir_node  *const frame = get_irg_frame(irg);
+	ir_node  *const store = cons(NULL, block, nomem, frame, value, NULL, 0);
+	sched_add_after(after, store);
+	return store;
 }
 
 static ir_node *riscv_new_reload(ir_node *const value, ir_node *const spill, ir_node *const before)
 {
 	ir_mode *const mode = get_irn_mode(value);
+	ir_node *(*cons)(dbg_info*, ir_node*, ir_node*, ir_node*, ir_entity*, int32_t);
+	unsigned pn;
 	if (be_mode_needs_gp_reg(mode)) {
-		ir_node  *const block = get_block(before);
-		ir_graph *const irg   = get_irn_irg(before);
-		ir_node  *const frame = get_irg_frame(irg);
-		ir_node  *const load  = new_bd_riscv_lw(NULL, block, spill, frame, NULL, 0);
-		sched_add_before(before, load);
-		return be_new_Proj(load, pn_riscv_lw_res);
+		if (riscv_machine_size == 64) {
+			cons = &new_bd_riscv_ld;
+			pn   = pn_riscv_ld_res;
+		} else {
+			cons = &new_bd_riscv_lw;
+			pn   = pn_riscv_lw_res;
+		}
+	} else if (mode_is_float(mode)) {
+		cons = &new_bd_riscv_fld;
+		pn   = pn_riscv_fld_res;
+	} else {
+		TODO(value);
 	}
-	TODO(value);
+	ir_node  *const block = get_block(before);
+	ir_graph *const irg   = get_irn_irg(before);
+	ir_node  *const frame = get_irg_frame(irg);
+	ir_node  *const load  = cons(NULL, block, spill, frame, NULL, 0);
+	sched_add_before(before, load);
+	return be_new_Proj(load, pn);
 }
 
 static regalloc_if_t const riscv_regalloc_if = {
@@ -139,14 +231,14 @@ static void riscv_collect_frame_entity_nodes(ir_node *const node, void *const da
 {
 	be_fec_env_t *const env = (be_fec_env_t*)data;
 
-	if (is_riscv_lw(node)) {
+	if (is_riscv_lw(node) || is_riscv_ld(node) || is_riscv_fld(node)) {
 		ir_node  *const base  = get_irn_n(node, n_riscv_lw_base);
 		ir_graph *const irg   = get_irn_irg(node);
 		ir_node  *const frame = get_irg_frame(irg);
 		if (base == frame) {
 			riscv_immediate_attr_t const *const attr = get_riscv_immediate_attr_const(node);
 			if (!attr->ent) {
-				unsigned const size     = RISCV_MACHINE_SIZE / 8; // TODO
+				unsigned const size     = is_riscv_lw(node) ? 4 : 8;
 				unsigned const po2align = log2_floor(size);
 				be_load_needs_frame_entity(env, node, size, po2align);
 			}
@@ -209,31 +301,52 @@ static void riscv_introduce_prologue_epilogue(ir_graph *const irg)
 	riscv_introduce_prologue(irg, size);
 }
 
-static void riscv_sp_sim(ir_node *const node, stack_pointer_state_t *const state)
+/**
+ * Returns whether the immediate of @p node may refer to a frame entity.
+ */
+static bool riscv_has_frame_immediate(ir_node const *const node)
 {
-	if (is_riscv_irn(node)) {
-		switch ((riscv_opcodes)get_riscv_irn_opcode(node)) {
-		case iro_riscv_addi:
-		case iro_riscv_FrameAddr:
-		case iro_riscv_lb:
-		case iro_riscv_lbu:
-		case iro_riscv_lh:
-		case iro_riscv_lhu:
-		case iro_riscv_lw:
-		case iro_riscv_sb:
-		case iro_riscv_sh:
-		case iro_riscv_sw: {
-			riscv_immediate_attr_t *const imm = get_riscv_immediate_attr(node);
-			ir_entity              *const ent = imm->ent;
-			if (ent && is_frame_type(get_entity_owner(ent))) {
-				imm->ent  = NULL;
-				imm->val += state->offset + get_entity_offset(ent);
-			}
-			break;
-		}
+	if (!is_riscv_irn(node))
+		return false;
+	switch ((riscv_opcodes)get_riscv_irn_opcode(node)) {
+	case iro_riscv_addi:
+	case iro_riscv_FrameAddr:
+	case iro_riscv_fld:
+	case iro_riscv_flw:
+	case iro_riscv_fsd:
+	case iro_riscv_fsw:
+	case iro_riscv_lb:
+	case iro_riscv_lbu:
+	case iro_riscv_ld:
+	case iro_riscv_lh:
+	case iro_riscv_lhu:
+	case iro_riscv_lw:
+	case iro_riscv_lwu:
+	case iro_riscv_sb:
+	case iro_riscv_sd:
+	case iro_riscv_sh:
+	case iro_riscv_sw:
+		return true;
+	default:
+		return false;
+	}
+}
 
-		default:
-			break;
+static ir_entity *riscv_get_frame_entity(ir_node const *const node)
+{
+	if (!riscv_has_frame_immediate(node))
+		return NULL;
+	return get_riscv_immediate_attr_const(node)->ent;
+}
+
+static void riscv_sp_sim(ir_node *const node, stack_pointer_state_t *const state)
+{
+	if (riscv_has_frame_immediate(node)) {
+		riscv_immediate_attr_t *const imm = get_riscv_immediate_attr(node);
+		ir_entity              *const ent = imm->ent;
+		if (ent && is_frame_type(get_entity_owner(ent))) {
+			imm->ent  = NULL;
+			imm->val += state->offset + get_entity_offset(ent);
 		}
 	}
 }
@@ -241,6 +354,7 @@ static void riscv_sp_sim(ir_node *const node, stack_pointer_state_t *const state
 static void riscv_generate_code(FILE *const output, char const *const cup_name)
 {
 	be_begin(output, cup_name);
+	riscv_constants = pmap_create();
 
 	unsigned *const sp_is_non_ssa = rbitset_alloca(N_RISCV_REGISTERS);
 	rbitset_set(sp_is_non_ssa, REG_SP);
@@ -259,7 +373,7 @@ static void riscv_generate_code(FILE *const output, char const *const cup_name)
 		riscv_assign_spill_slots(irg);
 
 		ir_type *const frame = get_irg_frame_type(irg);
-		be_sort_frame_entities(frame, true);
+		be_sort_frame_entities(irg, true, riscv_get_frame_entity);
 		be_layout_frame_type(frame, 0, 0);
 
 		riscv_introduce_prologue_epilogue(irg);
@@ -274,9 +388,78 @@ static void riscv_generate_code(FILE *const output, char const *const cup_name)
 		be_step_last(irg);
 	}
 
+	pmap_destroy(riscv_constants);
 	be_finish();
 }
 
+/**
+ * Returns the declared type of the function called by @p call or NULL, if it
+ * is unknown. Calls of variadic functions have their own method type, which
+ * contains all arguments.
+ */
+static ir_type *get_callee_type(ir_node const *const call)
+{
+	ir_node *const ptr = get_Call_ptr(call);
+	if (is_Address(ptr))
+		return get_entity_type(get_Address_entity(ptr));
+
+	/* Indirect calls use the type of the function pointer. */
+	ir_type *ptr_type = NULL;
+	if (is_Proj(ptr)) {
+		ir_node *const pred = get_Proj_pred(ptr);
+		if (is_Load(pred)) {
+			ptr_type = get_Load_type(pred);
+		} else if (is_Proj(pred) && is_Start(get_Proj_pred(pred))) {
+			ir_entity *const entity = get_irg_entity(get_irn_irg(call));
+			ptr_type = get_method_param_type(get_entity_type(entity), get_Proj_num(ptr));
+		}
+	}
+	if (ptr_type == NULL || !is_Pointer_type(ptr_type))
+		return NULL;
+	ir_type *const fun_type = get_pointer_points_to_type(ptr_type);
+	return is_Method_type(fun_type) ? fun_type : NULL;
+}
+
+/**
+ * The hard-float ABI passes variadic floating point arguments like integers,
+ * so turn them into integers of the same size. If the callee is unknown, all
+ * arguments are treated as variadic. riscv32 passes the resulting 64 bit
+ * integers in aligned register pairs after lowering them.
+ */
+static void lower_variadic_float_arg(ir_node *const node, void *const env)
+{
+	(void)env;
+	if (!is_Call(node))
+		return;
+	ir_type *const call_type = get_Call_type(node);
+	if (!is_method_variadic(call_type))
+		return;
+
+	ir_type *const callee_type = get_callee_type(node);
+	size_t   const n_fixed     = callee_type ? get_method_n_params(callee_type) : 0;
+	ir_type       *new_type    = NULL;
+	for (size_t i = n_fixed, n = get_Call_n_params(node); i < n; ++i) {
+		ir_node *const arg  = get_Call_param(node, i);
+		ir_mode *const mode = get_irn_mode(arg);
+		if (!mode_is_float(mode))
+			continue;
+
+		ir_mode *int_mode;
+		switch (get_mode_size_bits(mode)) {
+		case 32: int_mode = mode_Iu; break;
+		case 64: int_mode = mode_Lu; break;
+		default: panic("variadic %+F arguments are not supported", mode);
+		}
+		if (new_type == NULL)
+			new_type = clone_type_method(call_type, true, get_method_additional_properties(call_type));
+		set_method_param_type(new_type, i, get_type_for_mode(int_mode));
+		ir_node *const block = get_nodes_block(node);
+		set_Call_param(node, i, new_rd_Bitcast(get_irn_dbg_info(arg), block, arg, int_mode));
+	}
+	if (new_type != NULL)
+		set_Call_type(node, new_type);
+}
+
 static void riscv_lower_for_target(void)
 {
 	ir_arch_lower(&riscv_arch_dep);
@@ -298,8 +481,20 @@ static void riscv_lower_for_target(void)
 		be_after_transform(irg, "lower-switch");
 	}
 
-	riscv_lower64();
-	be_after_irp_transform("lower-64");
+	if (use_softfloat) {
+		lower_floating_point();
+		be_after_irp_transform("lower-fp");
+	} else {
+		foreach_irp_irg(i, irg) {
+			irg_walk_graph(irg, NULL, lower_variadic_float_arg, NULL);
+			be_after_transform(irg, "lower-variadic-float");
+		}
+	}
+
+	if (riscv_machine_size == 32) {
+		riscv_lower64();
+		be_after_irp_transform("lower-64");
+	}
 }
 
 static unsigned riscv_get_op_estimated_cost(ir_node const *const node)
@@ -313,13 +508,31 @@ arch_isa_if_t const riscv32_isa_if = {
 	.pointer_size          = 4,
 	.modulo_shift          = 32,
 	.big_endian            = false,
-	.po2_biggest_alignment = 4,
+	.po2_biggest_alignment = 4, /* 16 bytes, the stack alignment */
+	.pic_supported         = false,
+	.n_registers           = N_RISCV_REGISTERS,
+	.registers             = riscv_registers,
+	.n_register_classes    = N_RISCV_CLASSES,
+	.register_classes      = riscv_reg_classes,
+	.init                  = riscv32_init,
+	.finish                = riscv_finish,
+	.generate_code         = riscv_generate_code,
+	.lower_for_target      = riscv_lower_for_target,
+	.get_op_estimated_cost = riscv_get_op_estimated_cost,
+};
+
+arch_isa_if_t const riscv64_isa_if = {
+	.name                  = "riscv64",
+	.pointer_size          = 8,
+	.modulo_shift          = 64,
+	.big_endian            = false,
+	.po2_biggest_alignment = 4, /* 16 bytes, the stack alignment */
 	.pic_supported         = false,
 	.n_registers           = N_RISCV_REGISTERS,
 	.registers             = riscv_registers,
 	.n_register_classes    = N_RISCV_CLASSES,
 	.register_classes      = riscv_reg_classes,
-	.init                  = riscv_init,
+	.init                  = riscv64_init,
 	.finish                = riscv_finish,
 	.generate_code         = riscv_generate_code,
 	.lower_for_target      = riscv_lower_for_target,
@@ -329,4 +542,7 @@ arch_isa_if_t const riscv32_isa_if = {
 BE_REGISTER_MODULE_CONSTRUCTOR(be_init_arch_riscv)
 void be_init_arch_riscv(void)
 {
+	lc_opt_entry_t *const be_grp = lc_opt_get_grp(firm_opt_get_root(), "be");
+	lc_opt_add_table(lc_opt_get_grp(be_grp, "riscv32"), riscv32_options);
+	lc_opt_add_table(lc_opt_get_grp(be_grp, "riscv64"), riscv64_options);
 }
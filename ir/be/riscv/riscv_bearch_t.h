@@ -6,18 +6,28 @@
 #ifndef FIRM_BE_RISCV_RISCV_BEARCH_T_H
 #define FIRM_BE_RISCV_RISCV_BEARCH_T_H
 
-#define RISCV_MACHINE_SIZE 32
-
 #include <stdbool.h>
 #include <stdint.h>
 
 #include "firm_types.h"
+#include "pmap.h"
+
+/** Width of the general purpose registers in bits, 32 or 64. */
+extern unsigned riscv_machine_size;
+
+/** Maps floating point tarvals to their constant entities. */
+extern pmap *riscv_constants;
 
 static inline bool is_uimm5(long const val)
 {
 	return 0 <= val && val < 32;
 }
 
+static inline bool is_uimm6(long const val)
+{
+	return 0 <= val && val < 64;
+}
+
 static inline bool is_simm12(long const val)
 {
 	return -2048 <= val && val < 2048;
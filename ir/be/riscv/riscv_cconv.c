@@ -21,16 +21,33 @@ static unsigned const regs_param_gp[] = {
 	REG_A7,
 };
 
+static unsigned const regs_param_fp[] = {
+	REG_FA0,
+	REG_FA1,
+	REG_FA2,
+	REG_FA3,
+	REG_FA4,
+	REG_FA5,
+	REG_FA6,
+	REG_FA7,
+};
+
 static unsigned const regs_result_gp[] = {
 	REG_A0,
 	REG_A1,
 };
 
+static unsigned const regs_result_fp[] = {
+	REG_FA0,
+	REG_FA1,
+};
+
 void riscv_determine_calling_convention(riscv_calling_convention_t *const cconv, ir_type *const fun_type)
 {
 	/* Handle parameters. */
 	riscv_reg_or_slot_t *params   = NULL;
 	size_t               gp_param = 0;
+	size_t               fp_param = 0;
 	size_t         const n_params = get_method_n_params(fun_type);
 	if (n_params != 0) {
 		params = XMALLOCNZ(riscv_reg_or_slot_t, n_params);
@@ -40,19 +57,21 @@ void riscv_determine_calling_convention(riscv_calling_convention_t *const cconv,
 			ir_mode *const param_mode = get_type_mode(param_type);
 			if (!param_mode) {
 				panic("TODO");
-			} else if (mode_is_float(param_mode)) {
-				panic("TODO");
+			} else if (mode_is_float(param_mode) && fp_param < ARRAY_SIZE(regs_param_fp)) {
+				params[i].reg = &riscv_registers[regs_param_fp[fp_param++]];
 			} else {
+				if (mode_is_float(param_mode) && get_mode_size_bits(param_mode) > riscv_machine_size)
+					panic("passing %+F in integer registers is not supported, use soft-float", param_mode);
 				if (param_type->flags & tf_lowered_dw && gp_param % 2 != 0)
 					++gp_param;
 				if (gp_param < ARRAY_SIZE(regs_param_gp))
 					params[i].reg = &riscv_registers[regs_param_gp[gp_param]];
-				params[i].offset = (gp_param - ARRAY_SIZE(regs_param_gp)) * (RISCV_MACHINE_SIZE / 8);
+				params[i].offset = (gp_param - ARRAY_SIZE(regs_param_gp)) * (riscv_machine_size / 8);
 				++gp_param;
 			}
 		}
 	}
-	cconv->param_stack_size = gp_param * (RISCV_MACHINE_SIZE / 8);
+	cconv->param_stack_size = gp_param * (riscv_machine_size / 8);
 	cconv->n_mem_param      = gp_param > ARRAY_SIZE(regs_param_gp) ? gp_param - ARRAY_SIZE(regs_param_gp) : 0;
 	cconv->parameters       = params;
 
@@ -63,13 +82,16 @@ void riscv_determine_calling_convention(riscv_calling_convention_t *const cconv,
 		results = XMALLOCNZ(riscv_reg_or_slot_t, n_results);
 
 		size_t gp_res = 0;
+		size_t fp_res = 0;
 		for (size_t i = 0; i != n_results; ++i) {
 			ir_type *const res_type = get_method_res_type(fun_type, i);
 			ir_mode *const res_mode = get_type_mode(res_type);
 			if (!res_mode) {
 				panic("TODO");
 			} else if (mode_is_float(res_mode)) {
-				panic("TODO");
+				if (fp_res == ARRAY_SIZE(regs_result_fp))
+					panic("too many fp results");
+				results[i].reg = &riscv_registers[regs_result_fp[fp_res++]];
 			} else {
 				if (gp_res == ARRAY_SIZE(regs_result_gp))
 					panic("too many gp results");
@@ -21,6 +21,11 @@ typedef struct riscv_calling_convention_t {
 	riscv_reg_or_slot_t *results;
 } riscv_calling_convention_t;
 
+/**
+ * Determines the calling convention of @p fun_type. Floating point variadic
+ * arguments must have been turned into integers before, see
+ * riscv_lower_for_target().
+ */
 void riscv_determine_calling_convention(riscv_calling_convention_t *cconv, ir_type *fun_type);
 
 void riscv_layout_parameter_entities(riscv_calling_convention_t *cconv, ir_graph *irg);
@@ -76,6 +76,12 @@ void riscv_emitf(ir_node const *const node, char const *fmt, ...)
 		case 'I': emit_immediate("%lo", node); break;
 		case 'J': emit_immediate(NULL,  node); break;
 
+		case 'M': {
+			riscv_fp_attr_t const *const attr = get_riscv_fp_attr_const(node);
+			be_emit_string(riscv_get_mode_suffix(attr->mode));
+			break;
+		}
+
 		case 'R':
 			emit_register(va_arg(ap, arch_register_t const*));
 			break;
@@ -88,6 +94,19 @@ void riscv_emitf(ir_node const *const node, char const *fmt, ...)
 			break;
 		}
 
+		case 'V': {
+			riscv_conv_attr_t const *const attr = get_riscv_conv_attr_const(node);
+			be_emit_irprintf("%s.%s", riscv_get_mode_suffix(attr->dst_mode), riscv_get_mode_suffix(attr->src_mode));
+			break;
+		}
+
+		case 'W': {
+			/* Moves between register files use w instead of s. */
+			riscv_fp_attr_t const *const attr = get_riscv_fp_attr_const(node);
+			be_emit_char(get_mode_size_bits(attr->mode) == 32 ? 'w' : 'd');
+			break;
+		}
+
 		default:
 unknown:
 			panic("unknown format conversion");
@@ -180,6 +199,8 @@ static void emit_be_Copy(ir_node const *const node)
 
 	if (in->cls == &riscv_reg_classes[CLASS_riscv_gp]) {
 		riscv_emitf(node, "mv\t%R, %R", out, in);
+	} else if (in->cls == &riscv_reg_classes[CLASS_riscv_fp]) {
+		riscv_emitf(node, "fmv.d\t%R, %R", out, in);
 	} else {
 		panic("unexpected register class");
 	}
@@ -204,6 +225,14 @@ static void emit_be_Perm(ir_node const *const node)
 			"xor\t%D1, %D0, %D1\n"
 			"xor\t%D0, %D0, %D1"
 		);
+	} else if (out->cls == &riscv_reg_classes[CLASS_riscv_fp]) {
+		arch_register_t const *const tmp = &riscv_registers[REG_FT11];
+		riscv_emitf(node,
+			"fmv.d\t%R, %D0\n"
+			"fmv.d\t%D0, %D1\n"
+			"fmv.d\t%D1, %R",
+			tmp, tmp
+		);
 	} else {
 		panic("unexpected register class");
 	}
@@ -132,12 +132,19 @@ void riscv_finish_graph(ir_graph *irg)
 	/* perform legalizations (mostly fix nodes with too big immediates) */
 	ir_clear_opcodes_generic_func();
 	register_peephole_optimization(op_riscv_FrameAddr, finish_riscv_FrameAddr);
+	register_peephole_optimization(op_riscv_fld, finish_riscv_load_store_offsets);
+	register_peephole_optimization(op_riscv_flw, finish_riscv_load_store_offsets);
+	register_peephole_optimization(op_riscv_fsd, finish_riscv_load_store_offsets);
+	register_peephole_optimization(op_riscv_fsw, finish_riscv_load_store_offsets);
 	register_peephole_optimization(op_riscv_lb, finish_riscv_load_store_offsets);
 	register_peephole_optimization(op_riscv_lbu, finish_riscv_load_store_offsets);
+	register_peephole_optimization(op_riscv_ld, finish_riscv_load_store_offsets);
 	register_peephole_optimization(op_riscv_lh, finish_riscv_load_store_offsets);
 	register_peephole_optimization(op_riscv_lhu, finish_riscv_load_store_offsets);
 	register_peephole_optimization(op_riscv_lw, finish_riscv_load_store_offsets);
+	register_peephole_optimization(op_riscv_lwu, finish_riscv_load_store_offsets);
 	register_peephole_optimization(op_riscv_sb, finish_riscv_load_store_offsets);
+	register_peephole_optimization(op_riscv_sd, finish_riscv_load_store_offsets);
 	register_peephole_optimization(op_riscv_sh, finish_riscv_load_store_offsets);
 	register_peephole_optimization(op_riscv_sw, finish_riscv_load_store_offsets);
 
@@ -36,6 +36,25 @@ int riscv_cond_attrs_equal(ir_node const *const a, ir_node const *const b)
 		a_attr->cond == b_attr->cond;
 }
 
+int riscv_conv_attrs_equal(ir_node const *const a, ir_node const *const b)
+{
+	riscv_conv_attr_t const *const a_attr = get_riscv_conv_attr_const(a);
+	riscv_conv_attr_t const *const b_attr = get_riscv_conv_attr_const(b);
+	return
+		riscv_attrs_equal_(&a_attr->attr, &b_attr->attr) &&
+		a_attr->src_mode == b_attr->src_mode &&
+		a_attr->dst_mode == b_attr->dst_mode;
+}
+
+int riscv_fp_attrs_equal(ir_node const *const a, ir_node const *const b)
+{
+	riscv_fp_attr_t const *const a_attr = get_riscv_fp_attr_const(a);
+	riscv_fp_attr_t const *const b_attr = get_riscv_fp_attr_const(b);
+	return
+		riscv_attrs_equal_(&a_attr->attr, &b_attr->attr) &&
+		a_attr->mode == b_attr->mode;
+}
+
 int riscv_immediate_attrs_equal(ir_node const *const a, ir_node const *const b)
 {
 	riscv_immediate_attr_t const *const a_attr = get_riscv_immediate_attr_const(a);
@@ -84,17 +103,28 @@ void riscv_dump_node(FILE *const F, ir_node const *const n, dump_reason_t const
 			fprintf(F, "%s", get_irn_opname(n));
 			switch ((riscv_opcodes)get_riscv_irn_opcode(n)) {
 			case iro_riscv_addi:
+			case iro_riscv_addiw:
+			case iro_riscv_fld:
+			case iro_riscv_flw:
+			case iro_riscv_fsd:
+			case iro_riscv_fsw:
 			case iro_riscv_lb:
 			case iro_riscv_lbu:
+			case iro_riscv_ld:
 			case iro_riscv_lh:
 			case iro_riscv_lhu:
 			case iro_riscv_lw:
+			case iro_riscv_lwu:
 			case iro_riscv_sb:
+			case iro_riscv_sd:
 			case iro_riscv_sh:
 			case iro_riscv_slli:
+			case iro_riscv_slliw:
 			case iro_riscv_sltiu:
 			case iro_riscv_srai:
+			case iro_riscv_sraiw:
 			case iro_riscv_srli:
+			case iro_riscv_srliw:
 			case iro_riscv_sw:
 				dump_immediate(F, "%lo", n);
 				break;
@@ -113,6 +143,29 @@ void riscv_dump_node(FILE *const F, ir_node const *const n, dump_reason_t const
 				break;
 			}
 
+			case iro_riscv_fcvt_ff:
+			case iro_riscv_fcvt_fi:
+			case iro_riscv_fcvt_if: {
+				riscv_conv_attr_t const *const conv = get_riscv_conv_attr_const(n);
+				fprintf(F, " %s.%s", riscv_get_mode_suffix(conv->dst_mode), riscv_get_mode_suffix(conv->src_mode));
+				break;
+			}
+
+			case iro_riscv_fadd:
+			case iro_riscv_fdiv:
+			case iro_riscv_feq:
+			case iro_riscv_fle:
+			case iro_riscv_flt:
+			case iro_riscv_fmul:
+			case iro_riscv_fmv_f:
+			case iro_riscv_fmv_x:
+			case iro_riscv_fneg:
+			case iro_riscv_fsub: {
+				riscv_fp_attr_t const *const fp = get_riscv_fp_attr_const(n);
+				fprintf(F, " %s", riscv_get_mode_suffix(fp->mode));
+				break;
+			}
+
 			case iro_riscv_jal:
 				dump_immediate(F, NULL, n);
 				break;
@@ -125,6 +178,8 @@ void riscv_dump_node(FILE *const F, ir_node const *const n, dump_reason_t const
 			case iro_riscv_and:
 			case iro_riscv_div:
 			case iro_riscv_divu:
+			case iro_riscv_divuw:
+			case iro_riscv_divw:
 			case iro_riscv_FrameAddr:
 			case iro_riscv_ijmp:
 			case iro_riscv_j:
@@ -136,12 +191,17 @@ void riscv_dump_node(FILE *const F, ir_node const *const n, dump_reason_t const
 			case iro_riscv_or:
 			case iro_riscv_rem:
 			case iro_riscv_remu:
+			case iro_riscv_remuw:
+			case iro_riscv_remw:
 			case iro_riscv_ret:
 			case iro_riscv_sll:
+			case iro_riscv_sllw:
 			case iro_riscv_slt:
 			case iro_riscv_sltu:
 			case iro_riscv_sra:
+			case iro_riscv_sraw:
 			case iro_riscv_srl:
+			case iro_riscv_srlw:
 			case iro_riscv_sub:
 			case iro_riscv_switch:
 			case iro_riscv_xor:
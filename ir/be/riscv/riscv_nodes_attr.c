@@ -19,3 +19,21 @@ char const *riscv_get_cond_name(riscv_cond_t const cond)
 	}
 	panic("invalid cond");
 }
+
+char const *riscv_get_mode_suffix(ir_mode const *const mode)
+{
+	unsigned const size = get_mode_size_bits(mode);
+	if (mode_is_float(mode)) {
+		switch (size) {
+		case 32: return "s";
+		case 64: return "d";
+		}
+	} else {
+		bool const is_signed = mode_is_signed(mode);
+		switch (size) {
+		case 32: return is_signed ? "w" : "wu";
+		case 64: return is_signed ? "l" : "lu";
+		}
+	}
+	panic("unexpected mode %+F", mode);
+}
@@ -40,6 +40,17 @@ typedef struct riscv_cond_attr_t {
 	riscv_cond_t cond;
 } riscv_cond_attr_t;
 
+typedef struct riscv_conv_attr_t {
+	riscv_attr_t attr;
+	ir_mode     *src_mode;
+	ir_mode     *dst_mode;
+} riscv_conv_attr_t;
+
+typedef struct riscv_fp_attr_t {
+	riscv_attr_t attr;
+	ir_mode     *mode; /**< the floating point mode of the operation */
+} riscv_fp_attr_t;
+
 typedef struct riscv_immediate_attr_t {
 	riscv_attr_t attr;
 	ir_entity   *ent;
@@ -61,6 +72,16 @@ static inline riscv_cond_attr_t const *get_riscv_cond_attr_const(ir_node const *
 	return (riscv_cond_attr_t const*)get_irn_generic_attr_const(node);
 }
 
+static inline riscv_conv_attr_t const *get_riscv_conv_attr_const(ir_node const *const node)
+{
+	return (riscv_conv_attr_t const*)get_irn_generic_attr_const(node);
+}
+
+static inline riscv_fp_attr_t const *get_riscv_fp_attr_const(ir_node const *const node)
+{
+	return (riscv_fp_attr_t const*)get_irn_generic_attr_const(node);
+}
+
 static inline riscv_immediate_attr_t *get_riscv_immediate_attr(ir_node *const node)
 {
 	return (riscv_immediate_attr_t*)get_irn_generic_attr(node);
@@ -78,4 +99,10 @@ static inline riscv_switch_attr_t const *get_riscv_switch_attr_const(ir_node con
 
 char const *riscv_get_cond_name(riscv_cond_t cond);
 
+/**
+ * Returns the instruction suffix for operands of mode @p mode, i.e. s or d
+ * for floating point and w, wu, l or lu for integer modes.
+ */
+char const *riscv_get_mode_suffix(ir_mode const *mode);
+
 #endif
@@ -3,7 +3,8 @@
 
 $arch = "riscv";
 
-my $mode_gp = "mode_Iu";
+my $mode_gp = "mode_Iu"; # riscv64 switches to mode_Lu at initialization
+my $mode_fp = "mode_D";
 
 %reg_classes = (
 	gp => {
@@ -43,12 +44,54 @@ my $mode_gp = "mode_Iu";
 			{ name => "t6",   encoding => 31 },
 		]
 	},
+	fp => {
+		mode => $mode_fp,
+		registers => [
+			{ name => "ft0",  encoding =>  0 },
+			{ name => "ft1",  encoding =>  1 },
+			{ name => "ft2",  encoding =>  2 },
+			{ name => "ft3",  encoding =>  3 },
+			{ name => "ft4",  encoding =>  4 },
+			{ name => "ft5",  encoding =>  5 },
+			{ name => "ft6",  encoding =>  6 },
+			{ name => "ft7",  encoding =>  7 },
+			{ name => "fs0",  encoding =>  8 },
+			{ name => "fs1",  encoding =>  9 },
+			{ name => "fa0",  encoding => 10 },
+			{ name => "fa1",  encoding => 11 },
+			{ name => "fa2",  encoding => 12 },
+			{ name => "fa3",  encoding => 13 },
+			{ name => "fa4",  encoding => 14 },
+			{ name => "fa5",  encoding => 15 },
+			{ name => "fa6",  encoding => 16 },
+			{ name => "fa7",  encoding => 17 },
+			{ name => "fs2",  encoding => 18 },
+			{ name => "fs3",  encoding => 19 },
+			{ name => "fs4",  encoding => 20 },
+			{ name => "fs5",  encoding => 21 },
+			{ name => "fs6",  encoding => 22 },
+			{ name => "fs7",  encoding => 23 },
+			{ name => "fs8",  encoding => 24 },
+			{ name => "fs9",  encoding => 25 },
+			{ name => "fs10", encoding => 26 },
+			{ name => "fs11", encoding => 27 },
+			{ name => "ft8",  encoding => 28 },
+			{ name => "ft9",  encoding => 29 },
+			{ name => "ft10", encoding => 30 },
+			{ name => "ft11", encoding => 31 },
+		]
+	},
 );
 
 %init_attr = (
 	riscv_attr_t => "",
 	riscv_cond_attr_t =>
 		"attr->cond = cond;",
+	riscv_conv_attr_t =>
+		"attr->src_mode = src_mode;\n".
+		"\tattr->dst_mode = dst_mode;",
+	riscv_fp_attr_t =>
+		"attr->mode = mode;",
 	riscv_immediate_attr_t =>
 		"attr->ent = ent;\n".
 		"\tattr->val = val;",
@@ -95,6 +138,31 @@ my $loadOp = {
 	emit      => "{name}\t%D1, %A",
 };
 
+my $fpBinOp = {
+	irn_flags => [ "rematerializable" ],
+	in_reqs   => [ "cls-fp", "cls-fp" ],
+	out_reqs  => [ "cls-fp" ],
+	ins       => [ "left", "right" ],
+	outs      => [ "res" ],
+	attr_type => "riscv_fp_attr_t",
+	attr      => "ir_mode *const mode",
+	emit      => "{name}.%M\t%D0, %S0, %S1",
+};
+
+my $fpCmpOp = {
+	%$fpBinOp,
+	out_reqs => [ "cls-gp" ],
+};
+
+my $convOp = {
+	irn_flags => [ "rematerializable" ],
+	ins       => [ "val" ],
+	outs      => [ "res" ],
+	attr_type => "riscv_conv_attr_t",
+	attr      => "ir_mode *const src_mode, ir_mode *const dst_mode",
+	emit      => "fcvt.%V\t%D0, %S0",
+};
+
 my $storeOp = {
 	state     => "exc_pinned",
 	in_reqs   => [ "mem", "cls-gp", "cls-gp" ],
@@ -127,10 +195,102 @@ bcc => {
 	attr      => "riscv_cond_t const cond",
 },
 
+addiw => { template => $immediateOp },
+
 div => { template => $binOp, },
 
 divu => { template => $binOp, },
 
+divuw => { template => $binOp, },
+
+divw => { template => $binOp, },
+
+fadd => { template => $fpBinOp },
+
+fcvt_ff => {
+	template => $convOp,
+	in_reqs  => [ "cls-fp" ],
+	out_reqs => [ "cls-fp" ],
+},
+
+fcvt_fi => {
+	template => $convOp,
+	in_reqs  => [ "cls-fp" ],
+	out_reqs => [ "cls-gp" ],
+	emit     => "fcvt.%V\t%D0, %S0, rtz",
+},
+
+fcvt_if => {
+	template => $convOp,
+	in_reqs  => [ "cls-gp" ],
+	out_reqs => [ "cls-fp" ],
+},
+
+fdiv => { template => $fpBinOp },
+
+feq => { template => $fpCmpOp },
+
+fld => {
+	template => $loadOp,
+	out_reqs => [ "mem", "cls-fp" ],
+},
+
+fle => { template => $fpCmpOp },
+
+flt => { template => $fpCmpOp },
+
+flw => {
+	template => $loadOp,
+	out_reqs => [ "mem", "cls-fp" ],
+},
+
+fmul => { template => $fpBinOp },
+
+fmv_f => {
+	irn_flags => [ "rematerializable" ],
+	in_reqs   => [ "cls-gp" ],
+	out_reqs  => [ "cls-fp" ],
+	ins       => [ "val" ],
+	outs      => [ "res" ],
+	attr_type => "riscv_fp_attr_t",
+	attr      => "ir_mode *const mode",
+	emit      => "fmv.%W.x\t%D0, %S0",
+},
+
+fmv_x => {
+	irn_flags => [ "rematerializable" ],
+	in_reqs   => [ "cls-fp" ],
+	out_reqs  => [ "cls-gp" ],
+	ins       => [ "val" ],
+	outs      => [ "res" ],
+	attr_type => "riscv_fp_attr_t",
+	attr      => "ir_mode *const mode",
+	emit      => "fmv.x.%W\t%D0, %S0",
+},
+
+fneg => {
+	irn_flags => [ "rematerializable" ],
+	in_reqs   => [ "cls-fp" ],
+	out_reqs  => [ "cls-fp" ],
+	ins       => [ "val" ],
+	outs      => [ "res" ],
+	attr_type => "riscv_fp_attr_t",
+	attr      => "ir_mode *const mode",
+	emit      => "fneg.%M\t%D0, %S0",
+},
+
+fsd => {
+	template => $storeOp,
+	in_reqs  => [ "mem", "cls-gp", "cls-fp" ],
+},
+
+fsub => { template => $fpBinOp },
+
+fsw => {
+	template => $storeOp,
+	in_reqs  => [ "mem", "cls-gp", "cls-fp" ],
+},
+
 ijmp => {
 	state    => "pinned",
 	op_flags => [ "cfopcode", "unknown_jump" ],
@@ -160,6 +320,8 @@ jalr => {
 
 lb => { template => $loadOp },
 
+ld => { template => $loadOp },
+
 lbu => { template => $loadOp },
 
 lh => { template => $loadOp },
@@ -175,6 +337,8 @@ lui => {
 
 lw => { template => $loadOp },
 
+lwu => { template => $loadOp },
+
 mul => { template => $binOp, },
 
 mulh => { template => $binOp, },
@@ -189,6 +353,10 @@ rem => { template => $binOp, },
 
 remu => { template => $binOp, },
 
+remuw => { template => $binOp, },
+
+remw => { template => $binOp, },
+
 ret => {
 	state    => "pinned",
 	op_flags => [ "cfopcode" ],
@@ -200,12 +368,18 @@ ret => {
 
 sb => { template => $storeOp },
 
+sd => { template => $storeOp },
+
 sh => { template => $storeOp },
 
 sll => { template => $binOp },
 
 slli => { template => $immediateOp },
 
+slliw => { template => $immediateOp },
+
+sllw => { template => $binOp },
+
 slt => { template => $binOp },
 
 sltiu => { template => $immediateOp },
@@ -216,10 +390,18 @@ sra => { template => $binOp },
 
 srai => { template => $immediateOp },
 
+sraiw => { template => $immediateOp },
+
+sraw => { template => $binOp },
+
 srl => { template => $binOp },
 
 srli => { template => $immediateOp },
 
+srliw => { template => $immediateOp },
+
+srlw => { template => $binOp },
+
 sub => { template => $binOp },
 
 sw => { template => $storeOp },
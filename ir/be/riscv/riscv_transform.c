@@ -6,6 +6,7 @@
 #include "riscv_transform.h"
 
 #include "becconv.h"
+#include "bitfiddle.h"
 #include "beirg.h"
 #include "benode.h"
 #include "betranshlp.h"
@@ -23,6 +24,7 @@ static be_stack_env_t stack_env;
 
 static const unsigned ignore_regs[] = {
 	REG_T0,
+	REG_FT11,
 };
 
 static unsigned const callee_saves[] = {
@@ -38,6 +40,18 @@ static unsigned const callee_saves[] = {
 	REG_S9,
 	REG_S10,
 	REG_S11,
+	REG_FS0,
+	REG_FS1,
+	REG_FS2,
+	REG_FS3,
+	REG_FS4,
+	REG_FS5,
+	REG_FS6,
+	REG_FS7,
+	REG_FS8,
+	REG_FS9,
+	REG_FS10,
+	REG_FS11,
 };
 
 static unsigned const caller_saves[] = {
@@ -56,8 +70,81 @@ static unsigned const caller_saves[] = {
 	REG_T4,
 	REG_T5,
 	REG_T6,
+	REG_FT0,
+	REG_FT1,
+	REG_FT2,
+	REG_FT3,
+	REG_FT4,
+	REG_FT5,
+	REG_FT6,
+	REG_FT7,
+	REG_FA0,
+	REG_FA1,
+	REG_FA2,
+	REG_FA3,
+	REG_FA4,
+	REG_FA5,
+	REG_FA6,
+	REG_FA7,
+	REG_FT8,
+	REG_FT9,
+	REG_FT10,
 };
 
+static bool mode_needs_fp_reg(ir_mode *const mode)
+{
+	return mode_is_float(mode) && get_mode_size_bits(mode) <= 64;
+}
+
+typedef ir_node *cons_loadop(dbg_info*, ir_node*, ir_node*, ir_node*, ir_entity*, int32_t);
+typedef ir_node *cons_storeop(dbg_info*, ir_node*, ir_node*, ir_node*, ir_node*, ir_entity*, int32_t);
+
+static cons_loadop *get_load_cons(ir_mode *const mode)
+{
+	unsigned const size = get_mode_size_bits(mode);
+	if (mode_is_float(mode)) {
+		switch (size) {
+		case 32: return &new_bd_riscv_flw;
+		case 64: return &new_bd_riscv_fld;
+		}
+	} else {
+		bool const is_signed = mode_is_signed(mode);
+		switch (size) {
+		case  8: return is_signed ? &new_bd_riscv_lb : &new_bd_riscv_lbu;
+		case 16: return is_signed ? &new_bd_riscv_lh : &new_bd_riscv_lhu;
+		/* Unsigned values are loaded zero extended, see make_extension(). */
+		case 32: return is_signed || riscv_machine_size == 32 ? &new_bd_riscv_lw : &new_bd_riscv_lwu;
+		case 64:
+			if (riscv_machine_size == 64)
+				return &new_bd_riscv_ld;
+			break;
+		}
+	}
+	panic("invalid load");
+}
+
+static cons_storeop *get_store_cons(ir_mode *const mode)
+{
+	unsigned const size = get_mode_size_bits(mode);
+	if (mode_is_float(mode)) {
+		switch (size) {
+		case 32: return &new_bd_riscv_fsw;
+		case 64: return &new_bd_riscv_fsd;
+		}
+	} else {
+		switch (size) {
+		case  8: return &new_bd_riscv_sb;
+		case 16: return &new_bd_riscv_sh;
+		case 32: return &new_bd_riscv_sw;
+		case 64:
+			if (riscv_machine_size == 64)
+				return &new_bd_riscv_sd;
+			break;
+		}
+	}
+	panic("invalid store");
+}
+
 static ir_node *get_Start_sp(ir_graph *const irg)
 {
 	return be_get_Start_proj(irg, &riscv_registers[REG_SP]);
@@ -123,17 +210,19 @@ static ir_node *make_extension(dbg_info *const dbgi, ir_node *const op, unsigned
 			return new_op;
 	}
 
-	assert(op_size <= 16);
+	assert(op_size <= 32);
 	ir_node *const block = get_nodes_block(new_op);
-	if (mode_is_signed(op_mode)) {
-		int32_t  const val = RISCV_MACHINE_SIZE - op_size;
+	if (mode_is_signed(op_mode) && op_size == 32) {
+		return new_bd_riscv_addiw(dbgi, block, new_op, NULL, 0);
+	} else if (mode_is_signed(op_mode)) {
+		int32_t  const val = riscv_machine_size - op_size;
 		ir_node *const sll = new_bd_riscv_slli(dbgi, block, new_op, NULL, val);
 		ir_node *const sra = new_bd_riscv_srai(dbgi, block, sll,    NULL, val);
 		return sra;
 	} else if (op_size == 8) {
 		return new_bd_riscv_andi(dbgi, block, new_op, NULL, (1U << op_size) - 1);
 	} else {
-		int32_t  const val = RISCV_MACHINE_SIZE - op_size;
+		int32_t  const val = riscv_machine_size - op_size;
 		ir_node *const sll = new_bd_riscv_slli(dbgi, block, new_op, NULL, val);
 		ir_node *const srl = new_bd_riscv_srli(dbgi, block, sll,    NULL, val);
 		return srl;
@@ -142,7 +231,7 @@ static ir_node *make_extension(dbg_info *const dbgi, ir_node *const op, unsigned
 
 static ir_node *extend_value(ir_node *const val)
 {
-	return make_extension(NULL, val, RISCV_MACHINE_SIZE);
+	return make_extension(NULL, val, riscv_machine_size);
 }
 
 static void riscv_parse_constraint_letter(void const *const env, be_asm_constraint_t* const c, char const l)
@@ -163,6 +252,11 @@ static void riscv_parse_constraint_letter(void const *const env, be_asm_constrai
 		c->immediate_type = l;
 		break;
 
+	case 'f':
+		c->cls                   = &riscv_reg_classes[CLASS_riscv_fp];
+		c->all_registers_allowed = true;
+		break;
+
 	case 'm':
 		c->memory_possible = true;
 		break;
@@ -261,8 +355,24 @@ static ir_node *gen_ASM(ir_node *const node)
 	return be_make_asm(node, &info, operands);
 }
 
+typedef ir_node *cons_fp_binop(dbg_info*, ir_node*, ir_node*, ir_node*, ir_mode*);
+
+static ir_node *gen_fp_binop(ir_node *const node, ir_node *const l, ir_node *const r, cons_fp_binop *const cons)
+{
+	dbg_info *const dbgi  = get_irn_dbg_info(node);
+	ir_node  *const block = be_transform_nodes_block(node);
+	ir_node  *const new_l = be_transform_node(l);
+	ir_node  *const new_r = be_transform_node(r);
+	ir_mode  *const mode  = get_irn_mode(l);
+	return cons(dbgi, block, new_l, new_r, mode);
+}
+
 static ir_node *gen_Add(ir_node *const node)
 {
+	ir_mode *const mode = get_irn_mode(node);
+	if (mode_needs_fp_reg(mode))
+		return gen_fp_binop(node, get_Add_left(node), get_Add_right(node), &new_bd_riscv_fadd);
+
 	ir_tarval *tv;
 	ir_entity *ent;
 	unsigned   reloc_kind;
@@ -272,9 +382,8 @@ static ir_node *gen_Add(ir_node *const node)
 		return make_address(node, ent, val);
 	}
 
-	ir_node *const l    = get_Add_left(node);
-	ir_node *const r    = get_Add_right(node);
-	ir_mode *const mode = get_irn_mode(node);
+	ir_node *const l = get_Add_left(node);
+	ir_node *const r = get_Add_right(node);
 	if (be_mode_needs_gp_reg(mode)) {
 		dbg_info *const dbgi  = get_irn_dbg_info(node);
 		ir_node  *const block = be_transform_nodes_block(node);
@@ -320,12 +429,34 @@ static ir_node *gen_And(ir_node *const node)
 	return gen_logic_op(node, &new_bd_riscv_and, &new_bd_riscv_andi);
 }
 
+static ir_node *gen_Bitcast(ir_node *const node)
+{
+	dbg_info *const dbgi    = get_irn_dbg_info(node);
+	ir_node  *const block   = be_transform_nodes_block(node);
+	ir_node  *const op      = get_Bitcast_op(node);
+	ir_mode  *const op_mode = get_irn_mode(op);
+	ir_node  *const new_op  = be_transform_node(op);
+	ir_mode  *const mode    = get_irn_mode(node);
+	if (mode_is_float(op_mode) && !mode_is_float(mode)) {
+		return new_bd_riscv_fmv_x(dbgi, block, new_op, op_mode);
+	} else if (!mode_is_float(op_mode) && mode_is_float(mode)) {
+		return new_bd_riscv_fmv_f(dbgi, block, new_op, mode);
+	}
+	TODO(node);
+}
+
 static ir_node *gen_saturating_increment(ir_node *const node)
 {
   dbg_info *const dbgi    = get_irn_dbg_info(node);
   ir_node  *const block   = be_transform_nodes_block(node);
-  ir_node  *const operand = be_transform_node(get_Builtin_param(node, 0));
-  assert(get_mode_size_bits(get_irn_mode(operand)) == 32);
+  ir_node  *const param   = get_Builtin_param(node, 0);
+  ir_node        *operand = be_transform_node(param);
+  unsigned  const size    = get_mode_size_bits(get_irn_mode(param));
+  if (size != riscv_machine_size) {
+    /* Sign extend, so the maximal 32 bit value has all bits set. */
+    assert(size == 32 && riscv_machine_size == 64);
+    operand = new_bd_riscv_addiw(dbgi, block, operand, NULL, 0);
+  }
 
   ir_node *const sltiu = new_bd_riscv_sltiu(dbgi, block, operand, NULL, -1);
   ir_node *const addu  = new_bd_riscv_add(  dbgi, block, operand, sltiu);
@@ -339,11 +470,18 @@ static ir_node *gen_Builtin(ir_node *const node)
 	case ir_bk_saturating_increment: return gen_saturating_increment(node);
 
 	case ir_bk_bswap:
+	case ir_bk_ceil:
 	case ir_bk_clz:
 	case ir_bk_compare_swap:
+	case ir_bk_copysign:
 	case ir_bk_ctz:
+	case ir_bk_cycle_counter:
 	case ir_bk_debugbreak:
+	case ir_bk_fabs:
 	case ir_bk_ffs:
+	case ir_bk_floor:
+	case ir_bk_fmax:
+	case ir_bk_fmin:
 	case ir_bk_frame_address:
 	case ir_bk_inport:
 	case ir_bk_may_alias:
@@ -352,7 +490,10 @@ static ir_node *gen_Builtin(ir_node *const node)
 	case ir_bk_popcount:
 	case ir_bk_prefetch:
 	case ir_bk_return_address:
+	case ir_bk_round:
+	case ir_bk_sqrt:
 	case ir_bk_trap:
+	case ir_bk_trunc:
 	case ir_bk_va_arg:
 	case ir_bk_va_start:
 		TODO(node);
@@ -403,17 +544,30 @@ static ir_node *gen_Call(ir_node *const node)
 
 	dbg_info *const dbgi = get_irn_dbg_info(node);
 	for (size_t i = 0; i != n_params; ++i) {
-		ir_node *const arg = get_Call_param(node, i);
-		ir_node *const val = extend_value(arg);
+		ir_node *const arg  = get_Call_param(node, i);
+		ir_mode *const mode = get_irn_mode(arg);
+		ir_node       *val;
+		if (mode_is_float(mode)) {
+			val = be_transform_node(arg);
+		} else if (riscv_machine_size == 64 && get_mode_size_bits(mode) == 32) {
+			/* riscv64 passes 32 bit values sign extended, regardless of their
+			 * signedness. */
+			val = new_bd_riscv_addiw(dbgi, block, be_transform_node(arg), NULL, 0);
+		} else {
+			val = extend_value(arg);
+		}
 
 		riscv_reg_or_slot_t const *const param = &cconv.parameters[i];
 		if (param->reg) {
+			if (mode_is_float(mode) && param->reg->cls != &riscv_reg_classes[CLASS_riscv_fp])
+				val = new_bd_riscv_fmv_x(dbgi, block, val, mode);
 			ins[p]  = val;
 			reqs[p] = param->reg->single_req;
 			++p;
 		} else {
-			ir_node *const nomem = get_irg_no_mem(irg);
-			mems[m++] = new_bd_riscv_sw(dbgi, block, nomem, call_frame, val, NULL, param->offset);
+			ir_node      *const nomem = get_irg_no_mem(irg);
+			cons_storeop *const cons  = get_store_cons(mode_is_float(mode) ? mode : riscv_reg_classes[CLASS_riscv_gp].mode);
+			mems[m++] = cons(dbgi, block, nomem, call_frame, val, NULL, param->offset);
 		}
 	}
 
@@ -441,12 +595,75 @@ static ir_node *gen_Call(ir_node *const node)
 	return jal;
 }
 
+/**
+ * Computes a floating point comparison into a general purpose register.
+ * Relations including unordered are computed negated, *negated is set then.
+ */
+static ir_node *gen_fp_cmp(ir_node *const node, bool *const negated)
+{
+	ir_relation rel = get_Cmp_relation(node);
+	*negated = rel & ir_relation_unordered;
+	if (*negated)
+		rel = get_negated_relation(rel);
+
+	dbg_info *const dbgi  = get_irn_dbg_info(node);
+	ir_node  *const block = be_transform_nodes_block(node);
+	ir_node  *const l     = get_Cmp_left(node);
+	ir_mode  *const mode  = get_irn_mode(l);
+	ir_node        *new_l = be_transform_node(l);
+	ir_node        *new_r = be_transform_node(get_Cmp_right(node));
+	switch (rel) {
+	case ir_relation_equal:
+		return new_bd_riscv_feq(dbgi, block, new_l, new_r, mode);
+
+	case ir_relation_greater: {
+		ir_node *const t = new_l;
+		new_l = new_r;
+		new_r = t;
+	} /* FALLTHROUGH */
+	case ir_relation_less:
+		return new_bd_riscv_flt(dbgi, block, new_l, new_r, mode);
+
+	case ir_relation_greater_equal: {
+		ir_node *const t = new_l;
+		new_l = new_r;
+		new_r = t;
+	} /* FALLTHROUGH */
+	case ir_relation_less_equal:
+		return new_bd_riscv_fle(dbgi, block, new_l, new_r, mode);
+
+	case ir_relation_less_greater: {
+		ir_node *const lt = new_bd_riscv_flt(dbgi, block, new_l, new_r, mode);
+		ir_node *const gt = new_bd_riscv_flt(dbgi, block, new_r, new_l, mode);
+		return new_bd_riscv_or(dbgi, block, lt, gt);
+	}
+
+	case ir_relation_less_equal_greater: {
+		/* Only NaN is unequal to itself. */
+		ir_node *const ord_l = new_bd_riscv_feq(dbgi, block, new_l, new_l, mode);
+		ir_node *const ord_r = new_bd_riscv_feq(dbgi, block, new_r, new_r, mode);
+		return new_bd_riscv_and(dbgi, block, ord_l, ord_r);
+	}
+
+	default:
+		panic("unexpected relation");
+	}
+}
+
 static ir_node *gen_Cmp(ir_node *const node)
 {
 	ir_node       *l    = get_Cmp_left(node);
 	ir_node       *r    = get_Cmp_right(node);
 	ir_mode *const mode = get_irn_mode(l);
-	if (be_mode_needs_gp_reg(mode)) {
+	if (mode_needs_fp_reg(mode)) {
+		bool           negated;
+		ir_node *const cmp = gen_fp_cmp(node, &negated);
+		if (!negated)
+			return cmp;
+		dbg_info *const dbgi  = get_irn_dbg_info(node);
+		ir_node  *const block = be_transform_nodes_block(node);
+		return new_bd_riscv_xori(dbgi, block, cmp, NULL, 1);
+	} else if (be_mode_needs_gp_reg(mode)) {
 		ir_relation const rel = get_Cmp_relation(node) & ir_relation_less_equal_greater;
 		switch (rel) {
 		case ir_relation_greater: {
@@ -492,7 +709,16 @@ static ir_node *gen_Cond(ir_node *const node)
 	if (is_Cmp(sel)) {
 		ir_node       *l    = get_Cmp_left(sel);
 		ir_mode *const mode = get_irn_mode(l);
-		if (be_mode_needs_gp_reg(mode)) {
+		if (mode_needs_fp_reg(mode)) {
+			bool                negated;
+			ir_node      *const cmp   = gen_fp_cmp(sel, &negated);
+			dbg_info     *const dbgi  = get_irn_dbg_info(node);
+			ir_node      *const block = be_transform_nodes_block(node);
+			ir_graph     *const irg   = get_irn_irg(node);
+			ir_node      *const zero  = get_Start_zero(irg);
+			riscv_cond_t  const cc    = negated ? riscv_cc_eq : riscv_cc_ne;
+			return new_bd_riscv_bcc(dbgi, block, cmp, zero, cc);
+		} else if (be_mode_needs_gp_reg(mode)) {
 			ir_relation const rel = get_Cmp_relation(sel) & ir_relation_less_equal_greater;
 			ir_node          *r   = get_Cmp_right(sel);
 			switch (rel) {
@@ -544,30 +770,90 @@ bcc:;
 	TODO(node);
 }
 
+static ir_node *make_constant(dbg_info *const dbgi, ir_node *const block, int64_t const val)
+{
+	if (val == (int32_t)val) {
+		riscv_hi_lo_imm imm = calc_hi_lo((int32_t)val);
+		ir_node      *res;
+		if (imm.hi != 0) {
+			res = new_bd_riscv_lui(dbgi, block, NULL, imm.hi);
+		} else {
+			ir_graph *const irg = get_irn_irg(block);
+			res = get_Start_zero(irg);
+		}
+		if (imm.lo != 0) {
+			/* lui sign extends on riscv64, so the addition has to wrap around
+			 * at 32 bits. */
+			cons_binop_imm *const cons = riscv_machine_size == 64 ? &new_bd_riscv_addiw : &new_bd_riscv_addi;
+			res = cons(dbgi, block, res, NULL, imm.lo);
+		}
+		return res;
+	}
+
+	/* Materialize the upper bits, shift them into place and add the sign
+	 * extended lower 12 bits. */
+	int32_t  const lo    = (int32_t)((val & 0xFFF) ^ 0x800) - 0x800;
+	int64_t        hi    = (int64_t)((uint64_t)val - (uint64_t)(int64_t)lo) >> 12;
+	int32_t        shift = 12;
+	while ((hi & 1) == 0) {
+		hi >>= 1;
+		++shift;
+	}
+	ir_node *res = make_constant(dbgi, block, hi);
+	res = new_bd_riscv_slli(dbgi, block, res, NULL, shift);
+	if (lo != 0)
+		res = new_bd_riscv_addi(dbgi, block, res, NULL, lo);
+	return res;
+}
+
+static ir_entity *create_float_const_entity(ir_tarval *const tv)
+{
+	ir_entity *entity = pmap_get(ir_entity, riscv_constants, tv);
+	if (entity)
+		return entity;
+
+	ir_mode *const mode = get_tarval_mode(tv);
+	ir_type *const type = get_type_for_mode(mode);
+	ir_type *const glob = get_glob_type();
+	entity = new_global_entity(glob, id_unique("C"), type, ir_visibility_private, IR_LINKAGE_CONSTANT | IR_LINKAGE_NO_IDENTITY);
+	set_entity_initializer(entity, create_initializer_tarval(tv));
+
+	pmap_insert(riscv_constants, tv, entity);
+	return entity;
+}
+
 static ir_node *gen_Const(ir_node *const node)
 {
 	ir_mode *const mode = get_irn_mode(node);
 	if (be_mode_needs_gp_reg(mode)) {
-		long const val = get_Const_long(node);
+		long val = get_Const_long(node);
+		if (get_mode_size_bits(mode) <= 32)
+			val = (int32_t)val;
 		if (val == 0) {
 			ir_graph *const irg = get_irn_irg(node);
 			return get_Start_zero(irg);
 		} else {
 			dbg_info *const dbgi  = get_irn_dbg_info(node);
 			ir_node  *const block = be_transform_nodes_block(node);
-
-			riscv_hi_lo_imm imm = calc_hi_lo((int32_t)val);
-			ir_node      *res;
-			if (imm.hi != 0) {
-				res = new_bd_riscv_lui(dbgi, block, NULL, imm.hi);
-			} else {
-				ir_graph *const irg = get_irn_irg(node);
-				res = get_Start_zero(irg);
-			}
-			if (imm.lo != 0)
-				res = new_bd_riscv_addi(dbgi, block, res, NULL, imm.lo);
-			return res;
+			return make_constant(dbgi, block, val);
 		}
+	} else if (mode_needs_fp_reg(mode)) {
+		dbg_info  *const dbgi  = get_irn_dbg_info(node);
+		ir_node   *const block = be_transform_nodes_block(node);
+		ir_graph  *const irg   = get_irn_irg(node);
+		ir_tarval *const tv    = get_Const_tarval(node);
+		if (tv == get_mode_null(mode)) {
+			ir_node *const zero = get_Start_zero(irg);
+			return new_bd_riscv_fcvt_if(dbgi, block, zero, mode_Is, mode);
+		}
+
+		ir_entity   *const ent   = create_float_const_entity(tv);
+		ir_node     *const lui   = new_bd_riscv_lui(dbgi, block, ent, 0);
+		ir_node     *const nomem = get_irg_no_mem(irg);
+		cons_loadop *const cons  = get_load_cons(mode);
+		ir_node     *const load  = cons(dbgi, block, nomem, lui, ent, 0);
+		set_irn_pinned(load, false);
+		return be_new_Proj(load, pn_riscv_lw_res);
 	}
 	TODO(node);
 }
@@ -577,9 +863,31 @@ static ir_node *gen_Conv(ir_node *const node)
 	ir_node *const op      = get_Conv_op(node);
 	ir_mode *const op_mode = get_irn_mode(op);
 	ir_mode *const mode    = get_irn_mode(node);
+	dbg_info      *const dbgi    = get_irn_dbg_info(node);
 	if (be_mode_needs_gp_reg(op_mode) && be_mode_needs_gp_reg(mode)) {
-		dbg_info *const dbgi = get_irn_dbg_info(node);
 		return make_extension(dbgi, op, get_mode_size_bits(mode));
+	} else if (mode_needs_fp_reg(op_mode) && mode_needs_fp_reg(mode)) {
+		ir_node *const new_op = be_transform_node(op);
+		if (get_mode_size_bits(op_mode) == get_mode_size_bits(mode))
+			return new_op;
+		ir_node *const block = be_transform_nodes_block(node);
+		return new_bd_riscv_fcvt_ff(dbgi, block, new_op, op_mode, mode);
+	} else if (be_mode_needs_gp_reg(op_mode) && mode_needs_fp_reg(mode)) {
+		/* fcvt reads 32 or 64 bit integers, so extend smaller values. */
+		ir_node *const block = be_transform_nodes_block(node);
+		if (get_mode_size_bits(op_mode) < 32) {
+			ir_node *const new_op   = make_extension(dbgi, op, 32);
+			ir_mode *const src_mode = mode_is_signed(op_mode) ? mode_Is : mode_Iu;
+			return new_bd_riscv_fcvt_if(dbgi, block, new_op, src_mode, mode);
+		} else {
+			ir_node *const new_op = be_transform_node(op);
+			return new_bd_riscv_fcvt_if(dbgi, block, new_op, op_mode, mode);
+		}
+	} else if (mode_needs_fp_reg(op_mode) && be_mode_needs_gp_reg(mode)) {
+		ir_node *const block    = be_transform_nodes_block(node);
+		ir_node *const new_op   = be_transform_node(op);
+		ir_mode *const dst_mode = get_mode_size_bits(mode) < 32 ? mode_Is : mode;
+		return new_bd_riscv_fcvt_fi(dbgi, block, new_op, op_mode, dst_mode);
 	}
 	TODO(node);
 }
@@ -587,16 +895,25 @@ static ir_node *gen_Conv(ir_node *const node)
 static ir_node *gen_Div(ir_node *const node)
 {
 	ir_mode *const mode = get_Div_resmode(node);
-	if (be_mode_needs_gp_reg(mode) && get_mode_size_bits(mode) == RISCV_MACHINE_SIZE) {
+	if (mode_needs_fp_reg(mode))
+		return gen_fp_binop(node, get_Div_left(node), get_Div_right(node), &new_bd_riscv_fdiv);
+
+	if (be_mode_needs_gp_reg(mode)) {
+		unsigned   const size      = get_mode_size_bits(mode);
+		bool       const is_signed = mode_is_signed(mode);
+		cons_binop      *cons;
+		if (size == riscv_machine_size) {
+			cons = is_signed ? &new_bd_riscv_div : &new_bd_riscv_divu;
+		} else if (size == 32) {
+			cons = is_signed ? &new_bd_riscv_divw : &new_bd_riscv_divuw;
+		} else {
+			TODO(node);
+		}
 		dbg_info *const dbgi  = get_irn_dbg_info(node);
 		ir_node  *const block = be_transform_nodes_block(node);
 		ir_node  *const l     = be_transform_node(get_Div_left(node));
 		ir_node  *const r     = be_transform_node(get_Div_right(node));
-		if (mode_is_signed(mode)) {
-			return new_bd_riscv_div(dbgi, block, l, r);
-		} else {
-			return new_bd_riscv_divu(dbgi, block, l, r);
-		}
+		return cons(dbgi, block, l, r);
 	}
 	TODO(node);
 }
@@ -621,23 +938,11 @@ static ir_node *gen_Jmp(ir_node *const node)
 	return new_bd_riscv_j(dbgi, block);
 }
 
-typedef ir_node *cons_loadop(dbg_info*, ir_node*, ir_node*, ir_node*, ir_entity*, int32_t);
-
 static ir_node *gen_Load(ir_node *const node)
 {
 	ir_mode *const mode = get_Load_mode(node);
-	if (be_mode_needs_gp_reg(mode)) {
-		cons_loadop   *cons;
-		unsigned const size = get_mode_size_bits(mode);
-		if (size == 8) {
-			cons = mode_is_signed(mode) ? &new_bd_riscv_lb : &new_bd_riscv_lbu;
-		} else if (size == 16) {
-			cons = mode_is_signed(mode) ? &new_bd_riscv_lh : &new_bd_riscv_lhu;
-		} else if (size == 32) {
-			cons = new_bd_riscv_lw;
-		} else {
-			panic("invalid load");
-		}
+	if (be_mode_needs_gp_reg(mode) || mode_needs_fp_reg(mode)) {
+		cons_loadop *const cons  = get_load_cons(mode);
 		dbg_info  *const dbgi  = get_irn_dbg_info(node);
 		ir_node   *const block = be_transform_nodes_block(node);
 		ir_node   *const mem   = be_transform_node(get_Load_mem(node));
@@ -662,7 +967,12 @@ static ir_node *gen_Minus(ir_node *const node)
 {
 	ir_node *const val  = get_Minus_op(node);
 	ir_mode *const mode = get_irn_mode(node);
-	if (be_mode_needs_gp_reg(mode)) {
+	if (mode_needs_fp_reg(mode)) {
+		dbg_info *const dbgi   = get_irn_dbg_info(node);
+		ir_node  *const block  = be_transform_nodes_block(node);
+		ir_node  *const new_op = be_transform_node(val);
+		return new_bd_riscv_fneg(dbgi, block, new_op, mode);
+	} else if (be_mode_needs_gp_reg(mode)) {
 		dbg_info *const dbgi  = get_irn_dbg_info(node);
 		ir_node  *const block = be_transform_nodes_block(node);
 		ir_graph *const irg   = get_irn_irg(node);
@@ -676,16 +986,22 @@ static ir_node *gen_Minus(ir_node *const node)
 static ir_node *gen_Mod(ir_node *const node)
 {
 	ir_mode *const mode = get_Mod_resmode(node);
-	if (be_mode_needs_gp_reg(mode) && get_mode_size_bits(mode) == RISCV_MACHINE_SIZE) {
+	if (be_mode_needs_gp_reg(mode)) {
+		unsigned   const size      = get_mode_size_bits(mode);
+		bool       const is_signed = mode_is_signed(mode);
+		cons_binop      *cons;
+		if (size == riscv_machine_size) {
+			cons = is_signed ? &new_bd_riscv_rem : &new_bd_riscv_remu;
+		} else if (size == 32) {
+			cons = is_signed ? &new_bd_riscv_remw : &new_bd_riscv_remuw;
+		} else {
+			TODO(node);
+		}
 		dbg_info *const dbgi  = get_irn_dbg_info(node);
 		ir_node  *const block = be_transform_nodes_block(node);
 		ir_node  *const l     = be_transform_node(get_Mod_left(node));
 		ir_node  *const r     = be_transform_node(get_Mod_right(node));
-		if (mode_is_signed(mode)) {
-			return new_bd_riscv_rem(dbgi, block, l, r);
-		} else {
-			return new_bd_riscv_remu(dbgi, block, l, r);
-		}
+		return cons(dbgi, block, l, r);
 	}
 	TODO(node);
 }
@@ -693,7 +1009,9 @@ static ir_node *gen_Mod(ir_node *const node)
 static ir_node *gen_Mul(ir_node *const node)
 {
 	ir_mode *const mode = get_irn_mode(node);
-	if (be_mode_needs_gp_reg(mode)) {
+	if (mode_needs_fp_reg(mode)) {
+		return gen_fp_binop(node, get_Mul_left(node), get_Mul_right(node), &new_bd_riscv_fmul);
+	} else if (be_mode_needs_gp_reg(mode)) {
 		dbg_info *const dbgi  = get_irn_dbg_info(node);
 		ir_node  *const block = be_transform_nodes_block(node);
 		ir_node  *const l     = be_transform_node(get_Mul_left(node));
@@ -706,7 +1024,7 @@ static ir_node *gen_Mul(ir_node *const node)
 static ir_node *gen_Mulh(ir_node *const node)
 {
 	ir_mode *const mode = get_irn_mode(node);
-	if (be_mode_needs_gp_reg(mode) && get_mode_size_bits(mode) == RISCV_MACHINE_SIZE) {
+	if (be_mode_needs_gp_reg(mode) && get_mode_size_bits(mode) == riscv_machine_size) {
 		dbg_info *const dbgi  = get_irn_dbg_info(node);
 		ir_node  *const block = be_transform_nodes_block(node);
 		ir_node  *const l     = be_transform_node(get_Mulh_left(node));
@@ -716,6 +1034,18 @@ static ir_node *gen_Mulh(ir_node *const node)
 		} else {
 			return new_bd_riscv_mulhu(dbgi, block, l, r);
 		}
+	} else if (be_mode_needs_gp_reg(mode) && get_mode_size_bits(mode) == 32) {
+		/* The full product of the extended values fits into the register. */
+		dbg_info *const dbgi  = get_irn_dbg_info(node);
+		ir_node  *const block = be_transform_nodes_block(node);
+		ir_node  *const l     = extend_value(get_Mulh_left(node));
+		ir_node  *const r     = extend_value(get_Mulh_right(node));
+		ir_node  *const mul   = new_bd_riscv_mul(dbgi, block, l, r);
+		if (mode_is_signed(mode)) {
+			return new_bd_riscv_srai(dbgi, block, mul, NULL, 32);
+		} else {
+			return new_bd_riscv_srli(dbgi, block, mul, NULL, 32);
+		}
 	}
 	TODO(node);
 }
@@ -728,7 +1058,7 @@ static ir_node *gen_Mux(ir_node *const node)
 			ir_node *const sel = get_Mux_sel(node);
 			if (is_Cmp(sel)) {
 				ir_relation const rel = get_Cmp_relation(sel) & ir_relation_less_equal_greater;
-				if (rel == ir_relation_less || rel == ir_relation_greater)
+				if (rel == ir_relation_less || rel == ir_relation_greater || mode_needs_fp_reg(get_irn_mode(get_Cmp_left(sel))))
 					return be_transform_node(sel);
 			}
 		}
@@ -757,6 +1087,8 @@ static ir_node *gen_Phi(ir_node *const node)
 	ir_mode            *const  mode = get_irn_mode(node);
 	if (be_mode_needs_gp_reg(mode)) {
 		req = &riscv_class_reg_req_gp;
+	} else if (mode_needs_fp_reg(mode)) {
+		req = &riscv_class_reg_req_fp;
 	} else if (mode == mode_M) {
 		req = arch_memory_req;
 	} else {
@@ -776,11 +1108,18 @@ static ir_node *gen_Proj_Builtin(ir_node *const node)
 		return new_pred;
 
 	case ir_bk_bswap:
+	case ir_bk_ceil:
 	case ir_bk_clz:
 	case ir_bk_compare_swap:
+	case ir_bk_copysign:
 	case ir_bk_ctz:
+	case ir_bk_cycle_counter:
 	case ir_bk_debugbreak:
+	case ir_bk_fabs:
 	case ir_bk_ffs:
+	case ir_bk_floor:
+	case ir_bk_fmax:
+	case ir_bk_fmin:
 	case ir_bk_frame_address:
 	case ir_bk_inport:
 	case ir_bk_may_alias:
@@ -789,7 +1128,10 @@ static ir_node *gen_Proj_Builtin(ir_node *const node)
 	case ir_bk_popcount:
 	case ir_bk_prefetch:
 	case ir_bk_return_address:
+	case ir_bk_round:
+	case ir_bk_sqrt:
 	case ir_bk_trap:
+	case ir_bk_trunc:
 	case ir_bk_va_arg:
 	case ir_bk_va_start:
 		TODO(node);
@@ -884,14 +1226,19 @@ static ir_node *gen_Proj_Proj_Start(ir_node *const node)
 	ir_graph            *const irg   = get_irn_irg(node);
 	unsigned             const num   = get_Proj_num(node);
 	riscv_reg_or_slot_t *const param = &cur_cconv.parameters[num];
+	ir_mode             *const mode  = get_irn_mode(node);
+	dbg_info            *const dbgi  = get_irn_dbg_info(node);
+	ir_node             *const block = be_transform_nodes_block(node);
 	if (param->reg) {
-		return be_get_Start_proj(irg, param->reg);
+		ir_node *const val = be_get_Start_proj(irg, param->reg);
+		if (mode_is_float(mode) && param->reg->cls != &riscv_reg_classes[CLASS_riscv_fp])
+			return new_bd_riscv_fmv_f(dbgi, block, val, mode);
+		return val;
 	} else {
-		dbg_info *const dbgi  = get_irn_dbg_info(node);
-		ir_node  *const block = be_transform_nodes_block(node);
-		ir_node  *const mem   = be_get_Start_mem(irg);
-		ir_node  *const base  = get_Start_sp(irg);
-		ir_node  *const load  = new_bd_riscv_lw(dbgi, block, mem, base, param->entity, 0);
+		ir_node     *const mem  = be_get_Start_mem(irg);
+		ir_node     *const base = get_Start_sp(irg);
+		cons_loadop *const cons = get_load_cons(mode);
+		ir_node     *const load = cons(dbgi, block, mem, base, param->entity, 0);
 		return be_new_Proj(load, pn_riscv_lw_res);
 	}
 }
@@ -984,7 +1331,7 @@ static ir_node *gen_shift_op(ir_node *const node, cons_binop *const cons, cons_b
 	ir_node  *const r     = get_binop_right(node);
 	if (is_Const(r)) {
 		long const val = get_Const_long(r);
-		if (is_uimm5(val))
+		if (get_mode_size_bits(get_irn_mode(node)) == 64 ? is_uimm6(val) : is_uimm5(val))
 			return cons_imm(dbgi, block, new_l, NULL, val);
 	}
 	ir_node *const new_r = be_transform_node(r);
@@ -993,6 +1340,9 @@ static ir_node *gen_shift_op(ir_node *const node, cons_binop *const cons, cons_b
 
 static ir_node *gen_Shl(ir_node *const node)
 {
+	/* Smaller values are shifted modulo 32. */
+	if (riscv_machine_size == 64 && get_mode_size_bits(get_irn_mode(node)) < 64)
+		return gen_shift_op(node, &new_bd_riscv_sllw, &new_bd_riscv_slliw);
 	return gen_shift_op(node, &new_bd_riscv_sll, &new_bd_riscv_slli);
 }
 
@@ -1000,8 +1350,10 @@ static ir_node *gen_Shr(ir_node *const node)
 {
 	ir_mode *const mode = get_irn_mode(node);
 	unsigned const size = get_mode_size_bits(mode);
-	if (size == RISCV_MACHINE_SIZE)
+	if (size == riscv_machine_size)
 		return gen_shift_op(node, &new_bd_riscv_srl, &new_bd_riscv_srli);
+	if (size == 32)
+		return gen_shift_op(node, &new_bd_riscv_srlw, &new_bd_riscv_srliw);
 	TODO(node);
 }
 
@@ -1009,8 +1361,10 @@ static ir_node *gen_Shrs(ir_node *const node)
 {
 	ir_mode *const mode = get_irn_mode(node);
 	unsigned const size = get_mode_size_bits(mode);
-	if (size == RISCV_MACHINE_SIZE)
+	if (size == riscv_machine_size)
 		return gen_shift_op(node, &new_bd_riscv_sra, &new_bd_riscv_srai);
+	if (size == 32)
+		return gen_shift_op(node, &new_bd_riscv_sraw, &new_bd_riscv_sraiw);
 	TODO(node);
 }
 
@@ -1037,25 +1391,14 @@ static ir_node *gen_Start(ir_node *const node)
 	return be_new_Start(irg, outs);
 }
 
-typedef ir_node *cons_storeop(dbg_info*, ir_node*, ir_node*, ir_node*, ir_node*, ir_entity*, int32_t);
-
 static ir_node *gen_Store(ir_node *const node)
 {
 	ir_node       *old_val = get_Store_value(node);
 	ir_mode *const mode    = get_irn_mode(old_val);
-	if (be_mode_needs_gp_reg(mode)) {
-		cons_storeop  *cons;
-		unsigned const size = get_mode_size_bits(mode);
-		if (size == 8) {
-			cons = &new_bd_riscv_sb;
-		} else if (size == 16) {
-			cons = &new_bd_riscv_sh;
-		} else if (size == 32) {
-			cons = &new_bd_riscv_sw;
-		} else {
-			panic("invalid store");
-		}
-		old_val = be_skip_downconv(old_val, false);
+	if (be_mode_needs_gp_reg(mode) || mode_needs_fp_reg(mode)) {
+		cons_storeop *const cons = get_store_cons(mode);
+		if (be_mode_needs_gp_reg(mode))
+			old_val = be_skip_downconv(old_val, false);
 		dbg_info  *const dbgi  = get_irn_dbg_info(node);
 		ir_node   *const block = be_transform_nodes_block(node);
 		ir_node   *const mem   = be_transform_node(get_Store_mem(node));
@@ -1071,7 +1414,9 @@ static ir_node *gen_Sub(ir_node *const node)
 	ir_node *const l    = get_Sub_left(node);
 	ir_node *const r    = get_Sub_right(node);
 	ir_mode *const mode = get_irn_mode(node);
-	if (be_mode_needs_gp_reg(mode)) {
+	if (mode_needs_fp_reg(mode)) {
+		return gen_fp_binop(node, l, r, &new_bd_riscv_fsub);
+	} else if (be_mode_needs_gp_reg(mode)) {
 		dbg_info *const dbgi  = get_irn_dbg_info(node);
 		ir_node  *const block = be_transform_nodes_block(node);
 		ir_node  *const new_l = be_transform_node(l);
@@ -1090,16 +1435,18 @@ static ir_node *gen_Switch(ir_node *const node)
 	ident     *const id     = id_unique("TBL");
 	ir_entity *const entity = new_global_entity(irp->dummy_owner, id, utype, ir_visibility_private, IR_LINKAGE_CONSTANT | IR_LINKAGE_NO_IDENTITY);
 
-	dbg_info  *const dbgi   = get_irn_dbg_info(node);
-	ir_node   *const block  = be_transform_nodes_block(node);
-	ir_node   *const nomem  = get_irg_no_mem(irg);
-	ir_node   *const sel    = be_transform_node(get_Switch_selector(node));
-	ir_node   *const sll    = new_bd_riscv_slli(dbgi, block, sel, NULL, 2);
-	ir_node   *const lui    = new_bd_riscv_lui(dbgi, block, entity, 0);
-	ir_node   *const add    = new_bd_riscv_add(dbgi, block, sll, lui);
-	ir_node   *const load   = new_bd_riscv_lw(dbgi, block, nomem, add, entity, 0);
-	ir_node   *const res    = be_new_Proj(load, pn_riscv_lw_res);
-	unsigned   const n_outs = get_Switch_n_outs(node);
+	dbg_info    *const dbgi   = get_irn_dbg_info(node);
+	ir_node     *const block  = be_transform_nodes_block(node);
+	ir_node     *const nomem  = get_irg_no_mem(irg);
+	ir_node     *const sel    = be_transform_node(get_Switch_selector(node));
+	int32_t      const shift  = log2_floor(get_mode_size_bytes(mode_P));
+	ir_node     *const sll    = new_bd_riscv_slli(dbgi, block, sel, NULL, shift);
+	ir_node     *const lui    = new_bd_riscv_lui(dbgi, block, entity, 0);
+	ir_node     *const add    = new_bd_riscv_add(dbgi, block, sll, lui);
+	cons_loadop *const cons   = get_load_cons(mode_P);
+	ir_node     *const load   = cons(dbgi, block, nomem, add, entity, 0);
+	ir_node     *const res    = be_new_Proj(load, pn_riscv_lw_res);
+	unsigned     const n_outs = get_Switch_n_outs(node);
 	return new_bd_riscv_switch(dbgi, block, res, n_outs, table, entity);
 }
 
@@ -1109,6 +1456,8 @@ static ir_node *gen_Unknown(ir_node *const node)
 	ir_mode *const mode  = get_irn_mode(node);
 	if (be_mode_needs_gp_reg(mode)) {
 		return be_new_Unknown(block, &riscv_class_reg_req_gp);
+	} else if (mode_needs_fp_reg(mode)) {
+		return be_new_Unknown(block, &riscv_class_reg_req_fp);
 	} else {
 		TODO(node);
 	}
@@ -1122,6 +1471,7 @@ static void riscv_register_transformers(void)
 	be_set_transform_function(op_Add,     gen_Add);
 	be_set_transform_function(op_Address, gen_Address);
 	be_set_transform_function(op_And,     gen_And);
+	be_set_transform_function(op_Bitcast, gen_Bitcast);
 	be_set_transform_function(op_Builtin, gen_Builtin);
 	be_set_transform_function(op_Call,    gen_Call);
 	be_set_transform_function(op_Cmp,     gen_Cmp);
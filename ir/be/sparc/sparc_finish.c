@@ -578,7 +578,7 @@ void sparc_finish_graph(ir_graph *irg)
 	be_free_frame_entity_coalescer(fec_env);
 
 	ir_type *const frame = get_irg_frame_type(irg);
-	be_sort_frame_entities(frame, omit_fp);
+	be_sort_frame_entities(irg, omit_fp, sparc_get_frame_entity);
 	unsigned const misalign = 0;
 	be_layout_frame_type(frame, 0, misalign);
 
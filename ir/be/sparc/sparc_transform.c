@@ -1971,6 +1971,7 @@ static ir_node *gen_Builtin(ir_node *node)
 	case ir_bk_frame_address:
 	case ir_bk_outport:
 	case ir_bk_inport:
+	case ir_bk_cycle_counter:
 		/* not supported */
 		break;
 	case ir_bk_compare_swap:
@@ -1981,6 +1982,15 @@ static ir_node *gen_Builtin(ir_node *node)
 		return gen_va_start(node);
 	case ir_bk_may_alias:
 	case ir_bk_va_arg:
+	case ir_bk_sqrt:
+	case ir_bk_fabs:
+	case ir_bk_floor:
+	case ir_bk_ceil:
+	case ir_bk_trunc:
+	case ir_bk_round:
+	case ir_bk_fmin:
+	case ir_bk_fmax:
+	case ir_bk_copysign:
 		break;
 	}
 	panic("Builtin %s not implemented", get_builtin_kind_name(kind));
@@ -2010,6 +2020,7 @@ static ir_node *gen_Proj_Builtin(ir_node *proj)
 	case ir_bk_prefetch:
 	case ir_bk_outport:
 	case ir_bk_inport:
+	case ir_bk_cycle_counter:
 		/* not supported / should be lowered */
 		break;
 	case ir_bk_saturating_increment:
@@ -2031,6 +2042,15 @@ static ir_node *gen_Proj_Builtin(ir_node *proj)
 		}
 	case ir_bk_may_alias:
 	case ir_bk_va_arg:
+	case ir_bk_sqrt:
+	case ir_bk_fabs:
+	case ir_bk_floor:
+	case ir_bk_ceil:
+	case ir_bk_trunc:
+	case ir_bk_round:
+	case ir_bk_fmin:
+	case ir_bk_fmax:
+	case ir_bk_copysign:
 		break;
 	}
 	panic("Builtin %s not implemented", get_builtin_kind_name(kind));
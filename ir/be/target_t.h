@@ -23,6 +23,8 @@ typedef struct target_info_t {
 	ir_mode               *mode_float_arithmetic;
 	bool isa_initialized          : 1;
 	bool fast_unaligned_memaccess : 1;
+	/** Target supports the ir_bk_cycle_counter builtin. */
+	bool cycle_counter            : 1;
 	ENUMBF(float_int_conversion_overflow_style_t) float_int_overflow : 2;
 } target_info_t;
 
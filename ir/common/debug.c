@@ -16,6 +16,7 @@
 
 #include "irprintf.h"
 #include "debug.h"
+#include "firm_lock.h"
 
 #include "hashptr.h"
 #include "obst.h"
@@ -61,10 +62,13 @@ firm_dbg_module_t *firm_dbg_register(const char *name)
   mod.name = name;
   mod.file = stderr;
 
+  firm_lock_globals();
   if (!module_set)
     firm_dbg_init();
 
-  return set_insert(firm_dbg_module_t, module_set, &mod, sizeof(mod), hash_str(name));
+  firm_dbg_module_t *const res = set_insert(firm_dbg_module_t, module_set, &mod, sizeof(mod), hash_str(name));
+  firm_unlock_globals();
+  return res;
 }
 
 void firm_dbg_set_mask(firm_dbg_module_t *module, unsigned mask)
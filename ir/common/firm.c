@@ -19,6 +19,7 @@
 #include "entity_t.h"
 #include "execfreq_t.h"
 #include "firm.h"
+#include "firm_lock.h"
 #include "ident_t.h"
 #include "ircons_t.h"
 #include "iredges_t.h"
@@ -56,6 +57,7 @@ void ir_init_library(void)
 		panic("Double initialization");
 	initialized = true;
 
+	firm_init_lock();
 	firm_init_flags();
 	init_ident();
 	init_edges();
@@ -74,6 +76,24 @@ void ir_init_library(void)
 	init_irprog_2();
 	firm_init_memory_disambiguator();
 	firm_init_loop_opt();
+	firm_init_boolopt();
+	firm_init_cfopt();
+	firm_init_combo();
+	firm_init_confirm();
+	firm_init_constbits();
+	firm_init_convopt();
+	firm_init_dca();
+	firm_init_gvn_pre();
+	firm_init_ifconv();
+	firm_init_jumpthreading();
+	firm_init_lcssa();
+	firm_init_ldstopt();
+	firm_init_loop_unrolling();
+	firm_init_occult_consts();
+	firm_init_opt_blocks();
+	firm_init_opt_ldst();
+	firm_init_tailrec();
+	firm_init_vrp();
 
 	init_execfreq();
 	firm_be_init();
@@ -97,6 +117,7 @@ void ir_finish(void)
 	finish_mode();
 	finish_ident();
 	finish_target();
+	firm_finish_lock();
 	initialized = false;
 }
 
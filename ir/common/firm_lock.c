@@ -0,0 +1,56 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Lock protecting the global tables of libFirm.
+ */
+#include "firm_lock.h"
+
+#include "compiler.h"
+#include "firm_thread.h"
+
+#include <assert.h>
+
+bool firm_parallel;
+
+static firm_mutex_t globals_mutex;
+/** number of nested firm_lock_globals() calls of the current thread */
+static THREAD_LOCAL unsigned lock_depth;
+
+void firm_init_lock(void)
+{
+	firm_mutex_init(&globals_mutex);
+}
+
+void firm_finish_lock(void)
+{
+	firm_mutex_destroy(&globals_mutex);
+}
+
+void firm_lock(void)
+{
+	if (lock_depth++ == 0)
+		firm_mutex_lock(&globals_mutex);
+}
+
+void firm_unlock(void)
+{
+	assert(lock_depth > 0);
+	if (--lock_depth == 0)
+		firm_mutex_unlock(&globals_mutex);
+}
+
+void firm_lock_globals(void)
+{
+	if (firm_parallel)
+		firm_lock();
+}
+
+void firm_unlock_globals(void)
+{
+	if (firm_parallel)
+		firm_unlock();
+}
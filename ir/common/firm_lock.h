@@ -0,0 +1,44 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Lock protecting the global tables of libFirm while graphs are
+ *          optimized on several threads.
+ */
+#ifndef FIRM_COMMON_FIRM_LOCK_H
+#define FIRM_COMMON_FIRM_LOCK_H
+
+#include <stdbool.h>
+
+/**
+ * Set while graphs are optimized on several threads. Only changed while no
+ * other thread runs libFirm code.
+ */
+extern bool firm_parallel;
+
+void firm_init_lock(void);
+
+void firm_finish_lock(void);
+
+/**
+ * Takes the global libFirm lock. The lock may be taken recursively by the
+ * same thread. It is also the lock handed out by be_jit_lock().
+ */
+void firm_lock(void);
+
+void firm_unlock(void);
+
+/**
+ * Locks the tables shared by all graphs: idents, tarvals, modes, the type
+ * list and the members of compound types, as well as the program wide
+ * resources reserved by irp_reserve_resources(). Takes the global lock only
+ * if firm_parallel is set.
+ */
+void firm_lock_globals(void);
+
+void firm_unlock_globals(void);
+
+#endif
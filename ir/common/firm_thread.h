@@ -0,0 +1,166 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Minimal portable threads, mutexes and condition variables.
+ */
+#ifndef FIRM_COMMON_FIRM_THREAD_H
+#define FIRM_COMMON_FIRM_THREAD_H
+
+#include <stdbool.h>
+
+#include "xmalloc.h"
+
+typedef void *(*firm_thread_func)(void *arg);
+
+#ifdef _WIN32
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+typedef HANDLE             firm_thread_t;
+typedef CRITICAL_SECTION   firm_mutex_t;
+typedef CONDITION_VARIABLE firm_cond_t;
+
+typedef struct firm_thread_start_t {
+	firm_thread_func func;
+	void            *arg;
+} firm_thread_start_t;
+
+static inline DWORD WINAPI firm_thread_start(LPVOID const data)
+{
+	firm_thread_start_t const start = *(firm_thread_start_t*)data;
+	free(data);
+	start.func(start.arg);
+	return 0;
+}
+
+static inline bool firm_thread_create(firm_thread_t *const thread,
+                                      firm_thread_func const func,
+                                      void *const arg)
+{
+	firm_thread_start_t *const start = XMALLOC(firm_thread_start_t);
+	start->func = func;
+	start->arg  = arg;
+	*thread = CreateThread(NULL, 0, firm_thread_start, start, 0, NULL);
+	if (*thread == NULL) {
+		free(start);
+		return false;
+	}
+	return true;
+}
+
+static inline void firm_thread_join(firm_thread_t const thread)
+{
+	WaitForSingleObject(thread, INFINITE);
+	CloseHandle(thread);
+}
+
+static inline void firm_mutex_init(firm_mutex_t *const mutex)
+{
+	InitializeCriticalSection(mutex);
+}
+
+static inline void firm_mutex_destroy(firm_mutex_t *const mutex)
+{
+	DeleteCriticalSection(mutex);
+}
+
+static inline void firm_mutex_lock(firm_mutex_t *const mutex)
+{
+	EnterCriticalSection(mutex);
+}
+
+static inline void firm_mutex_unlock(firm_mutex_t *const mutex)
+{
+	LeaveCriticalSection(mutex);
+}
+
+static inline void firm_cond_init(firm_cond_t *const cond)
+{
+	InitializeConditionVariable(cond);
+}
+
+static inline void firm_cond_destroy(firm_cond_t *const cond)
+{
+	(void)cond;
+}
+
+static inline void firm_cond_wait(firm_cond_t *const cond,
+                                  firm_mutex_t *const mutex)
+{
+	SleepConditionVariableCS(cond, mutex, INFINITE);
+}
+
+static inline void firm_cond_broadcast(firm_cond_t *const cond)
+{
+	WakeAllConditionVariable(cond);
+}
+
+#else
+
+#include <pthread.h>
+
+typedef pthread_t       firm_thread_t;
+typedef pthread_mutex_t firm_mutex_t;
+typedef pthread_cond_t  firm_cond_t;
+
+static inline bool firm_thread_create(firm_thread_t *const thread,
+                                      firm_thread_func const func,
+                                      void *const arg)
+{
+	return pthread_create(thread, NULL, func, arg) == 0;
+}
+
+static inline void firm_thread_join(firm_thread_t const thread)
+{
+	pthread_join(thread, NULL);
+}
+
+static inline void firm_mutex_init(firm_mutex_t *const mutex)
+{
+	pthread_mutex_init(mutex, NULL);
+}
+
+static inline void firm_mutex_destroy(firm_mutex_t *const mutex)
+{
+	pthread_mutex_destroy(mutex);
+}
+
+static inline void firm_mutex_lock(firm_mutex_t *const mutex)
+{
+	pthread_mutex_lock(mutex);
+}
+
+static inline void firm_mutex_unlock(firm_mutex_t *const mutex)
+{
+	pthread_mutex_unlock(mutex);
+}
+
+static inline void firm_cond_init(firm_cond_t *const cond)
+{
+	pthread_cond_init(cond, NULL);
+}
+
+static inline void firm_cond_destroy(firm_cond_t *const cond)
+{
+	pthread_cond_destroy(cond);
+}
+
+static inline void firm_cond_wait(firm_cond_t *const cond,
+                                  firm_mutex_t *const mutex)
+{
+	pthread_cond_wait(cond, mutex);
+}
+
+static inline void firm_cond_broadcast(firm_cond_t *const cond)
+{
+	pthread_cond_broadcast(cond);
+}
+
+#endif
+
+#endif
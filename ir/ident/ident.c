@@ -10,6 +10,7 @@
  */
 #include "ident_t.h"
 
+#include "firm_lock.h"
 #include "hashptr.h"
 #include "obst.h"
 #include "set.h"
@@ -31,7 +32,9 @@ void init_ident(void)
 ident *new_id_from_chars(const char *str, size_t len)
 {
 	unsigned   hash   = hash_data((const unsigned char*)str, len);
+	firm_lock_globals();
 	set_entry *result = set_hinsert0(id_set, str, len, hash);
+	firm_unlock_globals();
 	return (ident*)result->dptr;
 }
 
@@ -53,9 +56,12 @@ ident *new_id_fmt(char const *const fmt, ...)
 {
 	va_list ap;
 	va_start(ap, fmt);
+	firm_lock_globals();
 	obstack_vprintf(&id_obst, fmt, ap);
+	ident *const res = new_ident_from_obst(&id_obst);
+	firm_unlock_globals();
 	va_end(ap);
-	return new_ident_from_obst(&id_obst);
+	return res;
 }
 
 const char *(get_id_str)(ident *id)
@@ -73,5 +79,8 @@ void finish_ident(void)
 ident *id_unique(const char *tag)
 {
 	static unsigned unique_id = 0;
-	return new_id_fmt("%s.%u", tag, unique_id++);
+	firm_lock_globals();
+	ident *const res = new_id_fmt("%s.%u", tag, unique_id++);
+	firm_unlock_globals();
+	return res;
 }
@@ -2192,8 +2192,24 @@ void dump_ir_graph(ir_graph *graph, const char *suffix)
 {
 	char buf[256];
 
-	snprintf(buf, sizeof(buf), "%s.vcg", suffix);
-	dump_ir_graph_ext(dump_ir_graph_file, graph, buf);
+	switch (ir_get_dump_format()) {
+	case ir_dump_format_vcg:
+		snprintf(buf, sizeof(buf), "%s.vcg", suffix);
+		dump_ir_graph_ext(dump_ir_graph_file, graph, buf);
+		return;
+	case ir_dump_format_stream:
+	case ir_dump_format_stream_zstd: {
+		char const *ext = ".firmdump";
+#ifdef HAVE_ZSTD
+		if (ir_get_dump_format() == ir_dump_format_stream_zstd)
+			ext = ".firmdump.zst";
+#endif
+		snprintf(buf, sizeof(buf), "%s%s", suffix, ext);
+		dump_ir_graph_ext(dump_ir_graph_stream, graph, buf);
+		return;
+	}
+	}
+	panic("invalid dump format");
 }
 
 void dump_all_ir_graphs(const char *suffix)
@@ -0,0 +1,308 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2012 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Write a compact streaming representation of firm graphs.
+ *
+ * The format consists of one JSON object per line. Strings are interned:
+ * A string record {"s":<id>,"v":"<string>"} precedes the first record
+ * referencing string <id>. Nodes are written in post order, so the
+ * predecessors of a node (except for backedges) are known before the node
+ * itself. support/firmdump.py converts dumps to vcg or dot.
+ */
+#include "dbginfo.h"
+#include "execfreq.h"
+#include "hashptr.h"
+#include "irdump_t.h"
+#include "irgraph_t.h"
+#include "irgwalk.h"
+#include "irnode_t.h"
+#include "irprintf.h"
+#include "irprog_t.h"
+#include "pmap.h"
+#include "set.h"
+#include "util.h"
+#include "xmalloc.h"
+#include <stdarg.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#define STREAM_DUMP_VERSION 1
+#define STREAM_BUFFER_SIZE  (64 * 1024)
+/* maximal length of a record without its strings */
+#define STREAM_RECORD_SIZE  256
+
+static ir_dump_format_t     dump_format = ir_dump_format_vcg;
+static dump_node_filter_func dump_node_filter;
+
+void ir_set_dump_format(ir_dump_format_t format)
+{
+	dump_format = format;
+}
+
+ir_dump_format_t ir_get_dump_format(void)
+{
+	return dump_format;
+}
+
+void set_dump_node_filter_hook(dump_node_filter_func hook)
+{
+	dump_node_filter = hook;
+}
+
+dump_node_filter_func get_dump_node_filter_hook(void)
+{
+	return dump_node_filter;
+}
+
+typedef struct stream_dumper_t {
+	FILE     *out;
+	set      *strings;    /**< the strings written so far */
+	pmap     *string_ids; /**< maps the strings in strings to their ids */
+	unsigned  n_strings;
+	unsigned  n_nodes;
+	size_t    len;       /**< bytes used in buf */
+#ifdef HAVE_ZSTD
+	ZSTD_CCtx *zstd;     /**< compression context or NULL */
+	char      *zbuf;
+	size_t     zbuf_size;
+#endif
+	char      buf[STREAM_BUFFER_SIZE];
+} stream_dumper_t;
+
+#ifdef HAVE_ZSTD
+static void write_compressed(stream_dumper_t *const d, ZSTD_EndDirective const mode)
+{
+	ZSTD_inBuffer input = { d->buf, d->len, 0 };
+	for (;;) {
+		ZSTD_outBuffer output    = { d->zbuf, d->zbuf_size, 0 };
+		size_t const   remaining = ZSTD_compressStream2(d->zstd, &output, &input, mode);
+		if (ZSTD_isError(remaining)) {
+			fprintf(stderr, "zstd compression failed: %s\n", ZSTD_getErrorName(remaining));
+			return;
+		}
+		fwrite(d->zbuf, 1, output.pos, d->out);
+		if (mode == ZSTD_e_end ? remaining == 0 : input.pos == input.size)
+			return;
+	}
+}
+#endif
+
+static void stream_flush(stream_dumper_t *const d)
+{
+#ifdef HAVE_ZSTD
+	if (d->zstd != NULL) {
+		write_compressed(d, ZSTD_e_continue);
+		d->len = 0;
+		return;
+	}
+#endif
+	fwrite(d->buf, 1, d->len, d->out);
+	d->len = 0;
+}
+
+/** Writes the remaining output and ends the compressed stream. */
+static void stream_finish(stream_dumper_t *const d)
+{
+#ifdef HAVE_ZSTD
+	if (d->zstd != NULL) {
+		write_compressed(d, ZSTD_e_end);
+		ZSTD_freeCCtx(d->zstd);
+		free(d->zbuf);
+		return;
+	}
+#endif
+	stream_flush(d);
+}
+
+/** Ensures that at least @p size bytes are free in the buffer. */
+static void stream_reserve(stream_dumper_t *const d, size_t const size)
+{
+	assert(size <= STREAM_BUFFER_SIZE);
+	if (d->len + size > STREAM_BUFFER_SIZE)
+		stream_flush(d);
+}
+
+static void stream_char(stream_dumper_t *const d, char const c)
+{
+	stream_reserve(d, 1);
+	d->buf[d->len++] = c;
+}
+
+static void stream_printf(stream_dumper_t *const d, char const *const fmt, ...)
+{
+	stream_reserve(d, STREAM_RECORD_SIZE);
+	va_list ap;
+	va_start(ap, fmt);
+	int const len = vsnprintf(d->buf + d->len, STREAM_RECORD_SIZE, fmt, ap);
+	va_end(ap);
+	assert(len >= 0 && len < STREAM_RECORD_SIZE);
+	d->len += len;
+}
+
+/** Writes @p str as JSON string literal. */
+static void stream_string(stream_dumper_t *const d, char const *str)
+{
+	stream_char(d, '"');
+	for (; *str != '\0'; ++str) {
+		unsigned char const c = (unsigned char)*str;
+		if (c == '"' || c == '\\') {
+			stream_char(d, '\\');
+			stream_char(d, c);
+		} else if (c < 0x20) {
+			stream_printf(d, "\\u%04x", c);
+		} else {
+			stream_char(d, c);
+		}
+	}
+	stream_char(d, '"');
+}
+
+/**
+ * Returns the id of string @p str, writes a string record before if the
+ * string is used for the first time.
+ */
+static unsigned intern_string(stream_dumper_t *const d, char const *const str)
+{
+	size_t      const len   = strlen(str);
+	unsigned    const hash  = hash_data((unsigned char const*)str, len);
+	set_entry  *const entry = set_hinsert0(d->strings, str, len, hash);
+	char const *const key   = (char const*)entry->dptr;
+	void       *const res   = pmap_get(void, d->string_ids, key);
+	if (res != NULL)
+		return PTR_TO_INT(res) - 1;
+
+	unsigned const nr = d->n_strings++;
+	pmap_insert(d->string_ids, key, INT_TO_PTR(nr + 1));
+	stream_printf(d, "{\"s\":%u,\"v\":", nr);
+	stream_string(d, str);
+	stream_printf(d, "}\n");
+	return nr;
+}
+
+/**
+ * Computes the label attribute of a node, which is dumped in addition to its
+ * opcode and mode. Returns false if the node has none.
+ */
+static bool get_node_attr(char *const buf, size_t const size,
+                          ir_node const *const node)
+{
+	switch (get_irn_opcode(node)) {
+	case iro_Address:
+		ir_snprintf(buf, size, "&%F", get_Address_entity(node));
+		return true;
+	case iro_Offset:
+		ir_snprintf(buf, size, "%F", get_Offset_entity(node));
+		return true;
+	case iro_Member:
+		ir_snprintf(buf, size, "%F", get_Member_entity(node));
+		return true;
+	case iro_Const:
+		ir_snprintf(buf, size, "%T", get_Const_tarval(node));
+		return true;
+	case iro_Proj:
+		snprintf(buf, size, "%u", get_Proj_num(node));
+		return true;
+	case iro_Cmp:
+		snprintf(buf, size, "%s", get_relation_string(get_Cmp_relation(node)));
+		return true;
+	case iro_Builtin:
+		snprintf(buf, size, "%s", get_builtin_kind_name(get_Builtin_kind(node)));
+		return true;
+	case iro_Load:
+		snprintf(buf, size, "%s", get_mode_name(get_Load_mode(node)));
+		return true;
+	case iro_Phi:
+		if (!get_Phi_loop(node))
+			return false;
+		snprintf(buf, size, "loop");
+		return true;
+	case iro_Block: {
+		ir_graph *const irg = get_irn_irg(node);
+		if (node == get_irg_start_block(irg)) {
+			snprintf(buf, size, "start");
+			return true;
+		} else if (node == get_irg_end_block(irg)) {
+			snprintf(buf, size, "end");
+			return true;
+		}
+		return false;
+	}
+	default:
+		return false;
+	}
+}
+
+static void dump_node_stream(ir_node *const node, void *const data)
+{
+	stream_dumper_t *const d = (stream_dumper_t*)data;
+	if (dump_node_filter != NULL && !dump_node_filter(node))
+		return;
+
+	char attr[128];
+	bool const     has_attr = get_node_attr(attr, sizeof(attr), node);
+	unsigned const op       = intern_string(d, get_irn_opname(node));
+	unsigned const mode     = intern_string(d, get_mode_name(get_irn_mode(node)));
+	unsigned const attr_id  = has_attr ? intern_string(d, attr) : 0;
+
+	src_loc_t const loc  = ir_retrieve_dbg_info(get_irn_dbg_info(node));
+	unsigned  const file = loc.file != NULL ? intern_string(d, loc.file) : 0;
+
+	stream_printf(d, "{\"n\":%ld,\"o\":%u,\"m\":%u", get_irn_node_nr(node), op, mode);
+	if (has_attr)
+		stream_printf(d, ",\"a\":%u", attr_id);
+	if (is_Block(node)) {
+		stream_printf(d, ",\"f\":%g", get_block_execfreq(node));
+	} else {
+		stream_printf(d, ",\"b\":%ld", get_irn_node_nr(get_nodes_block(node)));
+	}
+	if (loc.file != NULL)
+		stream_printf(d, ",\"src\":[%u,%u]", file, loc.line);
+
+	stream_printf(d, ",\"i\":[");
+	foreach_irn_in(node, i, pred) {
+		stream_printf(d, i == 0 ? "%ld" : ",%ld", get_irn_node_nr(pred));
+	}
+	stream_printf(d, "]}\n");
+	++d->n_nodes;
+}
+
+void dump_ir_graph_stream(FILE *out, ir_graph *graph)
+{
+	stream_dumper_t *const d = XMALLOCZ(stream_dumper_t);
+	d->out        = out;
+	d->strings    = new_set(memcmp, 64);
+	d->string_ids = pmap_create();
+	if (dump_format == ir_dump_format_stream_zstd) {
+#ifdef HAVE_ZSTD
+		d->zstd      = ZSTD_createCCtx();
+		d->zbuf_size = ZSTD_CStreamOutSize();
+		d->zbuf      = XMALLOCN(char, d->zbuf_size);
+#else
+		static bool warned;
+		if (!warned) {
+			fprintf(stderr, "libFirm was built without zstd, dumping uncompressed\n");
+			warned = true;
+		}
+#endif
+	}
+
+	unsigned const name = intern_string(d, get_irg_dump_name(graph));
+	stream_printf(d, "{\"format\":\"firm-stream\",\"version\":%d,\"graph\":%u}\n",
+	              STREAM_DUMP_VERSION, name);
+
+	irg_walk_graph(graph, NULL, dump_node_stream, d);
+
+	stream_printf(d, "{\"end\":%u}\n", d->n_nodes);
+	stream_finish(d);
+	pmap_destroy(d->string_ids);
+	del_set(d->strings);
+	free(d);
+}
@@ -15,6 +15,7 @@
 #include "iredges_t.h"
 
 #include "bitset.h"
+#include "compiler.h"
 #include "debug.h"
 #include "hashptr.h"
 #include "irdump_t.h"
@@ -632,7 +633,7 @@ int edges_verify_kind(ir_graph *irg, ir_edge_kind_t kind)
 	return w.fine;
 }
 
-static ir_nodemap usermap;
+static THREAD_LOCAL ir_nodemap usermap;
 
 /**
  * Initializes the user node map for each node.
@@ -11,6 +11,7 @@
 #include "irgraph_t.h"
 
 #include "array.h"
+#include "firm_lock.h"
 #include "irbackedge_t.h"
 #include "ircons_t.h"
 #include "iredges_t.h"
@@ -236,6 +237,7 @@ ir_graph *create_irg_copy(ir_graph *irg)
 	ir_graph *res = alloc_graph();
 
 	res->irg_pinned_state = irg->irg_pinned_state;
+	res->constraints      = irg->constraints;
 
 	/* clone the frame type here for safety */
 	irp_reserve_resources(irp, IRP_RESOURCE_ENTITY_LINK);
@@ -460,7 +462,8 @@ static ir_visited_t max_irg_visited = 0;
 void set_irg_visited(ir_graph *irg, ir_visited_t visited)
 {
 	irg->visited = visited;
-	if (irg->visited > max_irg_visited) {
+	/* optimize_graphs_parallel() restores the maximum afterwards. */
+	if (!firm_parallel && irg->visited > max_irg_visited) {
 		max_irg_visited = irg->visited;
 	}
 }
@@ -468,7 +471,7 @@ void set_irg_visited(ir_graph *irg, ir_visited_t visited)
 void inc_irg_visited(ir_graph *irg)
 {
 	++irg->visited;
-	if (irg->visited > max_irg_visited) {
+	if (!firm_parallel && irg->visited > max_irg_visited) {
 		max_irg_visited = irg->visited;
 	}
 }
@@ -612,7 +615,9 @@ void confirm_irg_properties(ir_graph *irg, ir_graph_properties_t props)
 	if (!(props & IR_GRAPH_PROPERTY_CONSISTENT_OUTS)
 	    && (irg->properties & IR_GRAPH_PROPERTY_CONSISTENT_OUTS))
 	    free_irg_outs(irg);
-	if (!(props & IR_GRAPH_PROPERTY_CONSISTENT_ENTITY_USAGE))
+	/* optimize_graphs_parallel() invalidates the usage of global entities
+	 * afterwards. */
+	if (!(props & IR_GRAPH_PROPERTY_CONSISTENT_ENTITY_USAGE) && !firm_parallel)
 		set_irp_globals_entity_usage_state(ir_entity_usage_not_computed);
 	if (!(props & IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE_FRONTIERS))
 		ir_free_dominance_frontiers(irg);
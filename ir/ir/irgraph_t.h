@@ -131,6 +131,8 @@ struct ir_graph {
 	unsigned short   dump_nr;       /**< number of graph dumps */
 
 	unsigned char    mem_disambig_opt;
+	/** Set, if the block execution frequencies were read from a profile. */
+	bool             execfreq_from_profile;
 
 	/** Number of local variables in this function during construction. */
 	int      n_loc;
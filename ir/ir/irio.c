@@ -145,7 +145,7 @@ parse_error(read_env_t *env, const char *fmt, ...)
 	va_end(ap);
 }
 
-COMPILETIME_ASSERT(ir_bk_va_arg == ir_bk_last, complete_builtin_list)
+COMPILETIME_ASSERT(ir_bk_cycle_counter == ir_bk_last, complete_builtin_list)
 
 /** Initializes the symbol table. May be called more than once without problems. */
 static void symtbl_init(void)
@@ -241,6 +241,16 @@ static void symtbl_init(void)
 	INSERTENUM(tt_builtin_kind, ir_bk_may_alias);
 	INSERTENUM(tt_builtin_kind, ir_bk_va_start);
 	INSERTENUM(tt_builtin_kind, ir_bk_va_arg);
+	INSERTENUM(tt_builtin_kind, ir_bk_sqrt);
+	INSERTENUM(tt_builtin_kind, ir_bk_fabs);
+	INSERTENUM(tt_builtin_kind, ir_bk_floor);
+	INSERTENUM(tt_builtin_kind, ir_bk_ceil);
+	INSERTENUM(tt_builtin_kind, ir_bk_trunc);
+	INSERTENUM(tt_builtin_kind, ir_bk_round);
+	INSERTENUM(tt_builtin_kind, ir_bk_fmin);
+	INSERTENUM(tt_builtin_kind, ir_bk_fmax);
+	INSERTENUM(tt_builtin_kind, ir_bk_copysign);
+	INSERTENUM(tt_builtin_kind, ir_bk_cycle_counter);
 
 	INSERTENUM(tt_cond_jmp_predicate, COND_JMP_PRED_NONE);
 	INSERTENUM(tt_cond_jmp_predicate, COND_JMP_PRED_TRUE);
@@ -11,6 +11,7 @@
 #include "irmode_t.h"
 
 #include "array.h"
+#include "firm_lock.h"
 #include "ident.h"
 #include "irhooks.h"
 #include "irprog_t.h"
@@ -21,6 +22,7 @@
 #include "util.h"
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 
 /** Obstack to hold all modes. */
 static struct obstack modes;
@@ -48,12 +50,17 @@ static bool modes_are_equal(const ir_mode *m, const ir_mode *n)
  */
 static ir_mode *find_mode(const ir_mode *m)
 {
+	ir_mode *res = NULL;
+	firm_lock_globals();
 	for (size_t i = 0, n_modes = ARR_LEN(mode_list); i < n_modes; ++i) {
 		ir_mode *n = mode_list[i];
-		if (modes_are_equal(n, m))
-			return n;
+		if (modes_are_equal(n, m)) {
+			res = n;
+			break;
+		}
 	}
-	return NULL;
+	firm_unlock_globals();
+	return res;
 }
 
 ir_mode *mode_T;
@@ -104,38 +111,39 @@ void set_modeP(ir_mode *p)
 }
 
 /*
- * Creates a new mode.
+ * Creates a template for a new mode.
  */
-static ir_mode *alloc_mode(const char *name, ir_mode_sort sort,
-                           ir_mode_arithmetic arithmetic, unsigned bit_size,
-                           int sign, unsigned modulo_shift)
-{
-	ir_mode *mode_tmpl = OALLOCZ(&modes, ir_mode);
-
-	mode_tmpl->name         = new_id_from_str(name);
-	mode_tmpl->sort         = sort;
-	mode_tmpl->size         = bit_size;
-	mode_tmpl->sign         = sign ? 1 : 0;
-	mode_tmpl->modulo_shift = modulo_shift;
-	mode_tmpl->arithmetic   = arithmetic;
+static ir_mode new_mode_template(const char *name, ir_mode_sort sort,
+                                 ir_mode_arithmetic arithmetic,
+                                 unsigned bit_size, int sign,
+                                 unsigned modulo_shift)
+{
+	ir_mode mode_tmpl;
+	memset(&mode_tmpl, 0, sizeof(mode_tmpl));
+	mode_tmpl.name         = new_id_from_str(name);
+	mode_tmpl.sort         = sort;
+	mode_tmpl.size         = bit_size;
+	mode_tmpl.sign         = sign ? 1 : 0;
+	mode_tmpl.modulo_shift = modulo_shift;
+	mode_tmpl.arithmetic   = arithmetic;
 	return mode_tmpl;
 }
 
-static ir_mode *register_mode(ir_mode *mode)
+static ir_mode *register_mode(ir_mode const *const mode_tmpl)
 {
+	firm_lock_globals();
 	/* does any of the existing modes have the same properties? */
-	ir_mode *old = find_mode(mode);
-	if (old != NULL) {
-		/* remove new mode from obstack */
-		obstack_free(&modes, mode);
-		return old;
+	ir_mode *mode = find_mode(mode_tmpl);
+	if (mode == NULL) {
+		mode  = OALLOC(&modes, ir_mode);
+		*mode = *mode_tmpl;
+		mode->kind = k_ir_mode;
+		mode->type = new_type_primitive(mode);
+		ARR_APP1(ir_mode*, mode_list, mode);
+		init_mode_values(mode);
+		hook_new_mode(mode);
 	}
-
-	mode->kind = k_ir_mode;
-	mode->type = new_type_primitive(mode);
-	ARR_APP1(ir_mode*, mode_list, mode);
-	init_mode_values(mode);
-	hook_new_mode(mode);
+	firm_unlock_globals();
 	return mode;
 }
 
@@ -145,9 +153,10 @@ ir_mode *new_int_mode(const char *name, unsigned bit_size, int sign,
 	if (bit_size >= (unsigned)sc_get_precision())
 		panic("cannot create mode: more bits than tarval module maximum");
 
-	ir_mode *result = alloc_mode(name, irms_int_number, irma_twos_complement,
-	                             bit_size, sign, modulo_shift);
-	return register_mode(result);
+	ir_mode const result = new_mode_template(name, irms_int_number,
+	                                         irma_twos_complement, bit_size,
+	                                         sign, modulo_shift);
+	return register_mode(&result);
 }
 
 ir_mode *new_reference_mode(const char *name, unsigned bit_size,
@@ -156,9 +165,11 @@ ir_mode *new_reference_mode(const char *name, unsigned bit_size,
 	if (bit_size >= (unsigned)sc_get_precision())
 		panic("cannot create mode: more bits than tarval module maximum");
 
-	ir_mode *result = alloc_mode(name, irms_reference, irma_twos_complement,
-	                             bit_size, 0, modulo_shift);
-	ir_mode *res = register_mode(result);
+	ir_mode const result = new_mode_template(name, irms_reference,
+	                                         irma_twos_complement, bit_size, 0,
+	                                         modulo_shift);
+	firm_lock_globals();
+	ir_mode *res = register_mode(&result);
 
 	/* Construct offset mode if none is set yet. */
 	if (res->offset_mode == NULL) {
@@ -167,6 +178,7 @@ ir_mode *new_reference_mode(const char *name, unsigned bit_size,
 		ir_mode *offset_mode = new_int_mode(buf, bit_size, 1, modulo_shift);
 		res->offset_mode = offset_mode;
 	}
+	firm_unlock_globals();
 	return res;
 }
 
@@ -191,25 +203,27 @@ ir_mode *new_float_mode(const char *name, ir_mode_arithmetic arithmetic,
 	if (mantissa_size >= (unsigned)sc_get_precision())
 		panic("cannot create mode: more bits than tarval module maximum");
 
-	ir_mode *result
-		= alloc_mode(name, irms_float_number, arithmetic, bit_size, 1, 0);
-	result->int_conv_overflow        = conv_overflow;
-	result->float_desc.exponent_size = exponent_size;
-	result->float_desc.mantissa_size = mantissa_size;
-	result->float_desc.explicit_one  = explicit_one;
-	return register_mode(result);
+	ir_mode result
+		= new_mode_template(name, irms_float_number, arithmetic, bit_size, 1, 0);
+	result.int_conv_overflow        = conv_overflow;
+	result.float_desc.exponent_size = exponent_size;
+	result.float_desc.mantissa_size = mantissa_size;
+	result.float_desc.explicit_one  = explicit_one;
+	return register_mode(&result);
 }
 
 ir_mode *new_non_arithmetic_mode(const char *name, unsigned bit_size)
 {
-	ir_mode *result = alloc_mode(name, irms_data, irma_none, bit_size, 0, 0);
-	return register_mode(result);
+	ir_mode const result
+		= new_mode_template(name, irms_data, irma_none, bit_size, 0, 0);
+	return register_mode(&result);
 }
 
 static ir_mode *new_non_data_mode(const char *name)
 {
-	ir_mode *result = alloc_mode(name, irms_auxiliary, irma_none, 0, 0, 0);
-	return register_mode(result);
+	ir_mode const result
+		= new_mode_template(name, irms_auxiliary, irma_none, 0, 0, 0);
+	return register_mode(&result);
 }
 
 ident *(get_mode_ident)(const ir_mode *mode)
@@ -442,8 +456,9 @@ void init_mode(void)
 	mode_T   = new_non_data_mode("T");
 	mode_ANY = new_non_data_mode("ANY");
 	mode_BAD = new_non_data_mode("BAD");
-	mode_b   = alloc_mode("b", irms_internal_boolean, irma_none, 1, 0, 0);
-	mode_b   = register_mode(mode_b);
+	ir_mode const b_tmpl
+		= new_mode_template("b", irms_internal_boolean, irma_none, 1, 0, 0);
+	mode_b   = register_mode(&b_tmpl);
 
 	mode_F   = new_float_mode("F", irma_ieee754,  8, 23, ir_overflow_min_max);
 	mode_D   = new_float_mode("D", irma_ieee754, 11, 52, ir_overflow_min_max);
@@ -582,6 +582,16 @@ const char *get_builtin_kind_name(ir_builtin_kind kind)
 		X(ir_bk_may_alias);
 		X(ir_bk_va_start);
 		X(ir_bk_va_arg);
+		X(ir_bk_sqrt);
+		X(ir_bk_fabs);
+		X(ir_bk_floor);
+		X(ir_bk_ceil);
+		X(ir_bk_trunc);
+		X(ir_bk_round);
+		X(ir_bk_fmin);
+		X(ir_bk_fmax);
+		X(ir_bk_copysign);
+		X(ir_bk_cycle_counter);
 	}
 	return "<unknown>";
 #undef X
@@ -840,6 +850,7 @@ int is_irn_const_memory(const ir_node *node)
 		case ir_bk_trap:
 		case ir_bk_debugbreak:
 		case ir_bk_compare_swap:
+		case ir_bk_cycle_counter:
 		case ir_bk_va_start:
 		case ir_bk_va_arg:
 			return false;
@@ -856,6 +867,15 @@ int is_irn_const_memory(const ir_node *node)
 		case ir_bk_outport:
 		case ir_bk_saturating_increment:
 		case ir_bk_may_alias:
+		case ir_bk_sqrt:
+		case ir_bk_fabs:
+		case ir_bk_floor:
+		case ir_bk_ceil:
+		case ir_bk_trunc:
+		case ir_bk_round:
+		case ir_bk_fmin:
+		case ir_bk_fmax:
+		case ir_bk_copysign:
 			return true;
 		}
 		panic("invalid Builtin %+F", node);
@@ -11,16 +11,23 @@
  */
 #include "irprofile.h"
 
+#include "array.h"
+#include "dbginfo.h"
 #include "debug.h"
 #include "execfreq_t.h"
 #include "hashptr.h"
 #include "ident_t.h"
 #include "ircons_t.h"
 #include "irdump_t.h"
+#include "iredges_t.h"
 #include "irgwalk.h"
+#include "irloop.h"
 #include "irnode_t.h"
+#include "irprintf.h"
 #include "irprog_t.h"
+#include "irtools.h"
 #include "obst.h"
+#include "pmap.h"
 #include "set.h"
 #include "typerep.h"
 #include "util.h"
@@ -168,14 +175,14 @@ static ir_entity *get_init_firmprof_ref(void)
  * Generates a new irg which calls the initializer
  *
  * Pseudocode:
- *    static void __firmprof_initializer(void) __attribute__ ((constructor))
+ *    static void <name>(void) __attribute__ ((constructor))
  *    {
  *        __init_firmprof(ent_filename, bblock_counts, n_blocks);
  *    }
  */
-static ir_graph *gen_initializer_irg(ir_entity *ent_filename, ir_entity *bblock_counts, int n_blocks)
+static ir_graph *gen_initializer_irg(char const *const init_name, ir_entity *ent_filename, ir_entity *bblock_counts, int n_blocks)
 {
-	ident     *const name  = new_id_from_str("__firmprof_initializer");
+	ident     *const name  = new_id_from_str(init_name);
 	ir_type   *const owner = get_glob_type();
 	ir_type   *const type  = new_type_method(0, 0, false, cc_cdecl_set, mtp_no_property);
 	ir_entity *const ent   = new_global_entity(owner, name, type, ir_visibility_local, IR_LINKAGE_DEFAULT);
@@ -284,32 +291,32 @@ static void block_instrument_walker(ir_node *bb, void *data)
 	++wd->id;
 }
 
+/**
+ * Returns the instrumentation memory at the end of a block.
+ */
+typedef ir_node *get_block_mem_func(ir_node *bb);
+
+static ir_node *get_block_link_mem(ir_node *bb)
+{
+	return (ir_node*)get_irn_link(bb);
+}
+
 /**
  * Synchronize the original memory input of node with the additional operand
  * from the profiling code.
  */
-static ir_node *sync_mem(ir_node *bb, ir_node *mem)
+static ir_node *sync_mem(ir_node *bb, ir_node *mem, get_block_mem_func *get_mem)
 {
-	ir_node *const ins[] = { (ir_node*)get_irn_link(bb), mem };
+	ir_node *const ins[] = { get_mem(bb), mem };
 	return new_r_Sync(bb, ARRAY_SIZE(ins), ins);
 }
 
 /**
- * Instrument a single ir_graph, counters should point to the bblock
- * counters array.
+ * Connect the (still dead) instrumentation memory to all nodes leaving the
+ * graph: Return, Raise and noreturn Calls.
  */
-static void instrument_irg(ir_graph *irg, ir_entity *counters, block_id_walker_data_t *wd)
+static void sync_exits(ir_graph *irg, get_block_mem_func *get_mem)
 {
-	/* generate a node pointing to the count array */
-	wd->counters = new_r_Address(irg, counters);
-
-	ir_reserve_resources(irg, IR_RESOURCE_IRN_LINK);
-
-	/* instrument each block in the current irg */
-	irg_block_walk_graph(irg, block_instrument_walker, NULL, wd);
-	irg_block_walk_graph(irg, fix_ssa, NULL, NULL);
-
-	/* connect the new memory nodes to the return nodes */
 	ir_node *const endbb = get_irg_end_block(irg);
 	for (unsigned i = get_Block_n_cfgpreds(endbb); i-- > 0;) {
 		ir_node *const node = skip_Proj(get_Block_cfgpred(endbb, i));
@@ -321,11 +328,11 @@ static void instrument_irg(ir_graph *irg, ir_entity *counters, block_id_walker_d
 		switch (get_irn_opcode(node)) {
 		case iro_Return:
 			mem = get_Return_mem(node);
-			set_Return_mem(node, sync_mem(bb, mem));
+			set_Return_mem(node, sync_mem(bb, mem, get_mem));
 			break;
 		case iro_Raise:
 			mem = get_Raise_mem(node);
-			set_Raise_mem(node, sync_mem(bb, mem));
+			set_Raise_mem(node, sync_mem(bb, mem, get_mem));
 			break;
 		case iro_Bad:
 			break;
@@ -343,9 +350,28 @@ static void instrument_irg(ir_graph *irg, ir_entity *counters, block_id_walker_d
 		if (is_Call(node)) {
 			ir_node *const bb  = get_nodes_block(node);
 			ir_node *const mem = get_Call_mem(node);
-			set_Call_mem(node, sync_mem(bb, mem));
+			set_Call_mem(node, sync_mem(bb, mem, get_mem));
 		}
 	}
+}
+
+/**
+ * Instrument a single ir_graph, counters should point to the bblock
+ * counters array.
+ */
+static void instrument_irg(ir_graph *irg, ir_entity *counters, block_id_walker_data_t *wd)
+{
+	/* generate a node pointing to the count array */
+	wd->counters = new_r_Address(irg, counters);
+
+	ir_reserve_resources(irg, IR_RESOURCE_IRN_LINK);
+
+	/* instrument each block in the current irg */
+	irg_block_walk_graph(irg, block_instrument_walker, NULL, wd);
+	irg_block_walk_graph(irg, fix_ssa, NULL, NULL);
+
+	/* connect the new memory nodes to the return nodes */
+	sync_exits(irg, get_block_link_mem);
 
 	ir_free_resources(irg, IR_RESOURCE_IRN_LINK);
 }
@@ -360,7 +386,10 @@ static ir_entity *new_array_entity(ident *const name, ir_mode *const element_mod
 	ir_type *const array_type   = new_type_array(element_type, length);
 	ident   *const id           = new_id_from_str(name);
 	ir_type *const owner        = get_glob_type();
-	return new_global_entity(owner, id, array_type, ir_visibility_private, linkage);
+	ir_entity *const ent = new_global_entity(owner, id, array_type, ir_visibility_private, linkage);
+	/* zero initialized, so the emitter defines it in the bss section */
+	set_entity_initializer(ent, get_initializer_null());
+	return ent;
 }
 
 /**
@@ -412,7 +441,330 @@ ir_graph *ir_profile_instrument(const char *filename)
 		instrument_irg(irg, bblock_counts, &wd);
 	}
 
-	return gen_initializer_irg(ent_filename, bblock_counts, n_blocks);
+	return gen_initializer_irg("__firmprof_initializer", ent_filename, bblock_counts, n_blocks);
+}
+
+/* Hot path instrumentation walker data. */
+typedef struct hotpath_env_t {
+	unsigned   flags;      /**< the ir_profile_hotpath_flags_t to instrument */
+	unsigned   n_counters; /**< number of counter slots used so far */
+	ir_node   *counters;   /**< the node representing the counter array */
+	ir_type   *cycle_type; /**< method type of the cycle counter builtin */
+	FILE      *map;        /**< receives the counter descriptions */
+	ir_node  **blocks;     /**< blocks containing counter increments */
+	ir_node  **first_load; /**< first Load of the increments per block */
+} hotpath_env_t;
+
+/**
+ * Walker counting the counter slots needed by the loops and calls of a graph.
+ */
+static void count_hotpath_slots(ir_node *node, void *data)
+{
+	hotpath_env_t *const env = (hotpath_env_t*)data;
+	if (is_Block(node)) {
+		if ((env->flags & IR_PROFILE_HOTPATH_LOOPS) && has_backedges(node))
+			env->n_counters += 2;
+	} else if (is_Call(node)) {
+		if (env->flags & IR_PROFILE_HOTPATH_CALLS)
+			++env->n_counters;
+	}
+}
+
+/**
+ * Returns the number of counter slots needed to instrument @p irg.
+ */
+static unsigned get_irg_n_hotpath_slots(ir_graph *irg, unsigned flags)
+{
+	hotpath_env_t env = { .flags = flags, .n_counters = 0 };
+	if (flags & IR_PROFILE_HOTPATH_ENTRY)
+		env.n_counters += 1;
+	if (flags & IR_PROFILE_HOTPATH_CYCLES)
+		env.n_counters += 2;
+	if (flags & IR_PROFILE_HOTPATH_LOOPS)
+		assure_loopinfo(irg);
+	irg_walk_graph(irg, count_hotpath_slots, NULL, &env);
+	return env.n_counters;
+}
+
+/**
+ * Allocates a new counter slot and describes it in the map file.
+ */
+static unsigned new_hotpath_slot(hotpath_env_t *env, ir_graph *irg, char const *kind, char const *detail)
+{
+	unsigned const slot = env->n_counters++;
+	if (env->map != NULL) {
+		ir_fprintf(env->map, "%u %s %s%s%s\n", slot, kind,
+		           get_entity_ld_name(get_irg_entity(irg)),
+		           detail != NULL ? " " : "", detail != NULL ? detail : "");
+	}
+	return slot;
+}
+
+/**
+ * Creates the address of counter slot @p slot.
+ */
+static ir_node *new_counter_address(ir_node *block, ir_node *counters, unsigned slot)
+{
+	ir_graph *const irg      = get_irn_irg(block);
+	ir_mode  *const mode_off = get_reference_offset_mode(get_irn_mode(counters));
+	ir_node  *const cnst     = new_r_Const_long(irg, mode_off, get_mode_size_bytes(mode_Iu) * slot);
+	return new_r_Add(block, counters, cnst);
+}
+
+/**
+ * Loads counter slot @p slot. The memory is threaded through @p mem.
+ */
+static ir_node *load_counter(ir_node *block, ir_node **mem, ir_node *counters, unsigned slot)
+{
+	ir_type *const type_arr = get_entity_type(get_irn_entity_attr(counters));
+	ir_node *const address  = new_counter_address(block, counters, slot);
+	ir_node *const load     = new_r_Load(block, *mem, address, mode_Iu, type_arr, cons_none);
+	*mem = new_r_Proj(load, mode_M, pn_Load_M);
+	return new_r_Proj(load, mode_Iu, pn_Load_res);
+}
+
+/**
+ * Stores @p value into counter slot @p slot. The memory is threaded through
+ * @p mem.
+ */
+static void store_counter(ir_node *block, ir_node **mem, ir_node *counters, unsigned slot, ir_node *value)
+{
+	ir_type *const type_arr = get_entity_type(get_irn_entity_attr(counters));
+	ir_node *const address  = new_counter_address(block, counters, slot);
+	ir_node *const store    = new_r_Store(block, *mem, address, value, type_arr, cons_none);
+	*mem = new_r_Proj(store, mode_M, pn_Store_M);
+}
+
+/**
+ * Appends an increment of counter slot @p slot to the instrumentation
+ * memory chain of @p block. The chain is connected to the rest of the
+ * instrumentation memory later by connect_hotpath_mem().
+ */
+static void add_counter_increment(hotpath_env_t *env, ir_node *block, unsigned slot)
+{
+	ir_graph *const irg   = get_irn_irg(block);
+	ir_node  *const last  = (ir_node*)get_irn_link(block);
+	ir_node        *mem   = last != NULL ? last : new_r_Unknown(irg, mode_M);
+	ir_node  *const value = load_counter(block, &mem, env->counters, slot);
+	if (last == NULL) {
+		/* the memory input of the first Load is fixed later */
+		ARR_APP1(ir_node*, env->blocks, block);
+		ARR_APP1(ir_node*, env->first_load, get_Proj_pred(mem));
+	}
+	ir_node *const one = new_r_Const_one(irg, mode_Iu);
+	ir_node *const add = new_r_Add(block, value, one);
+	store_counter(block, &mem, env->counters, slot, add);
+	set_irn_link(block, mem);
+}
+
+/**
+ * Walker placing the loop and call site counters.
+ */
+static void place_hotpath_counters(ir_node *node, void *data)
+{
+	hotpath_env_t *const env = (hotpath_env_t*)data;
+	ir_graph      *const irg = get_irn_irg(node);
+	if (is_Block(node)) {
+		if (!(env->flags & IR_PROFILE_HOTPATH_LOOPS) || !has_backedges(node))
+			return;
+
+		char buf[32];
+		snprintf(buf, sizeof(buf), "%ld", get_irn_node_nr(node));
+		unsigned const entries    = new_hotpath_slot(env, irg, "loop_entries", buf);
+		unsigned const iterations = new_hotpath_slot(env, irg, "loop_iterations", buf);
+		add_counter_increment(env, node, iterations);
+		/* Critical edges are split, so each predecessor of the loop header
+		 * has the header as its only successor. */
+		for (int i = get_Block_n_cfgpreds(node); i-- > 0;) {
+			ir_node *const pred = get_Block_cfgpred_block(node, i);
+			if (pred != NULL && !is_backedge(node, i))
+				add_counter_increment(env, pred, entries);
+		}
+	} else if (is_Call(node)) {
+		if (!(env->flags & IR_PROFILE_HOTPATH_CALLS))
+			return;
+
+		ir_entity  *const callee = get_Call_callee(node);
+		char const *const name   = callee != NULL ? get_entity_ld_name(callee) : "<indirect>";
+		unsigned    const slot   = new_hotpath_slot(env, irg, "call", name);
+		add_counter_increment(env, get_nodes_block(node), slot);
+	}
+}
+
+static ir_node *get_block_store(ir_node *bb)
+{
+	ir_graph *const irg = get_irn_irg(bb);
+	set_r_cur_block(irg, bb);
+	return get_r_store(irg);
+}
+
+/**
+ * Computes the instrumentation memory at the entry of @p bb.
+ */
+static ir_node *get_block_entry_mem(ir_node *bb)
+{
+	ir_graph *const irg = get_irn_irg(bb);
+	if (bb == get_irg_start_block(irg))
+		return get_irg_initial_mem(irg);
+
+	int       const arity = get_Block_n_cfgpreds(bb);
+	ir_node **const ins   = ALLOCAN(ir_node*, arity);
+	for (int i = arity; i-- > 0;) {
+		ir_node *const pred = get_Block_cfgpred_block(bb, i);
+		ins[i] = pred != NULL ? get_block_store(pred) : new_r_NoMem(irg);
+	}
+	if (arity == 1)
+		return ins[0];
+	return new_r_Phi(bb, arity, ins, mode_M);
+}
+
+/**
+ * SSA construction for the instrumentation memory: Connects the increment
+ * chains of all blocks and synchronizes the result with the exits.
+ */
+static void connect_hotpath_mem(hotpath_env_t *env, ir_graph *irg)
+{
+	/* the construction does not maintain out edges when removing Phis */
+	edges_deactivate(irg);
+	ssa_cons_start(irg, 0);
+
+	/* first define the memory at the end of all instrumented blocks, so that
+	 * the later queries see them */
+	ir_node *const start_block = get_irg_start_block(irg);
+	set_r_cur_block(irg, start_block);
+	set_r_store(irg, get_irg_initial_mem(irg));
+	for (size_t i = 0, n = ARR_LEN(env->blocks); i < n; ++i) {
+		ir_node *const bb = env->blocks[i];
+		set_r_cur_block(irg, bb);
+		set_r_store(irg, (ir_node*)get_irn_link(bb));
+	}
+
+	for (size_t i = 0, n = ARR_LEN(env->blocks); i < n; ++i) {
+		ir_node *const bb  = env->blocks[i];
+		ir_node *const mem = get_block_entry_mem(bb);
+		set_Load_mem(env->first_load[i], mem);
+	}
+
+	sync_exits(irg, get_block_store);
+
+	ssa_cons_finish(irg);
+}
+
+/**
+ * Sums up the cycles between the start of @p irg and each of its Returns in
+ * a 64bit value stored in the two counter slots starting at @p slot.
+ * The cycle counter reads are ordered with the regular memory of the graph.
+ */
+static void instrument_cycles(hotpath_env_t *env, ir_graph *irg, unsigned slot)
+{
+	ir_node *const start_block = get_irg_start_block(irg);
+	ir_node *const initial_mem = get_irg_initial_mem(irg);
+	ir_node *const start_read  = new_r_Builtin(start_block, initial_mem, 0, NULL, ir_bk_cycle_counter, env->cycle_type);
+	ir_node *const start_mem   = new_r_Proj(start_read, mode_M, pn_Builtin_M);
+	ir_node *const start       = new_r_Proj(start_read, mode_Iu, pn_Builtin_max + 1);
+
+	edges_reroute_except(initial_mem, start_mem, start_read);
+	/* beware: reroute routes anchor edges also, revert this */
+	set_irg_initial_mem(irg, initial_mem);
+
+	ir_node *const endbb = get_irg_end_block(irg);
+	for (unsigned i = get_Block_n_cfgpreds(endbb); i-- > 0;) {
+		ir_node *const ret = get_Block_cfgpred(endbb, i);
+		if (!is_Return(ret))
+			continue;
+
+		ir_node *const bb       = get_nodes_block(ret);
+		ir_node *const end_read = new_r_Builtin(bb, get_Return_mem(ret), 0, NULL, ir_bk_cycle_counter, env->cycle_type);
+		ir_node       *mem      = new_r_Proj(end_read, mode_M, pn_Builtin_M);
+		ir_node *const end      = new_r_Proj(end_read, mode_Iu, pn_Builtin_max + 1);
+		ir_node *const delta    = new_r_Sub(bb, end, start);
+
+		/* add delta to the 64bit sum (low, high); the carry is computed
+		 * without control flow or flags */
+		ir_node *const low      = load_counter(bb, &mem, env->counters, slot);
+		ir_node *const high     = load_counter(bb, &mem, env->counters, slot + 1);
+		ir_node *const new_low  = new_r_Add(bb, low, delta);
+		ir_node *const both     = new_r_And(bb, low, delta);
+		ir_node *const any      = new_r_Or(bb, low, delta);
+		ir_node *const lost     = new_r_And(bb, any, new_r_Not(bb, new_low));
+		ir_node *const carry_hi = new_r_Or(bb, both, lost);
+		ir_node *const shift    = new_r_Const_long(irg, mode_Iu, get_mode_size_bits(mode_Iu) - 1);
+		ir_node *const carry    = new_r_Shr(bb, carry_hi, shift);
+		ir_node *const new_high = new_r_Add(bb, high, carry);
+		store_counter(bb, &mem, env->counters, slot, new_low);
+		store_counter(bb, &mem, env->counters, slot + 1, new_high);
+		set_Return_mem(ret, mem);
+	}
+}
+
+/**
+ * Instrument a single ir_graph with the hot path counters selected in env.
+ */
+static void instrument_irg_hotpaths(hotpath_env_t *env, ir_graph *irg, ir_entity *counters)
+{
+	if (env->flags & IR_PROFILE_HOTPATH_LOOPS)
+		assure_loopinfo(irg);
+
+	env->counters  = new_r_Address(irg, counters);
+	env->blocks    = NEW_ARR_F(ir_node*, 0);
+	env->first_load = NEW_ARR_F(ir_node*, 0);
+
+	if (env->flags & IR_PROFILE_HOTPATH_CYCLES) {
+		unsigned const slot = new_hotpath_slot(env, irg, "cycles_low", NULL);
+		new_hotpath_slot(env, irg, "cycles_high", NULL);
+		assure_edges(irg);
+		instrument_cycles(env, irg, slot);
+	}
+
+	ir_reserve_resources(irg, IR_RESOURCE_IRN_LINK);
+	irg_walk_graph(irg, firm_clear_link, NULL, NULL);
+
+	if (env->flags & IR_PROFILE_HOTPATH_ENTRY) {
+		unsigned const slot = new_hotpath_slot(env, irg, "entry", NULL);
+		add_counter_increment(env, get_irg_start_block(irg), slot);
+	}
+	irg_walk_graph(irg, place_hotpath_counters, NULL, env);
+
+	if (ARR_LEN(env->blocks) > 0)
+		connect_hotpath_mem(env, irg);
+
+	ir_free_resources(irg, IR_RESOURCE_IRN_LINK);
+	DEL_ARR_F(env->first_load);
+	DEL_ARR_F(env->blocks);
+}
+
+ir_graph *ir_profile_instrument_hotpaths(const char *filename, unsigned flags, FILE *map)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.ir.profile");
+
+	if (get_irp_n_irgs() == 0 || flags == IR_PROFILE_HOTPATH_NONE)
+		return NULL;
+
+	unsigned n_counters = 0;
+	foreach_irp_irg(i, irg) {
+		n_counters += get_irg_n_hotpath_slots(irg, flags);
+	}
+	if (n_counters == 0)
+		return NULL;
+
+	ir_entity *const counts       = new_array_entity("__FIRMPROF__HOTPATH_COUNTS", mode_Iu, n_counters, IR_LINKAGE_DEFAULT);
+	ir_entity *const ent_filename = new_static_string_entity("__FIRMPROF__HOTPATH_FILE_NAME", filename);
+
+	ir_type *const cycle_type = new_type_method(0, 1, false, cc_cdecl_set, mtp_no_property);
+	set_method_res_type(cycle_type, 0, get_type_for_mode(mode_Iu));
+
+	hotpath_env_t env = {
+		.flags      = flags,
+		.n_counters = 0,
+		.cycle_type = cycle_type,
+		.map        = map,
+	};
+	foreach_irp_irg(i, irg) {
+		instrument_irg_hotpaths(&env, irg, counts);
+	}
+	assert(env.n_counters == n_counters);
+
+	return gen_initializer_irg("__firmprof_hotpath_initializer", ent_filename, counts, n_counters);
 }
 
 static unsigned int *parse_profile(const char *filename, unsigned int num_blocks)
@@ -549,6 +901,7 @@ static void ir_set_execfreqs_from_profile(ir_graph *irg)
 
 	initialize_execfreq_env_t env = { .freq_factor = 1.0 / count };
 	irg_block_walk_graph(irg, initialize_execfreq, NULL, &env);
+	set_execfreq_from_profile(irg);
 }
 
 void ir_create_execfreqs_from_profile(void)
@@ -557,3 +910,426 @@ void ir_create_execfreqs_from_profile(void)
 		ir_set_execfreqs_from_profile(irg);
 	}
 }
+
+/**
+ * Number of samples attributed to a source line. Lines are identified by the
+ * base name of their file, because sample profiles usually contain absolute
+ * paths while the debug info contains the names given to the frontend.
+ */
+typedef struct line_samples_t {
+	ident   *file;  /**< base name of the source file */
+	unsigned line;  /**< line number */
+	double   count; /**< number of samples */
+} line_samples_t;
+
+/** Sample profile being read. */
+typedef struct sample_profile_t {
+	set           *lines;     /**< samples per source line */
+	pmap          *functions; /**< maps ld idents to method entities */
+	pmap          *heads;     /**< maps entities to their entry samples */
+	struct obstack obst;
+} sample_profile_t;
+
+/** A function profile on the stack of (inlined) AutoFDO function profiles. */
+typedef struct autofdo_function_t {
+	size_t   indent;     /**< indentation of the function profile */
+	ident   *file;       /**< base name of the file of the function */
+	unsigned start_line; /**< line of the function declaration */
+} autofdo_function_t;
+
+static int cmp_line_samples(const void *a, const void *b, size_t size)
+{
+	const line_samples_t *la = (const line_samples_t*)a;
+	const line_samples_t *lb = (const line_samples_t*)b;
+	(void)size;
+	return la->file != lb->file || la->line != lb->line;
+}
+
+static ident *get_file_base_id(char const *const file)
+{
+	char const *const slash = strrchr(file, '/');
+	return new_id_from_str(slash != NULL ? slash + 1 : file);
+}
+
+static line_samples_t *get_line_samples(set *const lines, ident *const file,
+                                        unsigned const line, bool const insert)
+{
+	line_samples_t const query = { .file = file, .line = line, .count = 0 };
+	unsigned       const hash  = hash_combine(hash_ptr(file), line);
+	if (insert)
+		return set_insert(line_samples_t, lines, &query, sizeof(query), hash);
+	return set_find(line_samples_t, lines, &query, sizeof(query), hash);
+}
+
+/**
+ * Reads a line of arbitrary length from @p f onto @p obst.
+ * Returns NULL at the end of the file.
+ */
+static char *read_profile_line(FILE *const f, struct obstack *const obst)
+{
+	int c;
+	while ((c = getc(f)) != EOF && c != '\n')
+		obstack_1grow(obst, c);
+	if (c == EOF && obstack_object_size(obst) == 0)
+		return NULL;
+	obstack_1grow(obst, '\0');
+	return (char*)obstack_finish(obst);
+}
+
+/**
+ * Parses a decimal number spanning [begin, end). Returns false if the range
+ * is empty or contains anything else.
+ */
+static bool parse_profile_number(char const *begin, char const *const end,
+                                 double *const res)
+{
+	if (begin == end)
+		return false;
+	double value = 0;
+	for (; begin != end; ++begin) {
+		if (!is_digit(*begin))
+			return false;
+		value = value * 10 + (*begin - '0');
+	}
+	*res = value;
+	return true;
+}
+
+/**
+ * Parses a perf script srcline token "<file>:<line>".
+ */
+static bool parse_srcline(char const *const begin, char const *const end,
+                          src_loc_t *const loc, struct obstack *const obst)
+{
+	char const *colon = NULL;
+	for (char const *p = begin; p != end; ++p) {
+		if (*p == ':')
+			colon = p;
+	}
+	double line;
+	if (colon == NULL || colon == begin
+	 || !parse_profile_number(colon + 1, end, &line) || line == 0)
+		return false;
+	/* reject time stamps and other purely numeric fields */
+	bool numeric = true;
+	for (char const *p = begin; p != colon; ++p) {
+		if (!is_digit(*p) && *p != '.')
+			numeric = false;
+	}
+	if (numeric)
+		return false;
+
+	obstack_grow0(obst, begin, colon - begin);
+	loc->file   = (char const*)obstack_finish(obst);
+	loc->line   = (unsigned)line;
+	loc->column = 0;
+	return true;
+}
+
+/**
+ * Reads the output of "perf script -F ip,srcline": Each line containing a
+ * "<file>:<line>" token counts as one sample of that line.
+ */
+static void read_perf_script(sample_profile_t *const prof, FILE *const f)
+{
+	struct obstack line_obst;
+	obstack_init(&line_obst);
+	char *buf;
+	while ((buf = read_profile_line(f, &line_obst)) != NULL) {
+		for (char const *p = buf; *p != '\0';) {
+			while (*p == ' ' || *p == '\t')
+				++p;
+			char const *const begin = p;
+			while (*p != '\0' && *p != ' ' && *p != '\t')
+				++p;
+
+			src_loc_t loc;
+			if (begin != p && parse_srcline(begin, p, &loc, &line_obst)) {
+				ident          *const file = get_file_base_id(loc.file);
+				line_samples_t *const ls   = get_line_samples(prof->lines, file, loc.line, true);
+				ls->count += 1;
+				break;
+			}
+		}
+		obstack_free(&line_obst, buf);
+	}
+	obstack_free(&line_obst, NULL);
+}
+
+/**
+ * Returns the source location of the function named @p name for the line
+ * offsets of an AutoFDO function profile.
+ */
+static autofdo_function_t get_autofdo_function(sample_profile_t *const prof,
+                                               char const *const name,
+                                               size_t const indent)
+{
+	autofdo_function_t res = { .indent = indent, .file = NULL, .start_line = 0 };
+
+	ir_entity *const entity = pmap_get(ir_entity, prof->functions, new_id_from_str(name));
+	if (entity == NULL)
+		return res;
+	src_loc_t const loc = ir_retrieve_dbg_info(get_entity_dbg_info(entity));
+	if (loc.file == NULL || loc.line == 0)
+		return res;
+	res.file       = get_file_base_id(loc.file);
+	res.start_line = loc.line;
+	return res;
+}
+
+/**
+ * Reads an AutoFDO text profile: For every function a header
+ * "<name>:<total samples>:<head samples>" followed by indented lines
+ * "<line offset>[.<discriminator>]: <samples> [<call targets>]" and inlined
+ * callsites "<line offset>: <name>:<total samples>", which contain further
+ * indented lines relative to the inlined function.
+ * Samples of the same line are combined by maximum.
+ */
+static void read_autofdo(sample_profile_t *const prof, FILE *const f)
+{
+	struct obstack line_obst;
+	obstack_init(&line_obst);
+	autofdo_function_t *stack = NEW_ARR_F(autofdo_function_t, 0);
+	char *buf;
+	while ((buf = read_profile_line(f, &line_obst)) != NULL) {
+		size_t indent = 0;
+		while (buf[indent] == ' ' || buf[indent] == '\t')
+			++indent;
+		char *const content = buf + indent;
+		if (content[0] == '\0' || content[0] == '!')
+			goto next;
+
+		while (ARR_LEN(stack) > 0 && stack[ARR_LEN(stack) - 1].indent >= indent)
+			ARR_SHRINKLEN(stack, ARR_LEN(stack) - 1);
+
+		if (indent == 0) {
+			/* function header: name:total:head */
+			char *const head_colon = strrchr(content, ':');
+			if (head_colon == NULL)
+				goto next;
+			*head_colon = '\0';
+			char *const total_colon = strrchr(content, ':');
+			double head;
+			if (total_colon == NULL
+			 || !parse_profile_number(head_colon + 1, strchr(head_colon + 1, '\0'), &head))
+				goto next;
+			*total_colon = '\0';
+
+			ARR_APP1(autofdo_function_t, stack, get_autofdo_function(prof, content, indent));
+			ir_entity *const entity = pmap_get(ir_entity, prof->functions, new_id_from_str(content));
+			if (entity != NULL && head > 0) {
+				double *const count = OALLOC(&prof->obst, double);
+				*count = head;
+				pmap_insert(prof->heads, entity, count);
+			}
+			goto next;
+		}
+
+		if (ARR_LEN(stack) == 0)
+			goto next;
+
+		/* "<offset>[.<discriminator>]: <rest>" */
+		char *const colon = strchr(content, ':');
+		if (colon == NULL)
+			goto next;
+		char *offset_end = content;
+		while (is_digit(*offset_end))
+			++offset_end;
+		double offset;
+		if (!parse_profile_number(content, offset_end, &offset))
+			goto next;
+
+		char *rest = colon + 1;
+		while (*rest == ' ' || *rest == '\t')
+			++rest;
+		char *rest_end = rest;
+		while (*rest_end != '\0' && *rest_end != ' ' && *rest_end != '\t')
+			++rest_end;
+
+		double count;
+		if (parse_profile_number(rest, rest_end, &count)) {
+			autofdo_function_t const *const func = &stack[ARR_LEN(stack) - 1];
+			if (func->file == NULL)
+				goto next;
+			unsigned        const line = func->start_line + (unsigned)offset;
+			line_samples_t *const ls   = get_line_samples(prof->lines, func->file, line, true);
+			if (count > ls->count)
+				ls->count = count;
+		} else {
+			/* inlined callsite: name:total */
+			char *const name_end = strrchr(rest, ':');
+			if (name_end == NULL)
+				goto next;
+			*name_end = '\0';
+			ARR_APP1(autofdo_function_t, stack, get_autofdo_function(prof, rest, indent));
+		}
+next:
+		obstack_free(&line_obst, buf);
+	}
+	DEL_ARR_F(stack);
+	obstack_free(&line_obst, NULL);
+}
+
+/**
+ * Node walker: Attributes the samples of the source lines of all nodes to
+ * their blocks. The link of a block points to the maximal number of samples
+ * of its lines, blocks without any known source line have a NULL link.
+ */
+static void collect_block_samples(ir_node *const node, void *const data)
+{
+	sample_profile_t *const prof = (sample_profile_t*)data;
+	src_loc_t         const loc  = ir_retrieve_dbg_info(get_irn_dbg_info(node));
+	if (loc.file == NULL || loc.line == 0)
+		return;
+
+	ir_node *const block = is_Block(node) ? node : get_nodes_block(node);
+	double        *count = (double*)get_irn_link(block);
+	if (count == NULL) {
+		count  = OALLOCZ(&prof->obst, double);
+		set_irn_link(block, count);
+	}
+
+	ident                *const file = get_file_base_id(loc.file);
+	line_samples_t const *const ls   = get_line_samples(prof->lines, file, loc.line, false);
+	if (ls != NULL && ls->count > *count)
+		*count = ls->count;
+}
+
+/** Sums of samples and estimated frequencies of the sampled blocks. */
+typedef struct sample_calibration_t {
+	double samples;
+	double freqs;
+} sample_calibration_t;
+
+static void calibrate_samples(ir_node *const block, void *const data)
+{
+	sample_calibration_t *const calib = (sample_calibration_t*)data;
+	double         const *const count = (double const*)get_irn_link(block);
+	if (count != NULL && *count > 0) {
+		calib->samples += *count;
+		calib->freqs   += get_block_execfreq(block);
+	}
+}
+
+static void set_execfreq_from_samples(ir_node *const block, void *const data)
+{
+	double const  samples_per_entry = *(double const*)data;
+	double const *count             = (double const*)get_irn_link(block);
+	ir_graph     *irg               = get_irn_irg(block);
+	if (count == NULL
+	 || block == get_irg_start_block(irg) || block == get_irg_end_block(irg))
+		return;
+
+	double freq = *count / samples_per_entry;
+	if (freq < MIN_EXECFREQ)
+		freq = MIN_EXECFREQ;
+	set_block_execfreq(block, freq);
+}
+
+/**
+ * Sets the execution frequencies of @p irg from the samples of its lines.
+ * Blocks without source lines keep their estimated frequencies. The samples
+ * are normalized by the entry samples of the function if the profile
+ * contains them, otherwise they are calibrated against the estimated
+ * frequencies of the sampled blocks.
+ */
+static void ir_set_execfreqs_from_samples(sample_profile_t *const prof,
+                                          ir_graph *const irg)
+{
+	ir_estimate_execfreq(irg);
+
+	ir_reserve_resources(irg, IR_RESOURCE_IRN_LINK);
+	irg_walk_graph(irg, firm_clear_link, collect_block_samples, prof);
+
+	double const *const head = pmap_get(double const, prof->heads, get_irg_entity(irg));
+	double samples_per_entry;
+	if (head != NULL) {
+		samples_per_entry = *head;
+	} else {
+		sample_calibration_t calib = { .samples = 0, .freqs = 0 };
+		irg_block_walk_graph(irg, calibrate_samples, NULL, &calib);
+		samples_per_entry = calib.freqs > 0 ? calib.samples / calib.freqs : 0;
+	}
+
+	if (samples_per_entry > 0) {
+		DB((dbg, LEVEL_2, "%+F: %g samples per entry\n", irg, samples_per_entry));
+		irg_block_walk_graph(irg, set_execfreq_from_samples, NULL, &samples_per_entry);
+		set_execfreq_from_profile(irg);
+	} else {
+		DB((dbg, LEVEL_2, "%+F: no samples, keeping estimated frequencies\n", irg));
+	}
+	ir_free_resources(irg, IR_RESOURCE_IRN_LINK);
+}
+
+/**
+ * Returns true if the first non-empty line of @p f looks like an AutoFDO
+ * function header "<name>:<total>:<head>".
+ */
+static bool is_autofdo_profile(FILE *const f, struct obstack *const obst)
+{
+	bool  res = false;
+	char *buf;
+	while ((buf = read_profile_line(f, obst)) != NULL) {
+		if (buf[0] == '\0') {
+			obstack_free(obst, buf);
+			continue;
+		}
+		char *const head_colon = strrchr(buf, ':');
+		if (buf[0] != ' ' && buf[0] != '\t' && head_colon != NULL) {
+			*head_colon = '\0';
+			char const *const total_colon = strrchr(buf, ':');
+			double n;
+			res = total_colon != NULL && total_colon != buf
+			   && parse_profile_number(total_colon + 1, head_colon, &n)
+			   && parse_profile_number(head_colon + 1, strchr(head_colon + 1, '\0'), &n);
+		}
+		obstack_free(obst, buf);
+		break;
+	}
+	rewind(f);
+	return res;
+}
+
+bool ir_profile_read_samples(const char *filename)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.ir.profile");
+
+	FILE *const f = fopen(filename, "r");
+	if (!f) {
+		DBG((dbg, LEVEL_2, "Failed to open sample profile (%s)\n", filename));
+		return false;
+	}
+
+	sample_profile_t prof;
+	prof.lines     = new_set(cmp_line_samples, 64);
+	prof.functions = pmap_create();
+	prof.heads     = pmap_create();
+	obstack_init(&prof.obst);
+
+	foreach_irp_irg(i, irg) {
+		ir_entity *const entity = get_irg_entity(irg);
+		pmap_insert(prof.functions, get_entity_ld_ident(entity), entity);
+	}
+
+	if (is_autofdo_profile(f, &prof.obst)) {
+		DB((dbg, LEVEL_1, "Reading AutoFDO profile %s\n", filename));
+		read_autofdo(&prof, f);
+	} else {
+		DB((dbg, LEVEL_1, "Reading perf script profile %s\n", filename));
+		read_perf_script(&prof, f);
+	}
+	fclose(f);
+
+	bool const res = set_count(prof.lines) > 0;
+	if (res) {
+		foreach_irp_irg(i, irg) {
+			ir_set_execfreqs_from_samples(&prof, irg);
+		}
+	}
+
+	obstack_free(&prof.obst, NULL);
+	pmap_destroy(prof.heads);
+	pmap_destroy(prof.functions);
+	del_set(prof.lines);
+	return res;
+}
@@ -14,6 +14,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
 
 #include "firm_types.h"
 
@@ -25,6 +26,40 @@
  */
 ir_graph *ir_profile_instrument(const char *filename);
 
+/**
+ * Kinds of hot path instrumentation.
+ */
+typedef enum ir_profile_hotpath_flags_t {
+	IR_PROFILE_HOTPATH_NONE   = 0,
+	IR_PROFILE_HOTPATH_ENTRY  = 1 << 0, /**< count function entries */
+	IR_PROFILE_HOTPATH_CYCLES = 1 << 1, /**< sum up cycles spent in functions,
+	                                         x86 only */
+	IR_PROFILE_HOTPATH_LOOPS  = 1 << 2, /**< count loop entries and iterations,
+	                                         no trip count histograms */
+	IR_PROFILE_HOTPATH_CALLS  = 1 << 3, /**< count executions of call sites */
+} ir_profile_hotpath_flags_t;
+
+/**
+ * Instruments all irgs in the program with hot path counters selected by
+ * @p flags (see ir_profile_hotpath_flags_t). The counters are written to
+ * @p filename in the libfirmprof format when the program exits. Cycle counts
+ * are 64bit values split into two counters (low word first) and require
+ * support for the ir_bk_cycle_counter builtin, which only the x86 backends
+ * implement (with rdtsc). The backend drops cycle counting with a warning on
+ * other targets. As the builtin only reads the lower 32 bits of the cycle
+ * counter, a single call taking 2^32 cycles or more (about a second) is
+ * counted modulo 2^32.
+ * Loops get an entry and an iteration counter, so only their average trip
+ * count is known. Trip count histograms are not collected, as they would
+ * need new control flow after the block ids of the block profiler are fixed.
+ * If @p map is not NULL, one line "<counter> <kind> <function> [<detail>]"
+ * is written to it for each counter.
+ * Returns the constructor graph registering the counters or NULL if nothing
+ * was instrumented.
+ */
+ir_graph *ir_profile_instrument_hotpaths(const char *filename, unsigned flags,
+                                         FILE *map);
+
 /**
  * Reads the corresponding profile info file if it exists and returns a
  * profile info struct
@@ -32,6 +67,17 @@ ir_graph *ir_profile_instrument(const char *filename);
  */
 bool ir_profile_read(const char *filename);
 
+/**
+ * Reads a sampled profile and sets the execution frequencies of all irgs from
+ * it. Supported are the output of "perf script -F ip,srcline" and the AutoFDO
+ * text format. Samples are mapped to blocks through the source locations of
+ * the dbg_info of their nodes; blocks without source locations keep their
+ * estimated frequencies.
+ * @param filename The name of the file containing the samples
+ * @returns false if the file could not be read or contained no samples
+ */
+bool ir_profile_read_samples(const char *filename);
+
 /**
  * Frees the profile info
  */
@@ -12,6 +12,8 @@
 #include "irprog_t.h"
 
 #include "array.h"
+#include "compiler.h"
+#include "firm_lock.h"
 #include "ident_t.h"
 #include "ircons.h"
 #include "irgraph_t.h"
@@ -22,6 +24,9 @@
 /** The initial name of the irp program. */
 #define INITAL_PROG_NAME "no_name_set"
 
+/** Number of node numbers reserved at once by a thread. */
+#define NODE_NR_CHUNK 4096
+
 ir_prog *irp;
 ir_prog *get_irp(void) { return irp; }
 void set_irp(ir_prog *new_irp)
@@ -201,6 +206,22 @@ size_t get_irp_last_idx(void)
 	return irp->max_irg_idx;
 }
 
+long get_irp_new_node_nr_parallel(void)
+{
+	/* Each thread takes numbers from its own chunk, so the threads only
+	 * synchronize when a chunk is used up. */
+	static THREAD_LOCAL long next_nr;
+	static THREAD_LOCAL long end_nr;
+	if (next_nr == end_nr) {
+		firm_lock_globals();
+		next_nr = irp->max_node_nr;
+		irp->max_node_nr += NODE_NR_CHUNK;
+		firm_unlock_globals();
+		end_nr = next_nr + NODE_NR_CHUNK;
+	}
+	return next_nr++;
+}
+
 void set_irp_irg(size_t pos, ir_graph *irg)
 {
 	assert(irp && irg);
@@ -212,7 +233,9 @@ void add_irp_type(ir_type *typ)
 {
 	assert(typ != NULL);
 	assert(irp);
+	firm_lock_globals();
 	ARR_APP1(ir_type *, irp->types, typ);
+	firm_unlock_globals();
 }
 
 void remove_irp_type(ir_type *typ)
@@ -220,6 +243,7 @@ void remove_irp_type(ir_type *typ)
 	size_t i, l;
 	assert(typ);
 
+	firm_lock_globals();
 	l = ARR_LEN(irp->types);
 	for (i = 0; i < l; ++i) {
 		if (irp->types[i] == typ) {
@@ -230,6 +254,7 @@ void remove_irp_type(ir_type *typ)
 			break;
 		}
 	}
+	firm_unlock_globals();
 }
 
 size_t (get_irp_n_types) (void)
@@ -16,6 +16,7 @@
 
 #include "array.h"
 #include "callgraph.h"
+#include "firm_lock.h"
 #include "irmemory.h"
 #include "pmap.h"
 #include "typerep.h"
@@ -116,9 +117,13 @@ static inline ir_type *get_irp_type_(size_t pos)
 	return irp->types[pos];
 }
 
+long get_irp_new_node_nr_parallel(void);
+
 /** Returns a new, unique number to number nodes or the like. */
 static inline long get_irp_new_node_nr(void)
 {
+	if (firm_parallel)
+		return get_irp_new_node_nr_parallel();
 	return irp->max_node_nr++;
 }
 
@@ -138,10 +143,15 @@ static inline ir_label_t get_irp_next_label_nr_(void)
 	return ++irp->last_label_nr;
 }
 
+/*
+ * The program wide resources are shared by all graphs, so a reservation holds
+ * the global lock while graphs are optimized on several threads.
+ */
 #ifndef NDEBUG
 static inline void irp_reserve_resources(ir_prog *irp,
                                          irp_resources_t resources)
 {
+	firm_lock_globals();
 	assert((irp->reserved_resources & resources) == 0);
 	irp->reserved_resources |= resources;
 }
@@ -150,6 +160,7 @@ static inline void irp_free_resources(ir_prog *irp, irp_resources_t resources)
 {
 	assert((irp->reserved_resources & resources) == resources);
 	irp->reserved_resources &= ~resources;
+	firm_unlock_globals();
 }
 
 static inline irp_resources_t irp_resources_reserved(const ir_prog *irp)
@@ -162,12 +173,14 @@ static inline void irp_reserve_resources(ir_prog *irp,
 {
 	(void)irp;
 	(void)resources;
+	firm_lock_globals();
 }
 
 static inline void irp_free_resources(ir_prog *irp, irp_resources_t resources)
 {
 	(void)irp;
 	(void)resources;
+	firm_unlock_globals();
 }
 
 static inline irp_resources_t irp_resources_reserved(const ir_prog *irp)
@@ -11,6 +11,7 @@
  */
 #include "irverify_t.h"
 
+#include "compiler.h"
 #include "ircons.h"
 #include "irdom_t.h"
 #include "irdump.h"
@@ -1370,8 +1371,8 @@ static bool has_multiple_X_succs(const ir_node *node)
 	    || (is_fragile_op(node) && ir_throws_exception(node));
 }
 
-static unsigned n_returns;
-static bool     properties_fine;
+static THREAD_LOCAL unsigned n_returns;
+static THREAD_LOCAL bool     properties_fine;
 
 static void check_simple_properties(ir_node *node, void *env)
 {
@@ -10,13 +10,14 @@
  */
 #include "lower_alloc.h"
 
+#include "compiler.h"
 #include "ircons.h"
 #include "irgmod.h"
 #include "irgwalk.h"
 #include "irnode_t.h"
 #include "irnodeset.h"
 
-static unsigned po2_stack_alignment;
+static THREAD_LOCAL unsigned po2_stack_alignment;
 
 /**
  * Adjust the size of a node representing a stack alloc to a certain
@@ -36,6 +36,15 @@ static const char *get_builtin_name(ir_builtin_kind kind)
 	case ir_bk_popcount: return "popcount";
 	case ir_bk_parity:   return "parity";
 	case ir_bk_bswap:    return "bswap";
+	case ir_bk_sqrt:     return "sqrt";
+	case ir_bk_fabs:     return "fabs";
+	case ir_bk_floor:    return "floor";
+	case ir_bk_ceil:     return "ceil";
+	case ir_bk_trunc:    return "trunc";
+	case ir_bk_round:    return "round";
+	case ir_bk_fmin:     return "fmin";
+	case ir_bk_fmax:     return "fmax";
+	case ir_bk_copysign: return "copysign";
 	case ir_bk_prefetch:
 	case ir_bk_trap:
 	case ir_bk_debugbreak:
@@ -45,6 +54,7 @@ static const char *get_builtin_name(ir_builtin_kind kind)
 	case ir_bk_outport:
 	case ir_bk_saturating_increment:
 	case ir_bk_compare_swap:
+	case ir_bk_cycle_counter:
 	case ir_bk_may_alias:
 	case ir_bk_va_start:
 	case ir_bk_va_arg:
@@ -53,6 +63,38 @@ static const char *get_builtin_name(ir_builtin_kind kind)
 	abort();
 }
 
+static bool is_float_builtin(ir_builtin_kind kind)
+{
+	switch (kind) {
+	case ir_bk_sqrt:
+	case ir_bk_fabs:
+	case ir_bk_floor:
+	case ir_bk_ceil:
+	case ir_bk_trunc:
+	case ir_bk_round:
+	case ir_bk_fmin:
+	case ir_bk_fmax:
+	case ir_bk_copysign:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/**
+ * Returns the suffix of the C library function operating on values of the
+ * given floating point type. The type may already be lowered to an integer
+ * type of the same size by the softfloat lowering.
+ */
+static const char *get_libm_suffix(ir_type *type)
+{
+	switch (get_type_size(type)) {
+	case 4: return "f";
+	case 8: return "";
+	default: return "l";
+	}
+}
+
 static const char *get_gcc_machmode(ir_type *type)
 {
 	assert(is_Primitive_type(type));
@@ -111,8 +153,9 @@ static void replace_with_call(ir_node *node)
 	ir_builtin_kind const kind     = get_Builtin_kind(node);
 	char     const *const name     = get_builtin_name(kind);
 	ir_type        *const arg1     = get_method_param_type(mtp, 0);
-	char     const *const machmode = get_gcc_machmode(arg1);
-	ident          *const id       = new_id_fmt("__%s%s2", name, machmode);
+	ident          *const id       = is_float_builtin(kind)
+		? new_id_fmt("%s%s", name, get_libm_suffix(arg1))
+		: new_id_fmt("__%s%s2", name, get_gcc_machmode(arg1));
 	ir_entity      *const entity
 		= create_compilerlib_entity(get_id_str(id), mtp);
 
@@ -183,6 +226,15 @@ static void lower_builtin(ir_node *node, void *env)
 	case ir_bk_popcount:
 	case ir_bk_parity:
 	case ir_bk_bswap:
+	case ir_bk_sqrt:
+	case ir_bk_fabs:
+	case ir_bk_floor:
+	case ir_bk_ceil:
+	case ir_bk_trunc:
+	case ir_bk_round:
+	case ir_bk_fmin:
+	case ir_bk_fmax:
+	case ir_bk_copysign:
 		/* replace with a call */
 		replace_with_call(node);
 		goto changed;
@@ -205,6 +257,7 @@ changed:
 	case ir_bk_outport:
 	case ir_bk_saturating_increment:
 	case ir_bk_compare_swap:
+	case ir_bk_cycle_counter:
 	case ir_bk_va_start:
 		/* can't do anything about these, backend will probably fail now */
 		panic("builtin kind %s not supported (for this target)",
@@ -9,6 +9,7 @@
  * @author  Michael Beck, Matthias Braun, Manuel Mohr
  */
 #include "adt/list.h"
+#include "compiler.h"
 #include "ircons.h"
 #include "irgmod.h"
 #include "irgwalk.h"
@@ -21,13 +22,13 @@
 #include "type_t.h"
 #include "util.h"
 
-static unsigned max_small_size; /**< The maximum size of a CopyB node
-                                     so that it is regarded as 'small'. */
-static unsigned min_large_size; /**< The minimum size of a CopyB node
-                                     so that it is regarded as 'large'. */
-static unsigned native_mode_bytes; /**< The size of the native mode in bytes. */
-static bool allow_misalignments; /**< Whether backend can handle misaligned
-                                      loads and stores. */
+static THREAD_LOCAL unsigned max_small_size; /**< The maximum size of a CopyB node
+                                                  so that it is regarded as 'small'. */
+static THREAD_LOCAL unsigned min_large_size; /**< The minimum size of a CopyB node
+                                                  so that it is regarded as 'large'. */
+static THREAD_LOCAL unsigned native_mode_bytes; /**< The size of the native mode in bytes. */
+static THREAD_LOCAL bool allow_misalignments; /**< Whether backend can handle misaligned
+                                                   loads and stores. */
 
 typedef struct walk_env {
 	ir_node **copybs; /**< The list of CopyB nodes. */
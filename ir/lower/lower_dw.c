@@ -2248,6 +2248,7 @@ static void lower_Builtin(ir_node *const builtin)
 	ir_builtin_kind kind = get_Builtin_kind(builtin);
 	switch (kind) {
 	case ir_bk_compare_swap:
+	case ir_bk_cycle_counter:
 	case ir_bk_debugbreak:
 	case ir_bk_frame_address:
 	case ir_bk_inport:
@@ -2259,6 +2260,15 @@ static void lower_Builtin(ir_node *const builtin)
 	case ir_bk_trap:
 	case ir_bk_va_start:
 	case ir_bk_va_arg:
+	case ir_bk_sqrt:
+	case ir_bk_fabs:
+	case ir_bk_floor:
+	case ir_bk_ceil:
+	case ir_bk_trunc:
+	case ir_bk_round:
+	case ir_bk_fmin:
+	case ir_bk_fmax:
+	case ir_bk_copysign:
 		/* Nothing to do/impossible to lower in a generic way */
 		return;
 	case ir_bk_bswap:
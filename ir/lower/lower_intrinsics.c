@@ -157,6 +157,47 @@ static void replace_call(ir_node *irn, ir_node *call, ir_node *mem,
 	}
 }
 
+/**
+ * Replaces a call of a C library math function by a Builtin of the given
+ * kind. This is only done with fast math enabled, as the Builtin neither sets
+ * errno nor is guaranteed to handle NaNs and signed zeros like the library
+ * function.
+ *
+ * @param call  the call to replace
+ * @param kind  the kind of the Builtin
+ */
+static int map_to_builtin(ir_node *call, ir_builtin_kind kind)
+{
+	if (!get_opt_fast_math())
+		return 0;
+
+	ir_type *mtp = get_Call_type(call);
+	if (get_method_n_ress(mtp) != 1)
+		return 0;
+	ir_mode *mode = get_type_mode(get_method_res_type(mtp, 0));
+	if (mode != mode_F && mode != mode_D)
+		return 0;
+
+	int       n_params = get_Call_n_params(call);
+	ir_node **params   = get_Call_param_arr(call);
+	for (int i = 0; i < n_params; ++i) {
+		if (get_irn_mode(params[i]) != mode)
+			return 0;
+	}
+
+	dbg_info *dbg     = get_irn_dbg_info(call);
+	ir_node  *block   = get_nodes_block(call);
+	ir_node  *mem     = get_Call_mem(call);
+	ir_node  *builtin = new_rd_Builtin(dbg, block, mem, n_params, params,
+	                                   kind, mtp);
+	ir_node  *res     = new_r_Proj(builtin, mode, pn_Builtin_max + 1);
+	mem = new_r_Proj(builtin, mode_M, pn_Builtin_M);
+
+	DBG_OPT_ALGSIM0(call, builtin);
+	replace_call(res, call, mem, NULL, NULL);
+	return 1;
+}
+
 int i_mapper_abs(ir_node *call)
 {
 	ir_node  *mem      = get_Call_mem(call);
@@ -194,11 +235,11 @@ int i_mapper_sqrt(ir_node *call)
 	ir_node   *op = get_Call_param(call, 0);
 
 	if (!is_Const(op))
-		return 0;
+		return map_to_builtin(call, ir_bk_sqrt);
 
 	tv = get_Const_tarval(op);
 	if (! tarval_is_null(tv) && !tarval_is_one(tv))
-		return 0;
+		return map_to_builtin(call, ir_bk_sqrt);
 
 	mem = get_Call_mem(call);
 
@@ -476,6 +517,46 @@ int i_mapper_tanh(ir_node *call)
 	return i_mapper_zero_to_zero(call);
 }
 
+int i_mapper_fabs(ir_node *call)
+{
+	return map_to_builtin(call, ir_bk_fabs);
+}
+
+int i_mapper_floor(ir_node *call)
+{
+	return map_to_builtin(call, ir_bk_floor);
+}
+
+int i_mapper_ceil(ir_node *call)
+{
+	return map_to_builtin(call, ir_bk_ceil);
+}
+
+int i_mapper_trunc(ir_node *call)
+{
+	return map_to_builtin(call, ir_bk_trunc);
+}
+
+int i_mapper_round(ir_node *call)
+{
+	return map_to_builtin(call, ir_bk_round);
+}
+
+int i_mapper_fmin(ir_node *call)
+{
+	return map_to_builtin(call, ir_bk_fmin);
+}
+
+int i_mapper_fmax(ir_node *call)
+{
+	return map_to_builtin(call, ir_bk_fmax);
+}
+
+int i_mapper_copysign(ir_node *call)
+{
+	return map_to_builtin(call, ir_bk_copysign);
+}
+
 /**
  * Return the const entity that is accessed through the pointer ptr or
  * NULL if there is no entity (or the entity is not constant).
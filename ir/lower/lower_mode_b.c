@@ -11,6 +11,7 @@
 #include "lower_mode_b.h"
 
 #include "array.h"
+#include "compiler.h"
 #include "ircons_t.h"
 #include "iredges_t.h"
 #include "irflag.h"
@@ -32,8 +33,8 @@ typedef struct needs_lowering_t {
 	int      input;
 } needs_lowering_t;
 
-static ir_mode          *lowered_mode;
-static needs_lowering_t *needs_lowering;
+static THREAD_LOCAL ir_mode          *lowered_mode;
+static THREAD_LOCAL needs_lowering_t *needs_lowering;
 
 static ir_node *create_not(dbg_info *dbgi, ir_node *node)
 {
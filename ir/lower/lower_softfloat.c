@@ -395,19 +395,17 @@ static bool lower_Call(ir_node *node)
 }
 
 /**
- * Adapts the method type of a va_arg Builtin.
+ * Adapts the method type of a va_arg or floating point Builtin.
  */
 static bool lower_Builtin(ir_node *node)
 {
-	if (get_Builtin_kind(node) != ir_bk_va_arg)
-		return false;
-
 	ir_type *tp       = get_Builtin_type(node);
 	ir_type *lower_tp = lower_type_if_needed(tp);
 	if (lower_tp != tp) {
 		set_Builtin_type(node, lower_tp);
+		return true;
 	}
-	return true;
+	return get_Builtin_kind(node) == ir_bk_va_arg;
 }
 
 /**
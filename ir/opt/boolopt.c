@@ -16,6 +16,7 @@
 #include "irgwalk.h"
 #include "irnode_t.h"
 #include "iroptimize.h"
+#include "opt_init.h"
 #include "tv.h"
 #include <assert.h>
 
@@ -734,9 +735,6 @@ void opt_bool(ir_graph *const irg)
 {
 	bool_opt_env_t env;
 
-	/* register a debug mask */
-	FIRM_DBG_REGISTER(dbg, "firm.opt.bool");
-
 	env.changed = 0;
 
 	/* optimize simple Andb and Orb cases */
@@ -753,3 +751,8 @@ void opt_bool(ir_graph *const irg)
 	confirm_irg_properties(irg,
 		env.changed ? IR_GRAPH_PROPERTIES_NONE : IR_GRAPH_PROPERTIES_ALL);
 }
+
+void firm_init_boolopt(void)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.opt.bool");
+}
@@ -19,6 +19,7 @@
 #include "irnode_t.h"
 #include "iroptimize.h"
 #include "irverify.h"
+#include "opt_init.h"
 #include "util.h"
 #include "xmalloc.h"
 #include <assert.h>
@@ -550,7 +551,6 @@ void optimize_cf(ir_graph *irg)
 	ir_reserve_resources(irg, IR_RESOURCE_BLOCK_MARK | IR_RESOURCE_PHI_LIST
 	                        | IR_RESOURCE_IRN_LINK);
 
-	FIRM_DBG_REGISTER(dbg, "firm.opt.controlflow");
 	DB((dbg, LEVEL_1, "===> Performing control flow opt on %+F\n", irg));
 
 	ir_node *end            = get_irg_end(irg);
@@ -584,3 +584,8 @@ void optimize_cf(ir_graph *irg)
 	confirm_irg_properties(irg, global_changed ? IR_GRAPH_PROPERTIES_NONE
 	                                           : IR_GRAPH_PROPERTIES_ALL);
 }
+
+void firm_init_cfopt(void)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.opt.controlflow");
+}
@@ -13,14 +13,28 @@
  * The idea here is to push nodes as deep into the dominance tree as their
  * dependencies allow. After pushing them back up out of as many loops as
  * possible.
+ *
+ * Partial dead code elimination additionally sinks a node, which is only
+ * needed on some of the paths leaving its block, into the branches using it.
+ * Cheap nodes are duplicated if several branches use them. The decision is
+ * based on the block execution frequencies, which come from a profile if one
+ * was read.
  */
+#include "array.h"
+#include "execfreq_t.h"
 #include "iredges_t.h"
 #include "irgopt.h"
+#include "irgwalk.h"
 #include "irnode_t.h"
 #include "iroptimize.h"
 #include "pdeq.h"
 #include <stdbool.h>
 
+/** Maximum number of branches a node is sunk into. */
+#define MAX_SINK_COPIES  4
+/** Sinking must reduce the executions of a node at least by this factor. */
+#define SINK_FREQ_RATIO  0.8
+
 #ifndef NDEBUG
 static bool is_block_reachable(ir_node *block)
 {
@@ -355,3 +369,176 @@ void place_code(ir_graph *irg)
 	deq_free(&worklist);
 	confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_CONTROL_FLOW);
 }
+
+/** A branch a node is sunk into. */
+typedef struct sink_target_t {
+	ir_node *dom_child; /**< child of the node's block dominating the uses */
+	ir_node *block;     /**< the block the node is placed into */
+	ir_node *copy;      /**< the node used in this branch */
+} sink_target_t;
+
+/** A use of a node being sunk. */
+typedef struct sink_use_t {
+	ir_node  *user;
+	int       pos;
+	unsigned  target;
+} sink_use_t;
+
+static bool is_sinkable(const ir_node *n)
+{
+	if (get_irn_pinned(n) || is_Proj(n) || is_irn_start_block_placed(n)
+	 || is_irn_constlike(n))
+		return false;
+	ir_mode *const mode = get_irn_mode(n);
+	return mode_is_data(mode) || mode == mode_b;
+}
+
+/**
+ * Checks whether @p n is cheap enough to be computed in several branches
+ * instead of once. Copies increase the code size and, for operations with
+ * a long latency, the cost of each branch.
+ */
+static bool is_copyable(const ir_node *n)
+{
+	switch (get_irn_opcode(n)) {
+	case iro_Add:
+	case iro_And:
+	case iro_Cmp:
+	case iro_Conv:
+	case iro_Eor:
+	case iro_Member:
+	case iro_Minus:
+	case iro_Mux:
+	case iro_Not:
+	case iro_Or:
+	case iro_Shl:
+	case iro_Shr:
+	case iro_Shrs:
+	case iro_Sub:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/**
+ * Returns the child of dom in the dominator tree, which dominates block.
+ */
+static ir_node *get_dom_child(ir_node *block, ir_node const *const dom)
+{
+	for (;;) {
+		ir_node *const idom = get_Block_idom(block);
+		if (idom == dom)
+			return block;
+		if (idom == NULL)
+			return NULL;
+		block = idom;
+	}
+}
+
+/**
+ * Moves n into the branches of its block using it, if n is not needed on all
+ * paths leaving its block and this executes it less often.
+ */
+static void sink_node(ir_node *const n, sink_use_t **const uses)
+{
+	ir_node *const block      = get_nodes_block(n);
+	int      const loop_depth = get_block_loop_depth(block);
+	sink_target_t  targets[MAX_SINK_COPIES];
+	unsigned       n_targets  = 0;
+
+	ARR_RESIZE(sink_use_t, *uses, 0);
+	foreach_out_edge(n, edge) {
+		ir_node *const user = get_edge_src_irn(edge);
+		if (is_End(user))
+			continue;
+
+		int const pos       = get_edge_src_pos(edge);
+		ir_node  *use_block = get_nodes_block(user);
+		if (is_Phi(user))
+			use_block = get_Block_cfgpred_block(use_block, pos);
+		if (use_block == NULL || use_block == block)
+			return;
+
+		ir_node *const dom_child = get_dom_child(use_block, block);
+		if (dom_child == NULL)
+			return;
+
+		unsigned t = 0;
+		while (t < n_targets && targets[t].dom_child != dom_child)
+			++t;
+		if (t == n_targets) {
+			if (n_targets == MAX_SINK_COPIES)
+				return;
+			targets[t] = (sink_target_t) {
+				.dom_child = dom_child,
+				.block     = use_block,
+			};
+			++n_targets;
+		} else {
+			targets[t].block = calc_dom_dca(targets[t].block, use_block);
+		}
+
+		sink_use_t const use = { .user = user, .pos = pos, .target = t };
+		ARR_APP1(sink_use_t, *uses, use);
+	}
+	if (n_targets == 0 || (n_targets > 1 && !is_copyable(n)))
+		return;
+
+	/* never sink into loops */
+	double sunk_freq = 0.0;
+	for (unsigned t = 0; t < n_targets; ++t) {
+		if (get_block_loop_depth(targets[t].block) > loop_depth)
+			return;
+		sunk_freq += get_block_execfreq(targets[t].block);
+	}
+	double const freq = get_block_execfreq(block);
+	/* duplicating must pay off clearly */
+	double const max_freq = n_targets == 1 ? freq : freq * SINK_FREQ_RATIO;
+	if (sunk_freq >= max_freq)
+		return;
+
+	targets[0].copy = n;
+	set_nodes_block(n, targets[0].block);
+	for (unsigned t = 1; t < n_targets; ++t) {
+		ir_node *const copy = exact_copy(n);
+		set_nodes_block(copy, targets[t].block);
+		targets[t].copy = copy;
+	}
+	for (size_t i = 0, n_uses = ARR_LEN(*uses); i < n_uses; ++i) {
+		sink_use_t const *const use = &(*uses)[i];
+		if (use->target != 0)
+			set_irn_n(use->user, use->pos, targets[use->target].copy);
+	}
+}
+
+static void collect_sinkable(ir_node *const n, void *const env)
+{
+	ir_node ***const nodes = (ir_node***)env;
+	if (is_sinkable(n))
+		ARR_APP1(ir_node*, *nodes, n);
+}
+
+void sink_partially_dead_code(ir_graph *irg)
+{
+	assure_execfreq(irg);
+	place_code(irg);
+	assure_irg_properties(irg,
+		IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES |
+		IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE |
+		IR_GRAPH_PROPERTY_CONSISTENT_LOOPINFO);
+
+	/* The walk places the users of a node after it. Sinking the users first
+	 * lets their operands follow them into the branches. */
+	ir_node **nodes = NEW_ARR_F(ir_node*, 0);
+	irg_walk_graph(irg, NULL, collect_sinkable, &nodes);
+
+	sink_use_t *uses = NEW_ARR_F(sink_use_t, 0);
+	for (size_t i = ARR_LEN(nodes); i-- > 0;) {
+		sink_node(nodes[i], &uses);
+	}
+	DEL_ARR_F(uses);
+	DEL_ARR_F(nodes);
+
+	confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_CONTROL_FLOW);
+}
@@ -23,6 +23,7 @@
  */
 #include "array.h"
 #include "debug.h"
+#include "firm_lock.h"
 #include "ircons.h"
 #include "irdump.h"
 #include "irflag.h"
@@ -39,6 +40,7 @@
 #include "irprintf.h"
 #include "list.h"
 #include "obstack.h"
+#include "opt_init.h"
 #include "panic.h"
 #include "pmap.h"
 #include "set.h"
@@ -182,10 +184,10 @@ static inline bool is_reachable(const node_t *node)
 DEBUG_ONLY(static firm_dbg_module_t *dbg;)
 
 /** The what reason. */
-DEBUG_ONLY(static const char *what_reason;)
+DEBUG_ONLY(static THREAD_LOCAL const char *what_reason;)
 
 /** Next partition number. */
-DEBUG_ONLY(static unsigned part_nr = 0;)
+DEBUG_ONLY(static THREAD_LOCAL unsigned part_nr = 0;)
 
 /* forward */
 static node_t *identity(node_t *node);
@@ -1069,7 +1071,7 @@ static bool clear_flags(node_t *list)
 static partition_t *split(partition_t **pX, node_t *gg, environment_t *env)
 {
 	partition_t *X = *pX;
-	DEBUG_ONLY(static int run = 0;)
+	DEBUG_ONLY(static THREAD_LOCAL int run = 0;)
 
 	DB((dbg, LEVEL_2, "Run %d ", run++));
 	if (list_empty(&X->follower)) {
@@ -2267,6 +2269,36 @@ static void compute_Confirm(node_t *node)
 	node->type = pred->type;
 }
 
+/**
+ * Returns the function computing the type of nodes with opcode @p op. Unlike
+ * the generic function of the ir_op, this table is not shared with other
+ * passes, so combo can run on several graphs concurrently.
+ */
+static compute_func get_compute_func(ir_op const *const op)
+{
+	switch (get_op_code(op)) {
+	case iro_Add:     return compute_Add;
+	case iro_Address: return compute_Address;
+	case iro_Align:   return compute_Align;
+	case iro_Bad:     return compute_Bad;
+	case iro_Block:   return compute_Block;
+	case iro_Cmp:     return compute_Cmp;
+	case iro_Confirm: return compute_Confirm;
+	case iro_End:     return compute_End;
+	case iro_Eor:     return compute_Eor;
+	case iro_Jmp:     return compute_Jmp;
+	case iro_Mux:     return compute_Mux;
+	case iro_Offset:  return compute_Offset;
+	case iro_Phi:     return compute_Phi;
+	case iro_Proj:    return compute_Proj;
+	case iro_Return:  return compute_Return;
+	case iro_Size:    return compute_Size;
+	case iro_Sub:     return compute_Sub;
+	case iro_Unknown: return compute_Unknown;
+	default:          return default_compute;
+	}
+}
+
 /**
  * (Re-)compute the type for a given node.
  *
@@ -2296,9 +2328,8 @@ static void compute(node_t *node)
 		}
 	}
 
-	compute_func func = (compute_func)node->node->op->ops.generic;
-	if (func != NULL)
-		func(node);
+	compute_func const func = get_compute_func(get_irn_op(node->node));
+	func(node);
 }
 
 /*
@@ -3119,43 +3150,6 @@ static void apply_end(ir_node *end, environment_t *env)
 	}
 }
 
-static void set_compute_func(ir_op *op, compute_func func)
-{
-	op->ops.generic = (op_func)func;
-}
-
-/**
- * sets the generic functions to compute.
- */
-static void set_compute_functions(void)
-{
-	/* set the default compute function */
-	for (size_t i = 0, n = ir_get_n_opcodes(); i < n; ++i) {
-		ir_op *op = ir_get_opcode(i);
-		op->ops.generic = (op_func)default_compute;
-	}
-
-	/* set specific functions */
-	set_compute_func(op_Add,     compute_Add);
-	set_compute_func(op_Address, compute_Address);
-	set_compute_func(op_Align,   compute_Align);
-	set_compute_func(op_Bad,     compute_Bad);
-	set_compute_func(op_Block,   compute_Block);
-	set_compute_func(op_Cmp,     compute_Cmp);
-	set_compute_func(op_Confirm, compute_Confirm);
-	set_compute_func(op_End,     compute_End);
-	set_compute_func(op_Eor,     compute_Eor);
-	set_compute_func(op_Jmp,     compute_Jmp);
-	set_compute_func(op_Mux,     compute_Mux);
-	set_compute_func(op_Offset,  compute_Offset);
-	set_compute_func(op_Phi,     compute_Phi);
-	set_compute_func(op_Proj,    compute_Proj);
-	set_compute_func(op_Return,  compute_Return);
-	set_compute_func(op_Size,    compute_Size);
-	set_compute_func(op_Sub,     compute_Sub);
-	set_compute_func(op_Unknown, compute_Unknown);
-}
-
 /**
  * Add memory keeps.
  */
@@ -3186,9 +3180,6 @@ void combo(ir_graph *irg)
 		| IR_GRAPH_PROPERTY_CONSISTENT_OUTS
 		| IR_GRAPH_PROPERTY_CONSISTENT_LOOPINFO);
 
-	/* register a debug mask */
-	FIRM_DBG_REGISTER(dbg, "firm.opt.combo");
-
 	DB((dbg, LEVEL_1, "Doing COMBO for %+F\n", irg));
 
 	environment_t env;
@@ -3203,7 +3194,6 @@ void combo(ir_graph *irg)
 	/* we have our own value_of function */
 	set_value_of_func(get_node_tarval);
 
-	set_compute_functions();
 	DEBUG_ONLY(part_nr = 0;)
 
 	ir_reserve_resources(irg, IR_RESOURCE_IRN_LINK | IR_RESOURCE_PHI_LIST);
@@ -3213,8 +3203,9 @@ void combo(ir_graph *irg)
 	add_to_worklist(env.initial, &env);
 	irg_walk_graph(irg, create_initial_partitions, init_block_phis, &env);
 
-	/* set the hook: from now, every node has a partition and a type */
-	DEBUG_ONLY(set_dump_node_vcgattr_hook(dump_partition_hook);)
+	/* set the hook: from now, every node has a partition and a type. Graphs
+	 * are not dumped while they are optimized in parallel. */
+	DEBUG_ONLY(if (!firm_parallel) set_dump_node_vcgattr_hook(dump_partition_hook);)
 
 	/* all nodes on the initial partition have type Bottom */
 	env.initial->type_is_B_or_C = true;
@@ -3265,7 +3256,7 @@ void combo(ir_graph *irg)
 	ir_free_resources(irg, IR_RESOURCE_IRN_LINK | IR_RESOURCE_PHI_LIST);
 
 	/* remove the partition hook */
-	DEBUG_ONLY(set_dump_node_vcgattr_hook(NULL);)
+	DEBUG_ONLY(if (!firm_parallel) set_dump_node_vcgattr_hook(NULL);)
 
 	DEL_ARR_F(env.kept_memory);
 	del_set(env.opcode2id_map);
@@ -3276,3 +3267,8 @@ void combo(ir_graph *irg)
 
 	confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_NONE);
 }
+
+void firm_init_combo(void)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.opt.combo");
+}
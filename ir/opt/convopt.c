@@ -30,6 +30,7 @@
 #include "irnode_t.h"
 #include "iropt_t.h"
 #include "iroptimize.h"
+#include "opt_init.h"
 #include "tv.h"
 #include "util.h"
 #include "vrp.h"
@@ -275,8 +276,6 @@ static void conv_opt_walker(ir_node *node, void *data)
 
 void conv_opt(ir_graph *irg)
 {
-	FIRM_DBG_REGISTER(dbg, "firm.opt.conv");
-
 	assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES);
 
 	DB((dbg, LEVEL_1, "===> Performing conversion optimization on %+F\n", irg));
@@ -294,3 +293,8 @@ void conv_opt(ir_graph *irg)
 	confirm_irg_properties(irg,
 		global_changed ? IR_GRAPH_PROPERTIES_NONE : IR_GRAPH_PROPERTIES_ALL);
 }
+
+void firm_init_convopt(void)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.opt.conv");
+}
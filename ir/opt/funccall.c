@@ -337,6 +337,7 @@ static mtp_additional_properties follow_mem(ir_node *node,
 				break;
 			case ir_bk_return_address:
 			case ir_bk_frame_address:
+			case ir_bk_cycle_counter:
 				/* Access context information => not pure anymore */
 				max_prop &= ~mtp_property_pure;
 				break;
@@ -349,6 +350,15 @@ static mtp_additional_properties follow_mem(ir_node *node,
 			case ir_bk_bswap:
 			case ir_bk_saturating_increment:
 			case ir_bk_may_alias:
+			case ir_bk_sqrt:
+			case ir_bk_fabs:
+			case ir_bk_floor:
+			case ir_bk_ceil:
+			case ir_bk_trunc:
+			case ir_bk_round:
+			case ir_bk_fmin:
+			case ir_bk_fmax:
+			case ir_bk_copysign:
 				/* just arithmetic/no semantic change => no problem */
 				continue;
 			case ir_bk_compare_swap:
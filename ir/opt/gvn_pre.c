@@ -10,6 +10,7 @@
  * @author  Michael Beck
  * @brief
  */
+#include "compiler.h"
 #include "debug.h"
 #include "ircons.h"
 #include "irdom.h"
@@ -27,6 +28,7 @@
 #include "iropt_t.h"
 #include "iroptimize.h"
 #include "irouts.h"
+#include "opt_init.h"
 #include "tv_t.h"
 #include "valueset.h"
 
@@ -105,10 +107,10 @@ typedef struct pre_env {
 #endif
 } pre_env;
 
-static pre_env *environment;
+static THREAD_LOCAL pre_env *environment;
 
 /* custom GVN value map */
-static ir_nodehashmap_t value_map;
+static THREAD_LOCAL ir_nodehashmap_t value_map;
 
 /* debug module handle */
 DEBUG_ONLY(static firm_dbg_module_t *dbg;)
@@ -133,7 +135,7 @@ typedef struct gvnpre_statistics {
 	int infinite_loops;
 } gvnpre_statistics;
 
-static gvnpre_statistics *gvnpre_stats = NULL;
+static THREAD_LOCAL gvnpre_statistics *gvnpre_stats = NULL;
 
 static void init_stats(void)
 {
@@ -1801,9 +1803,6 @@ void do_gvn_pre(ir_graph *irg)
 		| IR_GRAPH_PROPERTY_NO_CRITICAL_EDGES
 		| IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE);
 
-	/* register a debug mask */
-	FIRM_DBG_REGISTER(dbg, "firm.opt.gvn_pre");
-
 	save_optimization_state(&state);
 	ir_reserve_resources(irg, IR_RESOURCE_IRN_LINK | IR_RESOURCE_LOOP_LINK);
 
@@ -1879,3 +1878,8 @@ void do_gvn_pre(ir_graph *irg)
 	set_opt_global_cse(0);
 	edges_activate(irg);
 }
+
+void firm_init_gvn_pre(void)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.opt.gvn_pre");
+}
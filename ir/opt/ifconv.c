@@ -8,17 +8,22 @@
  * @brief   If conversion
  * @author  Christoph Mallon
  */
+#include "array.h"
 #include "cdep_t.h"
 #include "debug.h"
+#include "execfreq_t.h"
 #include "ircons.h"
+#include "iredges_t.h"
 #include "irgmod.h"
 #include "irgopt.h"
 #include "irgwalk.h"
 #include "irnode_t.h"
 #include "iroptimize.h"
 #include "irtools.h"
+#include "opt_init.h"
 #include "pdeq.h"
 #include "target_t.h"
+#include "util.h"
 #include <assert.h>
 #include <stdbool.h>
 
@@ -27,11 +32,109 @@
  */
 typedef struct walker_env {
 	arch_allow_ifconv_func allow_ifconv;
-	bool                   changed; /**< Set if the graph was changed. */
+	bool                   changed;  /**< Set if the graph was changed. */
 } walker_env;
 
 DEBUG_ONLY(static firm_dbg_module_t *dbg;)
 
+/** Estimated cost of a correctly predicted conditional branch. */
+#define BRANCH_COST      1
+/** Estimated additional cost of a mispredicted conditional branch. */
+#define MISPREDICT_COST 16
+/** Estimated cost of a Mux. */
+#define MUX_COST         1
+/** Branches taking one direction at least this often are well predicted. */
+#define BIAS_THRESHOLD   0.9
+
+/**
+ * Estimates the number of instructions needed to compute a node.
+ */
+static unsigned get_node_cost(ir_node const *const node)
+{
+	if (is_irn_constlike(node))
+		return 0;
+
+	switch (get_irn_opcode(node)) {
+	case iro_Confirm:
+	case iro_Id:
+	case iro_Proj:
+		return 0;
+	case iro_Div:
+	case iro_Mod:
+		return 20;
+	case iro_Load:
+	case iro_Mul:
+		return 3;
+	default:
+		return 1;
+	}
+}
+
+/**
+ * Checks whether computing both arms of a branch with n_muxes Mux nodes is
+ * cheaper than the branch.
+ *
+ * A branch executes only one of the arms, but is mispredicted about as often
+ * as the less likely arm is taken.
+ *
+ * @param prob     the probability that the first arm is taken
+ * @param cost0    the cost of the first arm
+ * @param cost1    the cost of the second arm
+ * @param n_muxes  the number of Mux nodes replacing the branch
+ */
+static bool is_mux_profitable(double const prob, unsigned const cost0,
+                              unsigned const cost1, unsigned const n_muxes)
+{
+	double const mispredict  = MIN(prob, 1.0 - prob);
+	double const branch_cost = prob * cost0 + (1.0 - prob) * cost1
+	                         + BRANCH_COST + mispredict * MISPREDICT_COST;
+	double const mux_cost    = cost0 + cost1 + n_muxes * MUX_COST;
+	return mux_cost <= branch_cost;
+}
+
+/**
+ * Checks whether a branch, whose first arm is taken with probability prob,
+ * mostly takes the same direction.
+ */
+static bool is_biased(double const prob)
+{
+	return MAX(prob, 1.0 - prob) >= BIAS_THRESHOLD;
+}
+
+/**
+ * Estimates the cost of the computations node depends on, which are placed
+ * in blocks controlled by dependency. If-conversion moves them in front of
+ * the branch.
+ */
+static unsigned get_arm_cost(ir_node *const node,
+                             ir_node const *const dependency)
+{
+	if (irn_visited_else_mark(node) || is_Phi(node))
+		return 0;
+	ir_node *const block = get_nodes_block(node);
+	if (block == dependency || !is_cdep_on(block, dependency))
+		return 0;
+
+	unsigned cost = get_node_cost(node);
+	foreach_irn_in(node, i, pred) {
+		cost += get_arm_cost(pred, dependency);
+	}
+	return cost;
+}
+
+/**
+ * Returns the execution frequency of the arm starting at block target
+ * relative to the frequency of the branch in dependency.
+ */
+static double get_arm_probability(ir_node const *const target,
+                                  ir_node const *const dependency)
+{
+	double const cond_freq = get_block_execfreq(dependency);
+	if (cond_freq <= 0.0)
+		return 0.5;
+	return MIN(get_block_execfreq(target) / cond_freq, 1.0);
+}
+
 /**
  * Returns non-zero if a Block can be emptied.
  *
@@ -47,12 +150,14 @@ static bool can_empty_block(ir_node *block)
  *
  * @param start       a block that is control depended on dependency
  * @param dependency  the block that decides whether start is executed
+ * @param target      set to the block, which the ProjX node jumps to
  *
  * @return a ProjX node that represent the decision control flow or
  *         NULL is start is not dependent at all or a block on the way
  *         cannot be emptied
  */
-static ir_node *walk_to_projx(ir_node *start, const ir_node *dependency)
+static ir_node *walk_to_projx(ir_node *start, const ir_node *dependency,
+                              ir_node **target)
 {
 	/* No need to find the conditional block if this block cannot be emptied and
 	 * therefore not moved */
@@ -65,6 +170,7 @@ static ir_node *walk_to_projx(ir_node *start, const ir_node *dependency)
 			if (is_Proj(pred)) {
 				assert(get_irn_mode(pred) == mode_X);
 				/* we found it */
+				*target = start;
 				return pred;
 			}
 			/* Not a Proj? Should not happen. */
@@ -78,7 +184,7 @@ static ir_node *walk_to_projx(ir_node *start, const ir_node *dependency)
 		}
 
 		if (is_cdep_on(pred_block, dependency)) {
-			return walk_to_projx(pred_block, dependency);
+			return walk_to_projx(pred_block, dependency, target);
 		}
 	}
 	return NULL;
@@ -286,7 +392,9 @@ restart:;
 
 		for (ir_cdep *cdep = find_cdep(pred0); cdep != NULL; cdep = get_cdep_next(cdep)) {
 			const ir_node *dependency = get_cdep_node(cdep);
-			ir_node       *projx0     = walk_to_projx(pred0, dependency);
+			ir_node       *target0;
+			ir_node       *projx0     = walk_to_projx(pred0, dependency,
+			                                          &target0);
 
 			if (projx0 == NULL) continue;
 
@@ -300,7 +408,8 @@ restart:;
 
 				if (!is_cdep_on(pred1, dependency)) continue;
 
-				ir_node *projx1 = walk_to_projx(pred1, dependency);
+				ir_node *target1;
+				ir_node *projx1 = walk_to_projx(pred1, dependency, &target1);
 
 				if (projx1 == NULL) continue;
 
@@ -330,6 +439,32 @@ restart:;
 				if (!supported)
 					continue;
 
+				/* The Mux nodes compute both arms, so only convert if the
+				 * branch is hard to predict or the arms are cheap. */
+				inc_irg_visited(get_irn_irg(block));
+				unsigned cost0   = 0;
+				unsigned cost1   = 0;
+				unsigned n_muxes = 0;
+				for (ir_node *p = phi; p != NULL; p = get_Phi_next(p)) {
+					ir_node *const val0 = get_Phi_pred(p, i);
+					ir_node *const val1 = get_Phi_pred(p, j);
+					if (val0 == val1)
+						continue;
+					cost0 += get_arm_cost(val0, dependency);
+					cost1 += get_arm_cost(val1, dependency);
+					++n_muxes;
+				}
+				double const prob0 = get_arm_probability(target0, dependency);
+				double const prob1 = get_arm_probability(target1, dependency);
+				double const prob  = prob0 + prob1 > 0.0
+				                   ? prob0 / (prob0 + prob1) : 0.5;
+				if (is_biased(prob)
+				    || !is_mux_profitable(prob, cost0, cost1, n_muxes)) {
+					DB((dbg, LEVEL_1, "Keeping Cond %+F (prob %.2f, costs %u, %u)\n",
+						cond, prob, cost0, cost1));
+					continue;
+				}
+
 				DB((dbg, LEVEL_1, "Found Cond %+F with proj %+F and %+F\n",
 					cond, projx0, projx1
 				));
@@ -417,9 +552,9 @@ static void init_block_link(ir_node *block, void *env)
  * Daisy-chain all Phis in a block.
  * If a non-movable node is encountered set the has_pinned flag in its block.
  */
-static void collect_phis(ir_node *node, void *env)
+static void collect_phis(ir_node *node, void *ctx)
 {
-	(void)env;
+	walker_env *env = (walker_env*)ctx;
 
 	if (is_Phi(node)) {
 		ir_node *block = get_nodes_block(node);
@@ -445,11 +580,236 @@ static void fill_waitq(ir_node *node, void *env) {
 	deq_push_pointer_right(waitq, node);
 }
 
+/**
+ * Checks whether node is only used by a single node in block and can be moved
+ * into a branch below block together with its user.
+ */
+static bool is_exclusive_node(ir_node const *const node,
+                              ir_node const *const block)
+{
+	return get_nodes_block(node) == block
+	    && !is_Phi(node) && !get_irn_pinned(node)
+	    && !is_irn_start_block_placed(node)
+	    && get_irn_n_edges(node) == 1;
+}
+
+/**
+ * Checks whether node is only used by a single node in block and can be moved
+ * into a branch below block together with its user. A Proj is exclusive with
+ * its predecessor, e.g. a floating Load, if it is its only user.
+ */
+static bool is_exclusive_operand(ir_node const *const node,
+                                 ir_node const *const block)
+{
+	if (is_Proj(node))
+		return get_irn_n_edges(node) == 1
+		    && is_exclusive_node(get_Proj_pred(node), block);
+	return is_exclusive_node(node, block);
+}
+
+/**
+ * Estimates the cost of the computations, which are only needed for the Mux
+ * operand node in block.
+ */
+static unsigned get_exclusive_cost(ir_node const *const node,
+                                   ir_node const *const block)
+{
+	if (!is_exclusive_operand(node, block))
+		return 0;
+
+	unsigned cost = get_node_cost(node);
+	foreach_irn_in(node, i, pred) {
+		cost += get_exclusive_cost(pred, block);
+	}
+	return cost;
+}
+
+/**
+ * Moves the computations, which are only needed for the Mux operand node in
+ * block, into the branch arm.
+ */
+static void move_exclusive(ir_node *const node, ir_node const *const block,
+                           ir_node *const arm)
+{
+	if (!is_exclusive_operand(node, block))
+		return;
+
+	set_nodes_block(node, arm);
+	foreach_irn_in(node, i, pred) {
+		move_exclusive(pred, block, arm);
+	}
+}
+
+typedef struct split_env {
+	arch_allow_ifconv_func allow_ifconv;
+	ir_node              **muxes;
+	double                *probs;
+} split_env;
+
+/**
+ * Returns the probability, that the selector of mux is true.
+ *
+ * A Mux has no arms, whose execution frequencies could be measured, but its
+ * selector may also decide a branch elsewhere in the graph. Otherwise the
+ * Mux is assumed to be unpredictable.
+ */
+static double get_mux_probability(ir_node const *const mux)
+{
+	foreach_out_edge(get_Mux_sel(mux), edge) {
+		ir_node *const cond = get_edge_src_irn(edge);
+		if (!is_Cond(cond))
+			continue;
+		ir_node const *const block = get_nodes_block(cond);
+		foreach_out_edge(cond, proj_edge) {
+			ir_node *const proj = get_edge_src_irn(proj_edge);
+			if (get_Proj_num(proj) != pn_Cond_true)
+				continue;
+			foreach_out_edge(proj, target_edge) {
+				ir_node const *const target = get_edge_src_irn(target_edge);
+				return get_arm_probability(target, block);
+			}
+		}
+	}
+	return 0.5;
+}
+
+/**
+ * Collects the Mux nodes, which are more expensive than a branch.
+ *
+ * Mux nodes accepted by the target may have been built on purpose, so they
+ * are only split, if their selector is known to be biased. Mux nodes, which
+ * the target turns into a branch anyway, are split, if their operands are
+ * expensive.
+ */
+static void collect_expensive_muxes(ir_node *node, void *ctx)
+{
+	if (!is_Mux(node))
+		return;
+
+	split_env *const env       = (split_env*)ctx;
+	ir_node   *const block     = get_nodes_block(node);
+	ir_node   *const sel       = get_Mux_sel(node);
+	ir_node   *const val_true  = get_Mux_true(node);
+	ir_node   *const val_false = get_Mux_false(node);
+	if (is_Const(sel) || val_true == val_false)
+		return;
+
+	double const prob = get_mux_probability(node);
+	if (!is_biased(prob) && env->allow_ifconv(sel, val_false, val_true))
+		return;
+
+	unsigned const cost_true  = get_exclusive_cost(val_true, block);
+	unsigned const cost_false = get_exclusive_cost(val_false, block);
+	if (is_mux_profitable(prob, cost_true, cost_false, 1))
+		return;
+
+	DB((dbg, LEVEL_2, "%+F is expensive (prob %.2f, costs %u, %u)\n", node,
+	    prob, cost_true, cost_false));
+	ARR_APP1(ir_node*, env->muxes, node);
+	ARR_APP1(double, env->probs, prob);
+}
+
+/**
+ * Replaces a Mux by a branch and moves the computations of its operands into
+ * the arms.
+ */
+static void split_mux(ir_node *const mux, double const prob)
+{
+	DB((dbg, LEVEL_1, "Splitting %+F\n", mux));
+
+	ir_node  *const val_true    = get_Mux_true(mux);
+	ir_node  *const val_false   = get_Mux_false(mux);
+	ir_node  *const lower_block = part_block_edges(mux);
+	ir_node  *const upper_block = get_nodes_block(mux);
+	ir_graph *const irg         = get_irn_irg(mux);
+
+	ir_node *const cond        = new_r_Cond(upper_block, get_Mux_sel(mux));
+	ir_node *const proj_true   = new_r_Proj(cond, mode_X, pn_Cond_true);
+	ir_node *const proj_false  = new_r_Proj(cond, mode_X, pn_Cond_false);
+	ir_node *const block_true  = new_r_Block(irg, 1, &proj_true);
+	ir_node *const block_false = new_r_Block(irg, 1, &proj_false);
+	double   const freq        = get_block_execfreq(lower_block);
+	set_block_execfreq(upper_block, freq);
+	set_block_execfreq(block_true,  freq * prob);
+	set_block_execfreq(block_false, freq * (1.0 - prob));
+	move_exclusive(val_true,  upper_block, block_true);
+	move_exclusive(val_false, upper_block, block_false);
+
+	ir_node *const jmps[] = { new_r_Jmp(block_true), new_r_Jmp(block_false) };
+	set_irn_in(lower_block, ARRAY_SIZE(jmps), jmps);
+
+	ir_node  *const vals[] = { val_true, val_false };
+	dbg_info *const dbgi   = get_irn_dbg_info(mux);
+	ir_node  *const phi    = new_rd_Phi(dbgi, lower_block, ARRAY_SIZE(vals),
+	                                    vals, get_irn_mode(mux));
+	exchange(mux, phi);
+}
+
+/**
+ * Splits Mux nodes, which the target does not support and whose operands are
+ * too expensive to compute both of them, into branches.
+ */
+static void split_expensive_muxes(ir_graph *const irg,
+                                  arch_allow_ifconv_func const callback)
+{
+	assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES);
+
+	split_env env = { .allow_ifconv = callback };
+	env.muxes = NEW_ARR_F(ir_node*, 0);
+	env.probs = NEW_ARR_F(double, 0);
+	irg_walk_graph(irg, collect_expensive_muxes, NULL, &env);
+	ir_node **const muxes = env.muxes;
+
+	size_t const n_muxes = ARR_LEN(muxes);
+	if (n_muxes > 0) {
+		int rem_opt = get_optimize();
+		set_optimize(0);
+		for (size_t i = 0; i < n_muxes; ++i) {
+			split_mux(muxes[i], env.probs[i]);
+		}
+		set_optimize(rem_opt);
+	}
+	DEL_ARR_F(env.probs);
+	DEL_ARR_F(muxes);
+
+	confirm_irg_properties(irg, n_muxes == 0 ? IR_GRAPH_PROPERTIES_ALL :
+		IR_GRAPH_PROPERTY_NO_CRITICAL_EDGES
+		| IR_GRAPH_PROPERTY_NO_UNREACHABLE_CODE
+		| IR_GRAPH_PROPERTY_NO_BADS
+		| IR_GRAPH_PROPERTY_NO_TUPLES
+		| IR_GRAPH_PROPERTY_ONE_RETURN
+		| IR_GRAPH_PROPERTY_MANY_RETURNS
+		| IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES);
+}
+
+static void find_candidate(ir_node *node, void *ctx)
+{
+	bool *const found = (bool*)ctx;
+	if (is_Phi(node) || is_Mux(node))
+		*found = true;
+}
+
 void opt_if_conv_cb(ir_graph *irg, arch_allow_ifconv_func callback)
 {
-	walker_env  env   = { .allow_ifconv = callback, .changed = false };
-	deq_t waitq;
-	deq_init(&waitq);
+	walker_env env = { .allow_ifconv = callback, .changed = false };
+
+	assure_irg_properties(irg,
+		IR_GRAPH_PROPERTY_NO_CRITICAL_EDGES
+		| IR_GRAPH_PROPERTY_NO_UNREACHABLE_CODE
+		| IR_GRAPH_PROPERTY_NO_BADS
+		| IR_GRAPH_PROPERTY_ONE_RETURN);
+
+	/* Only Phis and Mux nodes are converted, which need the probabilities
+	 * of their arms. Splitting a Mux keeps the frequencies up to date. */
+	bool has_candidates = false;
+	irg_walk_graph(irg, find_candidate, NULL, &has_candidates);
+	if (!has_candidates) {
+		confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_ALL);
+		return;
+	}
+	assure_execfreq(irg);
+
+	split_expensive_muxes(irg, callback);
 
 	assure_irg_properties(irg,
 		IR_GRAPH_PROPERTY_NO_CRITICAL_EDGES
@@ -458,26 +818,29 @@ void opt_if_conv_cb(ir_graph *irg, arch_allow_ifconv_func callback)
 		| IR_GRAPH_PROPERTY_ONE_RETURN
 		| IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE);
 
-	FIRM_DBG_REGISTER(dbg, "firm.opt.ifconv");
-
 	DB((dbg, LEVEL_1, "Running if-conversion on %+F\n", irg));
 
 	compute_cdep(irg);
 
 	ir_reserve_resources(irg, IR_RESOURCE_BLOCK_MARK | IR_RESOURCE_PHI_LIST);
 
+	deq_t waitq;
+	deq_init(&waitq);
 	irg_block_walk_graph(irg, init_block_link, fill_waitq, &waitq);
-	irg_walk_graph(irg, collect_phis, NULL, NULL);
+	irg_walk_graph(irg, collect_phis, NULL, &env);
 
 	/* Disable local optimizations to avoid the creation of
 	 * new Phi nodes that are not tracked by the if conversion. */
 	int rem_opt = get_optimize();
 	set_optimize(0);
 
+	/* The visited flags are used to estimate the cost of the arms. */
+	ir_reserve_resources(irg, IR_RESOURCE_IRN_VISITED);
 	while (!deq_empty(&waitq)) {
 		ir_node *n = deq_pop_pointer_left(ir_node, &waitq);
 		if_conv_walker(n, &env);
 	}
+	ir_free_resources(irg, IR_RESOURCE_IRN_VISITED);
 	deq_free(&waitq);
 
 	set_optimize(rem_opt);
@@ -499,3 +862,8 @@ void opt_if_conv(ir_graph *irg)
 {
 	opt_if_conv_cb(irg, ir_target.allow_ifconv);
 }
+
+void firm_init_ifconv(void)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.opt.ifconv");
+}
@@ -0,0 +1,636 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Interprocedural constant and range propagation.
+ *
+ * All call sites of a function are known if its address is never taken and it
+ * is not visible outside of the compilation unit. For such functions the
+ * values of each parameter are joined over all call sites and the values of
+ * each result over all Returns. A value is a constant or, for integer modes,
+ * a range of constants. Parameters of callers and results of callees are
+ * looked up in the same lattice, so the values are propagated sparsely over
+ * the call graph until a fixpoint is reached: Parameters in top-down and
+ * results in bottom-up order of the call graph.
+ *
+ * Afterwards constant values replace the parameters and call results. Ranges
+ * are recorded with Confirm nodes, which value range propagation picks up.
+ * Parameters and results, which are not used anymore, are removed from the
+ * method type, the Returns and all call sites.
+ */
+#include "array.h"
+#include "callgraph.h"
+#include "cgana.h"
+#include "debug.h"
+#include "entity_t.h"
+#include "irmemory.h"
+#include "ircons.h"
+#include "iredges_t.h"
+#include "irgmod.h"
+#include "irgraph_t.h"
+#include "irgwalk.h"
+#include "irnode_t.h"
+#include "iroptimize.h"
+#include "irprog_t.h"
+#include "pmap.h"
+#include "tv.h"
+#include "type_t.h"
+#include "util.h"
+
+DEBUG_ONLY(static firm_dbg_module_t *dbg;)
+
+typedef enum value_kind_t {
+	VALUE_TOP,    /**< no value seen yet */
+	VALUE_RANGE,  /**< the value is in [min, max] */
+	VALUE_BOTTOM, /**< the value is unknown */
+} value_kind_t;
+
+typedef struct ip_value_t {
+	value_kind_t  kind;
+	ir_tarval    *min;
+	ir_tarval    *max;
+} ip_value_t;
+
+typedef struct ip_func_t {
+	ir_entity   *entity;
+	ir_graph    *irg;
+	ir_node    **calls;   /**< all call sites of the function */
+	ip_value_t  *params;
+	ip_value_t  *results;
+	bool         invalid; /**< a call site does not match the method type */
+} ip_func_t;
+
+typedef struct ip_env_t {
+	struct obstack obst;
+	pmap          *funcs; /**< maps entities to their ip_func_t */
+	ir_graph     **order; /**< graphs in bottom-up order of the call graph */
+} ip_env_t;
+
+static ip_func_t *get_func(ip_env_t const *const env,
+                           ir_entity const *const entity)
+{
+	ip_func_t *const func = pmap_get(ip_func_t, env->funcs, entity);
+	return func != NULL && !func->invalid ? func : NULL;
+}
+
+static ip_value_t value_from_tarval(ir_tarval *const tv)
+{
+	return (ip_value_t){ .kind = VALUE_RANGE, .min = tv, .max = tv };
+}
+
+static ip_value_t const value_bottom = { .kind = VALUE_BOTTOM };
+
+static ip_value_t join_values(ip_value_t const a, ip_value_t const b)
+{
+	if (a.kind == VALUE_TOP || b.kind == VALUE_BOTTOM)
+		return b;
+	if (b.kind == VALUE_TOP || a.kind == VALUE_BOTTOM)
+		return a;
+
+	ir_mode *const mode = get_tarval_mode(a.min);
+	if (get_tarval_mode(b.min) != mode)
+		return value_bottom;
+	if (!mode_is_int(mode))
+		return a.min == b.min ? a : value_bottom;
+
+	ip_value_t res = a;
+	if (tarval_cmp(b.min, a.min) == ir_relation_less)
+		res.min = b.min;
+	if (tarval_cmp(b.max, a.max) == ir_relation_greater)
+		res.max = b.max;
+	return res;
+}
+
+static bool values_equal(ip_value_t const a, ip_value_t const b)
+{
+	if (a.kind != b.kind)
+		return false;
+	return a.kind != VALUE_RANGE || (a.min == b.min && a.max == b.max);
+}
+
+/**
+ * Returns the value of @p node as far as it is known from constants and the
+ * lattice of the parameters and call results.
+ */
+static ip_value_t get_ip_value(ip_env_t const *const env, ir_node const *const node)
+{
+	if (is_Const(node))
+		return value_from_tarval(get_Const_tarval(node));
+	if (!is_Proj(node))
+		return value_bottom;
+
+	ir_node  *const pred = get_Proj_pred(node);
+	ir_graph *const irg  = get_irn_irg(node);
+	if (pred == get_irg_args(irg)) {
+		ip_func_t const *const func = get_func(env, get_irg_entity(irg));
+		if (func == NULL)
+			return value_bottom;
+		return func->params[get_Proj_num(node)];
+	}
+
+	if (!is_Proj(pred) || get_Proj_num(pred) != pn_Call_T_result)
+		return value_bottom;
+	ir_node *const call = get_Proj_pred(pred);
+	if (!is_Call(call))
+		return value_bottom;
+	ir_entity const *const callee = get_Call_callee(call);
+	if (callee == NULL)
+		return value_bottom;
+	ip_func_t const *const func = get_func(env, callee);
+	if (func == NULL)
+		return value_bottom;
+	return func->results[get_Proj_num(node)];
+}
+
+static bool update_value(ip_value_t *const value, ip_value_t const new_value)
+{
+	if (values_equal(*value, new_value))
+		return false;
+	*value = new_value;
+	return true;
+}
+
+static bool update_params(ip_env_t const *const env, ip_func_t *const func)
+{
+	bool           changed  = false;
+	ir_type *const mtp      = get_entity_type(func->entity);
+	for (size_t i = 0, n = get_method_n_params(mtp); i < n; ++i) {
+		ip_value_t value = { .kind = VALUE_TOP };
+		for (size_t c = 0, n_calls = ARR_LEN(func->calls); c < n_calls; ++c) {
+			ir_node *const arg = get_Call_param(func->calls[c], i);
+			value = join_values(value, get_ip_value(env, arg));
+		}
+		changed |= update_value(&func->params[i], value);
+	}
+	return changed;
+}
+
+static bool update_results(ip_env_t const *const env, ip_func_t *const func)
+{
+	bool           changed   = false;
+	ir_type *const mtp       = get_entity_type(func->entity);
+	ir_node *const end_block = get_irg_end_block(func->irg);
+	for (size_t i = 0, n = get_method_n_ress(mtp); i < n; ++i) {
+		ip_value_t value = { .kind = VALUE_TOP };
+		foreach_irn_in(end_block, p, ret) {
+			if (is_Return(ret))
+				value = join_values(value, get_ip_value(env, get_Return_res(ret, i)));
+		}
+		changed |= update_value(&func->results[i], value);
+	}
+	return changed;
+}
+
+static bool call_matches_type(ir_node const *const call, ir_type const *const mtp)
+{
+	int const n_params = (int)get_method_n_params(mtp);
+	if (get_Call_n_params(call) != n_params)
+		return false;
+	for (int i = 0; i < n_params; ++i) {
+		ir_mode *const mode = get_type_mode(get_method_param_type(mtp, i));
+		if (get_irn_mode(get_Call_param(call, i)) != mode)
+			return false;
+	}
+
+	/* Propagated results are only valid for results of the same modes. */
+	ir_type const *const call_mtp = get_Call_type(call);
+	size_t         const n_ress   = get_method_n_ress(mtp);
+	if (get_method_n_ress(call_mtp) != n_ress)
+		return false;
+	for (size_t i = 0; i < n_ress; ++i) {
+		ir_mode *const mode = get_type_mode(get_method_res_type(mtp, i));
+		if (get_type_mode(get_method_res_type(call_mtp, i)) != mode)
+			return false;
+	}
+	return true;
+}
+
+static void collect_calls(ir_node *const node, void *const data)
+{
+	if (!is_Call(node))
+		return;
+	ir_entity *const callee = get_Call_callee(node);
+	if (callee == NULL)
+		return;
+	ip_env_t  *const env  = (ip_env_t*)data;
+	ip_func_t *const func = pmap_get(ip_func_t, env->funcs, callee);
+	if (func == NULL)
+		return;
+	if (!call_matches_type(node, get_entity_type(callee)))
+		func->invalid = true;
+	ARR_APP1(ir_node*, func->calls, node);
+}
+
+static bool is_candidate(ir_entity const *const entity)
+{
+	if (get_entity_linktime_irg(entity) == NULL
+	 || entity_is_externally_visible(entity)
+	 || (get_entity_usage(entity) & ir_usage_address_taken)
+	 || (get_entity_linkage(entity) & IR_LINKAGE_HIDDEN_USER))
+		return false;
+
+	ir_type const *const mtp = get_entity_type(entity);
+	if (is_method_variadic(mtp))
+		return false;
+	/* Compound parameters and results are not passed as values yet. */
+	for (size_t i = 0, n = get_method_n_params(mtp); i < n; ++i) {
+		if (get_type_mode(get_method_param_type(mtp, i)) == NULL)
+			return false;
+	}
+	for (size_t i = 0, n = get_method_n_ress(mtp); i < n; ++i) {
+		if (get_type_mode(get_method_res_type(mtp, i)) == NULL)
+			return false;
+	}
+	return true;
+}
+
+static void append_irg(ir_graph *const irg, void *const data)
+{
+	ir_graph ***const order = (ir_graph***)data;
+	ARR_APP1(ir_graph*, *order, irg);
+}
+
+/**
+ * Computes the order of the graphs with the call graph. Callee information
+ * is computed for this if it is not available.
+ */
+static ir_graph **compute_order(void)
+{
+	bool const has_callee_info
+		= get_irp_callee_info_state() == irg_callee_info_consistent;
+	if (!has_callee_info) {
+		ir_entity **free_methods;
+		cgana(&free_methods);
+		free(free_methods);
+	}
+	compute_callgraph();
+
+	ir_graph **order = NEW_ARR_F(ir_graph*, 0);
+	callgraph_walk(NULL, append_irg, &order);
+
+	free_callgraph();
+	if (!has_callee_info)
+		free_irp_callee_info();
+	return order;
+}
+
+/**
+ * Restricts the uses of @p node to @p value. Constant values replace the node,
+ * ranges are recorded with Confirm nodes.
+ */
+static void specialize_value(ir_node *const node, ip_value_t const value)
+{
+	if (value.kind != VALUE_RANGE)
+		return;
+
+	ir_graph *const irg = get_irn_irg(node);
+	if (value.min == value.max) {
+		DB((dbg, LEVEL_2, "replacing %+F by %T\n", node, value.min));
+		exchange(node, new_r_Const(irg, value.min));
+		return;
+	}
+
+	dbg_info *const dbgi  = get_irn_dbg_info(node);
+	ir_node  *const block = get_nodes_block(node);
+	ir_mode  *const mode  = get_irn_mode(node);
+	ir_node  *first       = NULL;
+	ir_node  *confirmed   = node;
+	if (value.min != get_mode_min(mode)) {
+		ir_node *const bound = new_r_Const(irg, value.min);
+		confirmed = new_rd_Confirm(dbgi, block, confirmed, bound,
+		                           ir_relation_greater_equal);
+		first = confirmed;
+	}
+	if (value.max != get_mode_max(mode)) {
+		ir_node *const bound = new_r_Const(irg, value.max);
+		confirmed = new_rd_Confirm(dbgi, block, confirmed, bound,
+		                           ir_relation_less_equal);
+		if (first == NULL)
+			first = confirmed;
+	}
+	if (first != NULL && confirmed != node) {
+		DB((dbg, LEVEL_2, "confirming %+F in [%T, %T]\n", node, value.min,
+		    value.max));
+		edges_reroute_except(node, confirmed, first);
+	}
+}
+
+static ir_node *get_Call_result_tuple(ir_node const *const call)
+{
+	foreach_out_edge(call, edge) {
+		ir_node *const proj = get_edge_src_irn(edge);
+		if (is_Proj(proj) && get_Proj_num(proj) == pn_Call_T_result)
+			return proj;
+	}
+	return NULL;
+}
+
+static void specialize_func(ip_func_t const *const func)
+{
+	ir_node *const args = get_irg_args(func->irg);
+	foreach_out_edge_safe(args, edge) {
+		ir_node *const proj = get_edge_src_irn(edge);
+		if (is_Proj(proj))
+			specialize_value(proj, func->params[get_Proj_num(proj)]);
+	}
+
+	for (size_t c = 0, n_calls = ARR_LEN(func->calls); c < n_calls; ++c) {
+		ir_node *const tuple = get_Call_result_tuple(func->calls[c]);
+		if (tuple == NULL)
+			continue;
+		foreach_out_edge_safe(tuple, edge) {
+			ir_node *const proj = get_edge_src_irn(edge);
+			if (is_Proj(proj))
+				specialize_value(proj, func->results[get_Proj_num(proj)]);
+		}
+	}
+}
+
+static bool has_users(ir_node const *const proj)
+{
+	return get_irn_n_edges(proj) > 0;
+}
+
+/**
+ * Marks the parameters of @p func, which are still used, in @p used.
+ */
+static void mark_used_params(ip_func_t const *const func, bool *const used)
+{
+	ir_node *const args = get_irg_args(func->irg);
+	foreach_out_edge(args, edge) {
+		ir_node *const proj = get_edge_src_irn(edge);
+		if (is_Anchor(proj))
+			continue;
+		if (!is_Proj(proj)) {
+			/* Not a plain parameter access: Keep all parameters. */
+			size_t const n = get_method_n_params(get_entity_type(func->entity));
+			memset(used, true, n * sizeof(*used));
+			return;
+		}
+		if (has_users(proj))
+			used[get_Proj_num(proj)] = true;
+	}
+
+	/* Parameters with an entity are accessed through the frame. */
+	ir_type *const frame = get_irg_frame_type(func->irg);
+	for (size_t i = 0, n = get_compound_n_members(frame); i < n; ++i) {
+		ir_entity *const member = get_compound_member(frame, i);
+		if (!is_parameter_entity(member))
+			continue;
+		size_t const num = get_entity_parameter_number(member);
+		if (num != IR_VA_START_PARAMETER_NUMBER)
+			used[num] = true;
+	}
+}
+
+/**
+ * Marks the results of @p func, which are used at some call site, in @p used.
+ */
+static void mark_used_results(ip_func_t const *const func, bool *const used)
+{
+	size_t const n_ress = get_method_n_ress(get_entity_type(func->entity));
+	for (size_t c = 0, n_calls = ARR_LEN(func->calls); c < n_calls; ++c) {
+		ir_node *const tuple = get_Call_result_tuple(func->calls[c]);
+		if (tuple == NULL)
+			continue;
+		foreach_out_edge(tuple, edge) {
+			ir_node *const proj = get_edge_src_irn(edge);
+			if (!is_Proj(proj)) {
+				memset(used, true, n_ress * sizeof(*used));
+				return;
+			}
+			if (has_users(proj))
+				used[get_Proj_num(proj)] = true;
+		}
+	}
+}
+
+/**
+ * Computes the new numbers of the used entries. Returns the number of used
+ * entries.
+ */
+static size_t compute_map(size_t const n, bool const *const used,
+                          size_t *const map)
+{
+	size_t n_used = 0;
+	for (size_t i = 0; i < n; ++i) {
+		map[i] = n_used;
+		if (used[i])
+			++n_used;
+	}
+	return n_used;
+}
+
+static ir_type *remove_unused(ir_type *const mtp, bool const *const used_params,
+                              size_t const n_used_params,
+                              bool const *const used_ress,
+                              size_t const n_used_ress)
+{
+	ir_type *const res = new_type_method(n_used_params, n_used_ress, false,
+		get_method_calling_convention(mtp),
+		get_method_additional_properties(mtp));
+	for (size_t i = 0, j = 0, n = get_method_n_params(mtp); i < n; ++i) {
+		if (used_params[i])
+			set_method_param_type(res, j++, get_method_param_type(mtp, i));
+	}
+	for (size_t i = 0, j = 0, n = get_method_n_ress(mtp); i < n; ++i) {
+		if (used_ress[i])
+			set_method_res_type(res, j++, get_method_res_type(mtp, i));
+	}
+	return res;
+}
+
+/**
+ * Renumbers the Projs of @p tuple with @p map. Projs of unused entries have no
+ * users and are killed.
+ */
+static void renumber_projs(ir_node *const tuple, bool const *const used,
+                           size_t const *const map)
+{
+	foreach_out_edge_safe(tuple, edge) {
+		ir_node *const proj = get_edge_src_irn(edge);
+		if (!is_Proj(proj))
+			continue;
+		unsigned const num = get_Proj_num(proj);
+		if (used[num]) {
+			set_Proj_num(proj, map[num]);
+		} else {
+			assert(!has_users(proj));
+			kill_node(proj);
+		}
+	}
+}
+
+static void remove_params_from_graph(ip_func_t const *const func,
+                                     bool const *const used,
+                                     size_t const *const map)
+{
+	renumber_projs(get_irg_args(func->irg), used, map);
+
+	ir_type *const frame = get_irg_frame_type(func->irg);
+	for (size_t i = 0, n = get_compound_n_members(frame); i < n; ++i) {
+		ir_entity *const member = get_compound_member(frame, i);
+		if (!is_parameter_entity(member))
+			continue;
+		size_t const num = get_entity_parameter_number(member);
+		if (num != IR_VA_START_PARAMETER_NUMBER)
+			set_entity_parameter_number(member, map[num]);
+	}
+}
+
+static void remove_results_from_returns(ip_func_t const *const func,
+                                        bool const *const used,
+                                        size_t const n_used)
+{
+	ir_node *const end_block = get_irg_end_block(func->irg);
+	ir_node      **in        = ALLOCAN(ir_node*, n_used + 1);
+	foreach_irn_in(end_block, p, ret) {
+		if (!is_Return(ret))
+			continue;
+		size_t n_in = 0;
+		in[n_in++] = get_Return_mem(ret);
+		for (size_t i = 0, n = get_Return_n_ress(ret); i < n; ++i) {
+			if (used[i])
+				in[n_in++] = get_Return_res(ret, i);
+		}
+		set_irn_in(ret, n_in, in);
+	}
+}
+
+static void remove_unused_from_call(ir_node *const call, ir_type *const mtp,
+                                    bool const *const used_params,
+                                    bool const *const used_ress,
+                                    size_t const *const res_map)
+{
+	size_t    const n_params = get_Call_n_params(call);
+	ir_node **const in       = ALLOCAN(ir_node*, n_params + n_Call_max + 1);
+	size_t          n_in     = 0;
+	in[n_in++] = get_Call_mem(call);
+	in[n_in++] = get_Call_ptr(call);
+	for (size_t i = 0; i < n_params; ++i) {
+		if (used_params[i])
+			in[n_in++] = get_Call_param(call, i);
+	}
+	set_irn_in(call, n_in, in);
+	set_Call_type(call, mtp);
+
+	ir_node *const tuple = get_Call_result_tuple(call);
+	if (tuple != NULL)
+		renumber_projs(tuple, used_ress, res_map);
+}
+
+/**
+ * Removes the parameters and results of @p func, which are not used anymore.
+ * Returns true if any was removed.
+ */
+static bool remove_dead_params_and_results(ip_func_t const *const func)
+{
+	ir_type *const mtp      = get_entity_type(func->entity);
+	size_t   const n_params = get_method_n_params(mtp);
+	size_t   const n_ress   = get_method_n_ress(mtp);
+
+	bool *const used_params = ALLOCANZ(bool, n_params);
+	mark_used_params(func, used_params);
+	bool *const used_ress = ALLOCANZ(bool, n_ress);
+	mark_used_results(func, used_ress);
+
+	size_t *const param_map     = ALLOCAN(size_t, n_params);
+	size_t  const n_used_params = compute_map(n_params, used_params, param_map);
+	size_t *const res_map       = ALLOCAN(size_t, n_ress);
+	size_t  const n_used_ress   = compute_map(n_ress, used_ress, res_map);
+	if (n_used_params == n_params && n_used_ress == n_ress)
+		return false;
+
+	DB((dbg, LEVEL_1, "%+F: removing %zu parameters and %zu results\n",
+	    func->entity, n_params - n_used_params, n_ress - n_used_ress));
+	ir_type *const new_mtp = remove_unused(mtp, used_params, n_used_params,
+	                                       used_ress, n_used_ress);
+	set_entity_type(func->entity, new_mtp);
+
+	remove_params_from_graph(func, used_params, param_map);
+	remove_results_from_returns(func, used_ress, n_used_ress);
+	for (size_t c = 0, n_calls = ARR_LEN(func->calls); c < n_calls; ++c) {
+		remove_unused_from_call(func->calls[c], new_mtp, used_params,
+		                        used_ress, res_map);
+	}
+	return true;
+}
+
+static void propagate(ip_env_t *const env)
+{
+	size_t const n_irgs = ARR_LEN(env->order);
+	bool         changed;
+	do {
+		changed = false;
+		/* Parameters flow from the callers to the callees. */
+		for (size_t i = n_irgs; i-- > 0;) {
+			ip_func_t *const func = get_func(env, get_irg_entity(env->order[i]));
+			if (func != NULL)
+				changed |= update_params(env, func);
+		}
+		/* Results flow from the callees to the callers. */
+		for (size_t i = 0; i < n_irgs; ++i) {
+			ip_func_t *const func = get_func(env, get_irg_entity(env->order[i]));
+			if (func != NULL)
+				changed |= update_results(env, func);
+		}
+	} while (changed);
+}
+
+void propagate_interprocedural(void)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.opt.ipprop");
+
+	assure_irp_globals_entity_usage_computed();
+
+	ip_env_t env;
+	obstack_init(&env.obst);
+	env.funcs = pmap_create();
+	env.order = compute_order();
+
+	foreach_irp_irg(i, irg) {
+		assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES
+		                         | IR_GRAPH_PROPERTY_NO_TUPLES);
+		ir_entity *const entity = get_irg_entity(irg);
+		if (!is_candidate(entity))
+			continue;
+		ir_type   *const mtp  = get_entity_type(entity);
+		ip_func_t *const func = OALLOCZ(&env.obst, ip_func_t);
+		func->entity  = entity;
+		func->irg     = irg;
+		func->calls   = NEW_ARR_F(ir_node*, 0);
+		func->params  = OALLOCNZ(&env.obst, ip_value_t, get_method_n_params(mtp));
+		func->results = OALLOCNZ(&env.obst, ip_value_t, get_method_n_ress(mtp));
+		pmap_insert(env.funcs, entity, func);
+	}
+	foreach_irp_irg(i, irg) {
+		irg_walk_graph(irg, NULL, collect_calls, &env);
+	}
+
+	propagate(&env);
+
+	for (size_t i = 0, n = ARR_LEN(env.order); i < n; ++i) {
+		ip_func_t *const func = get_func(&env, get_irg_entity(env.order[i]));
+		/* Functions without calls are dead, leave them alone. */
+		if (func == NULL || ARR_LEN(func->calls) == 0)
+			continue;
+		specialize_func(func);
+		remove_dead_params_and_results(func);
+	}
+
+	foreach_pmap(env.funcs, entry) {
+		ip_func_t *const func = (ip_func_t*)entry->value;
+		DEL_ARR_F(func->calls);
+	}
+	foreach_irp_irg(i, irg) {
+		confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_CONTROL_FLOW
+		                          | IR_GRAPH_PROPERTY_ONE_RETURN
+		                          | IR_GRAPH_PROPERTY_MANY_RETURNS);
+	}
+	DEL_ARR_F(env.order);
+	pmap_destroy(env.funcs);
+	obstack_free(&env.obst, NULL);
+}
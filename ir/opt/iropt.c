@@ -137,7 +137,7 @@ static ir_tarval *default_value_of(const ir_node *n)
 		return tarval_unknown;
 }
 
-value_of_func value_of_ptr = default_value_of;
+THREAD_LOCAL value_of_func value_of_ptr = default_value_of;
 
 void set_value_of_func(value_of_func func)
 {
@@ -7428,19 +7428,51 @@ handle_tv:;
 	return NULL;
 }
 
+/**
+ * Strips constant offsets, member selections and array selections with a
+ * constant index from the address @p ptr and accumulates their byte offset in
+ * @p offset.
+ */
+static ir_node *skip_const_offsets(ir_node *ptr, long *offset)
+{
+	for (;;) {
+		if (is_Add(ptr)) {
+			ir_node *right = get_Add_right(ptr);
+			if (!is_Const(right))
+				return ptr;
+			ir_tarval *tv = get_Const_tarval(right);
+			if (!tarval_is_long(tv))
+				return ptr;
+			*offset += get_tarval_long(tv);
+			ptr      = get_Add_left(ptr);
+		} else if (is_Member(ptr)) {
+			ir_entity *member = get_Member_entity(ptr);
+			if (get_type_state(get_entity_owner(member)) != layout_fixed)
+				return ptr;
+			*offset += get_entity_offset(member);
+			ptr      = get_Member_ptr(ptr);
+		} else if (is_Sel(ptr)) {
+			ir_node *index = get_Sel_index(ptr);
+			if (!is_Const(index))
+				return ptr;
+			ir_tarval *tv = get_Const_tarval(index);
+			if (!tarval_is_long(tv))
+				return ptr;
+			ir_type *el_type = get_array_element_type(get_Sel_type(ptr));
+			if (get_type_state(el_type) != layout_fixed)
+				return ptr;
+			*offset += get_tarval_long(tv) * (long)get_type_size(el_type);
+			ptr      = get_Sel_ptr(ptr);
+		} else {
+			return ptr;
+		}
+	}
+}
+
 ir_node *predict_load(ir_node *ptr, ir_mode *mode)
 {
 	long offset = 0;
-	if (is_Add(ptr)) {
-		ir_node *right = get_Add_right(ptr);
-		if (!is_Const(right))
-			return NULL;
-		ir_tarval *tv = get_Const_tarval(right);
-		if (!tarval_is_long(tv))
-			return NULL;
-		offset = get_tarval_long(tv);
-		ptr    = get_Add_left(ptr);
-	}
+	ptr = skip_const_offsets(ptr, &offset);
 	if (is_Address(ptr)) {
 		ir_entity *entity = get_Address_entity(ptr);
 		if (get_entity_kind(entity) != IR_ENTITY_NORMAL ||
@@ -8,9 +8,19 @@
  * @brief   Path-Sensitive Jump Threading
  * @date    10. Sep. 2006
  * @author  Christoph Mallon, Matthias Braun
+ *
+ * Besides constants flowing into a compare through Phis, the range of a value
+ * along a control flow edge is used: It starts with the known bits and the
+ * vrp range of the value and is narrowed by the conditions on the paths
+ * leading to the edge. This threads correlated branches like
+ * "if (x > 10) ...; if (x > 5) ...".
  */
 #include "array.h"
+#include "compiler.h"
+#include "constbits.h"
 #include "debug.h"
+#include "execfreq_t.h"
+#include "hashptr.h"
 #include "ircons.h"
 #include "iredges_t.h"
 #include "irgmod.h"
@@ -19,8 +29,9 @@
 #include "irnode_t.h"
 #include "iropt_dbg.h"
 #include "iroptimize.h"
-#include "iroptimize.h"
 #include "irtools.h"
+#include "opt_init.h"
+#include "set.h"
 #include "tv.h"
 #include "vrp.h"
 #include <assert.h>
@@ -28,6 +39,14 @@
 
 #undef AVOID_PHIB
 
+/** Maximum number of blocks walked upwards to find the range of a value. */
+#define MAX_RANGE_DEPTH  8
+/** Number of nodes, which may always be duplicated to thread an edge. */
+#define BASE_BUDGET     32
+/** Additional nodes, which may be duplicated to thread an edge carrying all
+ * executions of a block. */
+#define HOT_BUDGET      96
+
 DEBUG_ONLY(static firm_dbg_module_t *dbg;)
 
 /**
@@ -44,8 +63,8 @@ static void add_pred(ir_node *node, ir_node *x)
 	set_irn_in(node, n + 1, ins);
 }
 
-static ir_node *ssa_second_def;
-static ir_node *ssa_second_def_block;
+static THREAD_LOCAL ir_node *ssa_second_def;
+static THREAD_LOCAL ir_node *ssa_second_def_block;
 
 static ir_node *search_def_and_create_phis(ir_node *block, ir_mode *mode,
                                            bool first)
@@ -199,7 +218,22 @@ static void split_critical_edge(ir_node *block, int pos)
 	set_Block_cfgpred(block, pos, new_jmp);
 }
 
+/** A range of integer values, which is empty if min is greater than max. */
+typedef struct value_range_t {
+	ir_tarval *min;
+	ir_tarval *max;
+} value_range_t;
+
+/** The range of a value along the control flow edge left by a jump. */
+typedef struct edge_range_t {
+	ir_node      *value;
+	ir_node      *jump;
+	value_range_t range;
+	unsigned      depth; /**< the depth the range was computed with */
+} edge_range_t;
+
 typedef struct jumpthreading_env_t {
+	set          *ranges;      /**< Lazily computed ranges on edges */
 	ir_node      *true_block;  /**< Block we try to thread into */
 	ir_node      *cmp;         /**< The Compare node that might be partial
 	                                evaluated */
@@ -393,58 +427,392 @@ static ir_tarval *get_Const_or_Confirm_tarval(const ir_node *node)
 	return get_Const_tarval(node);
 }
 
-static ir_node *find_const_or_confirm(jumpthreading_env_t *env, ir_node *jump,
-                                      ir_node *value)
+static int cmp_edge_range(const void *elt, const void *key, size_t size)
 {
-	if (irn_visited_else_mark(value))
-		return NULL;
+	(void)size;
+	const edge_range_t *a = (const edge_range_t*)elt;
+	const edge_range_t *b = (const edge_range_t*)key;
+	return a->value != b->value || a->jump != b->jump;
+}
 
-	ir_node *block = get_nodes_block(jump);
-	if (is_Const_or_Confirm(value)) {
-		int evaluated = eval_cmp(env, value);
-		if (evaluated < 0)
-			return NULL;
-		/* maybe we could evaluate the condition completely without any
-		 * partial tracking along paths. */
-		assert(get_Block_n_cfgpreds(env->true_block) == 1);
-		if (block == get_Block_cfgpred_block(env->true_block, 0)) {
-			if (evaluated == 0) {
-				ir_graph *irg = get_irn_irg(block);
-				ir_node  *bad = new_r_Bad(irg, mode_X);
-				exchange(jump, bad);
-			} else if (evaluated == 1) {
-				dbg_info *dbgi = get_irn_dbg_info(skip_Proj(jump));
-				ir_node  *jmp  = new_rd_Jmp(dbgi, get_nodes_block(jump));
-				exchange(jump, jmp);
+static unsigned hash_edge_range(const edge_range_t *entry)
+{
+	return hash_combine(hash_irn(entry->value), hash_irn(entry->jump));
+}
+
+static bool is_range_mode(const ir_mode *mode)
+{
+	return mode_is_int(mode)
+	    && get_mode_arithmetic(mode) == irma_twos_complement;
+}
+
+static value_range_t empty_range(ir_mode *mode)
+{
+	return (value_range_t) {
+		.min = get_mode_max(mode),
+		.max = get_mode_min(mode),
+	};
+}
+
+static bool range_is_empty(const value_range_t *range)
+{
+	return tarval_cmp(range->min, range->max) == ir_relation_greater;
+}
+
+static ir_tarval *tarval_min(ir_tarval *a, ir_tarval *b)
+{
+	return tarval_cmp(a, b) == ir_relation_greater ? b : a;
+}
+
+static ir_tarval *tarval_max(ir_tarval *a, ir_tarval *b)
+{
+	return tarval_cmp(a, b) == ir_relation_less ? b : a;
+}
+
+static void range_intersect(value_range_t *range, ir_tarval *min,
+                            ir_tarval *max)
+{
+	range->min = tarval_max(range->min, min);
+	range->max = tarval_min(range->max, max);
+}
+
+/** Extends range to the smallest range containing range and other. */
+static void range_union(value_range_t *range, const value_range_t *other)
+{
+	if (range_is_empty(other))
+		return;
+	if (range_is_empty(range)) {
+		*range = *other;
+		return;
+	}
+	range->min = tarval_min(range->min, other->min);
+	range->max = tarval_max(range->max, other->max);
+}
+
+/** Restricts range to the values v, for which "v relation tv" holds. */
+static void range_restrict(value_range_t *range, ir_relation relation,
+                           ir_tarval *tv)
+{
+	if (range_is_empty(range))
+		return;
+	ir_mode      *mode = get_tarval_mode(tv);
+	ir_tarval    *one  = get_mode_one(mode);
+	value_range_t res  = empty_range(mode);
+	if ((relation & ir_relation_less)
+	    && tarval_cmp(range->min, tv) == ir_relation_less) {
+		value_range_t const less = {
+			.min = range->min,
+			.max = tarval_min(range->max, tarval_sub(tv, one)),
+		};
+		range_union(&res, &less);
+	}
+	if ((relation & ir_relation_equal)
+	    && !(tarval_cmp(range->min, tv) & ir_relation_greater)
+	    && !(tarval_cmp(tv, range->max) & ir_relation_greater)) {
+		value_range_t const equal = { .min = tv, .max = tv };
+		range_union(&res, &equal);
+	}
+	if ((relation & ir_relation_greater)
+	    && tarval_cmp(range->max, tv) == ir_relation_greater) {
+		value_range_t const greater = {
+			.min = tarval_max(range->min, tarval_add(tv, one)),
+			.max = range->max,
+		};
+		range_union(&res, &greater);
+	}
+	*range = res;
+}
+
+/**
+ * Returns the range of value, which holds everywhere, from the known bits and
+ * the vrp information.
+ */
+static value_range_t get_value_range(const ir_node *value)
+{
+	ir_mode      *mode  = get_irn_mode(value);
+	ir_tarval    *min   = get_mode_min(mode);
+	value_range_t range = { .min = min, .max = get_mode_max(mode) };
+	if (is_Const(value)) {
+		ir_tarval *tv = get_Const_tarval(value);
+		return (value_range_t) { .min = tv, .max = tv };
+	}
+
+	const bitinfo *b = get_bitinfo(value);
+	if (b != NULL) {
+		/* contradicting bits mean the value is never computed */
+		if (!tarval_is_null(tarval_andnot(b->o, b->z)))
+			return empty_range(mode);
+		range_intersect(&range, tarval_or(b->o, tarval_and(b->z, min)),
+		                tarval_and(b->z, tarval_ornot(b->o, min)));
+	}
+
+	const vrp_attr *vrp = vrp_get_info(value);
+	if (vrp != NULL && vrp->range_type == VRP_RANGE)
+		range_intersect(&range, vrp->range_bottom, vrp->range_top);
+
+	if (is_Confirm(value)) {
+		ir_node *bound = get_Confirm_bound(value);
+		if (is_Const(bound))
+			range_restrict(&range, get_Confirm_relation(value),
+			               get_Const_tarval(bound));
+	}
+	return range;
+}
+
+static value_range_t get_range_on_jump(jumpthreading_env_t *env,
+                                       ir_node *value, ir_node *jump,
+                                       unsigned depth);
+
+/**
+ * Returns the range of value at the end of block by combining the ranges on
+ * the edges entering the block.
+ */
+static value_range_t get_range_at_end(jumpthreading_env_t *env,
+                                      ir_node *value, ir_node *block,
+                                      unsigned depth)
+{
+	value_range_t const base = get_value_range(value);
+	if (depth == 0 || range_is_empty(&base))
+		return base;
+
+	bool const is_local = get_nodes_block(value) == block;
+	if (is_local && !is_Phi(value))
+		return base;
+
+	value_range_t range = empty_range(get_irn_mode(value));
+	for (int i = 0, n = get_Block_n_cfgpreds(block); i < n; ++i) {
+		ir_node *cfgpred = get_Block_cfgpred(block, i);
+		if (is_Bad(cfgpred))
+			continue;
+		ir_node      *pred_value = is_local ? get_Phi_pred(value, i) : value;
+		value_range_t pred_range
+			= get_range_on_jump(env, pred_value, cfgpred, depth - 1);
+		range_union(&range, &pred_range);
+	}
+	if (!range_is_empty(&range))
+		range_intersect(&range, base.min, base.max);
+	return range;
+}
+
+/**
+ * Returns the range of value on the control flow edge left by jump. The range
+ * is narrowed by the condition deciding the edge and by the ranges on the
+ * paths leading to it, which are followed up to depth blocks. The results are
+ * cached until the graph changes.
+ */
+static value_range_t get_range_on_jump(jumpthreading_env_t *env,
+                                       ir_node *value, ir_node *jump,
+                                       unsigned depth)
+{
+	edge_range_t key = { .value = value, .jump = jump };
+	unsigned const hash  = hash_edge_range(&key);
+	edge_range_t  *entry = set_find(edge_range_t, env->ranges, &key,
+	                                sizeof(key), hash);
+	if (entry != NULL && entry->depth >= depth)
+		return entry->range;
+
+	/* cycles in the control flow see the range, which holds everywhere */
+	key.range = get_value_range(value);
+	key.depth = depth;
+	if (entry == NULL)
+		entry = set_insert(edge_range_t, env->ranges, &key, sizeof(key), hash);
+	else
+		*entry = key;
+
+	ir_node      *block = get_nodes_block(jump);
+	value_range_t range = get_range_at_end(env, value, block, depth);
+	if (is_Proj(jump) && is_Cond(get_Proj_pred(jump))) {
+		ir_node *selector = get_Cond_selector(get_Proj_pred(jump));
+		if (is_Cmp(selector)) {
+			ir_node    *left     = get_Cmp_left(selector);
+			ir_node    *right    = get_Cmp_right(selector);
+			ir_relation relation = get_Cmp_relation(selector);
+			if (right == value) {
+				ir_node *t = left;
+				left       = right;
+				right      = t;
+				relation   = get_inversed_relation(relation);
+			}
+			if (left == value && is_Const(right)) {
+				if (get_Proj_num(jump) == pn_Cond_false)
+					relation = get_negated_relation(relation);
+				range_restrict(&range, relation, get_Const_tarval(right));
 			}
-			/* we need a bigger visited nr when going back */
-			env->visited_nr++;
-			return block;
 		}
-		if (evaluated <= 0)
-			return NULL;
+	}
+	entry->range = range;
+	return range;
+}
 
-		DB((dbg, LEVEL_1, "> Found jump threading candidate %+F->%+F\n",
-			block, env->true_block));
+/**
+ * Returns whether the compare evaluates to true or false for all values of a
+ * range, or can't be evaluated!
+ *
+ * @returns 1: true, 0: false, -1: can't evaluate
+ */
+static int eval_cmp_range(const jumpthreading_env_t *env,
+                          const value_range_t *range)
+{
+	if (range_is_empty(range))
+		return -1;
 
-		/* adjust true_block to point directly towards our jump */
-		add_pred(env->true_block, jump);
+	ir_tarval  *tv       = get_Const_tarval(env->cnst);
+	ir_relation possible = ir_relation_false;
+	ir_relation min_rel  = tarval_cmp(range->min, tv);
+	ir_relation max_rel  = tarval_cmp(range->max, tv);
+	if (min_rel == ir_relation_less)
+		possible |= ir_relation_less;
+	if (!(min_rel & ir_relation_greater) && !(max_rel & ir_relation_less))
+		possible |= ir_relation_equal;
+	if (max_rel == ir_relation_greater)
+		possible |= ir_relation_greater;
+
+	if ((possible & ~env->relation) == 0)
+		return 1;
+	if ((possible & env->relation) == 0)
+		return 0;
+	return -1;
+}
 
-		split_critical_edge(env->true_block, 0);
+/**
+ * Checks, whether the nodes of block may be duplicated into the predecessor
+ * block at pos. The more executions of block come from the predecessor, the
+ * more nodes may be duplicated.
+ */
+static bool may_duplicate(const ir_node *block, int pos)
+{
+	double const block_freq = get_block_execfreq(block);
+	ir_node     *pred_block = get_Block_cfgpred_block(block, pos);
+	double       weight     = 0.0;
+	if (pred_block != NULL && block_freq > 0.0)
+		weight = MIN(get_block_execfreq(pred_block) / block_freq, 1.0);
+
+	unsigned const budget  = BASE_BUDGET + (unsigned)(weight * HOT_BUDGET);
+	unsigned       n_nodes = 0;
+	foreach_out_edge(block, edge) {
+		ir_node *node = get_edge_src_irn(edge);
+		if (is_End(node) || is_Phi(node) || get_irn_mode(node) == mode_X
+		    || is_Cond(node) || is_Switch(node))
+			continue;
+		if (++n_nodes > budget) {
+			DB((dbg, LEVEL_2, "> %+F too large to thread from %+F\n",
+			    block, pred_block));
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Threads the edge left by jump towards true_block, if the compare evaluates
+ * to true on it, or decides the condition completely if jump leaves the block
+ * of the condition.
+ */
+static ir_node *thread_edge(jumpthreading_env_t *env, ir_node *jump,
+                            int evaluated)
+{
+	if (evaluated < 0)
+		return NULL;
 
+	ir_node *block = get_nodes_block(jump);
+	/* maybe we could evaluate the condition completely without any
+	 * partial tracking along paths. */
+	assert(get_Block_n_cfgpreds(env->true_block) == 1);
+	if (block == get_Block_cfgpred_block(env->true_block, 0)) {
+		if (evaluated == 0) {
+			ir_graph *irg = get_irn_irg(block);
+			ir_node  *bad = new_r_Bad(irg, mode_X);
+			exchange(jump, bad);
+		} else if (evaluated == 1) {
+			dbg_info *dbgi = get_irn_dbg_info(skip_Proj(jump));
+			ir_node  *jmp  = new_rd_Jmp(dbgi, get_nodes_block(jump));
+			exchange(jump, jmp);
+		}
 		/* we need a bigger visited nr when going back */
 		env->visited_nr++;
 		return block;
 	}
+	if (evaluated <= 0)
+		return NULL;
 
-	if (is_Phi(value)) {
-		assert(get_irn_arity(value) > 1);
+	DB((dbg, LEVEL_1, "> Found jump threading candidate %+F->%+F\n",
+		block, env->true_block));
 
-		/* the Phi has to be in the same Block as the Jmp */
-		if (get_nodes_block(value) != block)
-			return NULL;
+	/* adjust true_block to point directly towards our jump */
+	add_pred(env->true_block, jump);
+
+	split_critical_edge(env->true_block, 0);
+
+	/* we need a bigger visited nr when going back */
+	env->visited_nr++;
+	return block;
+}
+
+/**
+ * Uses the range of value to decide the condition, either completely or on
+ * the edges entering the block of the condition.
+ */
+static ir_node *find_range(jumpthreading_env_t *env, ir_node *jump,
+                           ir_node *value)
+{
+	if (!is_range_mode(get_irn_mode(value)))
+		return NULL;
+
+	ir_node *block = get_nodes_block(jump);
+	if (block != get_Block_cfgpred_block(env->true_block, 0)) {
+		value_range_t const range
+			= get_range_on_jump(env, value, jump, MAX_RANGE_DEPTH);
+		return thread_edge(env, jump, eval_cmp_range(env, &range));
+	}
+
+	value_range_t const range
+		= get_range_at_end(env, value, block, MAX_RANGE_DEPTH);
+	ir_node *const decided = thread_edge(env, jump, eval_cmp_range(env, &range));
+	if (decided != NULL || get_nodes_block(value) == block)
+		return decided;
+
+	/* the value flows through the block unchanged, so the condition might be
+	 * known on some of the edges entering it */
+	for (int i = 0, n = get_Block_n_cfgpreds(block); i < n; ++i) {
+		ir_node *cfgpred = get_Block_cfgpred(block, i);
+		if (is_Bad(cfgpred) || !may_duplicate(block, i))
+			continue;
+		value_range_t const pred_range
+			= get_range_on_jump(env, value, cfgpred, MAX_RANGE_DEPTH);
+		if (eval_cmp_range(env, &pred_range) != 1)
+			continue;
+
+		ir_node *copy_block = thread_edge(env, cfgpred, 1);
+		/* copy duplicated nodes in copy_block and fix SSA */
+		copy_and_fix(env, block, copy_block, i);
+		env->cnst_pred = block;
+		env->cnst_pos  = i;
+		return copy_block;
+	}
+	return NULL;
+}
+
+static ir_node *find_const_or_confirm(jumpthreading_env_t *env, ir_node *jump,
+                                      ir_node *value)
+{
+	if (irn_visited_else_mark(value))
+		return NULL;
+
+	if (is_Const_or_Confirm(value)) {
+		ir_node *copy_block = thread_edge(env, jump, eval_cmp(env, value));
+		if (copy_block != NULL || !is_Confirm(value))
+			return copy_block;
+		return find_range(env, jump, value);
+	}
+
+	/* the Phi has to be in the same Block as the Jmp */
+	ir_node *block = get_nodes_block(jump);
+	if (is_Phi(value) && get_nodes_block(value) == block) {
+		assert(get_irn_arity(value) > 1);
 
 		foreach_irn_in(value, i, phi_pred) {
+			if (!may_duplicate(block, i))
+				continue;
 			ir_node *cfgpred    = get_Block_cfgpred(block, i);
 			ir_node *copy_block = find_const_or_confirm(env, cfgpred, phi_pred);
 			if (copy_block == NULL)
@@ -462,7 +830,7 @@ static ir_node *find_const_or_confirm(jumpthreading_env_t *env, ir_node *jump,
 		}
 	}
 
-	return NULL;
+	return find_range(env, jump, value);
 }
 
 static ir_node *find_candidate(jumpthreading_env_t *env, ir_node *jump,
@@ -495,6 +863,8 @@ static ir_node *find_candidate(jumpthreading_env_t *env, ir_node *jump,
 			return NULL;
 
 		foreach_irn_in(value, i, phi_pred) {
+			if (!may_duplicate(block, i))
+				continue;
 			ir_node *cfgpred    = get_Block_cfgpred(block, i);
 			ir_node *copy_block = find_candidate(env, cfgpred, phi_pred);
 			if (copy_block == NULL)
@@ -529,8 +899,9 @@ static ir_node *find_candidate(jumpthreading_env_t *env, ir_node *jump,
 
 		if (!is_Const(right))
 			return NULL;
-		if (get_nodes_block(left) != block)
-			return NULL;
+		/* left may come from another block: A Const or Confirm holds in all
+		 * blocks dominated by its definition and find_range() uses the ranges
+		 * of values, which flow through the block unchanged. */
 		/* negate condition when we're looking for the false block */
 		if (env->tv == tarval_b_false)
 			relation = get_negated_relation(relation);
@@ -545,10 +916,15 @@ static ir_node *find_candidate(jumpthreading_env_t *env, ir_node *jump,
 	return NULL;
 }
 
+typedef struct thread_jumps_env_t {
+	set  *ranges;
+	bool  changed;
+} thread_jumps_env_t;
+
 /**
  * Block-walker: searches for the following construct
  *
- *  Const or Phi with constants
+ *  Const or Phi with constants or a value with a known range on some paths
  *           |
  *          Cmp
  *           |
@@ -560,7 +936,7 @@ static ir_node *find_candidate(jumpthreading_env_t *env, ir_node *jump,
  */
 static void thread_jumps(ir_node* block, void* data)
 {
-	bool *changed = (bool*)data;
+	thread_jumps_env_t *walk_env = (thread_jumps_env_t*)data;
 
 	/* we do not deal with Phis, so restrict this to exactly one cfgpred */
 	if (get_Block_n_cfgpreds(block) != 1)
@@ -590,11 +966,12 @@ static void thread_jumps(ir_node* block, void* data)
 			[pn_Cond_true]  = is_true ? jmp : bad,
 		};
 		turn_into_tuple(cond, ARRAY_SIZE(in), in);
-		*changed = true;
+		walk_env->changed = true;
 		return;
 	}
 	inc_irg_visited(irg);
 	jumpthreading_env_t env;
+	env.ranges     = walk_env->ranges;
 	env.cnst_pred  = NULL;
 	env.tv         = get_Proj_num(projx) == pn_Cond_false
 	                 ? tarval_b_false : tarval_b_true;
@@ -626,35 +1003,76 @@ static void thread_jumps(ir_node* block, void* data)
 			}
 		}
 
+		/* the executions coming from the predecessor now run its copy */
+		ir_node *const pred_block = get_Block_cfgpred_block(env.cnst_pred,
+		                                                    cnst_pos);
+		double const freq = get_block_execfreq(env.cnst_pred);
+		if (pred_block != NULL) {
+			double const edge_freq = MIN(get_block_execfreq(pred_block), freq);
+			set_block_execfreq(env.cnst_pred, freq - edge_freq);
+		}
+
 		set_Block_cfgpred(env.cnst_pred, cnst_pos, badX);
 	}
 
-	/* the graph is changed now */
-	*changed = true;
+	/* the graph is changed now, so the cached ranges are not valid anymore */
+	walk_env->changed = true;
+	del_set(walk_env->ranges);
+	walk_env->ranges = new_set(cmp_edge_range, 16);
+}
+
+/**
+ * Block-walker: Checks whether the condition entering block may be threaded
+ * using a Phi or a compare with a constant, which need the analyses.
+ */
+static void find_threadable_cond(ir_node *block, void *data)
+{
+	bool *found = (bool*)data;
+	for (int i = 0, n = get_Block_n_cfgpreds(block); i < n && !*found; ++i) {
+		ir_node *projx = get_Block_cfgpred(block, i);
+		if (!is_Proj(projx) || !is_Cond(get_Proj_pred(projx)))
+			continue;
+
+		ir_node *selector = get_Cond_selector(get_Proj_pred(projx));
+		if (is_Phi(selector))
+			*found = true;
+		else if (is_Cmp(selector))
+			*found = is_Const(get_Cmp_left(selector))
+			      || is_Const(get_Cmp_right(selector));
+	}
 }
 
 void opt_jumpthreading(ir_graph* irg)
 {
+	/* Only conditions, which may be threaded, need the known bits and the
+	 * frequencies weighting the duplication budget of the edges. */
+	bool threadable = false;
+	irg_block_walk_graph(irg, find_threadable_cond, NULL, &threadable);
+	if (threadable)
+		ir_estimate_execfreq(irg);
 	assure_irg_properties(irg,
 		IR_GRAPH_PROPERTY_NO_UNREACHABLE_CODE
 		| IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES
 		| IR_GRAPH_PROPERTY_NO_CRITICAL_EDGES);
 
-	FIRM_DBG_REGISTER(dbg, "firm.opt.jumpthreading");
-
 	DB((dbg, LEVEL_1, "===> Performing jumpthreading on %+F\n", irg));
 
+	if (threadable)
+		constbits_analyze(irg);
 	ir_reserve_resources(irg, IR_RESOURCE_IRN_LINK | IR_RESOURCE_IRN_VISITED);
 
+	thread_jumps_env_t env = { .ranges = new_set(cmp_edge_range, 16) };
 	bool changed = false;
-	bool rerun;
 	do {
-		rerun = false;
-		irg_block_walk_graph(irg, thread_jumps, NULL, &rerun);
-		changed |= rerun;
-	} while (rerun);
+		env.changed = false;
+		irg_block_walk_graph(irg, thread_jumps, NULL, &env);
+		changed |= env.changed;
+	} while (env.changed);
+	del_set(env.ranges);
 
 	ir_free_resources(irg, IR_RESOURCE_IRN_LINK | IR_RESOURCE_IRN_VISITED);
+	if (threadable)
+		constbits_clear(irg);
 
 	if (changed) {
 		/* we tend to produce a lot of duplicated keep edges, remove them */
@@ -664,3 +1082,8 @@ void opt_jumpthreading(ir_graph* irg)
 		confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_ALL);
 	}
 }
+
+void firm_init_jumpthreading(void)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.opt.jumpthreading");
+}
@@ -10,6 +10,7 @@
  */
 #include "lcssa_t.h"
 #include "irtools.h"
+#include "opt_init.h"
 #include "xmalloc.h"
 #include "debug.h"
 #include <stdbool.h>
@@ -179,7 +180,6 @@ static void verify_lcssa(ir_graph *const irg)
 
 void assure_lcssa(ir_graph *const irg)
 {
-	FIRM_DBG_REGISTER(dbg, "firm.opt.lcssa");
 	assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_LOOPINFO | IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE);
 	ir_reserve_resources(irg, IR_RESOURCE_IRN_LINK);
 	irg_walk_graph(irg, firm_clear_link, NULL, NULL);
@@ -190,7 +190,6 @@ void assure_lcssa(ir_graph *const irg)
 
 void assure_loop_lcssa(ir_graph *const irg, ir_loop *const loop)
 {
-	FIRM_DBG_REGISTER(dbg, "firm.opt.lcssa");
 	assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_LOOPINFO | IR_GRAPH_PROPERTY_CONSISTENT_OUTS | IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE);
 	inc_irg_visited(irg);
 	ir_reserve_resources(irg, IR_RESOURCE_IRN_LINK);
@@ -199,3 +198,8 @@ void assure_loop_lcssa(ir_graph *const irg, ir_loop *const loop)
 	ir_free_resources(irg, IR_RESOURCE_IRN_LINK);
 	clear_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_LOOPINFO | IR_GRAPH_PROPERTY_CONSISTENT_OUTS | IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE);
 }
+
+void firm_init_lcssa(void)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.opt.lcssa");
+}
@@ -9,6 +9,7 @@
  * @author  Michael Beck
  */
 #include "array.h"
+#include "compiler.h"
 #include "dbginfo_t.h"
 #include "debug.h"
 #include "entity_t.h"
@@ -28,6 +29,7 @@
 #include "iropt_t.h"
 #include "iroptimize.h"
 #include "irtools.h"
+#include "opt_init.h"
 #include "panic.h"
 #include "set.h"
 #include "target_t.h"
@@ -94,7 +96,7 @@ typedef struct block_info_t {
 } block_info_t;
 
 /** the master visited flag for loop detection. */
-static unsigned master_visited;
+static THREAD_LOCAL unsigned master_visited;
 
 #define INC_MASTER()       ++master_visited
 #define MARK_NODE(info)    (info)->visited = master_visited
@@ -2303,8 +2305,6 @@ void optimize_load_store(ir_graph *irg)
 	                         | IR_GRAPH_PROPERTY_CONSISTENT_POSTDOMINANCE
 	                         | IR_GRAPH_PROPERTY_CONSISTENT_ENTITY_USAGE);
 
-	FIRM_DBG_REGISTER(dbg, "firm.opt.ldstopt");
-
 	assert(get_irg_pinned(irg) != op_pin_state_floats);
 
 	const ir_disambiguator_options opts =
@@ -2344,3 +2344,8 @@ void optimize_load_store(ir_graph *irg)
 		| IR_GRAPH_PROPERTY_CONSISTENT_ENTITY_USAGE
 		| IR_GRAPH_PROPERTY_MANY_RETURNS);
 }
+
+void firm_init_ldstopt(void)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.opt.ldstopt");
+}
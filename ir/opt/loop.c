@@ -11,6 +11,7 @@
  */
 
 #include "array.h"
+#include "compiler.h"
 #include "debug.h"
 #include "irbackedge_t.h"
 #include "ircons_t.h"
@@ -44,7 +45,7 @@ DEBUG_ONLY(static firm_dbg_module_t *dbg;)
 	for (ir_node *phi = get_Block_phis((block)), *next = NULL; phi ? next = get_Phi_next(phi), true : false; phi = next)
 
 /* Currently processed loop. */
-static ir_loop *cur_loop;
+static THREAD_LOCAL ir_loop *cur_loop;
 
 /* Flag for kind of unrolling. */
 typedef enum unrolling_kind_flag {
@@ -68,14 +69,14 @@ typedef struct unrolling_node_info {
 } unrolling_node_info;
 
 /* Outs of the nodes head. */
-static entry_edge *cur_head_outs;
+static THREAD_LOCAL entry_edge *cur_head_outs;
 
 /* Information about the loop head */
-static ir_node *loop_head       = NULL;
-static bool     loop_head_valid = true;
+static THREAD_LOCAL ir_node *loop_head       = NULL;
+static THREAD_LOCAL bool     loop_head_valid = true;
 
 /* List of all inner loops, that are processed. */
-static ir_loop **loops;
+static THREAD_LOCAL ir_loop **loops;
 
 /* Stats */
 typedef struct loop_stats_t {
@@ -93,7 +94,7 @@ typedef struct loop_stats_t {
 	unsigned unhandled;
 } loop_stats_t;
 
-static loop_stats_t stats;
+static THREAD_LOCAL loop_stats_t stats;
 
 /* Set stats to sero */
 static void reset_stats(void)
@@ -133,7 +134,7 @@ typedef struct loop_opt_params_t {
 	unsigned invar_unrolling_min_size;  /* [nodes] */
 } loop_opt_params_t;
 
-static loop_opt_params_t opt_params;
+static THREAD_LOCAL loop_opt_params_t opt_params;
 
 /* Loop analysis informations */
 typedef struct loop_info_t {
@@ -165,24 +166,24 @@ typedef struct loop_info_t {
 } loop_info_t;
 
 /* Information about the current loop */
-static loop_info_t loop_info;
+static THREAD_LOCAL loop_info_t loop_info;
 
 /* Outs of the condition chain (loop inversion). */
-static ir_node **cc_blocks;
+static THREAD_LOCAL ir_node **cc_blocks;
 /* Array of df loops found in the condition chain. */
-static entry_edge *head_df_loop;
+static THREAD_LOCAL entry_edge *head_df_loop;
 /* Number of blocks in cc */
-static unsigned inversion_blocks_in_cc;
+static THREAD_LOCAL unsigned inversion_blocks_in_cc;
 
 
 /* Cf/df edges leaving the loop.
  * Called entries here, as they are used to enter the loop with walkers. */
-static entry_edge *loop_entries;
+static THREAD_LOCAL entry_edge *loop_entries;
 /* Number of unrolls to perform */
-static int unroll_nr;
+static THREAD_LOCAL int unroll_nr;
 /* Phase is used to keep copies of nodes. */
-static ir_nodemap     map;
-static struct obstack obst;
+static THREAD_LOCAL ir_nodemap     map;
+static THREAD_LOCAL struct obstack obst;
 
 /* Loop operations.  */
 typedef enum loop_op_t {
@@ -303,8 +304,8 @@ static void get_loop_entries(ir_node *const node, void *const env)
 }
 
 /* ssa */
-static ir_node *ssa_second_def;
-static ir_node *ssa_second_def_block;
+static THREAD_LOCAL ir_node *ssa_second_def;
+static THREAD_LOCAL ir_node *ssa_second_def_block;
 
 /**
  * Walks the graph bottom up, searching for definitions and creates phis.
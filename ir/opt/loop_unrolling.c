@@ -8,8 +8,10 @@
  * @brief   loop unrolling using LCSSA form
  * @author  Elias Aebi
  */
+#include "compiler.h"
 #include "lcssa_t.h"
 #include "irtools.h"
+#include "opt_init.h"
 #include "xmalloc.h"
 #include "debug.h"
 #include <assert.h>
@@ -531,7 +533,7 @@ static void rewire_fully_unrolled(ir_loop *const loop, ir_node *header, unsigned
 	DB((dbg, LEVEL_2, "fully unrolled loop %+F\n", loop));
 }
 
-static unsigned n_loops_unrolled = 0;
+static THREAD_LOCAL unsigned n_loops_unrolled = 0;
 
 static void unroll_loop(ir_loop *const loop, unsigned factor)
 {
@@ -622,7 +624,6 @@ static void duplicate_innermost_loops(ir_loop *const loop, unsigned const factor
 
 void unroll_loops(ir_graph *const irg, unsigned factor, unsigned maxsize)
 {
-	FIRM_DBG_REGISTER(dbg, "firm.opt.loop-unrolling");
 	n_loops_unrolled = 0;
 	assure_lcssa(irg);
 	assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_LOOPINFO | IR_GRAPH_PROPERTY_CONSISTENT_OUTS | IR_GRAPH_PROPERTY_NO_BADS | IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE);
@@ -632,3 +633,8 @@ void unroll_loops(ir_graph *const irg, unsigned factor, unsigned maxsize)
 	clear_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE | IR_GRAPH_PROPERTY_CONSISTENT_LOOPINFO);
 	DB((dbg, LEVEL_1, "%+F: %d loops unrolled\n", irg, n_loops_unrolled));
 }
+
+void firm_init_loop_unrolling(void)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.opt.loop-unrolling");
+}
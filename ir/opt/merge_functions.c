@@ -0,0 +1,616 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Merging of identical functions.
+ *
+ * Every graph gets a structural hash computed over its nodes in walk order.
+ * Functions with the same hash and the same method type are compared by
+ * walking both graphs in parallel from their End nodes, which establishes a
+ * one-to-one mapping of their nodes. References to the function itself
+ * and to entities of the frame only need to correspond to each other.
+ *
+ * A duplicate is removed and all references to it are redirected to the
+ * remaining function, unless this could make the addresses of two functions
+ * compare equal when the program relies on them being different. Externally
+ * visible duplicates are replaced by an alias entity or, when the address
+ * must stay unique, their graph is replaced by a call of the remaining
+ * function. Redirecting the references may make callers identical, so this
+ * is repeated until no more functions are merged.
+ */
+#include <stdlib.h>
+
+#include "array.h"
+#include "debug.h"
+#include "entity_t.h"
+#include "hashptr.h"
+#include "ircons.h"
+#include "irgraph_t.h"
+#include "irgwalk.h"
+#include "irmemory.h"
+#include "irnode_t.h"
+#include "irop_t.h"
+#include "iroptimize.h"
+#include "irprog_t.h"
+#include "irtools.h"
+#include "pmap.h"
+#include "pset_new.h"
+#include "type_t.h"
+#include "util.h"
+
+DEBUG_ONLY(static firm_dbg_module_t *dbg;)
+
+/**
+ * A duplicate is only replaced by a call if it has more nodes than this. The
+ * backends do not turn every such call into a jump, e.g. ia32 keeps the call
+ * if a parameter is passed on the stack.
+ */
+#define THUNK_MIN_NODES 32
+
+typedef struct func_t {
+	ir_entity *entity;
+	ir_graph  *irg;
+	unsigned   hash;
+	unsigned   n_nodes;
+	bool       merged;
+} func_t;
+
+typedef struct merge_env_t {
+	pmap       *replacements; /**< maps removed entities to their replacement */
+	pset_new_t  thunks;       /**< functions replaced by a call */
+	bool        use_aliases;
+} merge_env_t;
+
+typedef struct hash_env_t {
+	ir_graph *irg;
+	unsigned  hash;
+	unsigned  n_nodes;
+} hash_env_t;
+
+static bool is_frame_entity(ir_graph *const irg,
+                            ir_entity const *const entity)
+{
+	return get_entity_owner(entity) == get_irg_frame_type(irg);
+}
+
+static void hash_node(ir_node *const node, void *const data)
+{
+	hash_env_t *const env  = (hash_env_t*)data;
+	unsigned          hash = hash_combine(env->hash, get_irn_opcode(node));
+	hash = hash_combine(hash, hash_ptr(get_irn_mode(node)));
+	hash = hash_combine(hash, get_irn_arity(node));
+
+	switch (get_irn_opcode(node)) {
+	case iro_Const:
+		hash = hash_combine(hash, hash_ptr(get_Const_tarval(node)));
+		break;
+	case iro_Proj:
+		hash = hash_combine(hash, get_Proj_num(node));
+		break;
+	case iro_Cmp:
+		hash = hash_combine(hash, get_Cmp_relation(node));
+		break;
+	case iro_Address: {
+		/* Recursive calls refer to different entities in equal functions. */
+		ir_entity *const entity = get_Address_entity(node);
+		if (entity != get_irg_entity(env->irg))
+			hash = hash_combine(hash, hash_ptr(entity));
+		break;
+	}
+	case iro_Member: {
+		ir_entity *const entity = get_Member_entity(node);
+		if (!is_frame_entity(env->irg, entity))
+			hash = hash_combine(hash, hash_ptr(entity));
+		break;
+	}
+	default:
+		break;
+	}
+
+	env->hash = hash;
+	++env->n_nodes;
+}
+
+static void compute_hash(func_t *const func)
+{
+	hash_env_t env = { .irg = func->irg, .hash = 0, .n_nodes = 0 };
+	irg_walk_graph(func->irg, NULL, hash_node, &env);
+	func->hash    = env.hash;
+	func->n_nodes = env.n_nodes;
+}
+
+static bool method_types_equal(ir_type const *const a, ir_type const *const b)
+{
+	if (a == b)
+		return true;
+	size_t const n_params  = get_method_n_params(a);
+	size_t const n_results = get_method_n_ress(a);
+	if (n_params  != get_method_n_params(b)
+	 || n_results != get_method_n_ress(b)
+	 || is_method_variadic(a) != is_method_variadic(b)
+	 || get_method_calling_convention(a) != get_method_calling_convention(b)
+	 || get_method_additional_properties(a)
+	    != get_method_additional_properties(b))
+		return false;
+	for (size_t i = 0; i < n_params; ++i) {
+		if (get_method_param_type(a, i) != get_method_param_type(b, i))
+			return false;
+	}
+	for (size_t i = 0; i < n_results; ++i) {
+		if (get_method_res_type(a, i) != get_method_res_type(b, i))
+			return false;
+	}
+	return true;
+}
+
+typedef struct compare_env_t {
+	func_t const  *a;
+	func_t const  *b;
+	pmap          *frame_map; /**< maps frame entities in both directions */
+	ir_node      **worklist;  /**< pairs of nodes still to compare */
+} compare_env_t;
+
+static bool entities_equivalent(compare_env_t *const env,
+                                ir_entity *const a, ir_entity *const b)
+{
+	bool const a_self = a == env->a->entity;
+	bool const b_self = b == env->b->entity;
+	if (a_self || b_self)
+		return a_self && b_self;
+
+	bool const a_frame = is_frame_entity(env->a->irg, a);
+	bool const b_frame = is_frame_entity(env->b->irg, b);
+	if (!a_frame || !b_frame)
+		return !a_frame && !b_frame && a == b;
+
+	ir_entity *const mapped = pmap_get(ir_entity, env->frame_map, a);
+	if (mapped != NULL)
+		return mapped == b;
+	if (pmap_contains(env->frame_map, b)
+	 || get_entity_type(a) != get_entity_type(b)
+	 || get_entity_alignment(a) != get_entity_alignment(b)
+	 || is_parameter_entity(a) != is_parameter_entity(b)
+	 || (is_parameter_entity(a)
+	     && get_entity_parameter_number(a) != get_entity_parameter_number(b)))
+		return false;
+	pmap_insert(env->frame_map, a, b);
+	pmap_insert(env->frame_map, b, a);
+	return true;
+}
+
+static bool switch_tables_equal(ir_node const *const a, ir_node const *const b)
+{
+	if (get_Switch_n_outs(a) != get_Switch_n_outs(b))
+		return false;
+	ir_switch_table const *const ta = get_Switch_table(a);
+	ir_switch_table const *const tb = get_Switch_table(b);
+	size_t const n_entries = ir_switch_table_get_n_entries(ta);
+	if (n_entries != ir_switch_table_get_n_entries(tb))
+		return false;
+	for (size_t i = 0; i < n_entries; ++i) {
+		if (ir_switch_table_get_min(ta, i) != ir_switch_table_get_min(tb, i)
+		 || ir_switch_table_get_max(ta, i) != ir_switch_table_get_max(tb, i)
+		 || ir_switch_table_get_pn(ta, i)  != ir_switch_table_get_pn(tb, i))
+			return false;
+	}
+	return true;
+}
+
+/**
+ * Compares two nodes without their inputs.
+ */
+static bool nodes_equivalent(compare_env_t *const env,
+                             ir_node const *const a, ir_node const *const b)
+{
+	ir_op *const op = get_irn_op(a);
+	if (op != get_irn_op(b)
+	 || get_irn_mode(a) != get_irn_mode(b)
+	 || get_irn_arity(a) != get_irn_arity(b)
+	 || get_irn_pinned(a) != get_irn_pinned(b)
+	 || (is_fragile_op(a) && ir_throws_exception(a) != ir_throws_exception(b)))
+		return false;
+
+	switch (get_irn_opcode(a)) {
+	case iro_Address:
+		return entities_equivalent(env, get_Address_entity(a),
+		                           get_Address_entity(b));
+	case iro_Member:
+		return entities_equivalent(env, get_Member_entity(a),
+		                           get_Member_entity(b));
+	case iro_Call:
+		/* Call types are often created per call site. */
+		return method_types_equal(get_Call_type(a), get_Call_type(b));
+	case iro_Block:
+		/* Labels are not compared across functions. */
+		return get_Block_entity(a) == NULL && get_Block_entity(b) == NULL;
+	case iro_Phi:
+		if (get_Phi_loop(a) != get_Phi_loop(b))
+			return false;
+		break;
+	case iro_Cond:
+		return get_Cond_jmp_pred(a) == get_Cond_jmp_pred(b);
+	case iro_Switch:
+		return switch_tables_equal(a, b);
+	default:
+		break;
+	}
+	return op->ops.attrs_equal(a, b);
+}
+
+/**
+ * Maps the node @p a of the first graph to @p b of the second graph.
+ * Returns false if one of them is already mapped to another node.
+ */
+static bool map_nodes(compare_env_t *const env, ir_node *const a,
+                      ir_node *const b)
+{
+	ir_node *const a_link = (ir_node*)get_irn_link(a);
+	ir_node *const b_link = (ir_node*)get_irn_link(b);
+	if (a_link != NULL || b_link != NULL)
+		return a_link == b && b_link == a;
+
+	set_irn_link(a, b);
+	set_irn_link(b, a);
+	ARR_APP1(ir_node*, env->worklist, a);
+	ARR_APP1(ir_node*, env->worklist, b);
+	return true;
+}
+
+/**
+ * Checks whether the attributes of the function entities @p a and @p b, which
+ * are kept when one of them is removed, agree. The owner is the section of a
+ * function.
+ */
+static bool entity_attributes_equal(ir_entity const *const a,
+                                    ir_entity const *const b)
+{
+	return get_entity_owner(a) == get_entity_owner(b)
+	    && get_entity_alignment(a) == get_entity_alignment(b)
+	    && get_entity_visibility(a) == get_entity_visibility(b)
+	    && get_entity_linkage(a) == get_entity_linkage(b)
+	    && get_entity_additional_properties(a)
+	       == get_entity_additional_properties(b);
+}
+
+static bool graphs_equivalent(func_t const *const a, func_t const *const b)
+{
+	if (a->hash != b->hash || a->n_nodes != b->n_nodes
+	 || !method_types_equal(get_entity_type(a->entity),
+	                        get_entity_type(b->entity))
+	 || !entity_attributes_equal(a->entity, b->entity))
+		return false;
+
+	compare_env_t env = {
+		.a         = a,
+		.b         = b,
+		.frame_map = pmap_create(),
+		.worklist  = NEW_ARR_F(ir_node*, 0),
+	};
+	ir_reserve_resources(a->irg, IR_RESOURCE_IRN_LINK);
+	ir_reserve_resources(b->irg, IR_RESOURCE_IRN_LINK);
+	irg_walk_graph(a->irg, firm_clear_link, NULL, NULL);
+	irg_walk_graph(b->irg, firm_clear_link, NULL, NULL);
+
+	bool equivalent = map_nodes(&env, get_irg_end(a->irg), get_irg_end(b->irg));
+	while (equivalent && ARR_LEN(env.worklist) > 0) {
+		size_t   const len = ARR_LEN(env.worklist);
+		ir_node *const na  = env.worklist[len - 2];
+		ir_node *const nb  = env.worklist[len - 1];
+		ARR_SHRINKLEN(env.worklist, len - 2);
+		if (!nodes_equivalent(&env, na, nb)) {
+			equivalent = false;
+			break;
+		}
+		if (!is_Block(na)
+		 && !map_nodes(&env, get_nodes_block(na), get_nodes_block(nb))) {
+			equivalent = false;
+			break;
+		}
+		foreach_irn_in(na, i, pred) {
+			if (!map_nodes(&env, pred, get_irn_n(nb, i))) {
+				equivalent = false;
+				break;
+			}
+		}
+	}
+
+	ir_free_resources(b->irg, IR_RESOURCE_IRN_LINK);
+	ir_free_resources(a->irg, IR_RESOURCE_IRN_LINK);
+	DEL_ARR_F(env.worklist);
+	pmap_destroy(env.frame_map);
+	return equivalent;
+}
+
+/**
+ * Checks whether a program may observe that @p entity has the same address
+ * as another function.
+ */
+static bool has_identity(ir_entity const *const entity)
+{
+	if (get_entity_linkage(entity) & IR_LINKAGE_NO_IDENTITY)
+		return false;
+	return entity_is_externally_visible(entity)
+	    || (get_entity_usage(entity) & ir_usage_address_taken);
+}
+
+static bool can_replace_by_thunk(func_t const *const func)
+{
+	ir_type const *const type = get_entity_type(func->entity);
+	if (is_method_variadic(type))
+		return false;
+	size_t const n_params  = get_method_n_params(type);
+	size_t const n_results = get_method_n_ress(type);
+	for (size_t i = 0; i < n_params; ++i) {
+		if (get_type_mode(get_method_param_type(type, i)) == NULL)
+			return false;
+	}
+	for (size_t i = 0; i < n_results; ++i) {
+		if (get_type_mode(get_method_res_type(type, i)) == NULL)
+			return false;
+	}
+	return func->n_nodes > THUNK_MIN_NODES;
+}
+
+/**
+ * Replaces the graph of @p func by a call of @p target passing all
+ * parameters and returning all results.
+ */
+static void replace_by_thunk(func_t *const func, ir_entity *const target)
+{
+	ir_entity *const entity = func->entity;
+	free_ir_graph(func->irg);
+
+	ir_type  *const type      = get_entity_type(entity);
+	size_t    const n_params  = get_method_n_params(type);
+	size_t    const n_results = get_method_n_ress(type);
+	ir_graph *const irg       = new_ir_graph(entity, 0);
+	ir_node  *const block     = get_r_cur_block(irg);
+	ir_node  *const args      = get_irg_args(irg);
+	ir_node **const in        = ALLOCAN(ir_node*, n_params);
+	for (size_t i = 0; i < n_params; ++i) {
+		ir_mode *const mode = get_type_mode(get_method_param_type(type, i));
+		in[i] = new_r_Proj(args, mode, i);
+	}
+	ir_node *const mem    = get_irg_initial_mem(irg);
+	ir_node *const callee = new_r_Address(irg, target);
+	ir_node *const call   = new_r_Call(block, mem, callee, n_params, in,
+	                                   get_entity_type(target));
+	ir_node *const call_mem = new_r_Proj(call, mode_M, pn_Call_M);
+	ir_node *const call_res = new_r_Proj(call, mode_T, pn_Call_T_result);
+	ir_node **const res     = ALLOCAN(ir_node*, n_results);
+	for (size_t i = 0; i < n_results; ++i) {
+		ir_mode *const mode = get_type_mode(get_method_res_type(type, i));
+		res[i] = new_r_Proj(call_res, mode, i);
+	}
+	ir_node *const ret = new_r_Return(block, call_mem, n_results, res);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+	irg_finalize_cons(irg);
+
+	func->irg = irg;
+}
+
+/**
+ * Removes the duplicate @p func of @p target. Returns false if the duplicate
+ * must be kept.
+ */
+static bool merge_function(merge_env_t *const env, func_t *const func,
+                           func_t const *const target)
+{
+	ir_entity *const entity     = func->entity;
+	ir_entity *const target_ent = target->entity;
+	if (has_identity(entity) && has_identity(target_ent)) {
+		if (!can_replace_by_thunk(func))
+			return false;
+		DB((dbg, LEVEL_1, "replacing %+F by a call of %+F\n", entity,
+		    target_ent));
+		replace_by_thunk(func, target_ent);
+		pset_new_insert(&env->thunks, entity);
+		return true;
+	}
+
+	bool const external = entity_is_externally_visible(entity);
+	if (external && !env->use_aliases)
+		return false;
+
+	DB((dbg, LEVEL_1, "merging %+F into %+F\n", entity, target_ent));
+	ir_entity_usage usage
+		= get_entity_usage(target_ent) | get_entity_usage(entity);
+	/* An alias makes the target reachable under the name of the duplicate. */
+	if (external)
+		usage = ir_usage_unknown;
+	set_entity_usage(target_ent, usage);
+	pmap_insert(env->replacements, entity, target_ent);
+	return true;
+}
+
+/**
+ * Frees the duplicate @p entity and replaces it by an alias of @p target if
+ * it is externally visible.
+ */
+static void remove_function(ir_entity *const entity, ir_entity *const target)
+{
+	free_ir_graph(get_entity_irg(entity));
+	if (!entity_is_externally_visible(entity)) {
+		free_entity(entity);
+		return;
+	}
+
+	ir_type       *const owner      = get_entity_owner(entity);
+	ident         *const name       = get_entity_ident(entity);
+	ident         *const ld_name    = get_entity_ld_ident(entity);
+	ir_type       *const type       = get_entity_type(entity);
+	ir_visibility  const visibility = get_entity_visibility(entity);
+	ir_linkage     const linkage    = get_entity_linkage(entity);
+	dbg_info      *const dbgi       = get_entity_dbg_info(entity);
+	/* The alias takes over the name, which must be unique. */
+	free_entity(entity);
+
+	ir_entity *const alias
+		= new_alias_entity(owner, name, target, type, visibility);
+	set_entity_ld_ident(alias, ld_name);
+	set_entity_linkage(alias, linkage);
+	set_entity_dbg_info(alias, dbgi);
+}
+
+static ir_entity *get_replacement(merge_env_t const *const env,
+                                  ir_entity *const entity)
+{
+	return pmap_get(ir_entity, env->replacements, entity);
+}
+
+static void redirect_inputs(ir_node *const node, void *const data)
+{
+	merge_env_t const *const env = (merge_env_t const*)data;
+	foreach_irn_in(node, i, pred) {
+		if (!is_Address(pred))
+			continue;
+		ir_entity *const replacement
+			= get_replacement(env, get_Address_entity(pred));
+		if (replacement != NULL)
+			set_irn_n(node, i, new_r_Address(get_irn_irg(pred), replacement));
+	}
+}
+
+static void redirect_initializer(merge_env_t *const env,
+                                 ir_initializer_t *const initializer)
+{
+	switch (initializer->kind) {
+	case IR_INITIALIZER_CONST: {
+		ir_node *const value = initializer->consti.value;
+		if (is_Address(value)) {
+			ir_entity *const replacement
+				= get_replacement(env, get_Address_entity(value));
+			if (replacement != NULL)
+				initializer->consti.value
+					= new_r_Address(get_const_code_irg(), replacement);
+		} else {
+			irg_walk(value, redirect_inputs, NULL, env);
+		}
+		return;
+	}
+	case IR_INITIALIZER_TARVAL:
+	case IR_INITIALIZER_NULL:
+		return;
+	case IR_INITIALIZER_COMPOUND:
+		for (size_t i = 0; i < initializer->compound.n_initializers; ++i) {
+			redirect_initializer(env, initializer->compound.initializers[i]);
+		}
+		return;
+	}
+	panic("invalid initializer found");
+}
+
+/**
+ * Redirects all references to the removed functions.
+ */
+static void redirect_references(merge_env_t *const env)
+{
+	foreach_irp_irg(i, irg) {
+		irg_walk_graph(irg, redirect_inputs, NULL, env);
+	}
+
+	for (ir_segment_t s = IR_SEGMENT_FIRST; s <= IR_SEGMENT_LAST; ++s) {
+		ir_type *const segment = get_segment_type(s);
+		for (size_t i = 0, n = get_compound_n_members(segment); i < n; ++i) {
+			ir_entity *const member = get_compound_member(segment, i);
+			if (is_alias_entity(member)) {
+				ir_entity *const replacement
+					= get_replacement(env, get_entity_alias(member));
+				if (replacement != NULL)
+					set_entity_alias(member, replacement);
+			} else if (get_entity_kind(member) == IR_ENTITY_NORMAL) {
+				ir_initializer_t *const init = get_entity_initializer(member);
+				if (init != NULL)
+					redirect_initializer(env, init);
+			}
+		}
+	}
+}
+
+static bool is_candidate(merge_env_t const *const env,
+                         ir_entity const *const entity)
+{
+	ir_linkage const linkage = get_entity_linkage(entity);
+	return is_segment_type(get_entity_owner(entity))
+	    && !(linkage & (IR_LINKAGE_WEAK | IR_LINKAGE_MERGE
+	                    | IR_LINKAGE_HIDDEN_USER | IR_LINKAGE_NO_CODEGEN))
+	    && !pset_new_contains(&env->thunks, (ir_entity*)entity);
+}
+
+static int cmp_func_hash(void const *const p1, void const *const p2)
+{
+	func_t const *const f1 = (func_t const*)p1;
+	func_t const *const f2 = (func_t const*)p2;
+	if (f1->hash != f2->hash)
+		return QSORT_CMP(f1->hash, f2->hash);
+	/* keep the order of the program for equal hashes */
+	return QSORT_CMP(get_irg_idx(f1->irg), get_irg_idx(f2->irg));
+}
+
+static bool merge_round(merge_env_t *const env)
+{
+	func_t *funcs = NEW_ARR_F(func_t, 0);
+	foreach_irp_irg(i, irg) {
+		ir_entity *const entity = get_irg_entity(irg);
+		if (!is_candidate(env, entity))
+			continue;
+		func_t func = { .entity = entity, .irg = irg, .merged = false };
+		compute_hash(&func);
+		ARR_APP1(func_t, funcs, func);
+	}
+
+	size_t const n_funcs = ARR_LEN(funcs);
+	QSORT_ARR(funcs, cmp_func_hash);
+
+	bool changed = false;
+	for (size_t i = 0; i < n_funcs; ++i) {
+		func_t const *const target = &funcs[i];
+		if (target->merged)
+			continue;
+		for (size_t j = i + 1; j < n_funcs && funcs[j].hash == target->hash;
+		     ++j) {
+			func_t *const func = &funcs[j];
+			if (!func->merged && graphs_equivalent(target, func)
+			 && merge_function(env, func, target)) {
+				func->merged = true;
+				changed      = true;
+			}
+		}
+	}
+
+	if (pmap_count(env->replacements) > 0) {
+		redirect_references(env);
+		for (size_t i = 0; i < n_funcs; ++i) {
+			ir_entity *const entity = funcs[i].entity;
+			ir_entity *const target = get_replacement(env, entity);
+			if (target != NULL)
+				remove_function(entity, target);
+		}
+		pmap_destroy(env->replacements);
+		env->replacements = pmap_create();
+	}
+
+	DEL_ARR_F(funcs);
+	return changed;
+}
+
+void merge_identical_functions(int use_aliases)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.opt.mergefunctions");
+
+	assure_irp_globals_entity_usage_computed();
+
+	merge_env_t env = {
+		.replacements = pmap_create(),
+		.use_aliases  = use_aliases,
+	};
+	pset_new_init(&env.thunks);
+
+	while (merge_round(&env)) {}
+
+	pset_new_destroy(&env.thunks);
+	pmap_destroy(env.replacements);
+}
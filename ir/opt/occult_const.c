@@ -21,6 +21,7 @@
 #include "irnodemap.h"
 #include "iropt_t.h"
 #include "iroptimize.h"
+#include "opt_init.h"
 #include "tv.h"
 #include <stdbool.h>
 
@@ -73,8 +74,6 @@ static void fill_nodemap(ir_node *node, void *data) {
 
 void occult_consts(ir_graph *irg)
 {
-	FIRM_DBG_REGISTER(dbg, "firm.opt.occults");
-
 	constbits_analyze(irg);
 
 	env_t env;
@@ -94,3 +93,8 @@ void occult_consts(ir_graph *irg)
 	confirm_irg_properties(irg,
 	                       env.changed ? IR_GRAPH_PROPERTIES_NONE : IR_GRAPH_PROPERTIES_ALL);
 }
+
+void firm_init_occult_consts(void)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.opt.occults");
+}
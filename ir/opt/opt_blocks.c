@@ -12,6 +12,7 @@
  * Two block are congruent, if they contains only equal calculations.
  */
 #include "array.h"
+#include "compiler.h"
 #include "debug.h"
 #include "ircons.h"
 #include "irgmod.h"
@@ -20,6 +21,7 @@
 #include "irnode_t.h"
 #include "iropt_t.h"
 #include "iroptimize.h"
+#include "opt_init.h"
 #include "set.h"
 #include "util.h"
 
@@ -136,7 +138,7 @@ typedef struct listmap_t {
 DEBUG_ONLY(static firm_dbg_module_t *dbg;)
 
 /** Next partition number. */
-DEBUG_ONLY(static unsigned part_nr = 0;)
+DEBUG_ONLY(static THREAD_LOCAL unsigned part_nr = 0;)
 
 #ifdef DEBUG_libfirm
 /**
@@ -1167,9 +1169,6 @@ void shape_blocks(ir_graph *irg)
 	block_t       *bl;
 	int           res, n;
 
-	/* register a debug mask */
-	FIRM_DBG_REGISTER(dbg, "firm.opt.blocks");
-
 	DEBUG_ONLY(part_nr = 0;)
 	DB((dbg, LEVEL_1, "Shaping blocks for %+F\n", irg));
 
@@ -1240,3 +1239,8 @@ void shape_blocks(ir_graph *irg)
 	del_set(env.opcode2id_map);
 	obstack_free(&env.obst, NULL);
 }
+
+void firm_init_opt_blocks(void)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.opt.blocks");
+}
@@ -21,4 +21,42 @@ void firm_init_scalar_replace(void);
 
 void firm_init_loop_opt(void);
 
+/* The passes below may run on several graphs in parallel, so their debug
+ * modules are registered once during initialization. */
+void firm_init_boolopt(void);
+
+void firm_init_cfopt(void);
+
+void firm_init_combo(void);
+
+void firm_init_confirm(void);
+
+void firm_init_constbits(void);
+
+void firm_init_convopt(void);
+
+void firm_init_dca(void);
+
+void firm_init_gvn_pre(void);
+
+void firm_init_ifconv(void);
+
+void firm_init_jumpthreading(void);
+
+void firm_init_lcssa(void);
+
+void firm_init_ldstopt(void);
+
+void firm_init_loop_unrolling(void);
+
+void firm_init_occult_consts(void);
+
+void firm_init_opt_blocks(void);
+
+void firm_init_opt_ldst(void);
+
+void firm_init_tailrec(void);
+
+void firm_init_vrp(void);
+
 #endif
@@ -11,6 +11,7 @@
  */
 
 #include "array.h"
+#include "compiler.h"
 #include "debug.h"
 #include "ircons.h"
 #include "irdom.h"
@@ -24,6 +25,7 @@
 #include "iropt.h"
 #include "iroptimize.h"
 #include "irouts_t.h"
+#include "opt_init.h"
 #include "panic.h"
 #include "raw_bitset.h"
 #include "type_t.h"
@@ -119,7 +121,7 @@ typedef struct ldst_env_t {
 } ldst_env;
 
 /* the one and only environment */
-static ldst_env env;
+static THREAD_LOCAL ldst_env env;
 
 #ifdef DEBUG_libfirm
 
@@ -1753,8 +1755,6 @@ void opt_ldst(ir_graph *irg)
 {
 	block_t *bl;
 
-	FIRM_DBG_REGISTER(dbg, "firm.opt.ldst");
-
 	DB((dbg, LEVEL_1, "\nDoing Load/Store optimization on %+F\n", irg));
 
 	assure_irg_properties(irg,
@@ -1884,3 +1884,8 @@ no_changes:
 	DEL_ARR_F(env.id_2_address);
 #endif
 }
+
+void firm_init_opt_ldst(void)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.opt.ldst");
+}
@@ -14,6 +14,7 @@
  *  Extended version.
  */
 #include "array.h"
+#include "compiler.h"
 #include "debug.h"
 #include "hashptr.h"
 #include "ircons.h"
@@ -36,8 +37,9 @@
 #include "util.h"
 #include <stdbool.h>
 
-/** The debug handle. */
-DEBUG_ONLY(static firm_dbg_module_t *dbg;)
+/** The debug handle. Thread local, as opt_osr() and remove_phi_cycles()
+ * select different modules. */
+DEBUG_ONLY(static THREAD_LOCAL firm_dbg_module_t *dbg;)
 
 /** A scc. */
 typedef struct scc {
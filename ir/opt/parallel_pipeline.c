@@ -0,0 +1,285 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Runs a per-graph optimization pipeline on several threads.
+ *
+ * The graphs are partitioned into the strongly connected components of the
+ * call graph. A component becomes ready, when all components containing
+ * callees of its graphs are finished, so every graph is optimized after its
+ * callees. The graphs of one component are optimized one after the other by
+ * a single thread, while independent components are optimized concurrently.
+ */
+#include "array.h"
+#include "debug.h"
+#include "firm_lock.h"
+#include "firm_thread.h"
+#include "irgraph_t.h"
+#include "irflag.h"
+#include "irgwalk.h"
+#include "irmemory.h"
+#include "irnode_t.h"
+#include "iroptimize.h"
+#include "irprog_t.h"
+#include "obst.h"
+#include "util.h"
+
+DEBUG_ONLY(static firm_dbg_module_t *dbg;)
+
+typedef struct scc_t scc_t;
+struct scc_t {
+	ir_graph **irgs;      /**< The graphs of this component. */
+	scc_t    **callers;   /**< Components, which call into this one. */
+	size_t     n_callees; /**< Number of unfinished callee components. */
+	scc_t     *next;      /**< Next component in the ready list. */
+};
+
+typedef struct irg_info_t {
+	ir_graph **callees;
+	scc_t     *scc;
+	unsigned   index;
+	unsigned   lowlink;
+	bool       on_stack;
+} irg_info_t;
+
+typedef struct scc_env_t {
+	struct obstack obst;
+	ir_graph     **stack;
+	scc_t        **sccs;     /**< Components in bottom-up order. */
+	unsigned       next_index;
+} scc_env_t;
+
+typedef struct pipeline_env_t {
+	irg_pipeline_func    pipeline;
+	void                *data;
+	optimization_state_t opt_state; /**< Flags of the calling thread. */
+	firm_mutex_t         mutex;
+	firm_cond_t          cond;
+	scc_t               *ready;
+	size_t               n_pending; /**< Number of unfinished components. */
+} pipeline_env_t;
+
+static irg_info_t *get_irg_info(ir_graph const *const irg)
+{
+	return (irg_info_t*)get_irg_link(irg);
+}
+
+static void collect_callees(ir_node *const node, void *const env)
+{
+	if (!is_Call(node))
+		return;
+	ir_entity *const callee = get_Call_callee(node);
+	if (callee == NULL)
+		return;
+	ir_graph *const callee_irg = get_entity_linktime_irg(callee);
+	if (callee_irg != NULL) {
+		ir_graph ***const callees = (ir_graph***)env;
+		ARR_APP1(ir_graph*, *callees, callee_irg);
+	}
+}
+
+static void find_sccs(scc_env_t *const env, ir_graph *const irg)
+{
+	irg_info_t *const info = get_irg_info(irg);
+	info->index    = env->next_index++;
+	info->lowlink  = info->index;
+	info->on_stack = true;
+	ARR_APP1(ir_graph*, env->stack, irg);
+
+	for (size_t i = 0, n = ARR_LEN(info->callees); i < n; ++i) {
+		ir_graph   *const callee      = info->callees[i];
+		irg_info_t *const callee_info = get_irg_info(callee);
+		if (callee_info->index == 0) {
+			find_sccs(env, callee);
+			info->lowlink = MIN(info->lowlink, callee_info->lowlink);
+		} else if (callee_info->on_stack) {
+			info->lowlink = MIN(info->lowlink, callee_info->index);
+		}
+	}
+
+	if (info->lowlink != info->index)
+		return;
+
+	scc_t *const scc = OALLOCZ(&env->obst, scc_t);
+	scc->irgs    = NEW_ARR_F(ir_graph*, 0);
+	scc->callers = NEW_ARR_F(scc_t*, 0);
+	ir_graph *member;
+	do {
+		size_t const top = ARR_LEN(env->stack) - 1;
+		member = env->stack[top];
+		ARR_SHRINKLEN(env->stack, top);
+		irg_info_t *const member_info = get_irg_info(member);
+		member_info->on_stack = false;
+		member_info->scc      = scc;
+		ARR_APP1(ir_graph*, scc->irgs, member);
+	} while (member != irg);
+	ARR_APP1(scc_t*, env->sccs, scc);
+}
+
+/**
+ * Partitions the graphs into the strongly connected components of the call
+ * graph and records, which components call each other.
+ */
+static void compute_sccs(scc_env_t *const env)
+{
+	obstack_init(&env->obst);
+	env->stack      = NEW_ARR_F(ir_graph*, 0);
+	env->sccs       = NEW_ARR_F(scc_t*, 0);
+	env->next_index = 1;
+
+	irp_reserve_resources(irp, IRP_RESOURCE_IRG_LINK);
+	foreach_irp_irg(i, irg) {
+		irg_info_t *const info = OALLOCZ(&env->obst, irg_info_t);
+		info->callees = NEW_ARR_F(ir_graph*, 0);
+		irg_walk_graph(irg, collect_callees, NULL, &info->callees);
+		set_irg_link(irg, info);
+	}
+
+	foreach_irp_irg(i, irg) {
+		if (get_irg_info(irg)->index == 0)
+			find_sccs(env, irg);
+	}
+
+	foreach_irp_irg(i, irg) {
+		irg_info_t *const info = get_irg_info(irg);
+		scc_t      *const scc  = info->scc;
+		for (size_t c = 0, n = ARR_LEN(info->callees); c < n; ++c) {
+			scc_t *const callee_scc = get_irg_info(info->callees[c])->scc;
+			if (callee_scc == scc)
+				continue;
+			ARR_APP1(scc_t*, callee_scc->callers, scc);
+			++scc->n_callees;
+		}
+		DEL_ARR_F(info->callees);
+	}
+	irp_free_resources(irp, IRP_RESOURCE_IRG_LINK);
+	DEL_ARR_F(env->stack);
+}
+
+static void free_sccs(scc_env_t *const env)
+{
+	for (size_t i = 0, n = ARR_LEN(env->sccs); i < n; ++i) {
+		scc_t *const scc = env->sccs[i];
+		DEL_ARR_F(scc->irgs);
+		DEL_ARR_F(scc->callers);
+	}
+	DEL_ARR_F(env->sccs);
+	obstack_free(&env->obst, NULL);
+}
+
+static void run_scc(pipeline_env_t const *const env, scc_t const *const scc)
+{
+	for (size_t i = 0, n = ARR_LEN(scc->irgs); i < n; ++i) {
+		ir_graph *const irg = scc->irgs[i];
+		DB((dbg, LEVEL_2, "optimizing %+F\n", irg));
+		env->pipeline(irg, env->data);
+	}
+}
+
+static void *worker(void *const data)
+{
+	pipeline_env_t *const env = (pipeline_env_t*)data;
+	/* The optimization flags are thread local. */
+	restore_optimization_state(&env->opt_state);
+	firm_mutex_lock(&env->mutex);
+	for (;;) {
+		while (env->ready == NULL && env->n_pending != 0)
+			firm_cond_wait(&env->cond, &env->mutex);
+		if (env->n_pending == 0)
+			break;
+
+		scc_t *const scc = env->ready;
+		env->ready = scc->next;
+		firm_mutex_unlock(&env->mutex);
+
+		run_scc(env, scc);
+
+		firm_mutex_lock(&env->mutex);
+		for (size_t i = 0, n = ARR_LEN(scc->callers); i < n; ++i) {
+			scc_t *const caller = scc->callers[i];
+			if (--caller->n_callees == 0) {
+				caller->next = env->ready;
+				env->ready   = caller;
+			}
+		}
+		--env->n_pending;
+		firm_cond_broadcast(&env->cond);
+	}
+	firm_mutex_unlock(&env->mutex);
+	return NULL;
+}
+
+void optimize_graphs_parallel(irg_pipeline_func const pipeline,
+                              void *const data, unsigned const n_threads)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.opt.parallel");
+
+	scc_env_t sccs;
+	compute_sccs(&sccs);
+	size_t const n_sccs = ARR_LEN(sccs.sccs);
+	DB((dbg, LEVEL_1, "%zu graphs in %zu components, %u threads\n",
+	    get_irp_n_irgs(), n_sccs, n_threads));
+
+	pipeline_env_t env = {
+		.pipeline  = pipeline,
+		.data      = data,
+		.ready     = NULL,
+		.n_pending = n_sccs,
+	};
+
+	if (n_threads <= 1 || n_sccs <= 1) {
+		/* The components were found in bottom-up order. */
+		for (size_t i = 0; i < n_sccs; ++i) {
+			run_scc(&env, sccs.sccs[i]);
+		}
+		free_sccs(&sccs);
+		return;
+	}
+
+	save_optimization_state(&env.opt_state);
+	for (size_t i = n_sccs; i-- > 0;) {
+		scc_t *const scc = sccs.sccs[i];
+		if (scc->n_callees == 0) {
+			scc->next = env.ready;
+			env.ready = scc;
+		}
+	}
+
+	/* Optimizing a graph only removes uses of global entities, so their usage
+	 * computed beforehand stays conservative while running in parallel. */
+	assure_irp_globals_entity_usage_computed();
+
+	firm_mutex_init(&env.mutex);
+	firm_cond_init(&env.cond);
+	firm_parallel = true;
+
+	/* The calling thread works, too. If a thread cannot be created, the
+	 * remaining threads still process all components. */
+	firm_thread_t *const threads = XMALLOCN(firm_thread_t, n_threads - 1);
+	unsigned             n_started = 0;
+	for (unsigned i = 0; i < n_threads - 1; ++i) {
+		if (!firm_thread_create(&threads[n_started], worker, &env))
+			break;
+		++n_started;
+	}
+	worker(&env);
+	for (unsigned i = 0; i < n_started; ++i) {
+		firm_thread_join(threads[i]);
+	}
+	free(threads);
+
+	firm_parallel = false;
+	firm_cond_destroy(&env.cond);
+	firm_mutex_destroy(&env.mutex);
+
+	/* The visited counters and the usage of global entities were not updated
+	 * while running in parallel. */
+	foreach_irp_irg(i, irg) {
+		set_irg_visited(irg, get_irg_visited(irg));
+	}
+	set_irp_globals_entity_usage_state(ir_entity_usage_not_computed);
+	free_sccs(&sccs);
+}
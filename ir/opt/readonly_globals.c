@@ -0,0 +1,111 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Promotes global variables, which are never written, to constants.
+ *
+ * A global entity, which is not visible outside the compilation unit and
+ * whose address is only used to read from it, keeps the value of its
+ * initializer during the whole program run. Such entities are marked
+ * constant, so the backend places them in a read-only section, and all loads
+ * at a constant offset into them are replaced by the matching part of the
+ * initializer.
+ */
+#include "debug.h"
+#include "entity_t.h"
+#include "ircons.h"
+#include "irgmod.h"
+#include "irgopt.h"
+#include "irgwalk.h"
+#include "irmemory.h"
+#include "irnode_t.h"
+#include "iropt_t.h"
+#include "iroptimize.h"
+#include "irprog_t.h"
+#include "type_t.h"
+
+DEBUG_ONLY(static firm_dbg_module_t *dbg;)
+
+typedef struct fold_env_t {
+	bool changed;    /**< Set, if a Load was replaced. */
+	bool cf_changed; /**< Set, if an exception edge was removed. */
+} fold_env_t;
+
+/**
+ * Checks whether the initializer of @p entity is its value during the whole
+ * program run. Entities without initializer are only declared here.
+ */
+static bool is_never_written(ir_entity const *const entity)
+{
+	if (get_entity_kind(entity) != IR_ENTITY_NORMAL
+	 || entity_is_externally_visible(entity)
+	 || get_entity_volatility(entity) == volatility_is_volatile
+	 || (get_entity_linkage(entity) & IR_LINKAGE_NO_CODEGEN)
+	 || get_entity_initializer(entity) == NULL)
+		return false;
+
+	ir_entity_usage const usage = get_entity_usage(entity);
+	return !(usage & (ir_usage_address_taken | ir_usage_write));
+}
+
+static void fold_load(ir_node *const node, void *const data)
+{
+	if (!is_Load(node) || get_Load_volatility(node) == volatility_is_volatile)
+		return;
+
+	ir_node *const ptr = get_Load_ptr(node);
+	ir_node *const val = predict_load(ptr, get_Load_mode(node));
+	if (val == NULL)
+		return;
+
+	DB((dbg, LEVEL_2, "replacing %+F by %+F\n", node, val));
+	fold_env_t *const env   = (fold_env_t*)data;
+	ir_node    *const block = get_nodes_block(node);
+	ir_node          *in[pn_Load_max + 1];
+	int               n_in  = 2;
+	in[pn_Load_M]   = get_Load_mem(node);
+	in[pn_Load_res] = val;
+	if (ir_throws_exception(node)) {
+		in[pn_Load_X_regular] = new_r_Jmp(block);
+		in[pn_Load_X_except]  = new_r_Bad(get_irn_irg(node), mode_X);
+		n_in                  = 4;
+		env->cf_changed       = true;
+	}
+	turn_into_tuple(node, n_in, in);
+	env->changed = true;
+}
+
+void promote_readonly_globals(void)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.opt.readonly_globals");
+
+	assure_irp_globals_entity_usage_computed();
+
+	/* Thread local and constructor entities are left alone, as their section
+	 * is determined by their segment. */
+	ir_type *const segment = get_segment_type(IR_SEGMENT_GLOBAL);
+	for (size_t i = 0, n = get_compound_n_members(segment); i < n; ++i) {
+		ir_entity *const entity = get_compound_member(segment, i);
+		if ((get_entity_linkage(entity) & IR_LINKAGE_CONSTANT)
+		 || !is_never_written(entity))
+			continue;
+
+		DB((dbg, LEVEL_1, "promoting %+F to read-only\n", entity));
+		add_entity_linkage(entity, IR_LINKAGE_CONSTANT);
+	}
+
+	/* Loads from constant entities are predicted from their initializers. */
+	foreach_irp_irg(i, irg) {
+		fold_env_t env = { .changed = false, .cf_changed = false };
+		irg_walk_graph(irg, NULL, fold_load, &env);
+		if (env.changed)
+			remove_tuples(irg);
+		confirm_irg_properties(irg,
+			env.cf_changed ? IR_GRAPH_PROPERTIES_NONE
+			: env.changed  ? IR_GRAPH_PROPERTIES_CONTROL_FLOW
+			               : IR_GRAPH_PROPERTIES_ALL);
+	}
+}
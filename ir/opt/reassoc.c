@@ -10,8 +10,11 @@
  */
 #include "reassoc_t.h"
 
+#include "array.h"
+#include "bitfiddle.h"
 #include "debug.h"
 #include "ircons_t.h"
+#include "irdom.h"
 #include "iredges_t.h"
 #include "irflag_t.h"
 #include "irgmod.h"
@@ -1666,216 +1669,303 @@ static multi_op *get_user(multi_op *o)
 	return user;
 }
 
-static ir_node *rebuild_node(multi_op *o, ir_node *curr, ir_node *node)
+/**
+ * An operand of a rebuilt multi_op. Operands are combined in the order of
+ * their ranks, which makes the shape of the rebuilt tree canonical.
+ */
+typedef struct {
+	ir_node  *node;
+	unsigned  rank;   /**< the rank of the operand, see get_rank() */
+	unsigned  height; /**< height of the operand tree within its rank */
+} ranked_operand;
+
+/**
+ * Returns the rank of an operand in the style of Briggs-Cooper: Constants have
+ * rank 0, all other values the loop depth of their block plus one. So values
+ * computed outside of a loop have a lower rank than values computed inside of
+ * it.
+ */
+static unsigned get_rank(const ir_node *node)
 {
-	ir_node  *block = get_nodes_block(o->base_node);
-	dbg_info *dbgi  = get_irn_dbg_info(o->base_node);
+	if (is_Const(node))
+		return 0;
+	ir_loop *const loop = get_irn_loop(get_nodes_block(node));
+	return loop != NULL ? get_loop_depth(loop) + 1 : 1;
+}
 
-	if (!curr)
-		return node;
+static ranked_operand make_ranked_operand(ir_node *node)
+{
+	return (ranked_operand) { .node = node, .rank = get_rank(node), .height = 0 };
+}
 
-	switch (get_op_code(get_multi_op_op(o))) {
-	case iro_Eor:
-		return new_rd_Eor(dbgi, block, node, curr);
-	case iro_And:
-		return new_rd_And(dbgi, block, node, curr);
-	case iro_Or:
-		return new_rd_Or(dbgi, block, node, curr);
-	default:
-		panic("Operation not supported");
-	}
+static int cmp_ranked_operand(const void *a, const void *b)
+{
+	const ranked_operand *op_a = (const ranked_operand*)a;
+	const ranked_operand *op_b = (const ranked_operand*)b;
+	if (op_a->rank != op_b->rank)
+		return QSORT_CMP(op_a->rank, op_b->rank);
+	if (op_a->height != op_b->height)
+		return QSORT_CMP(op_a->height, op_b->height);
+	return QSORT_CMP(get_irn_idx(op_a->node), get_irn_idx(op_b->node));
 }
 
 /**
- * Rebuild the graph according to the multi_ops. Only sets with change flag set, will bereplaced.
+ * Combines two ranked operands with the binary operation @p op.
  */
-static void rebuild(multi_op_env *multi_env)
+static ranked_operand combine_ranked(dbg_info *dbgi, ir_node *block, ir_op *op,
+                                     ranked_operand a, ranked_operand b)
 {
-	DBG((dbg, LEVEL_5, "rebuilding...\n"));
-
-	foreach_pset(multi_env->sets, multi_op, o) {
-		if (!o->changed) {
-			continue;
-		}
-
-		DBG((dbg, LEVEL_5, "rebuild %+F\n", o->base_node));
-
-		ir_node  *block = get_nodes_block(o->base_node);
-		dbg_info *dbgi  = get_irn_dbg_info(o->base_node);
-		ir_node  *curr  = NULL;
-
-
-		if (get_multi_op_op(o) == op_Add) {
-			/* rebuild polynoms */
-			pmap    *dic     = pmap_create();
-			ir_node *pointer = NULL;
-
-			foreach_pset(o->multi_operands, multi_op, operand) {
-				ir_node *node = operand->base_node;
-
-				/* In each Add-Set there should be at most one pointer.
-				 * If that's the case it have to be topmost. */
-				if (mode_is_reference(get_irn_mode(node))) {
-					assert(pointer == NULL);
-					pointer = node;
-					continue;
-				}
-
-				ir_tarval *val = pmap_get(ir_tarval, o->multiplier, operand);
-				assert(val);
-				if (!tarval_is_null(val)) {
-					pset *dic_set = pmap_get(pset, dic, val);
-					if (!dic_set) {
-						dic_set = pset_new_ptr_default();
-						pmap_insert(dic, val, dic_set);
-					}
-
-					pset_insert_ptr(dic_set, node);
-				}
-			}
-			foreach_pset(o->operands, ir_node, node) {
-				/* In each Add-Set there should be at most one pointer.
-				 * If that's the case it have to be topmost. */
-				if (mode_is_reference(get_irn_mode(node))) {
-					assert(pointer == NULL);
-					pointer = node;
-					continue;
-				}
+	ir_node  *in[] = { a.node, b.node };
+	ir_mode  *mode = op == op_Sub ? get_irn_mode(a.node) : get_mode_from_ops(a.node, b.node);
+	unsigned  rank = MAX(a.rank, b.rank);
+	/* lower ranked operands are computed outside, they do not count */
+	unsigned  height_a = a.rank == rank ? a.height : 0;
+	unsigned  height_b = b.rank == rank ? b.height : 0;
+	return (ranked_operand) {
+		.node   = create_node(dbgi, block, op, mode, ARRAY_SIZE(in), in),
+		.rank   = rank,
+		.height = MAX(height_a, height_b) + 1,
+	};
+}
 
-				ir_tarval *val = pmap_get(ir_tarval, o->multiplier, node);
-				assert(val);
-				if (!tarval_is_null(val)) {
-					pset *dic_set = pmap_get(pset, dic, val);
-					if (!dic_set) {
-						dic_set = pset_new_ptr_default();
-						pmap_insert(dic, val, dic_set);
-					}
+/**
+ * Combines the @p n operands in @p ops, which are sorted by
+ * cmp_ranked_operand(), into one tree.
+ */
+static ranked_operand combine_sorted(ranked_operand *ops, size_t n,
+                                     dbg_info *dbgi, ir_node *block, ir_op *op)
+{
+	assert(n > 0);
+	while (n > 1) {
+		ranked_operand const res = combine_ranked(dbgi, block, op, ops[0], ops[1]);
+
+		/* insert the result sorted */
+		n -= 2;
+		memmove(ops, ops + 2, n * sizeof(*ops));
+		size_t pos = 0;
+		while (pos < n && cmp_ranked_operand(&ops[pos], &res) < 0)
+			++pos;
+		memmove(ops + pos + 1, ops + pos, (n - pos) * sizeof(*ops));
+		ops[pos] = res;
+		++n;
+	}
+	return ops[0];
+}
 
-					pset_insert_ptr(dic_set, node);
-				}
-			}
+/**
+ * Builds a tree of the commutative operation @p op over the operands in the
+ * flexible array @p ops, which is consumed.
+ *
+ * The two operands with the lowest rank are combined repeatedly, ties are
+ * broken by the height of their trees. Hence operands of lower rank, e.g.
+ * loop invariant ones, form subtrees of their own, which can be hoisted and
+ * are found by CSE independent of the original order of the operands. Operands
+ * of the same rank form a balanced tree, which shortens the dependency chains.
+ * Constants are folded first, but combined last like reassoc_commutative()
+ * does, so they stay available for folding with the users and address modes.
+ *
+ * Returns a NULL node if @p ops is empty.
+ */
+static ranked_operand build_ranked_tree(ranked_operand *ops, dbg_info *dbgi,
+                                        ir_node *block, ir_op *op)
+{
+	size_t const n = ARR_LEN(ops);
+	ranked_operand res = { .node = NULL, .rank = 0, .height = 0 };
+	if (n > 0) {
+		QSORT(ops, n, cmp_ranked_operand);
+
+		size_t n_consts = 0;
+		while (n_consts < n && ops[n_consts].rank == 0)
+			++n_consts;
+
+		if (n_consts < n)
+			res = combine_sorted(ops + n_consts, n - n_consts, dbgi, block, op);
+		if (n_consts > 0) {
+			ranked_operand const consts = combine_sorted(ops, n_consts, dbgi, block, op);
+			res = res.node ? combine_ranked(dbgi, block, op, res, consts) : consts;
+		}
+	}
+	DEL_ARR_F(ops);
+	return res;
+}
 
-			curr = pointer;
-			pset    *done      = pset_new_ptr_default();
-			deq_t negatives;
-			deq_init(&negatives);
+/**
+ * Appends the nodes of @p set (which may be NULL) to the flexible array @p ops.
+ */
+static ranked_operand *append_ranked_operands(ranked_operand *ops, pset *set)
+{
+	if (set) {
+		foreach_pset(set, ir_node, node) {
+			ARR_APP1(ranked_operand, ops, make_ranked_operand(node));
+		}
+	}
+	return ops;
+}
 
-			foreach_pmap(dic, entry) {
-				ir_tarval *curr_val = (ir_tarval *)entry->key;
+/**
+ * Adds @p node with multiplier @p val to the polynom dictionary @p dic.
+ */
+static void add_to_polynom(pmap *dic, ir_node *node, ir_tarval *val)
+{
+	if (tarval_is_null(val))
+		return;
 
-				if (pset_find_ptr(done, curr_val)) {
-					continue;
-				}
+	pset *dic_set = pmap_get(pset, dic, val);
+	if (!dic_set) {
+		dic_set = pset_new_ptr_default();
+		pmap_insert(dic, val, dic_set);
+	}
+	pset_insert_ptr(dic_set, node);
+}
 
-				ir_tarval *neg_val    = tarval_neg(curr_val);
-				bool       is_max_val = neg_val == curr_val;
+/**
+ * Rebuilds an Add multi_op from its polynom.
+ *
+ * Operands with the same multiplier c are summed up and multiplied once,
+ * operands with multiplier -c are subtracted from that sum. The resulting
+ * terms are summed up in rank order, negative terms are subtracted at last.
+ */
+static ir_node *rebuild_polynom(multi_op *o)
+{
+	ir_node  *block  = get_nodes_block(o->base_node);
+	dbg_info *dbgi   = get_irn_dbg_info(o->base_node);
+	bool      signed_mode = mode_is_signed(get_irn_mode(o->base_node));
+	pmap     *dic     = pmap_create();
+	ir_node  *pointer = NULL;
+
+	foreach_pset(o->multi_operands, multi_op, operand) {
+		ir_node *node = operand->base_node;
+
+		/* In each Add-Set there should be at most one pointer.
+		 * If that's the case it have to be topmost. */
+		if (mode_is_reference(get_irn_mode(node))) {
+			assert(pointer == NULL);
+			pointer = node;
+			continue;
+		}
 
-				if (is_max_val || pmap_contains(dic, neg_val) || !tarval_is_negative(curr_val)) {
-					assert(!(mode_is_signed(get_irn_mode(o->base_node)) && pset_find_ptr(done, neg_val)));
+		ir_tarval *val = pmap_get(ir_tarval, o->multiplier, operand);
+		assert(val);
+		add_to_polynom(dic, node, val);
+	}
+	foreach_pset(o->operands, ir_node, node) {
+		if (mode_is_reference(get_irn_mode(node))) {
+			assert(pointer == NULL);
+			pointer = node;
+			continue;
+		}
 
-					ir_tarval *negativ_val;
-					ir_tarval *positiv_val;
+		ir_tarval *val = pmap_get(ir_tarval, o->multiplier, node);
+		assert(val);
+		add_to_polynom(dic, node, val);
+	}
 
-					if (is_max_val || !tarval_is_negative(curr_val)) {
-						negativ_val = neg_val;
-						positiv_val = curr_val;
-					} else {
-						negativ_val = curr_val;
-						positiv_val = neg_val;
-					}
+	ranked_operand *positives = NEW_ARR_F(ranked_operand, 0);
+	ranked_operand *negatives = NEW_ARR_F(ranked_operand, 0);
+	pset           *done      = pset_new_ptr_default();
 
-					pset *negativ_set = NULL;
-					if (!is_max_val && mode_is_signed(get_irn_mode(o->base_node))) {
-						negativ_set = pmap_get(pset, dic, negativ_val);
-					}
-					pset *positiv_set = pmap_get(pset, dic, positiv_val);
-					assert(positiv_set);
+	foreach_pmap(dic, entry) {
+		ir_tarval *curr_val = (ir_tarval *)entry->key;
 
-					ir_node *inner = NULL;
-					bool is_one = tarval_is_one(positiv_val);
-					if (curr && is_one) {
-						inner = curr;
-					}
-					foreach_pset(positiv_set, ir_node, node) {
-						if (!inner) {
-							inner = node;
-						} else {
-							inner = new_rd_Add(dbgi, block, inner, node);
-						}
-					}
-					assert(inner);
-					if (negativ_set) {
-						foreach_pset(negativ_set, ir_node, node) {
-							inner = new_rd_Sub(dbgi, block, inner, node);
-						}
-					}
+		/* the positive factor of the term */
+		ir_tarval *factor  = curr_val;
+		ir_tarval *neg_val = tarval_neg(curr_val);
+		if (signed_mode && tarval_is_negative(curr_val) && neg_val != curr_val)
+			factor = neg_val;
+		if (pset_find_ptr(done, factor))
+			continue;
+		pset_insert_ptr(done, factor);
 
-					if (!is_one) {
-						ir_node *c = new_rd_Const(dbgi, get_irn_irg(inner), positiv_val);
-						inner      = new_rd_Mul(dbgi, block, c, inner);
-					}
+		pset *positiv_set = pmap_get(pset, dic, factor);
+		pset *negativ_set = NULL;
+		ir_tarval *negativ_val = tarval_neg(factor);
+		if (signed_mode && negativ_val != factor)
+			negativ_set = pmap_get(pset, dic, negativ_val);
 
-					if (!curr || is_one) {
-						curr = inner;
-					} else {
-						curr = new_rd_Add(dbgi, block, curr, inner);
-					}
+		if (tarval_is_one(factor)) {
+			positives = append_ranked_operands(positives, positiv_set);
+			negatives = append_ranked_operands(negatives, negativ_set);
+			continue;
+		}
 
-					pset_insert_ptr(done, positiv_val);
-					if (negativ_set) {
-						pset_insert_ptr(done, negativ_val);
-					}
-				} else {
-					deq_push_pointer_right(&negatives, curr_val);
-				}
+		ranked_operand inner = build_ranked_tree(append_ranked_operands(NEW_ARR_F(ranked_operand, 0), positiv_set), dbgi, block, op_Add);
+		ranked_operand sub   = build_ranked_tree(append_ranked_operands(NEW_ARR_F(ranked_operand, 0), negativ_set), dbgi, block, op_Add);
+		bool           is_negative = false;
+		if (!inner.node) {
+			inner       = sub;
+			is_negative = true;
+		} else if (sub.node) {
+			inner = combine_ranked(dbgi, block, op_Sub, inner, sub);
+		}
+		assert(inner.node);
 
-			}
+		ir_mode  *node_mode = get_irn_mode(inner.node);
+		ir_node  *c         = new_rd_Const(dbgi, get_irn_irg(inner.node), tarval_convert_to(factor, node_mode));
+		ranked_operand term = combine_ranked(dbgi, block, op_Mul, make_ranked_operand(c), inner);
+		if (is_negative) {
+			ARR_APP1(ranked_operand, negatives, term);
+		} else {
+			ARR_APP1(ranked_operand, positives, term);
+		}
+	}
 
-			deq_foreach_pointer(&negatives, ir_tarval, negativ_val) {
-				assert(tarval_is_negative(negativ_val));
+	del_pset(done);
+	foreach_pmap(dic, entry) {
+		pset *dic_set = (pset *)entry->value;
+		del_pset(dic_set);
+	}
+	pmap_destroy(dic);
+
+	ranked_operand pos = build_ranked_tree(positives, dbgi, block, op_Add);
+	ranked_operand neg = build_ranked_tree(negatives, dbgi, block, op_Add);
+	ir_node       *curr;
+	if (pointer) {
+		curr = pointer;
+		if (pos.node)
+			curr = new_rd_Add(dbgi, block, curr, pos.node);
+	} else {
+		curr = pos.node;
+	}
+	if (neg.node) {
+		if (!curr) {
+			curr = new_rd_Minus(dbgi, block, neg.node);
+		} else {
+			curr = new_rd_Sub(dbgi, block, curr, neg.node);
+		}
+	}
+	return curr;
+}
 
-				pset *negativ_set = pmap_get(pset, dic, negativ_val);
-				assert(negativ_set);
+/**
+ * Rebuild the graph according to the multi_ops. Only sets with change flag set or consisting of
+ * several nodes will be replaced.
+ */
+static void rebuild(multi_op_env *multi_env)
+{
+	DBG((dbg, LEVEL_5, "rebuilding...\n"));
 
-				ir_node *inner = NULL;
-				foreach_pset(negativ_set, ir_node, node) {
-					if (!inner) {
-						inner = node;
-					} else {
-						inner = new_rd_Add(dbgi, block, inner, node);
-					}
-				}
+	foreach_pset(multi_env->sets, multi_op, o) {
+		/* trees of several nodes are rebuilt in canonical order, CSE
+		 * keeps the nodes of trees which are already canonical */
+		if (!o->changed && pset_count(o->nodes) < 2) {
+			continue;
+		}
 
-				ir_tarval *positiv_val = tarval_neg(negativ_val);
-				if (!tarval_is_one(positiv_val)) {
-					ir_mode *node_mode = get_irn_mode(inner);
-					ir_node *c         = new_rd_Const(dbgi, get_irn_irg(inner), tarval_convert_to(positiv_val, node_mode));
-					inner              = new_rd_Mul(dbgi, block, c, inner);
-				}
+		DBG((dbg, LEVEL_5, "rebuild %+F\n", o->base_node));
 
-				if (!curr) {
-					curr = new_rd_Minus(dbgi, block, inner);
-				} else {
-					curr = new_rd_Sub(dbgi, block, curr, inner);
-				}
-			}
+		dbg_info *dbgi = get_irn_dbg_info(o->base_node);
+		ir_node  *curr;
 
-			deq_free(&negatives);
-			del_pset(done);
-			foreach_pmap(dic, entry) {
-				pset *dic_set = (pset *)entry->value;
-				del_pset(dic_set);
-			}
-			pmap_destroy(dic);
+		if (get_multi_op_op(o) == op_Add) {
+			curr = rebuild_polynom(o);
 		} else {
 			/* rebuild other sets */
+			ranked_operand *ops = append_ranked_operands(NEW_ARR_F(ranked_operand, 0), o->operands);
 			foreach_pset(o->multi_operands, multi_op, operand) {
-				ir_node *node = operand->base_node;
-				curr = rebuild_node(o, curr, node);
-			}
-			foreach_pset(o->operands, ir_node, node) {
-				curr = rebuild_node(o, curr, node);
+				ARR_APP1(ranked_operand, ops, make_ranked_operand(operand->base_node));
 			}
+			ir_node *block = get_nodes_block(o->base_node);
+			curr = build_ranked_tree(ops, dbgi, block, get_multi_op_op(o)).node;
 		}
 
 		if (!curr) {
@@ -2064,6 +2154,149 @@ static void do_chaining(ir_graph *irg)
 	deq_free(&wq);
 }
 
+/**
+ * Returns true if @p node is an associative operation whose operand trees
+ * may be rebalanced.
+ */
+static bool is_balance_op(const ir_node *node)
+{
+	switch (get_irn_opcode(node)) {
+	case iro_Add:
+	case iro_Mul: {
+		ir_mode *mode = get_irn_mode(node);
+		/* reassociating floatingpoint ops is imprecise */
+		if (mode_is_float(mode))
+			return ir_imprecise_float_transforms_allowed();
+		return mode_is_int(mode);
+	}
+	case iro_And:
+	case iro_Or:
+	case iro_Eor:
+		return mode_is_int(get_irn_mode(node));
+	default:
+		return false;
+	}
+}
+
+/**
+ * Returns true if @p node belongs to the tree of @p root: It has to be the
+ * same operation in the same block and @p root must be its only user.
+ */
+static bool is_tree_node(const ir_node *node, const ir_node *root)
+{
+	return get_irn_op(node) == get_irn_op(root)
+	    && get_irn_mode(node) == get_irn_mode(root)
+	    && get_nodes_block(node) == get_nodes_block(root)
+	    && get_irn_n_edges(node) == 1;
+}
+
+/**
+ * Returns true if @p root is the root of a tree: It is no tree node of its
+ * only user.
+ */
+static bool is_tree_root(const ir_node *root)
+{
+	if (get_irn_n_edges(root) != 1)
+		return true;
+	ir_node const *const user = get_edge_src_irn(get_irn_out_edge_first(root));
+	return !is_balance_op(user) || !is_tree_node(root, user);
+}
+
+typedef struct {
+	ir_node  *node;
+	unsigned  depth;
+} tree_entry;
+
+/**
+ * Rebalances the tree of associative operations rooted at @p root.
+ *
+ * The tree is rebuilt with build_ranked_tree(), which results in a depth of
+ * log n for n operands of the same rank. An operand which is a Phi using the
+ * root is a loop carried accumulator, like in s += a0 + a1 + ... in an
+ * unrolled loop. It is combined last, so the loop carried dependency contains
+ * only a single operation and the remaining operations are independent of the
+ * previous iteration, as with one accumulator per unrolled iteration.
+ */
+static void balance_tree(ir_node *root)
+{
+	ranked_operand *leaves = NEW_ARR_F(ranked_operand, 0);
+	ir_node        *acc    = NULL;
+	unsigned        depth  = 0;
+	unsigned        acc_depth = 0;
+
+	tree_entry *stack = NEW_ARR_F(tree_entry, 0);
+	ARR_APP1(tree_entry, stack, ((tree_entry) { .node = root, .depth = 1 }));
+	while (ARR_LEN(stack) > 0) {
+		tree_entry const entry = stack[ARR_LEN(stack) - 1];
+		ARR_SHRINKLEN(stack, ARR_LEN(stack) - 1);
+
+		foreach_irn_in(entry.node, i, pred) {
+			if (is_tree_node(pred, root)) {
+				ARR_APP1(tree_entry, stack, ((tree_entry) { .node = pred, .depth = entry.depth + 1 }));
+				continue;
+			}
+
+			depth = MAX(depth, entry.depth);
+			if (acc == NULL && is_Phi(pred)) {
+				foreach_irn_in(pred, j, phi_pred) {
+					if (phi_pred == root) {
+						acc       = pred;
+						acc_depth = entry.depth;
+						break;
+					}
+				}
+				if (acc == pred)
+					continue;
+			}
+			ARR_APP1(ranked_operand, leaves, make_ranked_operand(pred));
+		}
+	}
+	DEL_ARR_F(stack);
+
+	size_t const n_operands = ARR_LEN(leaves) + (acc != NULL);
+	if (n_operands < 3 || (depth <= log2_ceil(n_operands) && acc_depth <= 1)) {
+		DEL_ARR_F(leaves);
+		return;
+	}
+
+	DBG((dbg, LEVEL_4, "balance %+F with %zu operands and depth %u\n", root, n_operands, depth));
+
+	dbg_info      *dbgi  = get_irn_dbg_info(root);
+	ir_node       *block = get_nodes_block(root);
+	ir_op         *op    = get_irn_op(root);
+	ranked_operand res   = build_ranked_tree(leaves, dbgi, block, op);
+	if (acc != NULL)
+		res = combine_ranked(dbgi, block, op, res, make_ranked_operand(acc));
+
+	if (res.node != root)
+		exchange(root, res.node);
+}
+
+static void collect_tree_roots(ir_node *node, void *env)
+{
+	ir_node ***roots = (ir_node***)env;
+	if (is_balance_op(node) && is_tree_root(node))
+		ARR_APP1(ir_node*, *roots, node);
+}
+
+void balance_expression_trees(ir_graph *irg)
+{
+	assure_irg_properties(irg,
+	                      IR_GRAPH_PROPERTY_CONSISTENT_LOOPINFO
+	                      | IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES);
+
+	/* the roots are collected in post order, so the operand trees of a
+	 * tree are balanced before the tree itself */
+	ir_node **roots = NEW_ARR_F(ir_node*, 0);
+	irg_walk_graph(irg, NULL, collect_tree_roots, &roots);
+	for (size_t i = 0, n = ARR_LEN(roots); i < n; ++i) {
+		balance_tree(roots[i]);
+	}
+	DEL_ARR_F(roots);
+
+	confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_CONTROL_FLOW);
+}
+
 /*
  * do the reassociation
  */
@@ -2111,6 +2344,11 @@ void optimize_reassociation(ir_graph *irg)
 	deq_free(&wq);
 
 	confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_CONTROL_FLOW);
+
+	if (get_optimize()) {
+		DBG((dbg, LEVEL_5, "balancing start...\n"));
+		balance_expression_trees(irg);
+	}
 }
 
 void ir_register_reassoc_node_ops(void)
@@ -22,6 +22,7 @@
 #include "iroptimize.h"
 #include "irouts_t.h"
 #include "irprog_t.h"
+#include "opt_init.h"
 #include "panic.h"
 #include "scalar_replace.h"
 #include "util.h"
@@ -583,7 +584,6 @@ static unsigned find_tail_rec_possibilities(tr_env *env, ir_graph *irg)
 
 void opt_tail_rec_irg(ir_graph *irg)
 {
-	FIRM_DBG_REGISTER(dbg, "firm.opt.tailrec");
 	assure_irg_properties(irg,
 		IR_GRAPH_PROPERTY_MANY_RETURNS
 		| IR_GRAPH_PROPERTY_NO_BADS
@@ -610,3 +610,8 @@ void opt_tail_rec_irg(ir_graph *irg)
 	free(env.parameter_projs);
 	ir_free_resources(irg, IR_RESOURCE_IRN_LINK);
 }
+
+void firm_init_tailrec(void)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.opt.tailrec");
+}
@@ -33,6 +33,7 @@
 #include "bitfiddle.h"
 #include "dbginfo.h"
 #include "entity_t.h"
+#include "firm_lock.h"
 #include "ircons.h"
 #include "irhooks.h"
 #include "irnode_t.h"
@@ -812,6 +813,7 @@ const char *get_compound_name(const ir_type *tp)
 void remove_compound_member(ir_type *type, ir_entity *member)
 {
 	assert(is_compound_type(type));
+	firm_lock_globals();
 	for (size_t i = 0, n = ARR_LEN(type->attr.compound.members); i < n; ++i) {
 		if (get_compound_member(type, i) != member)
 			continue;
@@ -826,11 +828,13 @@ void remove_compound_member(ir_type *type, ir_entity *member)
 		}
 		break;
 	}
+	firm_unlock_globals();
 }
 
 void add_compound_member(ir_type *type, ir_entity *entity)
 {
 	assert(is_compound_type(type));
+	firm_lock_globals();
 	/* try to detect double-add */
 	ARR_APP1(ir_entity *, type->attr.compound.members, entity);
 	/* Add segment members to globals map. */
@@ -842,6 +846,7 @@ void add_compound_member(ir_type *type, ir_entity *entity)
 		assert(NULL == pmap_get(ir_entity, globals, id));
 		pmap_insert(globals, id, entity);
 	}
+	firm_unlock_globals();
 }
 
 int is_code_type(ir_type const *const type)
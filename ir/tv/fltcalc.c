@@ -48,8 +48,8 @@ static unsigned fp_value_size;
 static unsigned value_size;
 static unsigned max_precision;
 
-/** Exact flag. */
-static bool fc_exact = true;
+/** Exact flag of the last operation of the current thread. */
+static THREAD_LOCAL bool fc_exact = true;
 
 static float_descriptor_t long_double_desc;
 
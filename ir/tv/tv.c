@@ -21,6 +21,7 @@
 #include "bitfiddle.h"
 #include "entity_t.h"
 #include "firm_common.h"
+#include "firm_lock.h"
 #include "fltcalc.h"
 #include "hashptr.h"
 #include "hashptr.h"
@@ -71,8 +72,11 @@ static int cmp_tv(const void *p1, const void *p2, size_t n)
 static ir_tarval *identify_tarval(ir_tarval const *const tv)
 {
 	unsigned hash = hash_tv(tv);
-	return set_insert(ir_tarval, tarvals, tv, sizeof(ir_tarval) + tv->length,
-	                  hash);
+	firm_lock_globals();
+	ir_tarval *const res = set_insert(ir_tarval, tarvals, tv,
+	                                  sizeof(ir_tarval) + tv->length, hash);
+	firm_unlock_globals();
+	return res;
 }
 
 static ir_tarval *get_fp_tarval(const fp_value *value, ir_mode *mode)
@@ -637,14 +641,15 @@ ir_tarval *tarval_convert_to(ir_tarval const *const src,
 			/* XXX floating point unit does not understand internal integer
 			 * representation, convert to string first, then create float from
 			 * string */
-			char *buffer = ALLOCAN(char, 100);
+			size_t const buf_len = sc_get_precision() + 1;
+			char  *const buffer  = ALLOCAN(char, buf_len);
 			/* decimal string representation because hexadecimal output is
 			 * interpreted unsigned by fc_val_from_str, so this is a HACK */
-			int len = snprintf(buffer, 100, "%s",
-				sc_print(src->value, get_mode_size_bits(src->mode), SC_DEC, mode_is_signed(src->mode)));
+			char const *const str = sc_print_buf(buffer, buf_len, src->value,
+				get_mode_size_bits(src->mode), SC_DEC, mode_is_signed(src->mode));
 
 			fp_value *fpval = (fp_value*)ALLOCAN(char, fp_value_size);
-			fc_val_from_str(buffer, len, fpval);
+			fc_val_from_str(str, strlen(str), fpval);
 			fc_cast(fpval, get_descriptor(dst_mode), fpval);
 			return get_fp_tarval(fpval, dst_mode);
 		}
@@ -1090,8 +1095,10 @@ int tarval_snprintf(char *buf, size_t len, ir_tarval const *tv)
 			return snprintf(buf, len, "NULL");
 		/* FALLTHROUGH */
 	case irms_int_number: {
-		unsigned    bits = get_mode_size_bits(tv->mode);
-		const char *str  = sc_print(tv->value, bits, SC_HEX, 0);
+		unsigned    bits    = get_mode_size_bits(tv->mode);
+		size_t      buf_len = sc_get_precision() + 1;
+		const char *str     = sc_print_buf(ALLOCAN(char, buf_len), buf_len,
+		                                   tv->value, bits, SC_HEX, 0);
 		return snprintf(buf, len, "0x%s", str);
 	}
 
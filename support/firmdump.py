@@ -0,0 +1,197 @@
+#! /usr/bin/env python
+#
+# This file is part of libFirm.
+# Copyright (C) 2012 Karlsruhe Institute of Technology.
+"""Convert streaming graph dumps (see dump_ir_graph_stream) to vcg or dot."""
+import json
+import optparse
+import subprocess
+import sys
+
+
+def open_dump(filename):
+    if filename == "-":
+        return sys.stdin
+    if not filename.endswith(".zst"):
+        return open(filename, "r")
+    try:
+        import io
+        import zstandard
+        reader = zstandard.ZstdDecompressor().stream_reader(open(filename, "rb"))
+        return io.TextIOWrapper(reader)
+    except ImportError:
+        proc = subprocess.Popen(["zstd", "-dc", filename], stdout=subprocess.PIPE,
+                                universal_newlines=True)
+        return proc.stdout
+
+
+class Node:
+    def __init__(self, record, strings):
+        self.nr = record["n"]
+        self.op = strings[record["o"]]
+        self.mode = strings[record["m"]]
+        self.attr = strings[record["a"]] if "a" in record else None
+        self.block = record.get("b")
+        self.freq = record.get("f")
+        src = record.get("src")
+        self.src = "%s:%d" % (strings[src[0]], src[1]) if src else None
+        self.ins = record["i"]
+
+    def is_block(self):
+        return self.block is None
+
+    def label(self):
+        label = self.op
+        if self.mode not in ("BB", "T"):
+            label += " " + self.mode
+        if self.attr is not None:
+            label += " " + self.attr
+        return "%s %d" % (label, self.nr)
+
+    def info(self):
+        info = []
+        if self.freq is not None:
+            info.append("freq: %g" % self.freq)
+        if self.src is not None:
+            info.append("src: %s" % self.src)
+        return ", ".join(info)
+
+    def edge_color(self, pred):
+        if self.is_block() or pred.mode == "X":
+            return "red"
+        if pred.mode == "M":
+            return "blue"
+        return None
+
+
+def read_dump(f):
+    strings = {}
+    nodes = []
+    graph = None
+    for line in f:
+        line = line.strip()
+        if not line:
+            continue
+        record = json.loads(line)
+        if "s" in record:
+            strings[record["s"]] = record["v"]
+        elif "n" in record:
+            nodes.append(Node(record, strings))
+        elif "format" in record:
+            if record["format"] != "firm-stream":
+                sys.stderr.write("not a firm stream dump\n")
+                sys.exit(1)
+            graph = strings[record["graph"]]
+    return graph, nodes
+
+
+def quote(string):
+    return '"%s"' % string.replace("\\", "\\\\").replace('"', '\\"')
+
+
+def edges(nodes, by_nr):
+    for node in nodes:
+        for pos, pred_nr in enumerate(node.ins):
+            pred = by_nr.get(pred_nr)
+            # skip edges to filtered nodes
+            if pred is not None:
+                yield node, pred, pos
+
+
+def emit_dot(out, graph, nodes):
+    by_nr = dict((node.nr, node) for node in nodes)
+    out.write("digraph %s {\n" % quote(graph))
+    out.write("\trankdir=BT;\n\tnode [shape=box];\n")
+    members = {}
+    for node in nodes:
+        if not node.is_block():
+            members.setdefault(node.block, []).append(node)
+    for node in nodes:
+        if not node.is_block():
+            continue
+        out.write("\tsubgraph cluster_%d {\n" % node.nr)
+        label = node.label()
+        if node.info():
+            label += " (%s)" % node.info()
+        out.write("\t\tlabel=%s;\n" % quote(label))
+        out.write("\t\tn%d [shape=point];\n" % node.nr)
+        for member in members.get(node.nr, []):
+            out.write("\t\tn%d [label=%s];\n" % (member.nr, quote(member.label())))
+        out.write("\t}\n")
+    for node in nodes:
+        if not node.is_block() and node.block not in by_nr:
+            out.write("\tn%d [label=%s];\n" % (node.nr, quote(node.label())))
+    for node, pred, pos in edges(nodes, by_nr):
+        attrs = "label=%d" % pos
+        color = node.edge_color(pred)
+        if color is not None:
+            attrs += ",color=%s" % color
+        out.write("\tn%d -> n%d [%s];\n" % (node.nr, pred.nr, attrs))
+    out.write("}\n")
+
+
+def emit_vcg(out, graph, nodes):
+    by_nr = dict((node.nr, node) for node in nodes)
+    out.write("graph: { title: %s\n" % quote(graph))
+    out.write("display_edge_labels: yes\nlayoutalgorithm: mindepth\n")
+    out.write("manhattan_edges: yes\nport_sharing: no\n")
+    out.write("orientation: bottom_to_top\n")
+    members = {}
+    for node in nodes:
+        if not node.is_block():
+            members.setdefault(node.block, []).append(node)
+
+    def emit_node(node):
+        out.write("node: { title: \"n%d\" label: %s" % (node.nr, quote(node.label())))
+        if node.info():
+            out.write(" info1: %s" % quote(node.info()))
+        out.write(" }\n")
+
+    for node in nodes:
+        if not node.is_block():
+            continue
+        out.write("graph: { title: \"n%d\" label: %s status:clustered\n"
+                  % (node.nr, quote(node.label())))
+        if node.info():
+            out.write("info1: %s\n" % quote(node.info()))
+        for member in members.get(node.nr, []):
+            emit_node(member)
+        out.write("}\n")
+    for node in nodes:
+        if not node.is_block() and node.block not in by_nr:
+            emit_node(node)
+    for node, pred, pos in edges(nodes, by_nr):
+        out.write("edge: { sourcename: \"n%d\" targetname: \"n%d\" label: \"%d\""
+                  % (node.nr, pred.nr, pos))
+        color = node.edge_color(pred)
+        if color is not None:
+            out.write(" color: %s" % color)
+        out.write(" }\n")
+    out.write("}\n")
+
+
+def main():
+    parser = optparse.OptionParser(usage="%prog [options] DUMP")
+    parser.add_option("-f", "--format", dest="format", default=None,
+                      choices=("vcg", "dot"),
+                      help="output format (vcg or dot, default: from output name or dot)")
+    parser.add_option("-o", "--output", dest="output", default="-",
+                      help="output file (default: stdout)")
+    options, args = parser.parse_args()
+    if len(args) != 1:
+        parser.error("expected exactly one dump file")
+
+    fmt = options.format
+    if fmt is None:
+        fmt = "vcg" if options.output.endswith(".vcg") else "dot"
+
+    graph, nodes = read_dump(open_dump(args[0]))
+    out = sys.stdout if options.output == "-" else open(options.output, "w")
+    if fmt == "vcg":
+        emit_vcg(out, graph, nodes)
+    else:
+        emit_dot(out, graph, nodes)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,90 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Measures the time libFirm needs to become ready for compiling.
+ *
+ * Every run happens in a fresh child process, as the library can only be
+ * initialized once per process. Usage: startup_bench [target triple [runs]]
+ */
+#include <firm.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+/** Initializes libFirm for @p triple and returns the time taken in usec. */
+static double measure_startup(char const *const triple)
+{
+	double const start = now();
+	ir_init_library();
+	if (!ir_target_set(triple)) {
+		fprintf(stderr, "unknown target '%s'\n", triple);
+		exit(1);
+	}
+	ir_target_init();
+	double const init = now() - start;
+	ir_finish();
+	return init;
+}
+
+static int compare_double(void const *const a, void const *const b)
+{
+	double const da = *(double const*)a;
+	double const db = *(double const*)b;
+	return da < db ? -1 : da > db;
+}
+
+int main(int argc, char **argv)
+{
+	char const *const triple = argc > 1 ? argv[1] : "x86_64-linux-gnu";
+	int         const runs   = argc > 2 ? atoi(argv[2]) : 100;
+	if (runs <= 0) {
+		fprintf(stderr, "usage: %s [target triple [runs]]\n", argv[0]);
+		return 1;
+	}
+
+	double *const times = malloc(runs * sizeof(*times));
+	for (int i = 0; i < runs; ++i) {
+		int fds[2];
+		if (pipe(fds) != 0) {
+			perror("pipe");
+			return 1;
+		}
+		pid_t const pid = fork();
+		if (pid == 0) {
+			double const time = measure_startup(triple);
+			if (write(fds[1], &time, sizeof(time)) != sizeof(time))
+				_exit(1);
+			_exit(0);
+		}
+		int status;
+		if (pid < 0 || read(fds[0], &times[i], sizeof(times[i])) != sizeof(times[i])
+		 || waitpid(pid, &status, 0) != pid || status != 0) {
+			fprintf(stderr, "benchmark run failed\n");
+			return 1;
+		}
+		close(fds[0]);
+		close(fds[1]);
+	}
+
+	qsort(times, runs, sizeof(*times), compare_double);
+	double sum = 0;
+	for (int i = 0; i < runs; ++i)
+		sum += times[i];
+	printf("%s: %d runs, min %.1f us, median %.1f us, mean %.1f us\n",
+	       triple, runs, times[0], times[runs / 2], sum / runs);
+	free(times);
+	return 0;
+}
@@ -0,0 +1,100 @@
+#include "firm.h"
+#include "testgraph.h"
+#include <assert.h>
+#include <stdbool.h>
+
+#define N_OPERANDS 8
+
+static unsigned get_add_depth(ir_node const *const node)
+{
+	if (!is_Add(node))
+		return 0;
+	unsigned const left  = get_add_depth(get_Add_left(node));
+	unsigned const right = get_add_depth(get_Add_right(node));
+	return 1 + (left > right ? left : right);
+}
+
+/* return ((a0 + a1) + a2) + ... + a7 */
+static void test_left_deep_tree(void)
+{
+	ir_graph *const irg = new_graph("left_deep", get_modeIs(), N_OPERANDS, 0);
+	ir_node *sum = get_param(irg, 0);
+	for (unsigned i = 1; i < N_OPERANDS; ++i)
+		sum = new_Add(sum, get_param(irg, i));
+	finish_graph(irg, sum);
+	assert(get_add_depth(get_return_value(irg)) == N_OPERANDS - 1);
+
+	balance_expression_trees(irg);
+	irg_verify(irg);
+	assert(get_add_depth(get_return_value(irg)) == 3);
+}
+
+/* s = 0; do { s = s + a0 + a1 + ... + a7; } while (s < a0); return s; */
+static void test_reduction(void)
+{
+	ir_mode  *const mode  = get_modeIs();
+	ir_graph *const irg   = new_graph("reduction", mode, N_OPERANDS, 1);
+	ir_node  *const zero  = new_Const_long(mode, 0);
+	ir_node  *params[N_OPERANDS];
+	for (unsigned i = 0; i < N_OPERANDS; ++i)
+		params[i] = get_param(irg, i);
+	set_value(0, zero);
+	ir_node *const entry = new_Jmp();
+
+	ir_node *const loop = new_immBlock();
+	add_immBlock_pred(loop, entry);
+	set_cur_block(loop);
+	ir_node *sum = get_value(0, mode);
+	for (unsigned i = 0; i < N_OPERANDS; ++i)
+		sum = new_Add(sum, params[i]);
+	set_value(0, sum);
+	ir_node *const cmp  = new_Cmp(sum, params[0], ir_relation_less);
+	ir_node *const cond = new_Cond(cmp);
+	add_immBlock_pred(loop, new_Proj(cond, get_modeX(), pn_Cond_true));
+	mature_immBlock(loop);
+
+	ir_node *const exit = new_immBlock();
+	add_immBlock_pred(exit, new_Proj(cond, get_modeX(), pn_Cond_false));
+	mature_immBlock(exit);
+	set_cur_block(exit);
+	finish_graph(irg, get_value(0, mode));
+
+	balance_expression_trees(irg);
+	irg_verify(irg);
+
+	/* The accumulator is added last to the balanced sum of the operands. */
+	ir_node *const root = get_return_value(irg);
+	assert(is_Add(root));
+	ir_node *const left  = get_Add_left(root);
+	ir_node *const right = get_Add_right(root);
+	assert(is_Phi(left) || is_Phi(right));
+	ir_node *const rest = is_Phi(left) ? right : left;
+	assert(get_add_depth(rest) == 3);
+}
+
+/* return ((a0 + a1) + a2) + ... + a7 for floating point values */
+static void test_reassociation(void)
+{
+	ir_graph *const irg = new_graph("float_sum", get_modeD(), N_OPERANDS, 0);
+	ir_node *sum = get_param(irg, 0);
+	for (unsigned i = 1; i < N_OPERANDS; ++i)
+		sum = new_Add(sum, get_param(irg, i));
+	finish_graph(irg, sum);
+
+	/* Setsort leaves floating point values alone, but they are balanced
+	 * afterwards. */
+	ir_allow_imprecise_float_transforms(true);
+	optimize_reassociation(irg);
+	irg_verify(irg);
+	assert(get_add_depth(get_return_value(irg)) == 3);
+	ir_allow_imprecise_float_transforms(false);
+}
+
+int main(void)
+{
+	ir_init();
+	test_left_deep_tree();
+	test_reduction();
+	test_reassociation();
+	return 0;
+}
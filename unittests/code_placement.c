@@ -0,0 +1,183 @@
+#include "firm.h"
+#include "execfreq_t.h"
+#include "testgraph.h"
+#include <assert.h>
+#include <stdbool.h>
+
+/** Creates "if (x > 0)" and returns the true and false blocks. */
+static void new_if(ir_node *const x, ir_node **const then_block,
+                   ir_node **const else_block)
+{
+	ir_node *const cmp  = new_Cmp(x, new_Const_long(get_modeIs(), 0),
+	                              ir_relation_greater);
+	ir_node *const cond = new_Cond(cmp);
+	*then_block = new_immBlock();
+	add_immBlock_pred(*then_block, new_Proj(cond, get_modeX(), pn_Cond_true));
+	mature_immBlock(*then_block);
+	*else_block = new_immBlock();
+	add_immBlock_pred(*else_block, new_Proj(cond, get_modeX(), pn_Cond_false));
+	mature_immBlock(*else_block);
+}
+
+/** Sets value 0 to x + val in block and returns a jump out of it. */
+static ir_node *new_use(ir_node *const block, ir_node *const x, long const val)
+{
+	set_cur_block(block);
+	set_value(0, new_Add(x, new_Const_long(get_modeIs(), val)));
+	return new_Jmp();
+}
+
+typedef struct find_env_t {
+	unsigned  opcode;
+	ir_node  *nodes[2];
+	unsigned  n_nodes;
+} find_env_t;
+
+static void find_node(ir_node *node, void *data)
+{
+	find_env_t *const env = (find_env_t*)data;
+	if (get_irn_opcode(node) == env->opcode && env->n_nodes < 2)
+		env->nodes[env->n_nodes++] = node;
+}
+
+/** Returns the number of nodes with opcode in irg and stores them in env. */
+static unsigned find_nodes(ir_graph *const irg, unsigned const opcode,
+                           find_env_t *const env)
+{
+	env->opcode  = opcode;
+	env->n_nodes = 0;
+	irg_walk_graph(irg, find_node, NULL, env);
+	return env->n_nodes;
+}
+
+typedef struct branches_t {
+	ir_node *start;
+	ir_node *then1;
+	ir_node *else1;
+	ir_node *then2;
+	ir_node *else2;
+	ir_node *join;
+} branches_t;
+
+/*
+ * x = a OP b;
+ * if (a > 0) r = x + 1; else if (b > 0) r = x + 2; else r = c;
+ * return r;
+ */
+static ir_graph *new_branches(char const *const name, bool const mul,
+                              branches_t *const b)
+{
+	ir_graph *const irg = new_graph(name, get_modeIs(), 3, 1);
+	ir_node  *const p0  = get_param(irg, 0);
+	ir_node  *const p1  = get_param(irg, 1);
+	ir_node  *const x   = mul ? new_Mul(p0, p1) : new_Eor(p0, p1);
+	b->start = get_nodes_block(x);
+	new_if(p0, &b->then1, &b->else1);
+	ir_node *const jmp1 = new_use(b->then1, x, 1);
+
+	set_cur_block(b->else1);
+	new_if(p1, &b->then2, &b->else2);
+	ir_node *const jmp2 = new_use(b->then2, x, 2);
+	set_cur_block(b->else2);
+	set_value(0, get_param(irg, 2));
+	ir_node *const jmp3 = new_Jmp();
+
+	b->join = new_immBlock();
+	add_immBlock_pred(b->join, jmp1);
+	add_immBlock_pred(b->join, jmp2);
+	add_immBlock_pred(b->join, jmp3);
+	mature_immBlock(b->join);
+	set_cur_block(b->join);
+	finish_graph(irg, get_value(0, get_modeIs()));
+	return irg;
+}
+
+static void test_duplicate(void)
+{
+	branches_t      b;
+	ir_graph *const irg = new_branches("duplicate", false, &b);
+
+	/* The branches using x run less often than its block. */
+	sink_partially_dead_code(irg);
+	irg_verify(irg);
+	find_env_t env;
+	assert(find_nodes(irg, iro_Eor, &env) == 2);
+	ir_node *const block0 = get_nodes_block(env.nodes[0]);
+	ir_node *const block1 = get_nodes_block(env.nodes[1]);
+	assert((block0 == b.then1 && block1 == b.then2)
+	       || (block0 == b.then2 && block1 == b.then1));
+}
+
+static void test_expensive(void)
+{
+	branches_t      b;
+	ir_graph *const irg = new_branches("expensive", true, &b);
+
+	/* A multiplication is too expensive to be computed twice. */
+	sink_partially_dead_code(irg);
+	irg_verify(irg);
+	find_env_t env;
+	assert(find_nodes(irg, iro_Mul, &env) == 1);
+	assert(get_nodes_block(env.nodes[0]) == b.start);
+}
+
+static void test_profile(void)
+{
+	branches_t      b;
+	ir_graph *const irg = new_branches("profile", false, &b);
+
+	/* The profile says, that x is almost always used. */
+	set_block_execfreq(get_irg_start_block(irg), 1.0);
+	set_block_execfreq(get_irg_end_block(irg), 1.0);
+	set_block_execfreq(b.start, 1.0);
+	set_block_execfreq(b.then1, 0.6);
+	set_block_execfreq(b.else1, 0.4);
+	set_block_execfreq(b.then2, 0.39);
+	set_block_execfreq(b.else2, 0.01);
+	set_block_execfreq(b.join,  1.0);
+	set_execfreq_from_profile(irg);
+
+	sink_partially_dead_code(irg);
+	irg_verify(irg);
+	find_env_t env;
+	assert(find_nodes(irg, iro_Eor, &env) == 1);
+	assert(get_nodes_block(env.nodes[0]) == b.start);
+}
+
+/* x = a * b; if (a > 0) r = x + 1; else r = x + 2; return r; */
+static void test_all_paths(void)
+{
+	ir_graph *const irg   = new_graph("all_paths", get_modeIs(), 3, 1);
+	ir_node  *const a     = get_param(irg, 0);
+	ir_node  *const x     = new_Mul(a, get_param(irg, 1));
+	ir_node  *const block = get_nodes_block(x);
+	ir_node  *then_block;
+	ir_node  *else_block;
+	new_if(a, &then_block, &else_block);
+	ir_node *const then_jmp = new_use(then_block, x, 1);
+	ir_node *const else_jmp = new_use(else_block, x, 2);
+
+	ir_node *const join = new_immBlock();
+	add_immBlock_pred(join, then_jmp);
+	add_immBlock_pred(join, else_jmp);
+	mature_immBlock(join);
+	set_cur_block(join);
+	finish_graph(irg, get_value(0, get_modeIs()));
+
+	/* x is needed on every path, so it is not duplicated. */
+	sink_partially_dead_code(irg);
+	irg_verify(irg);
+	find_env_t env;
+	assert(find_nodes(irg, iro_Mul, &env) == 1);
+	assert(get_nodes_block(env.nodes[0]) == block);
+}
+
+int main(void)
+{
+	ir_init();
+	test_duplicate();
+	test_expensive();
+	test_profile();
+	test_all_paths();
+	return 0;
+}
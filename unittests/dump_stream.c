@@ -0,0 +1,183 @@
+#include "firm.h"
+#include "testgraph.h"
+#include "xmalloc.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_STRINGS 64
+#define MAX_NODES   64
+
+/* return x * 3 + 3; */
+static ir_graph *new_test_graph(void)
+{
+	ir_graph *const irg   = new_graph("stream", get_modeIs(), 1, 0);
+	ir_node  *const x     = get_param(irg, 0);
+	ir_node  *const three = new_Const_long(get_modeIs(), 3);
+	finish_graph(irg, new_Add(new_Mul(x, three), three));
+	return irg;
+}
+
+/** Dumps irg into a string, which the caller has to free. */
+static char *dump_to_string(ir_graph *const irg)
+{
+	FILE *const f = tmpfile();
+	assert(f != NULL);
+	dump_ir_graph_stream(f, irg);
+	long const size = ftell(f);
+	assert(size > 0);
+	rewind(f);
+	char *const buf = XMALLOCN(char, size + 1);
+	assert(fread(buf, 1, size, f) == (size_t)size);
+	buf[size] = '\0';
+	fclose(f);
+	return buf;
+}
+
+typedef struct stream_t {
+	char     *strings[MAX_STRINGS];
+	unsigned  n_strings;
+	long      nodes[MAX_NODES];
+	unsigned  n_nodes;
+	unsigned  graph;
+	bool      ended;
+} stream_t;
+
+static bool has_string(stream_t const *const s, unsigned const id)
+{
+	return id < s->n_strings;
+}
+
+static bool has_node(stream_t const *const s, long const nr)
+{
+	for (unsigned i = 0; i < s->n_nodes; ++i) {
+		if (s->nodes[i] == nr)
+			return true;
+	}
+	return false;
+}
+
+static void read_string(stream_t *const s, char const *const line)
+{
+	unsigned id;
+	int      pos;
+	assert(sscanf(line, "{\"s\":%u,\"v\":\"%n", &id, &pos) == 1);
+	/* ids are assigned in order of first use */
+	assert(id == s->n_strings && id < MAX_STRINGS);
+	char const *const begin = line + pos;
+	char const *const end   = strchr(begin, '"');
+	assert(end != NULL);
+	size_t const len = end - begin;
+	char *const  str = XMALLOCN(char, len + 1);
+	memcpy(str, begin, len);
+	str[len] = '\0';
+	/* every string is written once */
+	for (unsigned i = 0; i < s->n_strings; ++i)
+		assert(strcmp(s->strings[i], str) != 0);
+	s->strings[s->n_strings++] = str;
+}
+
+static void read_node(stream_t *const s, char const *const line)
+{
+	long     nr;
+	unsigned op;
+	unsigned mode;
+	assert(sscanf(line, "{\"n\":%ld,\"o\":%u,\"m\":%u", &nr, &op, &mode)
+	       == 3);
+	assert(has_string(s, op) && has_string(s, mode));
+
+	unsigned    attr;
+	char const *const a = strstr(line, "\"a\":");
+	if (a != NULL) {
+		assert(sscanf(a, "\"a\":%u", &attr) == 1);
+		assert(has_string(s, attr));
+	}
+	long        block;
+	char const *const b = strstr(line, "\"b\":");
+	if (b != NULL) {
+		assert(sscanf(b, "\"b\":%ld", &block) == 1);
+		assert(has_node(s, block));
+	}
+
+	/* nodes come in post order, the graph has no backedges */
+	char const *in = strstr(line, "\"i\":[");
+	assert(in != NULL);
+	in += 5;
+	while (*in != ']') {
+		char *end;
+		long const pred = strtol(in, &end, 10);
+		assert(end != in && has_node(s, pred));
+		in = *end == ',' ? end + 1 : end;
+	}
+	assert(s->n_nodes < MAX_NODES);
+	s->nodes[s->n_nodes++] = nr;
+}
+
+/** Reads a stream dump and checks its structure. */
+static void read_stream(stream_t *const s, char *const dump)
+{
+	memset(s, 0, sizeof(*s));
+	bool has_header = false;
+	for (char *line = strtok(dump, "\n"); line != NULL;
+	     line = strtok(NULL, "\n")) {
+		assert(!s->ended);
+		unsigned value;
+		if (strncmp(line, "{\"s\":", 5) == 0) {
+			read_string(s, line);
+		} else if (sscanf(line, "{\"format\":\"firm-stream\",\"version\":1,\"graph\":%u", &value) == 1) {
+			assert(!has_header && has_string(s, value));
+			has_header = true;
+			s->graph   = value;
+		} else if (sscanf(line, "{\"end\":%u", &value) == 1) {
+			assert(has_header && value == s->n_nodes);
+			s->ended = true;
+		} else {
+			assert(has_header);
+			read_node(s, line);
+		}
+	}
+	assert(s->ended);
+}
+
+static bool has_string_value(stream_t const *const s, char const *const str)
+{
+	for (unsigned i = 0; i < s->n_strings; ++i) {
+		if (strcmp(s->strings[i], str) == 0)
+			return true;
+	}
+	return false;
+}
+
+static void free_stream(stream_t *const s)
+{
+	for (unsigned i = 0; i < s->n_strings; ++i)
+		free(s->strings[i]);
+}
+
+int main(void)
+{
+	ir_init();
+	ir_graph *const irg = new_test_graph();
+
+	char *const dump = dump_to_string(irg);
+	char *const copy = xstrdup(dump);
+
+	stream_t s;
+	read_stream(&s, copy);
+	assert(strcmp(s.strings[s.graph], "stream") == 0);
+	assert(has_string_value(&s, "Add") && has_string_value(&s, "Mul"));
+	assert(has_string_value(&s, "Return") && has_string_value(&s, "Is"));
+	assert(has_string_value(&s, "start") && has_string_value(&s, "end"));
+	free_stream(&s);
+
+	/* Each dump has its own strings, so dumping again gives the same output. */
+	char *const again = dump_to_string(irg);
+	assert(strcmp(dump, again) == 0);
+
+	free(again);
+	free(copy);
+	free(dump);
+	return 0;
+}
@@ -0,0 +1,110 @@
+#include "firm.h"
+#include "testgraph.h"
+#include <assert.h>
+#include <stdbool.h>
+
+static ir_node *new_call(ir_entity *const callee, int const n_params,
+                         ir_node *const *const in)
+{
+	ir_type *const type = get_entity_type(callee);
+	ir_node *const call = new_Call(get_store(), new_Address(callee), n_params,
+	                               in, type);
+	set_store(new_Proj(call, get_modeM(), pn_Call_M));
+	ir_node *const results = new_Proj(call, get_modeT(), pn_Call_T_result);
+	ir_mode *const mode    = get_type_mode(get_method_res_type(type, 0));
+	return new_Proj(results, mode, 0);
+}
+
+static void count_node(ir_node *node, void *env)
+{
+	unsigned *const counts = (unsigned*)env;
+	if (is_Call(node)) {
+		++counts[0];
+	} else if (is_Builtin(node)) {
+		ir_builtin_kind const kind = get_Builtin_kind(node);
+		if (kind == ir_bk_sqrt)
+			++counts[1];
+		else if (kind == ir_bk_fmin)
+			++counts[2];
+	}
+}
+
+static void count_nodes(ir_graph *const irg, unsigned *const n_calls,
+                        unsigned *const n_sqrts, unsigned *const n_fmins)
+{
+	unsigned counts[3] = { 0, 0, 0 };
+	irg_walk_graph(irg, count_node, NULL, counts);
+	*n_calls = counts[0];
+	*n_sqrts = counts[1];
+	*n_fmins = counts[2];
+}
+
+/* return fmin(sqrt(x), y) in the given mode */
+static ir_graph *new_math_graph(char const *const name, ir_mode *const mode,
+                                ir_entity *const sqrt_entity,
+                                ir_entity *const fmin_entity)
+{
+	ir_graph *const irg  = new_graph(name, mode, 2, 0);
+	ir_node  *const x    = get_param(irg, 0);
+	ir_node  *const root = new_call(sqrt_entity, 1, &x);
+	ir_node  *const in[] = { root, get_param(irg, 1) };
+	finish_graph(irg, new_call(fmin_entity, 2, in));
+	return irg;
+}
+
+int main(void)
+{
+	ir_init();
+
+	ir_mode   *const mode_D   = get_modeD();
+	ir_mode   *const mode_Is  = get_modeIs();
+	ir_entity *const sqrt_ent = new_function("sqrt", new_method_type(mode_D, 1),
+	                                         ir_visibility_external);
+	ir_entity *const fmin_ent = new_function("fmin", new_method_type(mode_D, 2),
+	                                         ir_visibility_external);
+	ir_entity *const isqrt    = new_function("isqrt", new_method_type(mode_Is, 1),
+	                                         ir_visibility_external);
+	ir_entity *const imin     = new_function("imin", new_method_type(mode_Is, 2),
+	                                         ir_visibility_external);
+
+	i_record records[4];
+	ir_entity     *const entities[] = { sqrt_ent, fmin_ent, isqrt, imin };
+	i_mapper_func *const mappers[]  = { i_mapper_sqrt, i_mapper_fmin,
+	                                    i_mapper_sqrt, i_mapper_fmin };
+	for (unsigned i = 0; i < 4; ++i) {
+		records[i].i_call.kind     = INTRINSIC_CALL;
+		records[i].i_call.i_ent    = entities[i];
+		records[i].i_call.i_mapper = mappers[i];
+	}
+	ir_intrinsics_map *const map = ir_create_intrinsics_map(records, 4, 0);
+
+	unsigned n_calls;
+	unsigned n_sqrts;
+	unsigned n_fmins;
+
+	/* Without fast math, the library calls are kept. */
+	ir_graph *const strict = new_math_graph("strict", mode_D, sqrt_ent,
+	                                        fmin_ent);
+	ir_lower_intrinsics(strict, map);
+	irg_verify(strict);
+	count_nodes(strict, &n_calls, &n_sqrts, &n_fmins);
+	assert(n_calls == 2 && n_sqrts == 0 && n_fmins == 0);
+
+	/* With fast math, they become Builtins. */
+	set_opt_fast_math(1);
+	ir_graph *const fast = new_math_graph("fast", mode_D, sqrt_ent, fmin_ent);
+	ir_lower_intrinsics(fast, map);
+	irg_verify(fast);
+	count_nodes(fast, &n_calls, &n_sqrts, &n_fmins);
+	assert(n_calls == 0 && n_sqrts == 1 && n_fmins == 1);
+
+	/* Functions on integers are not floating point Builtins. */
+	ir_graph *const integer = new_math_graph("integer", mode_Is, isqrt, imin);
+	ir_lower_intrinsics(integer, map);
+	irg_verify(integer);
+	count_nodes(integer, &n_calls, &n_sqrts, &n_fmins);
+	assert(n_calls == 2 && n_sqrts == 0 && n_fmins == 0);
+
+	ir_free_intrinsics_map(map);
+	return 0;
+}
@@ -0,0 +1,149 @@
+#include "firm.h"
+#include "testgraph.h"
+#include "xmalloc.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CUP_NAME "hotpath_instrument"
+#define MAP_FILE CUP_NAME ".hotprof.map"
+
+/*
+ * int loop(int n)
+ * {
+ *     int s = 0;
+ *     for (int i = 0; i < n; ++i)
+ *         s += callee(i);
+ *     return s;
+ * }
+ */
+static void new_loop_graph(void)
+{
+	ir_mode   *const mode   = get_modeIs();
+	ir_graph  *const irg    = new_graph("loop", mode, 1, 2);
+	ir_type   *const type   = get_entity_type(get_irg_entity(irg));
+	ir_entity *const callee = new_function("callee", type,
+	                                       ir_visibility_external);
+	ir_node   *const n      = get_param(irg, 0);
+
+	set_value(0, new_Const_long(mode, 0));
+	set_value(1, new_Const_long(mode, 0));
+	ir_node *const entry_jmp = new_Jmp();
+
+	ir_node *const header = new_immBlock();
+	add_immBlock_pred(header, entry_jmp);
+	set_cur_block(header);
+	ir_node *const cmp  = new_Cmp(get_value(1, mode), n, ir_relation_less);
+	ir_node *const cond = new_Cond(cmp);
+
+	ir_node *const body = new_immBlock();
+	add_immBlock_pred(body, new_Proj(cond, get_modeX(), pn_Cond_true));
+	mature_immBlock(body);
+	set_cur_block(body);
+	ir_node *const i    = get_value(1, mode);
+	ir_node *const call = new_Call(get_store(), new_Address(callee), 1, &i,
+	                               type);
+	set_store(new_Proj(call, get_modeM(), pn_Call_M));
+	ir_node *const results = new_Proj(call, get_modeT(), pn_Call_T_result);
+	set_value(0, new_Add(get_value(0, mode), new_Proj(results, mode, 0)));
+	set_value(1, new_Add(i, new_Const_long(mode, 1)));
+	add_immBlock_pred(header, new_Jmp());
+	mature_immBlock(header);
+
+	ir_node *const exit = new_immBlock();
+	add_immBlock_pred(exit, new_Proj(cond, get_modeX(), pn_Cond_false));
+	mature_immBlock(exit);
+	set_cur_block(exit);
+	finish_graph(irg, get_value(0, mode));
+}
+
+/** Emits the program and returns the assembly, which the caller has to free. */
+static char *emit_to_string(void)
+{
+	FILE *const f = tmpfile();
+	assert(f != NULL);
+	be_main(f, CUP_NAME);
+	long const size = ftell(f);
+	assert(size > 0);
+	rewind(f);
+	char *const buf = XMALLOCN(char, size + 1);
+	assert(fread(buf, 1, size, f) == (size_t)size);
+	buf[size] = '\0';
+	fclose(f);
+	return buf;
+}
+
+/** Reads the counter map and checks that the counters are numbered in order. */
+static unsigned read_map(char kinds[][32], char details[][32],
+                         unsigned const max)
+{
+	FILE *const f = fopen(MAP_FILE, "r");
+	assert(f != NULL);
+	unsigned n = 0;
+	char     line[128];
+	while (fgets(line, sizeof(line), f) != NULL) {
+		assert(n < max);
+		unsigned slot;
+		char     function[32];
+		details[n][0] = '\0';
+		int const n_fields = sscanf(line, "%u %31s %31s %31s", &slot,
+		                            kinds[n], function, details[n]);
+		assert(n_fields >= 3 && slot == n);
+		assert(strcmp(function, "loop") == 0);
+		++n;
+	}
+	fclose(f);
+	remove(MAP_FILE);
+	return n;
+}
+
+static bool has_counter(char kinds[][32], char details[][32], unsigned const n,
+                        char const *const kind, char const *const detail)
+{
+	for (unsigned i = 0; i < n; ++i) {
+		if (strcmp(kinds[i], kind) == 0 && strcmp(details[i], detail) == 0)
+			return true;
+	}
+	return false;
+}
+
+int main(void)
+{
+	ir_init_library();
+	if (!ir_target_set("x86_64-linux-gnu"))
+		return 1;
+	if (ir_target_option("instrument=all") != 1)
+		return 1;
+	ir_target_init();
+
+	new_loop_graph();
+	char *const assembly = emit_to_string();
+	/* the cycle counter is read at the entry and at the Return */
+	char const *const rdtsc = strstr(assembly, "rdtsc");
+	assert(rdtsc != NULL && strstr(rdtsc + 1, "rdtsc") != NULL);
+	assert(strstr(assembly, "__FIRMPROF__HOTPATH_COUNTS") != NULL);
+	assert(strstr(assembly, "__firmprof_hotpath_initializer") != NULL);
+	free(assembly);
+
+	char           kinds[8][32];
+	char           details[8][32];
+	unsigned const n = read_map(kinds, details, 8);
+	assert(n == 6);
+	assert(strcmp(kinds[0], "cycles_low") == 0);
+	assert(strcmp(kinds[1], "cycles_high") == 0);
+	assert(has_counter(kinds, details, n, "entry", ""));
+	assert(has_counter(kinds, details, n, "call", "callee"));
+	/* the entry and iteration counters of a loop name its header */
+	unsigned n_loop_counters = 0;
+	for (unsigned i = 0; i < n; ++i) {
+		if (strcmp(kinds[i], "loop_entries") == 0) {
+			assert(has_counter(kinds, details, n, "loop_iterations",
+			                   details[i]));
+			++n_loop_counters;
+		}
+	}
+	assert(n_loop_counters == 1);
+	return 0;
+}
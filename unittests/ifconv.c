@@ -0,0 +1,227 @@
+#include "firm.h"
+#include "execfreq_t.h"
+#include "testgraph.h"
+#include <assert.h>
+#include <stdbool.h>
+
+static int allow_all(ir_node const *sel, ir_node const *mux_false,
+                     ir_node const *mux_true)
+{
+	(void)sel;
+	(void)mux_false;
+	(void)mux_true;
+	return true;
+}
+
+static int allow_none(ir_node const *sel, ir_node const *mux_false,
+                      ir_node const *mux_true)
+{
+	(void)sel;
+	(void)mux_false;
+	(void)mux_true;
+	return false;
+}
+
+/** Returns a floating division, which is the most expensive operation. */
+static ir_node *new_floating_div(ir_node *const left, ir_node *const right)
+{
+	ir_node *const div = new_Div(get_store(), left, right,
+	                             op_pin_state_floats);
+	return new_Proj(div, get_modeIs(), pn_Div_res);
+}
+
+static void count_node(ir_node *node, void *env)
+{
+	unsigned *const counts = (unsigned*)env;
+	if (is_Mux(node))
+		++counts[0];
+	else if (is_Phi(node))
+		++counts[1];
+	else if (is_Cond(node))
+		++counts[2];
+}
+
+static void count_nodes(ir_graph *const irg, unsigned *const n_muxes,
+                        unsigned *const n_phis, unsigned *const n_conds)
+{
+	unsigned counts[3] = { 0, 0, 0 };
+	irg_walk_graph(irg, count_node, NULL, counts);
+	*n_muxes = counts[0];
+	*n_phis  = counts[1];
+	*n_conds = counts[2];
+}
+
+/* return a < b ? a : a / b; built as Mux */
+static ir_graph *new_mux_graph(char const *const name)
+{
+	ir_graph *const irg = new_graph(name, get_modeIs(), 2, 1);
+	ir_node  *const a   = get_param(irg, 0);
+	ir_node  *const b   = get_param(irg, 1);
+	ir_node  *const cmp = new_Cmp(a, b, ir_relation_less);
+	ir_node  *const mux = new_Mux(cmp, new_floating_div(a, b), a);
+	finish_graph(irg, mux);
+	return irg;
+}
+
+typedef enum arm_cost {
+	ARMS_FREE,      /**< x = a; x = b */
+	ARMS_CHEAP,     /**< x = a + 1; x = b + 2 */
+	ARMS_EXPENSIVE, /**< x = a / b; x = b */
+} arm_cost;
+
+/* if (a < b) x = <then>; else x = <else>; return x; */
+static ir_graph *new_diamond_graph(char const *const name, arm_cost const cost)
+{
+	ir_mode  *const mode = get_modeIs();
+	ir_graph *const irg  = new_graph(name, mode, 2, 1);
+	ir_node  *const a    = get_param(irg, 0);
+	ir_node  *const b    = get_param(irg, 1);
+	ir_node  *const cond = new_Cond(new_Cmp(a, b, ir_relation_less));
+
+	ir_node *const then_block = new_immBlock();
+	add_immBlock_pred(then_block, new_Proj(cond, get_modeX(), pn_Cond_true));
+	mature_immBlock(then_block);
+	set_cur_block(then_block);
+	set_value(0, cost == ARMS_FREE      ? a
+	           : cost == ARMS_EXPENSIVE ? new_floating_div(a, b)
+	           : new_Add(a, new_Const_long(mode, 1)));
+	ir_node *const then_jmp = new_Jmp();
+
+	ir_node *const else_block = new_immBlock();
+	add_immBlock_pred(else_block, new_Proj(cond, get_modeX(), pn_Cond_false));
+	mature_immBlock(else_block);
+	set_cur_block(else_block);
+	set_value(0, cost == ARMS_CHEAP ? new_Add(b, new_Const_long(mode, 2)) : b);
+	ir_node *const else_jmp = new_Jmp();
+
+	ir_node *const join = new_immBlock();
+	add_immBlock_pred(join, then_jmp);
+	add_immBlock_pred(join, else_jmp);
+	mature_immBlock(join);
+	set_cur_block(join);
+	finish_graph(irg, get_value(0, mode));
+	return irg;
+}
+
+/*
+ * if (a < b) {} else {}
+ * return a < b ? a : a / b;
+ */
+static ir_graph *new_branch_and_mux_graph(char const *const name)
+{
+	ir_graph *const irg  = new_graph(name, get_modeIs(), 2, 1);
+	ir_node  *const a    = get_param(irg, 0);
+	ir_node  *const b    = get_param(irg, 1);
+	ir_node  *const cmp  = new_Cmp(a, b, ir_relation_less);
+	ir_node  *const cond = new_Cond(cmp);
+
+	ir_node *const then_block = new_immBlock();
+	add_immBlock_pred(then_block, new_Proj(cond, get_modeX(), pn_Cond_true));
+	mature_immBlock(then_block);
+	set_cur_block(then_block);
+	ir_node *const then_jmp = new_Jmp();
+
+	ir_node *const else_block = new_immBlock();
+	add_immBlock_pred(else_block, new_Proj(cond, get_modeX(), pn_Cond_false));
+	mature_immBlock(else_block);
+	set_cur_block(else_block);
+	ir_node *const else_jmp = new_Jmp();
+
+	ir_node *const join = new_immBlock();
+	add_immBlock_pred(join, then_jmp);
+	add_immBlock_pred(join, else_jmp);
+	mature_immBlock(join);
+	set_cur_block(join);
+	finish_graph(irg, new_Mux(cmp, new_floating_div(a, b), a));
+	return irg;
+}
+
+static void set_profile_freq(ir_node *block, void *env)
+{
+	double const prob = *(double const*)env;
+	double       freq = 1.0;
+	if (get_Block_n_cfgpreds(block) == 1) {
+		ir_node *const pred = get_Block_cfgpred(block, 0);
+		if (is_Proj(pred) && is_Cond(get_Proj_pred(pred)))
+			freq = get_Proj_num(pred) == pn_Cond_true ? prob : 1.0 - prob;
+	}
+	set_block_execfreq(block, freq);
+}
+
+/** Sets a profile, in which every Cond in irg is true with probability prob. */
+static void set_profile(ir_graph *const irg, double prob)
+{
+	irg_block_walk_graph(irg, set_profile_freq, NULL, &prob);
+	set_execfreq_from_profile(irg);
+}
+
+int main(void)
+{
+	ir_init();
+
+	unsigned n_muxes;
+	unsigned n_phis;
+	unsigned n_conds;
+
+	/* A Mux supported by the target is kept, even if it is expensive. */
+	ir_graph *const kept = new_mux_graph("kept");
+	opt_if_conv_cb(kept, allow_all);
+	irg_verify(kept);
+	count_nodes(kept, &n_muxes, &n_phis, &n_conds);
+	assert(n_muxes == 1 && n_conds == 0);
+
+	/* An expensive Mux, which the target does not support, is split. The
+	 * cost of the Div is charged through its Proj. */
+	ir_graph *const split = new_mux_graph("split");
+	opt_if_conv_cb(split, allow_none);
+	irg_verify(split);
+	count_nodes(split, &n_muxes, &n_phis, &n_conds);
+	assert(n_muxes == 0 && n_phis == 1 && n_conds == 1);
+
+	/* Cheap arms are converted. */
+	ir_graph *const cheap = new_diamond_graph("cheap", ARMS_CHEAP);
+	opt_if_conv_cb(cheap, allow_all);
+	irg_verify(cheap);
+	count_nodes(cheap, &n_muxes, &n_phis, &n_conds);
+	assert(n_muxes == 1 && n_phis == 0 && n_conds == 0);
+
+	/* An arm with a division costs more than a mispredicted branch. */
+	ir_graph *const expensive = new_diamond_graph("expensive", ARMS_EXPENSIVE);
+	opt_if_conv_cb(expensive, allow_all);
+	irg_verify(expensive);
+	count_nodes(expensive, &n_muxes, &n_phis, &n_conds);
+	assert(n_muxes == 0 && n_phis == 1 && n_conds == 1);
+
+	/* Selecting between available values is cheaper than a branch. */
+	ir_graph *const selection = new_diamond_graph("free", ARMS_FREE);
+	opt_if_conv_cb(selection, allow_all);
+	irg_verify(selection);
+	count_nodes(selection, &n_muxes, &n_phis, &n_conds);
+	assert(n_muxes == 1 && n_phis == 0 && n_conds == 0);
+
+	/* A well predicted branch is kept anyway. */
+	ir_graph *const biased = new_diamond_graph("biased", ARMS_FREE);
+	set_profile(biased, 0.95);
+	opt_if_conv_cb(biased, allow_all);
+	irg_verify(biased);
+	count_nodes(biased, &n_muxes, &n_phis, &n_conds);
+	assert(n_muxes == 0 && n_phis == 1 && n_conds == 1);
+
+	/* A supported Mux is kept, if nothing is known about its selector. */
+	ir_graph *const unknown = new_branch_and_mux_graph("unknown");
+	opt_if_conv_cb(unknown, allow_all);
+	irg_verify(unknown);
+	count_nodes(unknown, &n_muxes, &n_phis, &n_conds);
+	assert(n_muxes == 1 && n_conds == 1);
+
+	/* A supported, expensive Mux is split, if a branch on the same selector
+	 * shows that it is biased. */
+	ir_graph *const biased_mux = new_branch_and_mux_graph("biased_mux");
+	set_profile(biased_mux, 0.95);
+	opt_if_conv_cb(biased_mux, allow_all);
+	irg_verify(biased_mux);
+	count_nodes(biased_mux, &n_muxes, &n_phis, &n_conds);
+	assert(n_muxes == 0 && n_phis == 1 && n_conds == 2);
+
+	return 0;
+}
@@ -0,0 +1,134 @@
+#include "firm.h"
+#include "testgraph.h"
+#include <assert.h>
+#include <stdbool.h>
+
+static ir_node *new_call(ir_graph *const callee, ir_node *const arg0,
+                         ir_node *const arg1)
+{
+	ir_entity *const entity = get_irg_entity(callee);
+	ir_node   *const in[]   = { arg0, arg1 };
+	ir_node   *const call   = new_Call(get_store(), new_Address(entity),
+	                                   2, in,
+	                                   get_entity_type(entity));
+	set_store(new_Proj(call, get_modeM(), pn_Call_M));
+	ir_node *const results = new_Proj(call, get_modeT(), pn_Call_T_result);
+	return new_Proj(results, get_modeIs(), 0);
+}
+
+/* Calls callee(x, 3) and callee(x, 7); callee returns b * a. */
+static void test_propagation(void)
+{
+	ir_mode  *const mode   = get_modeIs();
+	ir_graph *const callee = new_graph("callee", mode, 2, 0);
+	set_entity_visibility(get_irg_entity(callee), ir_visibility_local);
+	ir_node  *const a      = get_param(callee, 0);
+	ir_node  *const b      = get_param(callee, 1);
+	finish_graph(callee, new_Mul(b, a));
+
+	ir_graph *const caller = new_graph("caller", mode, 1, 0);
+	ir_node  *const x      = get_param(caller, 0);
+	ir_node  *const res0   = new_call(callee, x, new_Const_long(mode, 3));
+	ir_node  *const res1   = new_call(callee, x, new_Const_long(mode, 7));
+	finish_graph(caller, new_Add(res0, res1));
+
+	propagate_interprocedural();
+	irg_verify(callee);
+	irg_verify(caller);
+
+	/* b is in [3, 7], which vrp reads from the Confirms. */
+	ir_node *const mul = get_return_value(callee);
+	assert(is_Mul(mul));
+	ir_node *const left      = get_Mul_left(mul);
+	ir_node *const confirmed = is_Confirm(left) ? left : get_Mul_right(mul);
+	assert(is_Confirm(confirmed));
+	set_vrp_data(callee);
+	vrp_attr const *const vrp = vrp_get_info(confirmed);
+	assert(vrp != NULL && vrp->range_type == VRP_RANGE);
+	assert(get_tarval_long(vrp->range_bottom) == 3);
+	assert(get_tarval_long(vrp->range_top) == 7);
+	free_vrp_data(callee);
+}
+
+/* A constant parameter is replaced and removed from all call sites. */
+static void test_constant(void)
+{
+	ir_mode  *const mode   = get_modeIs();
+	ir_graph *const callee = new_graph("const_callee", mode, 2, 0);
+	set_entity_visibility(get_irg_entity(callee), ir_visibility_local);
+	finish_graph(callee, new_Sub(get_param(callee, 0), get_param(callee, 1)));
+
+	ir_graph *const caller = new_graph("const_caller", mode, 1, 0);
+	ir_node  *const x      = get_param(caller, 0);
+	ir_node  *const five   = new_Const_long(mode, 5);
+	finish_graph(caller, new_Add(new_call(callee, x, five),
+	                             new_call(callee, five, five)));
+
+	propagate_interprocedural();
+	irg_verify(callee);
+	irg_verify(caller);
+
+	ir_type *const type = get_entity_type(get_irg_entity(callee));
+	assert(get_method_n_params(type) == 1);
+	ir_node *const sub = get_return_value(callee);
+	assert(is_Sub(sub) && is_Const(get_Sub_right(sub)));
+	assert(get_tarval_long(get_Const_tarval(get_Sub_right(sub))) == 5);
+}
+
+/* return Confirm(Confirm(x >= 10) <= 3) */
+static void test_empty_confirm(void)
+{
+	ir_mode  *const mode  = get_modeIs();
+	ir_graph *const irg   = new_graph("empty", mode, 1, 0);
+	ir_node  *const x     = get_param(irg, 0);
+	ir_node  *const lower = new_Confirm(x, new_Const_long(mode, 10),
+	                                    ir_relation_greater_equal);
+	ir_node  *const upper = new_Confirm(lower, new_Const_long(mode, 3),
+	                                    ir_relation_less_equal);
+	finish_graph(irg, upper);
+
+	/* The intersection is empty, so no inverted range is derived. */
+	set_vrp_data(irg);
+	vrp_attr const *const vrp = vrp_get_info(upper);
+	assert(vrp == NULL || vrp->range_type != VRP_RANGE
+	       || tarval_cmp(vrp->range_bottom, vrp->range_top)
+	          != ir_relation_greater);
+	free_vrp_data(irg);
+}
+
+/* A call through a type with another result mode gets no propagated result. */
+static void test_result_mismatch(void)
+{
+	ir_mode  *const mode   = get_modeIs();
+	ir_graph *const callee = new_graph("mismatch_callee", mode, 1, 0);
+	set_entity_visibility(get_irg_entity(callee), ir_visibility_local);
+	finish_graph(callee, new_Const_long(mode, 5));
+
+	ir_graph *const caller = new_graph("mismatch_caller", mode, 1, 0);
+	ir_type  *const type   = new_type_method(1, 1, false, cc_cdecl_set,
+	                                         mtp_no_property);
+	set_method_param_type(type, 0, get_type_for_mode(mode));
+	set_method_res_type(type, 0, get_type_for_mode(get_modeIu()));
+	ir_node *const address = new_Address(get_irg_entity(callee));
+	ir_node *const in[]    = { get_param(caller, 0) };
+	ir_node *const call    = new_Call(get_store(), address, 1, in, type);
+	set_store(new_Proj(call, get_modeM(), pn_Call_M));
+	ir_node *const results = new_Proj(call, get_modeT(), pn_Call_T_result);
+	ir_node *const res     = new_Proj(results, get_modeIu(), 0);
+	finish_graph(caller, new_Conv(res, mode));
+
+	propagate_interprocedural();
+	irg_verify(caller);
+	ir_node *const conv = get_return_value(caller);
+	assert(is_Conv(conv) && is_Proj(get_Conv_op(conv)));
+}
+
+int main(void)
+{
+	ir_init();
+	test_propagation();
+	test_constant();
+	test_empty_confirm();
+	test_result_mismatch();
+	return 0;
+}
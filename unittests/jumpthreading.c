@@ -0,0 +1,142 @@
+#include "firm.h"
+#include "testgraph.h"
+#include <assert.h>
+#include <stdbool.h>
+
+/** Creates "if (x > bound)" and sets the current block to the true block. */
+static ir_node *new_if(ir_node *const x, long const bound)
+{
+	ir_node *const cmp  = new_Cmp(x, new_Const_long(get_modeIs(), bound),
+	                              ir_relation_greater);
+	ir_node *const cond = new_Cond(cmp);
+	ir_node *const then_block = new_immBlock();
+	add_immBlock_pred(then_block, new_Proj(cond, get_modeX(), pn_Cond_true));
+	mature_immBlock(then_block);
+	set_cur_block(then_block);
+	return new_Proj(cond, get_modeX(), pn_Cond_false);
+}
+
+/** Sets value 0 to val and joins the current block with the else edge. */
+static void new_join(ir_node *const false_proj, long const val,
+                     long const else_val)
+{
+	ir_mode *const mode = get_modeIs();
+	set_value(0, new_Const_long(mode, val));
+	ir_node *const then_jmp = new_Jmp();
+
+	ir_node *const else_block = new_immBlock();
+	add_immBlock_pred(else_block, false_proj);
+	mature_immBlock(else_block);
+	set_cur_block(else_block);
+	set_value(0, new_Const_long(mode, else_val));
+	ir_node *const else_jmp = new_Jmp();
+
+	ir_node *const join = new_immBlock();
+	add_immBlock_pred(join, then_jmp);
+	add_immBlock_pred(join, else_jmp);
+	mature_immBlock(join);
+	set_cur_block(join);
+}
+
+static void count_cond(ir_node *node, void *env)
+{
+	unsigned *const n_conds = (unsigned*)env;
+	if (is_Cond(node))
+		++*n_conds;
+}
+
+static unsigned count_conds(ir_graph *const irg)
+{
+	unsigned n_conds = 0;
+	irg_walk_graph(irg, count_cond, NULL, &n_conds);
+	return n_conds;
+}
+
+static void count_join(ir_node *node, void *env)
+{
+	unsigned *const n_joins = (unsigned*)env;
+	if (!is_Cond(node))
+		return;
+	ir_node *const block = get_nodes_block(node);
+	int            n_live = 0;
+	for (int i = 0, n = get_Block_n_cfgpreds(block); i < n; ++i) {
+		if (!is_Bad(get_Block_cfgpred(block, i)))
+			++n_live;
+	}
+	if (n_live > 1)
+		++*n_joins;
+}
+
+/** Counts the conditions in blocks with more than one predecessor. */
+static unsigned count_conds_after_joins(ir_graph *const irg)
+{
+	unsigned n_joins = 0;
+	irg_walk_graph(irg, count_join, NULL, &n_joins);
+	return n_joins;
+}
+
+/* if (x > 10) { if (x > 5) r = 1; else r = 2; } else r = 3; return r; */
+static void test_nested(void)
+{
+	ir_graph *const irg   = new_graph("nested", get_modeIs(), 1, 1);
+	ir_node  *const x     = get_param(irg, 0);
+	ir_node  *const outer = new_if(x, 10);
+	ir_node  *const inner = new_if(x, 5);
+	new_join(inner, 1, 2);
+	ir_node *const jmp = new_Jmp();
+
+	ir_node *const else_block = new_immBlock();
+	add_immBlock_pred(else_block, outer);
+	mature_immBlock(else_block);
+	set_cur_block(else_block);
+	set_value(0, new_Const_long(get_modeIs(), 3));
+	ir_node *const else_jmp = new_Jmp();
+
+	ir_node *const join = new_immBlock();
+	add_immBlock_pred(join, jmp);
+	add_immBlock_pred(join, else_jmp);
+	mature_immBlock(join);
+	set_cur_block(join);
+	finish_graph(irg, get_value(0, get_modeIs()));
+	assert(count_conds(irg) == 2);
+
+	/* x > 5 holds whenever x > 10 does. */
+	opt_jumpthreading(irg);
+	irg_verify(irg);
+	assert(count_conds(irg) == 1);
+}
+
+/* r = x > 10 ? 1 : 2; if (x > 5) r += 4; return r; */
+static void test_correlated(void)
+{
+	ir_graph *const irg   = new_graph("correlated", get_modeIs(), 1, 1);
+	ir_node  *const x     = get_param(irg, 0);
+	ir_node  *const first = new_if(x, 10);
+	new_join(first, 1, 2);
+	ir_node *const second = new_if(x, 5);
+	ir_mode *const mode   = get_modeIs();
+	set_value(0, new_Add(get_value(0, mode), new_Const_long(mode, 4)));
+	ir_node *const then_jmp = new_Jmp();
+
+	ir_node *const join = new_immBlock();
+	add_immBlock_pred(join, then_jmp);
+	add_immBlock_pred(join, second);
+	mature_immBlock(join);
+	set_cur_block(join);
+	finish_graph(irg, get_value(0, mode));
+	assert(count_conds_after_joins(irg) == 1);
+
+	/* The path with x > 10 skips the second condition. */
+	opt_jumpthreading(irg);
+	irg_verify(irg);
+	assert(count_conds(irg) == 2);
+	assert(count_conds_after_joins(irg) == 0);
+}
+
+int main(void)
+{
+	ir_init();
+	test_nested();
+	test_correlated();
+	return 0;
+}
@@ -0,0 +1,102 @@
+#include "firm.h"
+#include "testgraph.h"
+#include <assert.h>
+#include <stdbool.h>
+
+static ir_type *get_method_type(void)
+{
+	static ir_type *method_type;
+	if (method_type == NULL) {
+		ir_type *const type = get_type_for_mode(get_modeIs());
+		method_type = new_type_method(1, 1, false, cc_cdecl_set,
+		                              mtp_no_property);
+		set_method_param_type(method_type, 0, type);
+		set_method_res_type(method_type, 0, type);
+	}
+	return method_type;
+}
+
+/* int name(int x) { return x * 3 + 7; } */
+static ir_entity *new_leaf(char const *const name,
+                           ir_visibility const visibility)
+{
+	ir_entity *const entity = new_function(name, get_method_type(), visibility);
+	ir_graph  *const irg    = new_function_graph(entity, 0);
+	ir_mode   *const mode   = get_modeIs();
+	ir_node   *const x      = get_param(irg, 0);
+	ir_node   *const mul    = new_Mul(x, new_Const_long(mode, 3));
+	finish_graph(irg, new_Add(mul, new_Const_long(mode, 7)));
+	return entity;
+}
+
+/* int name(int x) { return a(x) + b(x); } */
+static ir_graph *new_caller(char const *const name, ir_entity *const a,
+                            ir_entity *const b)
+{
+	ir_entity *const entity = new_function(name, get_method_type(),
+	                                       ir_visibility_external);
+	ir_graph  *const irg    = new_function_graph(entity, 0);
+	ir_mode   *const mode    = get_modeIs();
+	ir_node   *const in[]    = { get_param(irg, 0) };
+	ir_entity *const callees[] = { a, b };
+	ir_node   *res[2];
+	for (unsigned i = 0; i < 2; ++i) {
+		ir_node *const call = new_Call(get_store(), new_Address(callees[i]),
+		                               1, in, get_method_type());
+		set_store(new_Proj(call, get_modeM(), pn_Call_M));
+		ir_node *const results = new_Proj(call, get_modeT(), pn_Call_T_result);
+		res[i] = new_Proj(results, mode, 0);
+	}
+	finish_graph(irg, new_Add(res[0], res[1]));
+	return irg;
+}
+
+static void find_callee(ir_node *node, void *env)
+{
+	ir_entity **const callees = (ir_entity**)env;
+	if (!is_Call(node))
+		return;
+	ir_entity *const callee = get_Call_callee(node);
+	callees[callees[0] != NULL] = callee;
+}
+
+/** Checks whether both calls of @p caller call @p a and @p b. */
+static bool calls(ir_graph *const caller, ir_entity const *const a,
+                  ir_entity const *const b)
+{
+	ir_entity *callees[2] = { NULL, NULL };
+	irg_walk_graph(caller, find_callee, NULL, callees);
+	return (callees[0] == a && callees[1] == b)
+	    || (callees[0] == b && callees[1] == a);
+}
+
+int main(void)
+{
+	ir_init();
+
+	/* Local duplicates are merged and their calls are redirected. */
+	ir_entity *const f      = new_leaf("f", ir_visibility_local);
+	ir_entity *const g      = new_leaf("g", ir_visibility_local);
+	ir_graph  *const caller = new_caller("caller", f, g);
+
+	/* Duplicates with different alignment or visibility are kept. */
+	ir_entity *const aligned = new_leaf("aligned", ir_visibility_local);
+	ir_entity *const other   = new_leaf("other", ir_visibility_local);
+	set_entity_alignment(aligned, 64);
+	ir_graph *const aligned_caller = new_caller("aligned_caller", f, aligned);
+	ir_entity *const external = new_leaf("external", ir_visibility_external);
+	ir_graph *const external_caller = new_caller("external_caller", other,
+	                                             external);
+
+	assert(get_irp_n_irgs() == 8);
+	merge_identical_functions(true);
+	assert(get_irp_n_irgs() == 6);
+
+	assert(calls(caller, f, f));
+	assert(calls(aligned_caller, f, aligned));
+	assert(calls(external_caller, f, external));
+	for (size_t i = 0, n = get_irp_n_irgs(); i < n; ++i)
+		irg_verify(get_irp_irg(i));
+
+	return 0;
+}
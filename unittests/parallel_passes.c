@@ -0,0 +1,108 @@
+#include "firm.h"
+#include "testgraph.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#define N_GRAPHS 64
+
+typedef struct opcode_counts_t {
+	unsigned counts[iro_last + 1];
+} opcode_counts_t;
+
+/* combo and gvn_pre used to share the optimization flags, the value_of
+ * function and the operation table between threads. */
+static void pipeline(ir_graph *const irg, void *const data)
+{
+	(void)data;
+	combo(irg);
+	do_gvn_pre(irg);
+	optimize_graph_df(irg);
+	irg_verify(irg);
+}
+
+/*
+ * int name(int x, int y)
+ * {
+ *     int r = x > 0 ? x * y : 7;
+ *     return r + x * y + (x ^ x) + i;
+ * }
+ */
+static ir_graph *new_test_graph(char const *const name, long const i)
+{
+	ir_mode  *const mode = get_modeIs();
+	ir_graph *const irg  = new_graph(name, mode, 2, 1);
+	ir_node  *const x    = get_param(irg, 0);
+	ir_node  *const y    = get_param(irg, 1);
+
+	ir_node *const cmp  = new_Cmp(x, new_Const_long(mode, 0),
+	                              ir_relation_greater);
+	ir_node *const cond = new_Cond(cmp);
+
+	ir_node *const then_block = new_immBlock();
+	add_immBlock_pred(then_block, new_Proj(cond, get_modeX(), pn_Cond_true));
+	mature_immBlock(then_block);
+	set_cur_block(then_block);
+	set_value(0, new_Mul(x, y));
+	ir_node *const then_jmp = new_Jmp();
+
+	ir_node *const else_block = new_immBlock();
+	add_immBlock_pred(else_block, new_Proj(cond, get_modeX(), pn_Cond_false));
+	mature_immBlock(else_block);
+	set_cur_block(else_block);
+	set_value(0, new_Const_long(mode, 7));
+	ir_node *const else_jmp = new_Jmp();
+
+	ir_node *const join = new_immBlock();
+	add_immBlock_pred(join, then_jmp);
+	add_immBlock_pred(join, else_jmp);
+	mature_immBlock(join);
+	set_cur_block(join);
+	ir_node *res = new_Add(get_value(0, mode), new_Mul(x, y));
+	res = new_Add(res, new_Eor(x, x));
+	finish_graph(irg, new_Add(res, new_Const_long(mode, i)));
+	return irg;
+}
+
+static void count_opcode(ir_node *node, void *env)
+{
+	opcode_counts_t *const counts = (opcode_counts_t*)env;
+	++counts->counts[get_irn_opcode(node)];
+}
+
+static void count_opcodes(ir_graph *const irg, opcode_counts_t *const counts)
+{
+	memset(counts, 0, sizeof(*counts));
+	irg_walk_graph(irg, count_opcode, NULL, counts);
+}
+
+int main(void)
+{
+	ir_init();
+
+	ir_graph *graphs[N_GRAPHS];
+	for (unsigned i = 0; i < N_GRAPHS; ++i) {
+		char name[16];
+		snprintf(name, sizeof(name), "f%u", i);
+		graphs[i] = new_test_graph(name, 100 + i);
+	}
+
+	optimize_graphs_parallel(pipeline, NULL, 4);
+
+	/* The flags changed by gvn_pre are restored on every thread. */
+	assert(!get_opt_global_cse());
+
+	/* Every graph is optimized like a graph optimized on its own. */
+	ir_graph *const reference = new_test_graph("reference", 100 + N_GRAPHS);
+	pipeline(reference, NULL);
+	opcode_counts_t expected;
+	count_opcodes(reference, &expected);
+	assert(expected.counts[iro_Eor] == 0);
+	for (unsigned i = 0; i < N_GRAPHS; ++i) {
+		opcode_counts_t counts;
+		count_opcodes(graphs[i], &counts);
+		assert(memcmp(&counts, &expected, sizeof(counts)) == 0);
+	}
+	return 0;
+}
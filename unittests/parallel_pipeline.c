@@ -0,0 +1,94 @@
+#include "firm.h"
+#include "testgraph.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#define N_CHAINS 8
+#define CHAIN_LEN 8
+#define N_GRAPHS (N_CHAINS * CHAIN_LEN)
+
+static ir_graph *graphs[N_GRAPHS];
+static bool      done[N_GRAPHS];
+
+static unsigned get_graph_index(ir_graph const *const irg)
+{
+	for (unsigned i = 0; i < N_GRAPHS; ++i) {
+		if (graphs[i] == irg)
+			return i;
+	}
+	assert(false);
+	return 0;
+}
+
+static void pipeline(ir_graph *const irg, void *const data)
+{
+	(void)data;
+	unsigned const i = get_graph_index(irg);
+	assert(!done[i]);
+	/* Graph i calls graph i - 1 of the same chain. */
+	if (i % CHAIN_LEN != 0)
+		assert(done[i - 1]);
+
+	/* Both passes reserve the entity links of the program. */
+	scalar_replacement_opt(irg);
+	opt_frame_irg(irg);
+	optimize_graph_df(irg);
+	irg_verify(irg);
+	done[i] = true;
+}
+
+/* int f(int x) { int local = x; return g(local) + 1; } */
+static ir_graph *new_chain_graph(char const *const name,
+                                 ir_entity *const callee)
+{
+	ir_mode  *const mode = get_modeIs();
+	ir_type  *const type = get_type_for_mode(mode);
+	ir_graph *const irg  = new_graph(name, mode, 1, 0);
+
+	ir_entity *const local = new_entity(get_irg_frame_type(irg),
+	                                    new_id_from_str("local"), type);
+	ir_node *const x     = get_param(irg, 0);
+	ir_node *const ptr   = new_Member(get_irg_frame(irg), local);
+	ir_node *const store = new_Store(get_store(), ptr, x, type, cons_none);
+	set_store(new_Proj(store, get_modeM(), pn_Store_M));
+	ir_node *const load  = new_Load(get_store(), ptr, mode, type, cons_none);
+	set_store(new_Proj(load, get_modeM(), pn_Load_M));
+	ir_node *res = new_Proj(load, mode, pn_Load_res);
+	if (callee != NULL) {
+		ir_node *const in[] = { res };
+		ir_node *const call = new_Call(get_store(), new_Address(callee), 1,
+		                               in, get_entity_type(callee));
+		set_store(new_Proj(call, get_modeM(), pn_Call_M));
+		ir_node *const results = new_Proj(call, get_modeT(), pn_Call_T_result);
+		res = new_Proj(results, mode, 0);
+	}
+	finish_graph(irg, new_Add(res, new_Const_long(mode, 1)));
+	return irg;
+}
+
+int main(void)
+{
+	ir_init();
+
+	for (unsigned c = 0; c < N_CHAINS; ++c) {
+		ir_entity *callee = NULL;
+		for (unsigned k = 0; k < CHAIN_LEN; ++k) {
+			char name[16];
+			snprintf(name, sizeof(name), "f%u_%u", c, k);
+			ir_graph *const irg = new_chain_graph(name, callee);
+			graphs[c * CHAIN_LEN + k] = irg;
+			callee = get_irg_entity(irg);
+		}
+	}
+
+	optimize_graphs_parallel(pipeline, NULL, 4);
+
+	for (unsigned i = 0; i < N_GRAPHS; ++i) {
+		assert(done[i]);
+		/* The local variable was replaced and removed from the frame. */
+		assert(get_compound_n_members(get_irg_frame_type(graphs[i])) == 0);
+	}
+
+	return 0;
+}
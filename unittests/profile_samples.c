@@ -0,0 +1,170 @@
+#include "firm.h"
+#include "irprofile.h"
+#include "testgraph.h"
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#define AUTOFDO_FILE "profile_samples.afdo"
+#define PERF_FILE    "profile_samples.perf"
+
+/* Line offsets are relative to the declaration lines 10 (hot) and
+ * 20 (inlined). */
+static char const autofdo_profile[] =
+	"hot:1000:100\n"
+	" 1: 100\n"
+	" 2: 90 callee:90\n"
+	" 4.1: 30\n"
+	" 4: 8\n"
+	" 6: inlined:40\n"
+	"  1: 40\n"
+	"unknown:50:5\n"
+	" 1: 50\n";
+
+static char const perf_profile[] =
+	"  4005d0 /home/user/src/hot.c:11\n"
+	"  4005d0 /home/user/src/hot.c:11\n"
+	"  4005d4 /home/user/src/hot.c:12\n"
+	"  4005d4 /home/user/src/hot.c:12\n"
+	"  4005d8 /home/user/src/hot.c:12\n"
+	"  4005e0 /home/user/src/hot.c:14\n"
+	"  4005e4 ??:0\n"
+	"  4005e8 /home/user/src/other.c:12\n";
+
+static src_loc_t const locs[] = {
+	{ "src/hot.c", 10, 0 },
+	{ "src/hot.c", 11, 0 },
+	{ "src/hot.c", 12, 0 },
+	{ "src/hot.c", 14, 0 },
+	{ "src/hot.c", 20, 0 },
+	{ "src/hot.c", 21, 0 },
+};
+
+enum { LOC_HOT, LOC_COND, LOC_THEN, LOC_ELSE, LOC_INLINED, LOC_INLINED_BODY };
+
+static dbg_info *get_dbg(unsigned const loc)
+{
+	return (dbg_info*)&locs[loc];
+}
+
+static src_loc_t retrieve_dbg(dbg_info const *const dbg)
+{
+	if (dbg == NULL) {
+		src_loc_t const none = { NULL, 0, 0 };
+		return none;
+	}
+	return *(src_loc_t const*)dbg;
+}
+
+/** Creates the graph of "int name(int)" declared at @p loc. */
+static ir_graph *new_located_graph(char const *const name, unsigned const loc,
+                                   int const n_loc)
+{
+	ir_graph *const irg = new_graph(name, get_modeIs(), 1, n_loc);
+	set_entity_dbg_info(get_irg_entity(irg), get_dbg(loc));
+	return irg;
+}
+
+/* int inlined(int x) { return x ^ 5; } */
+static void new_inlined_graph(void)
+{
+	ir_graph *const irg = new_located_graph("inlined", LOC_INLINED, 0);
+	finish_graph(irg, new_d_Eor(get_dbg(LOC_INLINED_BODY), get_param(irg, 0),
+	                            new_Const_long(get_modeIs(), 5)));
+}
+
+/*
+ * int hot(int x)              // line 10
+ * {
+ *     if (x > 0)              // line 11
+ *         x = x * x;          // line 12
+ *     else
+ *         x = x * 3;          // line 14
+ *     return inlined(x);      // line 16, the inlined body is at line 21
+ * }
+ */
+static void new_hot_graph(ir_node **const then_block,
+                          ir_node **const else_block,
+                          ir_node **const join_block)
+{
+	ir_graph *const irg  = new_located_graph("hot", LOC_HOT, 1);
+	ir_mode  *const mode = get_modeIs();
+	ir_node  *const x    = get_param(irg, 0);
+
+	ir_node *const cmp  = new_d_Cmp(get_dbg(LOC_COND), x,
+	                                new_Const_long(mode, 0),
+	                                ir_relation_greater);
+	ir_node *const cond = new_d_Cond(get_dbg(LOC_COND), cmp);
+
+	*then_block = new_immBlock();
+	add_immBlock_pred(*then_block, new_Proj(cond, get_modeX(), pn_Cond_true));
+	mature_immBlock(*then_block);
+	set_cur_block(*then_block);
+	set_value(0, new_d_Mul(get_dbg(LOC_THEN), x, x));
+	ir_node *const then_jmp = new_Jmp();
+
+	*else_block = new_immBlock();
+	add_immBlock_pred(*else_block, new_Proj(cond, get_modeX(), pn_Cond_false));
+	mature_immBlock(*else_block);
+	set_cur_block(*else_block);
+	set_value(0, new_d_Mul(get_dbg(LOC_ELSE), x, new_Const_long(mode, 3)));
+	ir_node *const else_jmp = new_Jmp();
+
+	*join_block = new_immBlock();
+	add_immBlock_pred(*join_block, then_jmp);
+	add_immBlock_pred(*join_block, else_jmp);
+	mature_immBlock(*join_block);
+	set_cur_block(*join_block);
+	finish_graph(irg, new_d_Eor(get_dbg(LOC_INLINED_BODY), get_value(0, mode),
+	                            new_Const_long(mode, 5)));
+}
+
+static void write_file(char const *const name, char const *const content)
+{
+	FILE *const f = fopen(name, "w");
+	assert(f != NULL);
+	fputs(content, f);
+	fclose(f);
+}
+
+static bool is_freq(ir_node const *const block, double const expected)
+{
+	return fabs(get_block_execfreq(block) - expected) < 1e-6;
+}
+
+int main(void)
+{
+	ir_init();
+	ir_set_debug_retrieve(retrieve_dbg);
+
+	new_inlined_graph();
+	ir_node *then_block;
+	ir_node *else_block;
+	ir_node *join_block;
+	new_hot_graph(&then_block, &else_block, &join_block);
+
+	assert(!ir_profile_read_samples("profile_samples.missing"));
+
+	/* The AutoFDO samples are normalized by the head samples of hot. Lines
+	 * take the maximum of their discriminators. Inlined lines are relative to
+	 * the declaration of the inlined function. */
+	write_file(AUTOFDO_FILE, autofdo_profile);
+	assert(ir_profile_read_samples(AUTOFDO_FILE));
+	remove(AUTOFDO_FILE);
+	assert(is_freq(then_block, 0.9));
+	assert(is_freq(else_block, 0.3));
+	assert(is_freq(join_block, 0.4));
+
+	/* Every perf script srcline is one sample. Without head samples, they are
+	 * calibrated against the estimated frequencies of the sampled blocks.
+	 * Blocks with source lines, but without samples, are rarely executed. */
+	write_file(PERF_FILE, perf_profile);
+	assert(ir_profile_read_samples(PERF_FILE));
+	remove(PERF_FILE);
+	double const then_freq = get_block_execfreq(then_block);
+	double const else_freq = get_block_execfreq(else_block);
+	assert(fabs(then_freq - 3 * else_freq) < 1e-6);
+	assert(get_block_execfreq(join_block) < else_freq);
+	return 0;
+}
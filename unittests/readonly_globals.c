@@ -0,0 +1,125 @@
+#include "firm.h"
+#include "testgraph.h"
+#include <assert.h>
+#include <stdbool.h>
+
+static ir_node *new_const(long const val)
+{
+	return new_r_Const_long(get_const_code_irg(), get_modeIs(), val);
+}
+
+static ir_entity *new_variable(char const *const name,
+                               ir_visibility const visibility, long const val)
+{
+	ir_type   *const type   = get_type_for_mode(get_modeIs());
+	ir_entity *const entity = new_global_entity(get_glob_type(),
+	                                            new_id_from_str(name), type,
+	                                            visibility, IR_LINKAGE_DEFAULT);
+	set_entity_initializer(entity, create_initializer_const(new_const(val)));
+	return entity;
+}
+
+/* struct { int a; int b; } name = { a, b }; */
+static ir_entity *new_pair(char const *const name, long const a, long const b)
+{
+	ir_type *const int_type = get_type_for_mode(get_modeIs());
+	ir_type *const type     = new_type_struct(new_id_from_str("pair"));
+	new_entity(type, new_id_from_str("a"), int_type);
+	new_entity(type, new_id_from_str("b"), int_type);
+	default_layout_compound_type(type);
+
+	ir_entity *const entity = new_global_entity(get_glob_type(),
+	                                            new_id_from_str(name), type,
+	                                            ir_visibility_local,
+	                                            IR_LINKAGE_DEFAULT);
+	ir_initializer_t *const init = create_initializer_compound(2);
+	set_initializer_compound_value(init, 0,
+	                               create_initializer_const(new_const(a)));
+	set_initializer_compound_value(init, 1,
+	                               create_initializer_const(new_const(b)));
+	set_entity_initializer(entity, init);
+	return entity;
+}
+
+static ir_node *new_load(ir_node *const ptr)
+{
+	ir_type *const type = get_type_for_mode(get_modeIs());
+	ir_node *const load = new_Load(get_store(), ptr, get_modeIs(), type,
+	                               cons_none);
+	set_store(new_Proj(load, get_modeM(), pn_Load_M));
+	return new_Proj(load, get_modeIs(), pn_Load_res);
+}
+
+/* return *entity; */
+static ir_graph *new_reader(char const *const name, ir_entity *const entity)
+{
+	ir_graph *const irg = new_graph(name, get_modeIs(), 1, 0);
+	finish_graph(irg, new_load(new_Address(entity)));
+	return irg;
+}
+
+static bool returns_const(ir_graph *const irg, long const val)
+{
+	ir_node *const res = get_return_value(irg);
+	return is_Const(res) && get_tarval_long(get_Const_tarval(res)) == val;
+}
+
+static bool is_constant(ir_entity const *const entity)
+{
+	return get_entity_linkage(entity) & IR_LINKAGE_CONSTANT;
+}
+
+int main(void)
+{
+	ir_init();
+
+	/* A local variable, which is only read, is promoted. */
+	ir_entity *const read_only = new_variable("read_only", ir_visibility_local,
+	                                          42);
+	ir_graph  *const reader    = new_reader("reader", read_only);
+
+	/* A local variable, which is written, is kept. */
+	ir_entity *const written = new_variable("written", ir_visibility_local, 1);
+	ir_graph  *const writer  = new_graph("writer", get_modeIs(), 1, 0);
+	ir_node   *const address = new_Address(written);
+	ir_node   *const x       = new_Proj(get_irg_args(writer), get_modeIs(), 0);
+	ir_node   *const store   = new_Store(get_store(), address, x,
+	                                     get_type_for_mode(get_modeIs()),
+	                                     cons_none);
+	set_store(new_Proj(store, get_modeM(), pn_Store_M));
+	finish_graph(writer, new_load(address));
+
+	/* An externally visible variable may be written elsewhere. */
+	ir_entity *const external = new_variable("external",
+	                                         ir_visibility_external, 2);
+	ir_graph  *const external_reader = new_reader("external_reader",
+	                                              external);
+
+	/* A variable without initializer is not defined here. */
+	ir_type   *const int_type = get_type_for_mode(get_modeIs());
+	ir_entity *const declared = new_global_entity(get_glob_type(),
+	                                              new_id_from_str("declared"),
+	                                              int_type, ir_visibility_local,
+	                                              IR_LINKAGE_DEFAULT);
+	ir_graph  *const declared_reader = new_reader("declared_reader",
+	                                              declared);
+
+	/* Members of aggregates are folded as well. */
+	ir_entity *const pair        = new_pair("pair", 3, 4);
+	ir_graph  *const pair_reader = new_graph("pair_reader", get_modeIs(), 1, 0);
+	ir_entity *const member      = get_compound_member(get_entity_type(pair),
+	                                                   1);
+	finish_graph(pair_reader, new_load(new_Member(new_Address(pair), member)));
+
+	promote_readonly_globals();
+	for (size_t i = 0, n = get_irp_n_irgs(); i < n; ++i)
+		irg_verify(get_irp_irg(i));
+
+	assert(is_constant(read_only) && returns_const(reader, 42));
+	assert(!is_constant(written) && !is_Const(get_return_value(writer)));
+	assert(!is_constant(external) && !returns_const(external_reader, 2));
+	assert(!is_constant(declared)
+	       && !is_Const(get_return_value(declared_reader)));
+	assert(is_constant(pair) && returns_const(pair_reader, 4));
+	return 0;
+}
@@ -0,0 +1,178 @@
+#include "firm.h"
+#include "testgraph.h"
+#include <assert.h>
+#include <stdbool.h>
+
+#define N_OPERANDS 8
+
+static unsigned get_add_depth(ir_node const *const node)
+{
+	if (!is_Add(node))
+		return 0;
+	unsigned const left  = get_add_depth(get_Add_left(node));
+	unsigned const right = get_add_depth(get_Add_right(node));
+	return 1 + (left > right ? left : right);
+}
+
+static bool has_operands(ir_node const *const add, ir_node const *const a,
+                         ir_node const *const b)
+{
+	ir_node const *const left  = get_Add_left(add);
+	ir_node const *const right = get_Add_right(add);
+	return (left == a && right == b) || (left == b && right == a);
+}
+
+/* return ((a0 + a1) + a2) + ... + a7 */
+static void test_deep_tree(void)
+{
+	ir_graph *const irg = new_graph("deep", get_modeIs(), N_OPERANDS, 1);
+	ir_node *sum = get_param(irg, 0);
+	for (unsigned i = 1; i < N_OPERANDS; ++i)
+		sum = new_Add(sum, get_param(irg, i));
+	finish_graph(irg, sum);
+
+	optimize_reassociation(irg);
+	irg_verify(irg);
+	assert(get_add_depth(get_return_value(irg)) == 3);
+}
+
+static bool returns_zero(ir_graph *const irg)
+{
+	ir_node *const res = get_return_value(irg);
+	return is_Const(res) && tarval_is_null(get_Const_tarval(res));
+}
+
+/* return ((a + b) + c) ^ ((c + a) + b) */
+static void test_permuted_chain(void)
+{
+	ir_graph *const irg   = new_graph("permuted_chain", get_modeIs(), 3, 1);
+	ir_node  *const a     = get_param(irg, 0);
+	ir_node  *const b     = get_param(irg, 1);
+	ir_node  *const c     = get_param(irg, 2);
+	ir_node  *const left  = new_Add(new_Add(a, b), c);
+	ir_node  *const right = new_Add(new_Add(c, a), b);
+	finish_graph(irg, new_Eor(left, right));
+
+	/* Both sums are rebuilt in rank order, so CSE unifies them. */
+	optimize_reassociation(irg);
+	optimize_graph_df(irg);
+	irg_verify(irg);
+	assert(returns_zero(irg));
+}
+
+/* return ((a + c) + (b + d)) ^ ((d + a) + (c + b)) */
+static void test_permuted_balanced(void)
+{
+	ir_graph *const irg   = new_graph("permuted_balanced", get_modeIs(), 4, 1);
+	ir_node  *const a     = get_param(irg, 0);
+	ir_node  *const b     = get_param(irg, 1);
+	ir_node  *const c     = get_param(irg, 2);
+	ir_node  *const d     = get_param(irg, 3);
+	ir_node  *const left  = new_Add(new_Add(a, c), new_Add(b, d));
+	ir_node  *const right = new_Add(new_Add(d, a), new_Add(c, b));
+	finish_graph(irg, new_Eor(left, right));
+
+	/* Trees of the same height are put into the same order as well. */
+	optimize_reassociation(irg);
+	optimize_graph_df(irg);
+	irg_verify(irg);
+	assert(returns_zero(irg));
+}
+
+/*
+ * s = 0; do { s = (s + a) + b; } while (s < 100); return s;
+ */
+static void test_invariant_operands(void)
+{
+	ir_mode  *const mode  = get_modeIs();
+	ir_graph *const irg   = new_graph("invariant", mode, 2, 1);
+	ir_node  *const a     = get_param(irg, 0);
+	ir_node  *const b     = get_param(irg, 1);
+	set_value(0, new_Const_long(mode, 0));
+	ir_node  *const entry = new_Jmp();
+
+	ir_node *const loop = new_immBlock();
+	add_immBlock_pred(loop, entry);
+	set_cur_block(loop);
+	ir_node *const s   = get_value(0, mode);
+	ir_node *const sum = new_Add(new_Add(s, a), b);
+	set_value(0, sum);
+	ir_node *const cmp  = new_Cmp(sum, new_Const_long(mode, 100),
+	                              ir_relation_less);
+	ir_node *const cond = new_Cond(cmp);
+	add_immBlock_pred(loop, new_Proj(cond, get_modeX(), pn_Cond_true));
+	mature_immBlock(loop);
+
+	ir_node *const exit = new_immBlock();
+	add_immBlock_pred(exit, new_Proj(cond, get_modeX(), pn_Cond_false));
+	mature_immBlock(exit);
+	set_cur_block(exit);
+	finish_graph(irg, get_value(0, mode));
+
+	/* a and b are computed outside of the loop, so they are added first. */
+	optimize_reassociation(irg);
+	irg_verify(irg);
+	ir_node *const root = get_return_value(irg);
+	assert(is_Add(root));
+	ir_node *const left  = get_Add_left(root);
+	ir_node *const right = get_Add_right(root);
+	ir_node *const phi   = is_Phi(left) ? left : right;
+	ir_node *const inner = is_Phi(left) ? right : left;
+	assert(is_Phi(phi));
+	assert(is_Add(inner) && has_operands(inner, a, b));
+}
+
+/*
+ * s = 0; do { s = s + a; } while (s < 100);
+ * (next block) w = c * c; return (s + w) + b;
+ */
+static void test_loop_exit(void)
+{
+	ir_mode  *const mode  = get_modeIs();
+	ir_graph *const irg   = new_graph("loop_exit", mode, 3, 1);
+	ir_node  *const a     = get_param(irg, 0);
+	ir_node  *const b     = get_param(irg, 1);
+	ir_node  *const c     = get_param(irg, 2);
+	set_value(0, new_Const_long(mode, 0));
+	ir_node  *const entry = new_Jmp();
+
+	ir_node *const loop = new_immBlock();
+	add_immBlock_pred(loop, entry);
+	set_cur_block(loop);
+	ir_node *const sum = new_Add(get_value(0, mode), a);
+	set_value(0, sum);
+	ir_node *const cmp  = new_Cmp(sum, new_Const_long(mode, 100),
+	                              ir_relation_less);
+	ir_node *const cond = new_Cond(cmp);
+	add_immBlock_pred(loop, new_Proj(cond, get_modeX(), pn_Cond_true));
+	mature_immBlock(loop);
+
+	ir_node *const exit = new_immBlock();
+	add_immBlock_pred(exit, new_Proj(cond, get_modeX(), pn_Cond_false));
+	mature_immBlock(exit);
+	set_cur_block(exit);
+	ir_node *const w = new_Mul(c, c);
+	finish_graph(irg, new_Add(new_Add(sum, w), b));
+
+	/* w is computed after the loop, but outside of it like b. */
+	optimize_reassociation(irg);
+	irg_verify(irg);
+	ir_node *const root = get_return_value(irg);
+	assert(is_Add(root));
+	ir_node *const left  = get_Add_left(root);
+	ir_node *const right = get_Add_right(root);
+	ir_node *const inner = left == sum ? right : left;
+	assert(left == sum || right == sum);
+	assert(is_Add(inner) && has_operands(inner, w, b));
+}
+
+int main(void)
+{
+	ir_init();
+	test_deep_tree();
+	test_permuted_chain();
+	test_permuted_balanced();
+	test_invariant_operands();
+	test_loop_exit();
+	return 0;
+}
@@ -0,0 +1,150 @@
+#include "firm.h"
+#include "xmalloc.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* void name(double, ...) */
+static ir_type *new_variadic_type(void)
+{
+	ir_type *const type = new_type_method(1, 0, true, cc_cdecl_set,
+	                                      mtp_no_property);
+	set_method_param_type(type, 0, get_type_for_mode(get_modeD()));
+	return type;
+}
+
+/* The type of a call with two double arguments. */
+static ir_type *new_call_type(void)
+{
+	ir_type *const type   = new_type_method(2, 0, true, cc_cdecl_set,
+	                                        mtp_no_property);
+	ir_type *const double_type = get_type_for_mode(get_modeD());
+	set_method_param_type(type, 0, double_type);
+	set_method_param_type(type, 1, double_type);
+	return type;
+}
+
+static void new_call(ir_node *const ptr, ir_node *const x)
+{
+	ir_node *const in[] = { x, x };
+	ir_node *const call = new_Call(get_store(), ptr, 2, in, new_call_type());
+	set_store(new_Proj(call, get_modeM(), pn_Call_M));
+}
+
+/*
+ * void caller(void (*param)(double, ...), double x)
+ * {
+ *     param(x, x);
+ *     global(x, x);
+ *     function(x, x);
+ * }
+ */
+static ir_graph *new_caller(void)
+{
+	ir_type *const variadic = new_variadic_type();
+	ir_type *const ptr_type = new_type_pointer(variadic);
+	ir_type *const type     = new_type_method(2, 0, false, cc_cdecl_set,
+	                                          mtp_no_property);
+	set_method_param_type(type, 0, ptr_type);
+	set_method_param_type(type, 1, get_type_for_mode(get_modeD()));
+	ir_entity *const entity
+		= new_global_entity(get_glob_type(), new_id_from_str("caller"), type,
+		                    ir_visibility_external, IR_LINKAGE_DEFAULT);
+	ir_entity *const global
+		= new_global_entity(get_glob_type(), new_id_from_str("global"),
+		                    ptr_type, ir_visibility_external,
+		                    IR_LINKAGE_DEFAULT);
+	ir_entity *const function
+		= new_global_entity(get_glob_type(), new_id_from_str("function"),
+		                    variadic, ir_visibility_external,
+		                    IR_LINKAGE_DEFAULT);
+
+	ir_graph *const irg = new_ir_graph(entity, 0);
+	set_current_ir_graph(irg);
+	ir_node *const args = get_irg_args(irg);
+	ir_node *const x    = new_Proj(args, get_modeD(), 1);
+	new_call(new_Proj(args, get_modeP(), 0), x);
+
+	ir_node *const load = new_Load(get_store(), new_Address(global),
+	                               get_modeP(), ptr_type, cons_none);
+	set_store(new_Proj(load, get_modeM(), pn_Load_M));
+	new_call(new_Proj(load, get_modeP(), pn_Load_res), x);
+
+	new_call(new_Address(function), x);
+
+	ir_node *const ret = new_Return(get_store(), 0, NULL);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+	mature_immBlock(get_r_cur_block(irg));
+	irg_finalize_cons(irg);
+	return irg;
+}
+
+static void check_call(ir_node *node, void *env)
+{
+	if (!is_Call(node))
+		return;
+	/* The fixed argument stays a double, the variadic one becomes an
+	 * integer. */
+	ir_node *const fixed    = get_Call_param(node, 0);
+	ir_node *const variadic = get_Call_param(node, 1);
+	assert(get_irn_mode(fixed) == get_modeD());
+	assert(is_Bitcast(variadic) && get_irn_mode(variadic) == get_modeLu());
+	ir_type *const type = get_Call_type(node);
+	assert(get_type_mode(get_method_param_type(type, 0)) == get_modeD());
+	assert(get_type_mode(get_method_param_type(type, 1)) == get_modeLu());
+	++*(unsigned*)env;
+}
+
+/** Emits the program and returns the assembly, which the caller has to free. */
+static char *emit_to_string(void)
+{
+	FILE *const f = tmpfile();
+	assert(f != NULL);
+	be_main(f, "riscv_call");
+	long const size = ftell(f);
+	assert(size > 0);
+	rewind(f);
+	char *const buf = XMALLOCN(char, size + 1);
+	assert(fread(buf, 1, size, f) == (size_t)size);
+	buf[size] = '\0';
+	fclose(f);
+	return buf;
+}
+
+static bool has_define(char const *const name, char const *const value)
+{
+	for (ir_platform_define_t const *define = ir_platform_define_first();
+	     define != NULL; define = ir_platform_define_next(define)) {
+		if (strcmp(ir_platform_define_name(define), name) == 0)
+			return strcmp(ir_platform_define_value(define), value) == 0;
+	}
+	return false;
+}
+
+int main(void)
+{
+	ir_init_library();
+	if (!ir_target_set("riscv64-linux-gnu"))
+		return 1;
+	ir_target_init();
+
+	/* The default ISA rv64gc has the D extension. */
+	assert(has_define("__riscv_float_abi_double", "1"));
+	assert(has_define("__riscv_flen", "64"));
+	assert(!has_define("__riscv_float_abi_soft", "1"));
+	assert(ir_target_biggest_alignment() == 16);
+
+	ir_graph *const irg = new_caller();
+	be_lower_for_target();
+	irg_verify(irg);
+	unsigned n_calls = 0;
+	irg_walk_graph(irg, check_call, NULL, &n_calls);
+	assert(n_calls == 3);
+
+	char *const assembly = emit_to_string();
+	assert(strstr(assembly, "fmv.x.d") != NULL);
+	free(assembly);
+	return 0;
+}
@@ -0,0 +1,150 @@
+#include "firm.h"
+#include "testgraph.h"
+#include "xmalloc.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static ir_node *new_callee_call(ir_entity *const callee, ir_node *const a,
+                                ir_node *const b)
+{
+	ir_node *const in[] = { a, b };
+	ir_type *const type = get_entity_type(callee);
+	ir_node *const call = new_Call(get_store(), new_Address(callee), 2, in,
+	                               type);
+	set_store(new_Proj(call, get_modeM(), pn_Call_M));
+	ir_node *const results = new_Proj(call, get_modeT(), pn_Call_T_result);
+	return new_Proj(results, get_modeIs(), 0);
+}
+
+/* int swap(int a, int b) { return callee(b, a + b); } */
+static void new_swap_graph(ir_entity *const callee)
+{
+	ir_graph *const irg = new_graph("swap", get_modeIs(), 2, 0);
+	ir_node  *const a   = get_param(irg, 0);
+	ir_node  *const b   = get_param(irg, 1);
+	finish_graph(irg, new_callee_call(callee, b, new_Add(a, b)));
+}
+
+/*
+ * int branch(int a, int b)
+ * {
+ *     if (a > 0)
+ *         return callee(b, a);
+ *     return b;
+ * }
+ */
+static void new_branch_graph(ir_entity *const callee)
+{
+	ir_mode  *const mode = get_modeIs();
+	ir_graph *const irg  = new_graph("branch", mode, 2, 0);
+	ir_node  *const a    = get_param(irg, 0);
+	ir_node  *const b    = get_param(irg, 1);
+	ir_node  *const cmp  = new_Cmp(a, new_Const_long(mode, 0),
+	                               ir_relation_greater);
+	ir_node  *const cond = new_Cond(cmp);
+	ir_node  *const mem  = get_store();
+
+	ir_node *const then_block = new_immBlock();
+	add_immBlock_pred(then_block, new_Proj(cond, get_modeX(), pn_Cond_true));
+	mature_immBlock(then_block);
+	set_cur_block(then_block);
+	ir_node *res = new_callee_call(callee, b, a);
+	ir_node *const ret = new_Return(get_store(), 1, &res);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+
+	ir_node *const else_block = new_immBlock();
+	add_immBlock_pred(else_block, new_Proj(cond, get_modeX(), pn_Cond_false));
+	set_cur_block(else_block);
+	set_store(mem);
+	finish_graph(irg, b);
+}
+
+/* int grow(int a) { return callee(a, a); } */
+static void new_grow_graph(ir_entity *const callee)
+{
+	ir_graph *const irg = new_graph("grow", get_modeIs(), 1, 0);
+	ir_node  *const a   = get_param(irg, 0);
+	finish_graph(irg, new_callee_call(callee, a, a));
+}
+
+/** Emits the program and returns the assembly, which the caller has to free. */
+static char *emit_to_string(void)
+{
+	FILE *const f = tmpfile();
+	assert(f != NULL);
+	be_main(f, "sibling_call");
+	long const size = ftell(f);
+	assert(size > 0);
+	rewind(f);
+	char *const buf = XMALLOCN(char, size + 1);
+	assert(fread(buf, 1, size, f) == (size_t)size);
+	buf[size] = '\0';
+	fclose(f);
+	return buf;
+}
+
+/**
+ * Returns the code of @p function in @p assembly, which the caller has to
+ * free.
+ */
+static char *get_function(char const *const assembly,
+                          char const *const function)
+{
+	char label[32];
+	snprintf(label, sizeof(label), "\n%s:\n", function);
+	char const *const begin = strstr(assembly, label);
+	assert(begin != NULL);
+	char const *const end = strstr(begin, "\t.size");
+	assert(end != NULL);
+	size_t const size = end - begin;
+	char  *const code = XMALLOCN(char, size + 1);
+	memcpy(code, begin, size);
+	code[size] = '\0';
+	return code;
+}
+
+static bool is_sibling_call(char const *const code)
+{
+	return strstr(code, "jmp callee") != NULL
+	    && strstr(code, "\tcall ") == NULL;
+}
+
+int main(void)
+{
+	ir_init_library();
+	if (!ir_target_set("i686-linux-gnu"))
+		return 1;
+	if (ir_target_option("omitfp") != 1)
+		return 1;
+	ir_target_init();
+
+	ir_type   *const type   = new_method_type(get_modeIs(), 2);
+	ir_entity *const callee = new_function("callee", type,
+	                                       ir_visibility_external);
+	new_swap_graph(callee);
+	new_branch_graph(callee);
+	new_grow_graph(callee);
+
+	char *const assembly = emit_to_string();
+	/* The arguments are stored into the incoming parameters. Every read of
+	 * the first parameter precedes the store of the first argument. */
+	char *const swap = get_function(assembly, "swap");
+	assert(is_sibling_call(swap));
+	char const *const store = strstr(swap, ", 4(%esp)");
+	assert(store != NULL && strstr(store, " 4(%esp),") == NULL);
+	free(swap);
+
+	char *const branch = get_function(assembly, "branch");
+	assert(is_sibling_call(branch));
+	free(branch);
+
+	/* The arguments do not fit into the incoming parameters. */
+	char *const grow = get_function(assembly, "grow");
+	assert(strstr(grow, "call callee") != NULL);
+	free(grow);
+	free(assembly);
+	return 0;
+}
@@ -0,0 +1,95 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2012 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Helpers constructing small graphs for the unittests.
+ */
+#ifndef FIRM_UNITTESTS_TESTGRAPH_H
+#define FIRM_UNITTESTS_TESTGRAPH_H
+
+#include "firm.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Returns a new method type with @p n_params parameters and one result, all
+ * of mode @p mode.
+ */
+static inline ir_type *new_method_type(ir_mode *const mode,
+                                       size_t const n_params)
+{
+	ir_type *const type        = get_type_for_mode(mode);
+	ir_type *const method_type = new_type_method(n_params, 1, false,
+	                                             cc_cdecl_set, mtp_no_property);
+	for (size_t i = 0; i < n_params; ++i)
+		set_method_param_type(method_type, i, type);
+	set_method_res_type(method_type, 0, type);
+	return method_type;
+}
+
+/** Returns a new global function entity. */
+static inline ir_entity *new_function(char const *const name,
+                                      ir_type *const type,
+                                      ir_visibility const visibility)
+{
+	return new_global_entity(get_glob_type(), new_id_from_str(name), type,
+	                         visibility, IR_LINKAGE_DEFAULT);
+}
+
+/**
+ * Creates the graph of @p entity with @p n_loc local variables and makes it
+ * the current graph.
+ */
+static inline ir_graph *new_function_graph(ir_entity *const entity,
+                                           int const n_loc)
+{
+	ir_graph *const irg = new_ir_graph(entity, n_loc);
+	set_current_ir_graph(irg);
+	return irg;
+}
+
+/**
+ * Creates the graph of a new external function with @p n_params parameters
+ * and one result of mode @p mode, see new_function_graph().
+ */
+static inline ir_graph *new_graph(char const *const name, ir_mode *const mode,
+                                  size_t const n_params, int const n_loc)
+{
+	ir_type   *const type   = new_method_type(mode, n_params);
+	ir_entity *const entity = new_function(name, type, ir_visibility_external);
+	return new_function_graph(entity, n_loc);
+}
+
+/** Returns parameter @p i of @p irg in the mode of its type. */
+static inline ir_node *get_param(ir_graph *const irg, unsigned const i)
+{
+	ir_type *const type = get_entity_type(get_irg_entity(irg));
+	ir_mode *const mode = get_type_mode(get_method_param_type(type, i));
+	return new_Proj(get_irg_args(irg), mode, i);
+}
+
+/**
+ * Returns @p res from the current block and finishes the construction of
+ * @p irg.
+ */
+static inline void finish_graph(ir_graph *const irg, ir_node *res)
+{
+	ir_node *const ret = new_Return(get_store(), 1, &res);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+	mature_immBlock(get_r_cur_block(irg));
+	irg_finalize_cons(irg);
+}
+
+/** Returns the result of the only Return of @p irg. */
+static inline ir_node *get_return_value(ir_graph *const irg)
+{
+	ir_node *const ret = get_Block_cfgpred(get_irg_end_block(irg), 0);
+	assert(is_Return(ret));
+	return get_Return_res(ret, 0);
+}
+
+#endif